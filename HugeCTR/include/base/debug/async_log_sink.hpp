@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace HugeCTR {
+
+/**
+ * @brief
+ * Hands formatted log messages over to a background thread that writes them. Messages are passed
+ * through a bounded lock-free ring buffer (multiple producers, single consumer), so \p push never
+ * waits for I/O or for a lock. If the buffer is full, the message is dropped and counted instead.
+ */
+class AsyncLogSink final {
+ public:
+  using WriteFunction = std::function<void(int level, const std::string& message)>;
+  using FlushFunction = std::function<void()>;
+
+  /**
+   * @param capacity Number of messages that can be queued (rounded up to a power of 2).
+   * @param write Called by the writer thread for each message.
+   * @param flush Called by the writer thread after each batch of messages.
+   */
+  AsyncLogSink(size_t capacity, const WriteFunction& write, const FlushFunction& flush);
+  AsyncLogSink(const AsyncLogSink&) = delete;
+  AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+  /**
+   * Writes all queued messages and stops the writer thread.
+   */
+  ~AsyncLogSink();
+
+  /**
+   * Queue a message. Never blocks.
+   *
+   * @return false if the message was dropped, because the buffer is full.
+   */
+  bool push(int level, std::string&& message);
+
+  /**
+   * Blocks until all messages pushed before this call have been written and flushed.
+   */
+  void flush() const;
+
+  size_t get_num_dropped() const { return num_dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    int level;
+    std::string message;
+  };
+
+  const size_t capacity_;
+  const std::unique_ptr<Slot[]> slots_;
+  const WriteFunction write_;
+  const FlushFunction flush_;
+
+  alignas(64) std::atomic<size_t> head_{0};     // Next position to push to.
+  alignas(64) size_t tail_{0};                  // Next position to pop from (writer thread).
+  alignas(64) std::atomic<size_t> written_{0};  // Messages written and flushed.
+  std::atomic<size_t> num_dropped_{0};
+  std::atomic<bool> terminate_{false};
+  std::thread writer_;
+
+  size_t drain();
+  void run();
+};
+
+}  // namespace HugeCTR
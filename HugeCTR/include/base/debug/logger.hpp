@@ -60,6 +60,23 @@
      hctr_3374842_0_warning.log
      hctr_3374842_0_debug.log
 
+ * Messages at a disabled level cost a single branch: neither the message nor the arguments of
+ HCTR_LOG, HCTR_PRINT and HCTR_LOG_S are evaluated. If HugeCTR is configured with
+ -DHCTR_COMPILED_LOG_LEVEL=N, all messages above level N are removed at compile time.
+ * HCTR_LOG_S is a statement. To keep a stream open across several statements, use
+ HCTR_LOG_ENTRY instead.
+ * 1.3. Examples:
+     HCTR_LOG_S(TRACE, WORLD) << "hits: " << count_hits() << std::endl;  // count_hits() is only
+ called if TRACE is enabled.
+     auto log = HCTR_LOG_ENTRY(INFO, ROOT);
+     for (const auto& x : xs) log << x << ' ';
+     log << std::endl;
+
+ * By setting 'HUGECTR_LOG_ASYNC' to 1, messages are handed to a background thread which writes
+ them, so that logging threads never block on file I/O. Errors are always written synchronously.
+ * 1.4. Examples:
+     $ HUGECTR_LOG_ASYNC=1 HUGECTR_LOG_LEVEL=9 python inference.py
+
  * 2. Exception handling:
  * For HugeCTR's own errors, HCTR_OWN_THROW is used.
  * For MPI, use HCTR_MPI_THROW. For the other libraries including CUDA, cuBLAS, NCCL,etc, use
@@ -114,6 +131,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -168,17 +186,38 @@ enum class Error_t {
 #define DEFAULT_LOG_LEVEL LOG_LEVEL(DEBUG)
 #endif
 
-#define HCTR_LOG(NAME, TYPE, ...) \
-  HugeCTR::Logger::get().log(LOG_LEVEL(NAME), LOG_RANK(TYPE), true, __VA_ARGS__)
-#define HCTR_LOG_AT(LEVEL, TYPE, ...) \
-  HugeCTR::Logger::get().log(LEVEL, LOG_RANK(TYPE), true, __VA_ARGS__)
+// Log levels above HCTR_COMPILED_LOG_LEVEL are compiled out.
+#ifdef HCTR_COMPILED_LOG_LEVEL
+#define LOG_LEVEL_COMPILED(LEVEL) ((LEVEL) <= HCTR_COMPILED_LOG_LEVEL)
+#else
+#define LOG_LEVEL_COMPILED(LEVEL) true
+#endif
+
+#define HCTR_LOG_ENABLED(LEVEL, PER_RANK) \
+  (LOG_LEVEL_COMPILED(LEVEL) && HugeCTR::Logger::get().is_enabled((LEVEL), (PER_RANK)))
+
+// The arguments are only evaluated if the level is enabled.
+#define HCTR_LOG_AT_(LEVEL, PER_RANK, WITH_PREFIX, ...) \
+  (!HCTR_LOG_ENABLED((LEVEL), (PER_RANK))               \
+       ? static_cast<void>(0)                           \
+       : HugeCTR::Logger::get().log((LEVEL), (PER_RANK), (WITH_PREFIX), __VA_ARGS__))
+
+#define HCTR_LOG(NAME, TYPE, ...) HCTR_LOG_AT_(LOG_LEVEL(NAME), LOG_RANK(TYPE), true, __VA_ARGS__)
+#define HCTR_LOG_AT(LEVEL, TYPE, ...) HCTR_LOG_AT_(LEVEL, LOG_RANK(TYPE), true, __VA_ARGS__)
 
-#define HCTR_LOG_S(NAME, TYPE) HugeCTR::Logger::get().log(LOG_LEVEL(NAME), LOG_RANK(TYPE), true)
+// Stream statement. `<<` binds tighter than `&`, so the whole chain is skipped if disabled.
+#define HCTR_LOG_S(NAME, TYPE)                          \
+  !HCTR_LOG_ENABLED(LOG_LEVEL(NAME), LOG_RANK(TYPE))    \
+      ? static_cast<void>(0)                            \
+      : HugeCTR::Logger::Statement() &                  \
+            HugeCTR::Logger::get().log(LOG_LEVEL(NAME), LOG_RANK(TYPE), true)
 
-#define HCTR_PRINT(NAME, ...) \
-  HugeCTR::Logger::get().log(LOG_LEVEL(NAME), LOG_RANK_ROOT, false, __VA_ARGS__)
-#define HCTR_PRINT_AT(LEVEL, ...) \
-  HugeCTR::Logger::get().log(LEVEL, LOG_RANK_ROOT, false, __VA_ARGS__)
+// Stream object that can be kept across statements. Written when it goes out of scope.
+#define HCTR_LOG_ENTRY(NAME, TYPE) \
+  HugeCTR::Logger::get().log(LOG_LEVEL(NAME), LOG_RANK(TYPE), true)
+
+#define HCTR_PRINT(NAME, ...) HCTR_LOG_AT_(LOG_LEVEL(NAME), LOG_RANK_ROOT, false, __VA_ARGS__)
+#define HCTR_PRINT_AT(LEVEL, ...) HCTR_LOG_AT_(LEVEL, LOG_RANK_ROOT, false, __VA_ARGS__)
 
 // #define HCTR_PRINT_S(NAME) Logger::get().log(LOG_LEVEL(NAME), LOG_RANK_ROOT, false)
 
@@ -401,6 +440,8 @@ inline std::string getErrorString(curandStatus_t err) {
 #define HCTR_ASSERT(EXPR)
 #endif
 
+class AsyncLogSink;
+
 class Logger final {
  public:
   class DeferredEntry final {
@@ -408,8 +449,12 @@ class Logger final {
     inline DeferredEntry(const Logger* logger, const int level, const bool per_rank,
                          const bool with_prefix)
         : logger_{logger}, level_{level}, per_rank_{per_rank}, with_prefix_{with_prefix} {
-      if (with_prefix) {
-        logger_->write_log_prefix(os_, level_);
+      // The stream is only constructed for enabled entries.
+      if (logger_) {
+        os_.emplace();
+        if (with_prefix) {
+          logger_->write_log_prefix(*os_, level_);
+        }
       }
     }
 
@@ -423,14 +468,14 @@ class Logger final {
     template <typename T>
     inline DeferredEntry& operator<<(const T& value) {
       if (logger_) {
-        os_ << value;
+        *os_ << value;
       }
       return *this;
     }
 
     inline DeferredEntry& operator<<(std::ostream& (*fn)(std::ostream&)) {
       if (logger_) {
-        fn(os_);
+        fn(*os_);
       }
       return *this;
     }
@@ -440,12 +485,20 @@ class Logger final {
     int level_;
     bool per_rank_;
     bool with_prefix_;
-    std::ostringstream os_;
+    std::optional<std::ostringstream> os_;
+  };
+
+  // Turns a stream expression into a statement (see HCTR_LOG_S).
+  struct Statement final {
+    inline void operator&(const DeferredEntry&) const {}
   };
 
   static void print_exception(const std::exception& e, int depth);
   static Logger& get();
   ~Logger();
+  inline bool is_enabled(const int level, const bool per_rank) const {
+    return level != LOG_SILENCE_LEVEL && level <= max_level_ && (rank_ == 0 || per_rank);
+  }
   void log(int level, bool per_rank, bool with_prefix, const char* format, ...) const;
   DeferredEntry log(int level, bool per_rank, bool with_prefix) const;
   void abort(const SrcLoc& loc, const char* format = nullptr, ...) const;
@@ -457,6 +510,8 @@ class Logger final {
   }
   void do_throw(HugeCTR::Error_t error_type, const SrcLoc& loc, const std::string& message) const;
   int get_rank();
+  // Blocks until all messages logged so far have been written.
+  void flush() const;
 
  private:
   Logger();
@@ -467,6 +522,8 @@ class Logger final {
 
   FILE* get_file_stream(int level);
   void write_log_prefix(std::ostringstream& os, int level) const;
+  void write(int level, std::string&& message) const;
+  void write_sync(int level, const std::string& message, bool flush) const;
 
   int rank_;
   int max_level_;
@@ -475,6 +532,7 @@ class Logger final {
   std::map<int, FILE*> log_std_;
   std::map<int, FILE*> log_file_;
   std::map<int, std::string> level_name_;
+  std::unique_ptr<AsyncLogSink> async_sink_;
 };
 
 // TODO: Make fully templated and find better location for this?
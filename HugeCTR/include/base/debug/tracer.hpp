@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Scoped tracing spans.
+ *
+ * A span records the wall time of a scope on the calling thread:
+ *
+ *   void DataCollector::read_a_batch_to_device() {
+ *     HCTR_TRACE_SCOPE("data", "DataCollector::read_a_batch_to_device");
+ *     ...
+ *   }
+ *
+ * Spans are only recorded while tracing is enabled. Set the env variable 'HUGECTR_TRACE_FILE' to
+ * enable tracing at startup. The trace is written to that file when the process exits, in the
+ * Chrome trace-event format (open with chrome://tracing or https://ui.perfetto.dev):
+ *
+ *   $ HUGECTR_TRACE_FILE=trace.json python dcn_norm_train.py
+ *
+ * Alternatively, call Tracer::get().set_enabled(true) and Tracer::get().dump(path) directly.
+ *
+ * Each thread appends to its own buffer, so recording a span takes no shared lock. At most
+ * 'HUGECTR_TRACE_MAX_EVENTS' (default: 1048576) spans are kept per thread. Further spans are
+ * dropped. Building with -DHCTR_DISABLE_TRACING removes all spans at compile time.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+class Tracer final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Event final {
+    const char* category;
+    const char* name;
+    int64_t begin;  // ns
+    int64_t end;    // ns
+  };
+
+  static Tracer& get();
+
+  inline bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void set_enabled(bool enabled);
+
+  /**
+   * @return Monotonic timestamp in nanoseconds.
+   */
+  static inline int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+        .count();
+  }
+
+  /**
+   * Record a span on the calling thread. \p category and \p name must outlive the tracer (i.e.,
+   * string literals or names returned by \p intern ).
+   */
+  void record(const char* category, const char* name, int64_t begin, int64_t end);
+
+  /**
+   * @return A copy of \p name that remains valid until the process exits.
+   */
+  const char* intern(const std::string& name);
+
+  /**
+   * Write all recorded spans as Chrome trace-event JSON.
+   */
+  void write_chrome_trace(std::ostream& os) const;
+  void dump(const std::string& path) const;
+
+  /**
+   * Discard all recorded spans.
+   */
+  void clear();
+
+  size_t get_num_events() const;
+  size_t get_num_dropped() const { return num_dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  Tracer();
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  struct ThreadBuffer final {
+    size_t tid;
+    std::string thread_name;
+    // Only contended while the trace is written.
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+  };
+
+  ThreadBuffer& thread_buffer_();
+
+  std::atomic<bool> enabled_{false};
+  size_t max_events_per_thread_;
+  std::atomic<size_t> num_dropped_{0};
+
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  std::set<std::string> interned_names_;
+};
+
+/**
+ * Records the time from construction to destruction, if tracing is enabled at construction.
+ */
+class TraceSpan final {
+ public:
+  TraceSpan(const char* const category, const char* const name)
+      : category_{category},
+        name_{name},
+        begin_{Tracer::get().is_enabled() ? Tracer::now() : -1} {}
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  ~TraceSpan() {
+    if (begin_ >= 0) {
+      Tracer::get().record(category_, name_, begin_, Tracer::now());
+    }
+  }
+
+ private:
+  const char* const category_;
+  const char* const name_;
+  const int64_t begin_;
+};
+
+}  // namespace HugeCTR
+
+#define HCTR_TRACE_CONCAT_(A, B) A##B
+#define HCTR_TRACE_VAR_(LINE) HCTR_TRACE_CONCAT_(hctr_trace_span_, LINE)
+
+#ifndef HCTR_DISABLE_TRACING
+
+// Trace the remainder of the enclosing scope.
+#define HCTR_TRACE_SCOPE(CATEGORY, NAME) \
+  const HugeCTR::TraceSpan HCTR_TRACE_VAR_(__LINE__)((CATEGORY), (NAME))
+
+// Timestamp for HCTR_TRACE_RECORD, or -1 if tracing is disabled.
+#define HCTR_TRACE_NOW() \
+  (HugeCTR::Tracer::get().is_enabled() ? HugeCTR::Tracer::now() : int64_t{-1})
+
+// Trace an interval that does not map to a scope, e.g., an asynchronous I/O request.
+#define HCTR_TRACE_RECORD(CATEGORY, NAME, BEGIN)                           \
+  do {                                                                     \
+    const int64_t hctr_trace_begin_ = (BEGIN);                             \
+    if (hctr_trace_begin_ >= 0) {                                          \
+      HugeCTR::Tracer::get().record((CATEGORY), (NAME), hctr_trace_begin_, \
+                                    HugeCTR::Tracer::now());               \
+    }                                                                      \
+  } while (0)
+
+#else
+
+#define HCTR_TRACE_SCOPE(CATEGORY, NAME) \
+  do {                                   \
+  } while (0)
+#define HCTR_TRACE_NOW() int64_t{-1}
+#define HCTR_TRACE_RECORD(CATEGORY, NAME, BEGIN) \
+  do {                                           \
+    (void)(BEGIN);                               \
+  } while (0)
+
+#endif
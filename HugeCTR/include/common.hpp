@@ -280,7 +280,7 @@ inline void hctr_print_func<double>(Logger::DeferredEntry& log, double const& t)
 template <typename... Args>
 inline void HCTR_LOG_ARGS(const Args&... args) {
   if (Logger::get().get_rank() == 0) {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << '[';
     (hctr_print_func(log, args), ...);
     log << ']' << std::endl;
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chrono>
+#include <common.hpp>
+#include <condition_variable>
+#include <cpu/inference_session_cpu.hpp>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <parser.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Dynamic batching front end for \p InferenceSessionCPU . Concurrent \p predict calls are queued
+ * and merged into combined batches of up to \p max_batchsize samples. A batch is dispatched once
+ * it is full, or once the oldest request in it has waited for \p max_batch_delay . Batches are
+ * executed by a pool of session replicas (one worker thread each), which share the parameter
+ * server. Outputs are scattered back to the callers via futures.
+ *
+ * Requests use the same layout as \p InferenceSessionCPU::predict (dense features and keys sample
+ * first, row pointers per embedding table), but only need to cover \p num_samples samples.
+ */
+template <typename TypeHashKey>
+class BatchingInferenceSessionCPU {
+ public:
+  DISALLOW_COPY_AND_MOVE(BatchingInferenceSessionCPU);
+
+  /**
+   * Construct a new BatchingInferenceSessionCPU object.
+   *
+   * @param model_config_path Model configuration (same as for \p InferenceSessionCPU ).
+   * @param inference_params Inference parameters. \p max_batchsize limits the merged batches.
+   * @param parameter_server Parameter server shared by all replicas.
+   * @param num_replicas Number of session replicas that process batches concurrently.
+   * @param max_batch_delay Maximum time a request waits for other requests to join its batch.
+   */
+  BatchingInferenceSessionCPU(const std::string& model_config_path,
+                              const InferenceParams& inference_params,
+                              const std::shared_ptr<HierParameterServerBase>& parameter_server,
+                              size_t num_replicas = 1,
+                              std::chrono::microseconds max_batch_delay =
+                                  std::chrono::microseconds(1000));
+
+  virtual ~BatchingInferenceSessionCPU();
+
+  /**
+   * Enqueue a request. All input buffers must stay valid, and \p h_output must not be touched,
+   * until the returned future is ready.
+   *
+   * @param h_dense Dense features (\p num_samples x dense_dim).
+   * @param h_embeddingcolumns Keys of all samples (sample first).
+   * @param h_row_ptrs Row pointers for each embedding table (\p num_samples x slot_num + 1 each).
+   * @param h_output Receives the predictions (\p num_samples x label_dim).
+   * @param num_samples Number of samples (at most \p max_batchsize ).
+   */
+  std::future<void> predict_async(const float* h_dense, const void* h_embeddingcolumns,
+                                  const int* h_row_ptrs, float* h_output, int num_samples);
+
+  /**
+   * Blocking version of \p predict_async .
+   */
+  void predict(const float* h_dense, const void* h_embeddingcolumns, const int* h_row_ptrs,
+               float* h_output, int num_samples);
+
+  size_t num_batches() const;
+  size_t num_requests() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request final {
+    const float* h_dense;
+    const TypeHashKey* h_keys;
+    const int* h_row_ptrs;
+    float* h_output;
+    size_t num_samples;
+    Clock::time_point enqueue_time;
+    std::promise<void> done;
+  };
+
+  struct Replica final {
+    std::unique_ptr<InferenceSessionCPU<TypeHashKey>> session;
+    std::vector<float> dense;
+    std::vector<TypeHashKey> keys;
+    std::vector<int> row_ptrs;
+    std::vector<float> output;
+    std::thread worker;
+  };
+
+  const InferenceParser inference_parser_;
+  const size_t max_batchsize_;
+  const std::chrono::microseconds max_batch_delay_;
+
+  std::vector<std::unique_ptr<Replica>> replicas_;
+
+  std::deque<Request> queue_;
+  bool collecting_{false};  // A worker is assembling the next batch.
+  bool terminate_{false};
+  size_t num_batches_{0};
+  size_t num_requests_{0};
+  mutable std::mutex queue_guard_;
+  std::condition_variable queue_cv_;
+
+  /**
+   * Take the next batch from the queue. Blocks until a batch is complete or its deadline expired.
+   *
+   * @return The requests in the batch (empty if terminating).
+   */
+  std::vector<Request> next_batch_();
+
+  void run_(Replica& replica);
+  void process_(Replica& replica, std::vector<Request>& batch);
+};
+
+}  // namespace HugeCTR
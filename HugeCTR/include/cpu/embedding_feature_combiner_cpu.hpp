@@ -17,11 +17,19 @@
 #pragma once
 
 #include <cpu/layer_cpu.hpp>
+#include <functional>
+#include <vector>
 
 namespace HugeCTR {
 
 enum class EmbeddingFeatureCombiner_t { Sum, Mean };
 
+/**
+ * Writes the embedding vectors of the next \p num_keys keys of a table to \p vectors . Successive
+ * calls walk through the keys in the order of the row pointers.
+ */
+using EmbeddingLookupFunc = std::function<void(size_t num_keys, float* vectors)>;
+
 /**
  * Combine the embedding feature vectors by Sum or Mean
  * according to slot_num and row_ptrs
@@ -67,6 +75,15 @@ class EmbeddingFeatureCombinerCPU : public LayerCPU {
    */
   void fprop(bool is_train = false) override;
 
+  /**
+   * Fused lookup and combine (embedding bag). Instead of reading the embedding vectors from the
+   * input tensor, they are fetched chunk by chunk with \p lookup and accumulated straight into
+   * the output tensor. The input tensor is not used.
+   * @param lookup fetches the embedding vectors of the next keys
+   * @param num_samples number of valid samples. The output of the remaining samples is set to 0.
+   */
+  void fprop_fused(const EmbeddingLookupFunc& lookup, int num_samples);
+
   void bprop() override {
     HCTR_OWN_THROW(Error_t::IllegalCall,
                    "The bprop() of EmbeddingFeatureCombiner is not implemented!");
@@ -77,6 +94,11 @@ class EmbeddingFeatureCombinerCPU : public LayerCPU {
   int slot_num_;
   int embedding_vec_size_;
   EmbeddingFeatureCombiner_t combiner_type_;
+
+  /*
+   * staging buffer for the fused path (holds the embedding vectors of one chunk).
+   */
+  std::vector<float> lookup_buffer_;
 };
 
 }  // namespace HugeCTR
@@ -45,7 +45,6 @@ class InferenceSessionCPU {
   std::shared_ptr<HierParameterServerBase> parameter_server_;
 
   void* h_keys_;
-  float* h_embedding_vectors_;
 
   std::shared_ptr<CPUResource> cpu_resource_;
 
@@ -56,6 +56,11 @@ class LayerCPU {
    * Some of the layers requires initialize like fully connected layer
    */
   virtual void initialize() {}
+
+  /*
+   * Quantize the weights for INT8 inference. Layers that support it run fprop in INT8 afterwards
+   */
+  virtual void quantize() {}
 };
 
 }  // namespace HugeCTR
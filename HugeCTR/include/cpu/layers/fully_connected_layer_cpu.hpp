@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cpu/layer_cpu.hpp>
+#include <cpu/quantization_cpu.hpp>
 #include <functional>
 #include <vector>
 
@@ -33,6 +34,7 @@ template <>
 class FullyConnectedLayerCPU<float> : public LayerCPU {
  private:
   const bool use_mixed_precision_{false};
+  const bool fuse_relu_{false};
 
   /*
    * stores the weight tensors of this layer.
@@ -50,6 +52,13 @@ class FullyConnectedLayerCPU<float> : public LayerCPU {
    * stores the references to the output tensors of this layer.
    */
   Tensors2<float> out_tensors_;
+  /*
+   * INT8 weights and activations (only used once quantized).
+   */
+  bool quantized_{false};
+  Int8WeightsCPU int8_weights_;
+  Int8ActivationsCPU int8_in_;
+  std::vector<float> int8_concat_in_;  // Inputs gathered row by row if there are several.
 
   Tensors2<float>& get_in_tensors(bool is_train) { return in_tensors_; }
 
@@ -62,6 +71,10 @@ class FullyConnectedLayerCPU<float> : public LayerCPU {
    * backward pass
    */
   void bprop() final;
+  /**
+   * quantize weights for INT8 inference
+   */
+  void quantize() final;
 
   /**
    * This is the constructor of the FullyConnectedLayer.
@@ -75,11 +88,20 @@ class FullyConnectedLayerCPU<float> : public LayerCPU {
    * @param out_tensor: stores the output tensor
    * @param weight_format: specifies the format of the weight tensor, either HW (row major) or WH
    * (col-major)
+   * @param fuse_relu: apply ReLU to the output (after the bias)
    */
   FullyConnectedLayerCPU(const std::shared_ptr<BufferBlock2<float>>& weight_buff,
                          const std::shared_ptr<BufferBlock2<float>>& wgrad_buff,
                          const Tensor2<float>& in_tensor, const Tensor2<float>& out_tensor,
-                         bool use_mixed_precision);
+                         bool use_mixed_precision, bool fuse_relu = false);
+  /**
+   * Fully connected layer over the concatenation (along the second dimension) of \p in_tensors ,
+   * without materializing it. Each input is multiplied with its own rows of the weights.
+   */
+  FullyConnectedLayerCPU(const std::shared_ptr<BufferBlock2<float>>& weight_buff,
+                         const std::shared_ptr<BufferBlock2<float>>& wgrad_buff,
+                         const Tensors2<float>& in_tensors, const Tensor2<float>& out_tensor,
+                         bool use_mixed_precision, bool fuse_relu = false);
   FullyConnectedLayerCPU(const FullyConnectedLayerCPU& C) = delete;
   FullyConnectedLayerCPU& operator=(const FullyConnectedLayerCPU&);
 };
@@ -18,6 +18,7 @@
 
 #include <cpu/layer_cpu.hpp>
 #include <cpu/layers/fully_connected_layer_cpu.hpp>
+#include <cpu/quantization_cpu.hpp>
 #include <functional>
 #include <vector>
 
@@ -54,6 +55,19 @@ class FullyConnectedLayerCPU<__half> : public LayerCPU {
    */
   Tensor2<__half> identity_tensor_;
 
+  /*
+   * apply ReLU to the output (after the bias).
+   */
+  const bool fuse_relu_{false};
+
+  /*
+   * INT8 weights and activations (only used once quantized).
+   */
+  bool quantized_{false};
+  Int8WeightsCPU int8_weights_;
+  Int8ActivationsCPU int8_bottom_;
+  std::vector<float> int8_top_;
+
   Tensor2<__half>& get_bottom_tensor(bool is_train) { return bottom_tensor_; }
 
  public:
@@ -65,6 +79,10 @@ class FullyConnectedLayerCPU<__half> : public LayerCPU {
    * backward pass
    */
   void bprop() final;
+  /**
+   * quantize weights for INT8 inference
+   */
+  void quantize() final;
 
   /**
    * This is the constructor of the FullyConnectedLayer.
@@ -78,12 +96,14 @@ class FullyConnectedLayerCPU<__half> : public LayerCPU {
    * @param top_tensor: stores the tensor to top layer
    * @param tensor_format: specifies the format of the weight tensor, either HW (row major) or WH
    * (col-major)
+   * @param fuse_relu: apply ReLU to the output (after the bias)
    */
   FullyConnectedLayerCPU(const std::shared_ptr<BufferBlock2<float>>& master_weights_buff,
                          const std::shared_ptr<BufferBlock2<__half>>& weights_buff,
                          const std::shared_ptr<BufferBlock2<__half>>& weights_grad_buff,
                          const std::shared_ptr<GeneralBuffer2<HostAllocator>>& blobs_buff,
-                         const Tensor2<__half>& bottom_tensor, const Tensor2<__half>& top_tensor);
+                         const Tensor2<__half>& bottom_tensor, const Tensor2<__half>& top_tensor,
+                         bool fuse_relu = false);
   FullyConnectedLayerCPU(const FullyConnectedLayerCPU&) = delete;
   FullyConnectedLayerCPU& operator=(const FullyConnectedLayerCPU&);
 };
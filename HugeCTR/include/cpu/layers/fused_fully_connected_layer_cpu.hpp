@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cpu/layer_cpu.hpp>
+#include <cpu/quantization_cpu.hpp>
 #include <functional>
 #include <vector>
 
@@ -56,6 +57,14 @@ class FusedFullyConnectedLayerCPU : public LayerCPU {
    */
   Tensor2<float> bias_grad_tensor_;
 
+  /*
+   * INT8 weights and activations (only used once quantized).
+   */
+  bool quantized_{false};
+  Int8WeightsCPU int8_weights_;
+  Int8ActivationsCPU int8_bottom_;
+  std::vector<float> int8_top_;
+
   Tensor2<__half>& get_bottom_tensor(bool is_train) { return bottom_tensor_; }
 
  public:
@@ -67,6 +76,10 @@ class FusedFullyConnectedLayerCPU : public LayerCPU {
    * backward pass
    */
   void bprop() final;
+  /**
+   * quantize weights for INT8 inference
+   */
+  void quantize() final;
 
   /**
    * This is the constructor of the FullyConnectedLayer.
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cpu/layer_cpu.hpp>
+#include <cpu/quantization_cpu.hpp>
 #include <functional>
 #include <vector>
 
@@ -25,11 +26,13 @@ namespace HugeCTR {
 class MultiCrossLayerCPU : public LayerCPU {
  private:
   const int num_layers_;
+  const size_t projection_dim_;  // 0: DCNv1, otherwise DCNv2 with U: [w,p], V: [p,w]
   Tensors2<float> blob_tensors_; /**< vector of internal blobs' tensors */
   Tensors2<float> vec_tensors_;  //[h,1]
 
   Tensor2<float> tmp_mat_tensors_[3];  //[h,w]
   Tensor2<float> tmp_vec_tensor_;      //[h,1]
+  Tensor2<float> xu_tensor_;           //[h,p], DCNv2 only
 
   /*
    * stores the weight tensors of this layer.
@@ -47,6 +50,13 @@ class MultiCrossLayerCPU : public LayerCPU {
    * stores the references to the output tensors of this layer.
    */
   Tensors2<float> out_tensors_;
+  /*
+   * INT8 kernels of each cross layer (U and V for DCNv2), and activations (only used once
+   * quantized).
+   */
+  std::vector<Int8WeightsCPU> int8_kernels_;
+  Int8ActivationsCPU int8_in_;
+  Int8ActivationsCPU int8_xu_;
 
  public:
   /**
@@ -57,12 +67,21 @@ class MultiCrossLayerCPU : public LayerCPU {
    * backward pass
    */
   void bprop() final;
+  /**
+   * quantize weights for INT8 inference
+   */
+  void quantize() final;
 
+  /**
+   * @param projection_dim If nonzero, use the low-rank DCNv2 cross layer
+   * x_{l+1} = x_0 .* (x_l * U * V + b) + x_l, with the weights U, V and b of each layer reserved
+   * in the same order as by MultiCrossLayer.
+   */
   MultiCrossLayerCPU(const std::shared_ptr<BufferBlock2<float>>& weight_buff,
                      const std::shared_ptr<BufferBlock2<float>>& wgrad_buff,
                      const std::shared_ptr<GeneralBuffer2<HostAllocator>>& blobs_buff,
                      const Tensor2<float>& in_tensor, const Tensor2<float>& out_tensor,
-                     int num_layers);
+                     int num_layers, size_t projection_dim = 0);
   MultiCrossLayerCPU(const MultiCrossLayerCPU&) = delete;
   MultiCrossLayerCPU& operator=(const MultiCrossLayerCPU&) = delete;
 };
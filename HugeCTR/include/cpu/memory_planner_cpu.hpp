@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <tensor2.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * @brief
+ * Liveness-based memory planner for the intermediate tensors of a \p NetworkCPU . Each tensor is
+ * reserved with the step (layer) that produces it, and marked as used by every step that reads
+ * it. \p allocate assigns offsets in one arena such that tensors with overlapping lifetimes never
+ * share memory, while all others may.
+ */
+class MemoryPlannerCPU {
+ public:
+  static constexpr size_t alignment = 64;
+
+  MemoryPlannerCPU() = default;
+  MemoryPlannerCPU(const MemoryPlannerCPU&) = delete;
+  MemoryPlannerCPU& operator=(const MemoryPlannerCPU&) = delete;
+
+  /**
+   * Reserve a tensor that is written by \p step .
+   *
+   * @return Id of the tensor for \p use .
+   */
+  template <typename T>
+  size_t reserve(const std::vector<size_t>& dimensions, const size_t step, Tensor2<T>* tensor) {
+    const size_t size_in_bytes =
+        get_num_elements_from_dimensions(dimensions) * TensorScalarSizeFunc<T>::get_element_size();
+    *tensor = Tensor2<T>(dimensions, reserve_(size_in_bytes, step));
+    return blocks_.size() - 1;
+  }
+
+  /**
+   * Extend the lifetime of tensor \p id up to (and including) \p step .
+   */
+  void use(size_t id, size_t step);
+
+  /**
+   * Plan the offsets of all reserved tensors and allocate the arena.
+   */
+  void allocate();
+
+  /**
+   * @return Size of the arena (valid after \p allocate ).
+   */
+  size_t get_size_in_bytes() const { return size_in_bytes_; }
+
+  /**
+   * @return Memory that the reserved tensors would need without reuse.
+   */
+  size_t get_reserved_size_in_bytes() const;
+
+ private:
+  class Arena;
+  class PlannedBuffer;
+
+  struct Block {
+    size_t size_in_bytes;
+    size_t first_step;
+    size_t last_step;
+    std::shared_ptr<PlannedBuffer> buffer;
+  };
+
+  std::vector<Block> blocks_;
+  std::shared_ptr<Arena> arena_;
+  size_t size_in_bytes_{0};
+
+  std::shared_ptr<TensorBuffer2> reserve_(size_t size_in_bytes, size_t step);
+};
+
+}  // namespace HugeCTR
@@ -35,6 +35,7 @@ namespace HugeCTR {
 class NetworkCPU {
  private:
   std::vector<std::unique_ptr<LayerCPU>> layers_; /**< vector of layers */
+  std::vector<const char*> layer_trace_names_;    /**< layer names for tracing */
 
   Tensor2<float> weight_tensor_;
   Tensor2<float> wgrad_tensor_;
@@ -43,10 +44,13 @@ class NetworkCPU {
 
   Tensor2<float> pred_tensor_;
 
+  size_t buffer_size_in_bytes_{0};
+
   std::shared_ptr<CPUResource> cpu_resource_;
   // std::shared_ptr<GPUResource> gpu_resource_; /**< gpu resource */
 
   bool use_mixed_precision_;
+  bool use_int8_; /**< quantize layers that support INT8 once weights are known */
   // bool enable_cuda_graph_;
 
   // bool predict_graph_created_;
@@ -64,14 +68,18 @@ class NetworkCPU {
 
   void conv_weight_(Tensor2<__half>& target, const Tensor2<float>& source);
 
+  void quantize_();
+
  public:
   /**
    * Ctor.
    * @param device_id device id.
    * @param gpu_resource gpu resource for local gpu.
    * @param disable_parser only for unit test.
+   * @param use_int8 run dense layers that support it in INT8 (post-training quantization).
    */
-  NetworkCPU(const std::shared_ptr<CPUResource>& cpu_resource, bool use_mixed_precision = false);
+  NetworkCPU(const std::shared_ptr<CPUResource>& cpu_resource, bool use_mixed_precision = false,
+             bool use_int8 = false);
   NetworkCPU(const NetworkCPU&) = delete;
   NetworkCPU& operator=(const NetworkCPU&) = delete;
 
@@ -90,6 +98,11 @@ class NetworkCPU {
    */
   size_t get_params_num() const { return weight_tensor_.get_num_elements(); }
 
+  /**
+   * Get the size of all host buffers of this network (weights, activations, workspaces).
+   */
+  size_t get_buffer_size_in_bytes() const { return buffer_size_in_bytes_; }
+
   /**
    * Read parameters from model_file.
    */
@@ -102,11 +115,14 @@ class NetworkCPU {
 
   /**
    * factory method to create network
+   * @param optimize_graph fuse layers (FC + ReLU, Concat into FC), replace Reshape, Slice and
+   * Dropout by views, and let intermediate tensors with disjoint lifetimes share memory.
    */
   static NetworkCPU* create_network(const nlohmann::json& j_array,
                                     std::vector<TensorEntry>& tensor_entries,
                                     const std::shared_ptr<CPUResource>& cpu_resource,
-                                    bool use_mixed_precision);
+                                    bool use_mixed_precision, bool use_int8 = false,
+                                    bool optimize_graph = true);
 };
 
 }  // namespace HugeCTR
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * @brief
+ * Weights of a dense layer (k inputs x n outputs, row-major), quantized to symmetric INT8 with one
+ * scale per output channel. Channels are stored transposed (n x k_padded), so that each output is
+ * the dot product of two contiguous rows.
+ */
+struct Int8WeightsCPU {
+  static constexpr size_t k_alignment = 64;  // Rows are zero-padded to full AVX-512 registers.
+
+  size_t k{0};
+  size_t n{0};
+  size_t k_padded{0};
+  std::vector<int8_t> values;  // n x k_padded
+  std::vector<float> scales;   // n
+  std::vector<int32_t> sums;   // Sum of each channel (compensates the offset of VNNI kernels).
+
+  void quantize(const float* weights, size_t k, size_t n);
+};
+
+/**
+ * @brief
+ * Activations (m x k, row-major), dynamically quantized to symmetric INT8 with one scale per row.
+ */
+struct Int8ActivationsCPU {
+  size_t m{0};
+  size_t k{0};
+  size_t k_padded{0};
+  std::vector<int8_t> values;  // m x k_padded
+  std::vector<float> scales;   // m
+
+  template <typename T>
+  void quantize(const T* in, size_t m, size_t k);
+};
+
+enum class Int8GemmKernel_t { Generic, AVX2, AVX512VNNI };
+
+/**
+ * INT8 GEMM with INT32 accumulation: out[i][j] = sum_k a[i][k] * w[k][j], dequantized to float
+ * (m x n, row-major). Uses AVX512-VNNI or AVX2 kernels if the CPU supports them.
+ */
+void int8_gemm_cpu(const Int8ActivationsCPU& a, const Int8WeightsCPU& w, float* out);
+
+/**
+ * INT8 GEMM using a specific kernel. All kernels yield bit-identical results.
+ * @param kernel must be one of int8_gemm_cpu_kernels()
+ */
+void int8_gemm_cpu(const Int8ActivationsCPU& a, const Int8WeightsCPU& w, float* out,
+                   Int8GemmKernel_t kernel);
+
+/**
+ * @return Name of the INT8 GEMM kernel that is used on this CPU.
+ */
+const char* int8_gemm_cpu_kernel();
+
+/**
+ * @return INT8 GEMM kernels that this CPU supports (fastest first).
+ */
+std::vector<Int8GemmKernel_t> int8_gemm_cpu_kernels();
+
+}  // namespace HugeCTR
@@ -39,6 +39,7 @@ struct InternalBatchBuffer {
   int num_submitted_broadcasts;
   bool preload_done;
   cudaEvent_t event;
+  int64_t trace_begin = -1;  // Start of the current I/O or upload, see HCTR_TRACE_NOW().
 
   // Following the rule of 5 just in case
   // Only need the destructor here
@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <base/debug/tracer.hpp>
 #include <common.hpp>
 #include <memory>
 #include <mutex>
@@ -114,6 +115,7 @@ class DataCollector {
           }
           dst_buffer->current_batch_size = current_src_buffer->current_batch_size;
           if (current_src_buffer->current_batch_size != 0) {
+            HCTR_TRACE_SCOPE("data", "DataCollector::broadcast");
             broadcast<T>(current_src_buffer, dst_buffer, last_batch_nnz_, resource_manager_);
 
             current_src_buffer->state.store(BufferState::ReadyForWrite);
@@ -158,7 +160,10 @@ class DataCollector {
         last_batch_nnz_(
             broadcast_buffer->is_fixed_length.size() * resource_manager->get_local_gpu_count(), 0),
         resource_manager_(resource_manager) {
-    background_collector_thread_ = std::thread([this]() { background_collector_.start(); });
+    background_collector_thread_ = std::thread([this]() {
+      hctr_set_thread_name("data collector");
+      background_collector_.start();
+    });
   }
 
   ~DataCollector() {
@@ -168,11 +173,16 @@ class DataCollector {
 
   long long read_a_batch_to_device() {
     // HCTR_LOG(INFO, ROOT, "data collector waiting read_a_batch_to_device\n");
-    BufferState expected = BufferState::ReadyForRead;
-    while (!broadcast_buffer_->state.compare_exchange_weak(expected, BufferState::Reading)) {
-      expected = BufferState::ReadyForRead;
-      usleep(2);
+    {
+      // Time spent here means the data readers fell behind.
+      HCTR_TRACE_SCOPE("data", "DataCollector::wait_for_batch");
+      BufferState expected = BufferState::ReadyForRead;
+      while (!broadcast_buffer_->state.compare_exchange_weak(expected, BufferState::Reading)) {
+        expected = BufferState::ReadyForRead;
+        usleep(2);
+      }
     }
+    HCTR_TRACE_SCOPE("data", "DataCollector::read_a_batch_to_device");
     long long current_batch_size = broadcast_buffer_->current_batch_size;
     if (current_batch_size != 0) {
       int local_gpu_count = resource_manager_->get_local_gpu_count();
@@ -231,6 +241,7 @@ class DataCollector {
   }
 
   void finalize_batch() {
+    HCTR_TRACE_SCOPE("data", "DataCollector::finalize_batch");
     /*for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
       const auto &local_gpu = resource_manager_->get_local_gpu(i);
       CudaDeviceContext context(local_gpu->get_device_id());
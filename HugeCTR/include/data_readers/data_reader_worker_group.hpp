@@ -19,6 +19,7 @@
 #include <numa.h>
 
 #include <atomic>
+#include <base/debug/tracer.hpp>
 #include <common.hpp>
 #include <data_readers/csr.hpp>
 #include <data_readers/data_reader_worker_interface.hpp>
@@ -48,7 +49,9 @@ static void data_reader_thread_func_(const std::shared_ptr<IDataReaderWorker>& d
       usleep(2);
     }
 
+    hctr_set_thread_name("data reader");
     while (*p_loop_flag) {
+      HCTR_TRACE_SCOPE("data", "DataReaderWorker::read_a_batch");
       data_reader->read_a_batch();
     }
   } catch (const std::runtime_error& rt_err) {
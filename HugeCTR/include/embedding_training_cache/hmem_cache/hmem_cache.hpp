@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <common.hpp>
+#include <cstdint>
 #include <embedding_training_cache/hmem_cache/sparse_model_file_ts.hpp>
+#include <memory>
 
 namespace HugeCTR {
 
@@ -40,6 +43,29 @@ class HMemCache {
   size_t static const end_flag{SparseModelFileTS<TypeKey>::end_flag};
 
  private:
+  /**
+   * A cached pass. The slot ids, access frequencies, embedding vectors and optimizer states of
+   * all lines are stored in a single arena, which is interleaved across NUMA nodes if the host
+   * has more than one node.
+   */
+  struct Block {
+    HashTableType key_idx_map;
+    size_t *slot_ids{nullptr};
+    uint32_t *freqs{nullptr};
+    // data_ptrs[0] is for the embedding vectors, data_ptrs[1~data_ptrs.size()-1] for opt states.
+    std::vector<float *> data_ptrs;
+
+    Block(size_t capacity, bool use_slot_id, size_t vec_per_line, size_t emb_vec_size,
+          size_t num_threads);
+    ~Block();
+    DISALLOW_COPY_AND_MOVE(Block);
+
+   private:
+    void *arena_{nullptr};
+    size_t arena_size_{0};
+    bool numa_allocated_{false};
+  };
+
   int const num_block_;
   double const target_hit_rate_;
   size_t const max_num_evict_;
@@ -48,19 +74,22 @@ class HMemCache {
   const bool use_slot_id_;
   const size_t emb_vec_size_;
   const size_t vec_per_line_;
+  const size_t num_threads_;
   std::shared_ptr<ResourceManager> resource_manager_;
 
-  std::vector<HashTableType> key_idx_maps_;
-  std::vector<std::vector<size_t>> slot_ids_;
-  std::vector<std::vector<std::vector<float>>> cache_datas_;
+  // +1 is reserved for a temp buffer
+  std::vector<std::unique_ptr<Block>> blocks_;
 
   bool is_full_{false};
   int head_id_{-1};
+  size_t pass_counter_{0};
+  double hit_rate_{0.};
 
   std::shared_ptr<SparseModelFileTS<TypeKey>> sparse_model_file_ptr_;
 
   size_t find_(TypeKey key);
   std::pair<int, size_t> cascade_find_(TypeKey key);
+  size_t retain_hot_lines_(Block &dst, size_t dst_offset, Block &src);
 
  public:
   HMemCache(size_t num_cached_pass, double target_hit_rate, size_t max_num_evict,
@@ -76,6 +105,11 @@ class HMemCache {
   void sync_to_ssd();
 
   auto get_sparse_model_file() { return sparse_model_file_ptr_; }
+
+  /**
+   * @return Fraction of the keys found in the cache during the most recent read().
+   */
+  double get_hit_rate() const { return hit_rate_; }
 };
 
 }  // namespace HugeCTR
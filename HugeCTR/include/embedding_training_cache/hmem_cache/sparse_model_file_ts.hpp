@@ -16,9 +16,9 @@
 
 #pragma once
 
+#include <embedding_training_cache/key_index_map.hpp>
 #include <memory>
 #include <resource_manager.hpp>
-#include <unordered_map>
 #include <vector>
 
 namespace HugeCTR {
@@ -26,7 +26,7 @@ namespace HugeCTR {
 template <typename TypeKey>
 class SparseModelFileTS {
  public:
-  using HashTableType = std::unordered_map<TypeKey, size_t>;
+  using HashTableType = KeyIndexMap<TypeKey, size_t>;
 
  private:
   struct EmbeddingTableFile;
@@ -104,6 +104,9 @@ class SparseModelFileTS {
   void dump_update(HashTableType &dump_key_idx_map, std::vector<size_t> &slot_id_vec,
                    std::vector<std::vector<float>> &data_vecs);
 
+  void dump_update(HashTableType &dump_key_idx_map, size_t const *slot_id_ptr,
+                   std::vector<float *> &data_ptrs);
+
   void dump_update(std::vector<size_t> const &ssd_idx_vec, std::vector<size_t> const &mem_idx_vec,
                    size_t const *slot_id_ptr, std::vector<float *> &data_ptrs);
 
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Compact open-addressing hash map from keys to indices, used to track the location of embedding
+ * vectors in the embedding training cache (ETC).
+ *
+ * Key/value pairs are stored inline in a single array with linear probing. Hence, for 8 byte keys
+ * and values an entry occupies 16 bytes (vs. ~64 bytes per node in a std::unordered_map), and a
+ * lookup is typically served from a single cache line. The largest representable key marks empty
+ * slots. If this key is inserted, it is kept in an extra slot at the end of the array.
+ *
+ * The interface mirrors the subset of std::unordered_map used by the ETC. Erasing individual keys
+ * is not supported. Keys must not be modified through iterators.
+ *
+ * @tparam TypeKey Integral key type.
+ * @tparam TypeValue Trivially copyable value type.
+ */
+template <typename TypeKey, typename TypeValue>
+class KeyIndexMap {
+  static_assert(std::is_integral_v<TypeKey>, "Keys must be integral.");
+  static_assert(std::is_trivially_copyable_v<TypeValue>, "Values must be trivially copyable.");
+
+ public:
+  using key_type = TypeKey;
+  using mapped_type = TypeValue;
+  using value_type = std::pair<TypeKey, TypeValue>;
+  using size_type = size_t;
+
+  static constexpr TypeKey empty_key{std::numeric_limits<TypeKey>::max()};
+
+ private:
+  template <bool IsConst>
+  class Iterator {
+    using Map = std::conditional_t<IsConst, const KeyIndexMap, KeyIndexMap>;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = KeyIndexMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+    using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+    Iterator() = default;
+    Iterator(Map* map, size_t pos) : map_{map}, pos_{pos} {}
+    template <bool C = IsConst, typename = std::enable_if_t<!C>>
+    operator Iterator<true>() const {
+      return {map_, pos_};
+    }
+
+    reference operator*() const { return map_->slots_[pos_]; }
+    pointer operator->() const { return &map_->slots_[pos_]; }
+
+    Iterator& operator++() {
+      pos_ = map_->next_(pos_ + 1);
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator tmp{*this};
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+    bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+   private:
+    Map* map_{nullptr};
+    size_t pos_{0};
+  };
+
+ public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  KeyIndexMap() : slots_(1, value_type{empty_key, TypeValue{}}) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t capacity() const { return capacity_; }
+
+  /**
+   * @return Number of bytes allocated for storing entries.
+   */
+  size_t memory_usage() const { return slots_.capacity() * sizeof(value_type); }
+
+  iterator begin() { return {this, next_(0)}; }
+  iterator end() { return {this, end_pos_()}; }
+  const_iterator begin() const { return {this, next_(0)}; }
+  const_iterator end() const { return {this, end_pos_()}; }
+
+  iterator find(const TypeKey key) { return {this, find_(key)}; }
+  const_iterator find(const TypeKey key) const { return {this, find_(key)}; }
+  size_t count(const TypeKey key) const { return find_(key) != end_pos_(); }
+
+  TypeValue& at(const TypeKey key) {
+    const size_t pos{find_(key)};
+    if (pos == end_pos_()) {
+      throw std::out_of_range("KeyIndexMap::at");
+    }
+    return slots_[pos].second;
+  }
+  const TypeValue& at(const TypeKey key) const {
+    return const_cast<KeyIndexMap*>(this)->at(key);
+  }
+
+  /**
+   * Ensure that \p n entries can be stored without rehashing.
+   */
+  void reserve(const size_t n) {
+    if (n > max_load_(capacity_)) {
+      size_t new_capacity{std::max(capacity_, min_capacity)};
+      while (n > max_load_(new_capacity)) {
+        new_capacity *= 2;
+      }
+      rehash_(new_capacity);
+    }
+  }
+
+  /**
+   * Remove all entries, but keep the allocated memory.
+   */
+  void clear() {
+    for (size_t i{0}; i < capacity_; i++) {
+      slots_[i].first = empty_key;
+    }
+    has_empty_key_ = false;
+    size_ = 0;
+  }
+
+  std::pair<iterator, bool> emplace(const TypeKey key, const TypeValue& value) {
+    if (key == empty_key) {
+      const bool inserted{!has_empty_key_};
+      if (inserted) {
+        slots_[capacity_].second = value;
+        has_empty_key_ = true;
+        size_++;
+      }
+      return {{this, capacity_}, inserted};
+    }
+
+    reserve(size_ + 1);
+    size_t pos{home_(key)};
+    while (true) {
+      value_type& slot{slots_[pos]};
+      if (slot.first == empty_key) {
+        slot.first = key;
+        slot.second = value;
+        size_++;
+        return {{this, pos}, true};
+      }
+      if (slot.first == key) {
+        return {{this, pos}, false};
+      }
+      pos = (pos + 1) & mask_;
+    }
+  }
+
+  std::pair<iterator, bool> insert(const value_type& pair) {
+    return emplace(pair.first, pair.second);
+  }
+
+  template <typename InputIt>
+  void insert(InputIt first, const InputIt last) {
+    for (; first != last; ++first) {
+      emplace(first->first, first->second);
+    }
+  }
+
+  /**
+   * Insert \p n key/value pairs using multiple threads. Slots are claimed with an atomic
+   * compare-and-swap on the key. The result is the same as inserting the pairs one by one in input
+   * order: keys that are already present keep their current value, and if \p keys contains
+   * duplicates, the value of the first occurrence is retained.
+   *
+   * @param n Number of \p keys and \p values .
+   * @param keys Keys to insert.
+   * @param values Values corresponding to \p keys .
+   * @param num_threads Number of OpenMP threads (0 = use OpenMP default).
+   * @return Number of keys that were actually inserted.
+   */
+  size_t bulk_insert(const size_t n, const TypeKey* const keys, const TypeValue* const values,
+                     const size_t num_threads = 0) {
+    reserve(size_ + n);
+
+    size_t num_inserted{0};
+    const size_t min_chunk_size{64 * 1024};
+    const size_t max_threads{num_threads ? num_threads
+                                         : static_cast<size_t>(omp_get_max_threads())};
+    const int thread_num{
+        static_cast<int>(std::max<size_t>(std::min(max_threads, n / min_chunk_size), 1))};
+
+    // Which thread claims a slot depends on timing. Hence, we remember the pairs that claimed a
+    // slot, and the pairs whose key was found already present, to fix up duplicates afterwards.
+    std::vector<char> claimed(n, 0);
+    std::vector<std::vector<std::pair<TypeKey, size_t>>> found(thread_num);
+    const bool had_empty_key{has_empty_key_};
+    size_t empty_key_index{n};
+
+#pragma omp parallel for num_threads(thread_num) reduction(+ : num_inserted)
+    for (size_t i = 0; i < n; i++) {
+      const TypeKey key{keys[i]};
+      if (key == empty_key) {
+#pragma omp critical
+        {
+          if (!had_empty_key && i < empty_key_index) {
+            slots_[capacity_].second = values[i];
+            num_inserted += !has_empty_key_;
+            has_empty_key_ = true;
+            empty_key_index = i;
+          }
+        }
+        continue;
+      }
+
+      size_t pos{home_(key)};
+      while (true) {
+        TypeKey* const slot_key{&slots_[pos].first};
+        TypeKey expected{__atomic_load_n(slot_key, __ATOMIC_ACQUIRE)};
+        if (expected == empty_key) {
+          if (__atomic_compare_exchange_n(slot_key, &expected, key, false, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE)) {
+            slots_[pos].second = values[i];
+            claimed[i] = 1;
+            num_inserted++;
+            break;
+          }
+          // Lost the race. Fall through and check what the other thread inserted.
+        }
+        if (expected == key) {
+          found[omp_get_thread_num()].emplace_back(key, i);
+          break;
+        }
+        pos = (pos + 1) & mask_;
+      }
+    }
+    size_ += num_inserted;
+
+    // First occurrence of each found key. If it precedes the pair that claimed the slot, its value
+    // wins. Keys that were present before this call have no claiming pair and remain untouched.
+    KeyIndexMap<TypeKey, size_t> first;
+    for (const auto& thread_found : found) {
+      for (const auto& pair : thread_found) {
+        const auto result{first.emplace(pair.first, pair.second)};
+        if (!result.second && pair.second < result.first->second) {
+          result.first->second = pair.second;
+        }
+      }
+    }
+    if (!first.empty()) {
+#pragma omp parallel for num_threads(thread_num)
+      for (size_t i = 0; i < n; i++) {
+        if (claimed[i]) {
+          const auto it{first.find(keys[i])};
+          if (it != first.end() && it->second < i) {
+            slots_[find_(keys[i])].second = values[it->second];
+          }
+        }
+      }
+    }
+
+    return num_inserted;
+  }
+
+ private:
+  static constexpr size_t min_capacity{16};
+
+  // Entries [0, capacity_) form the hash table. Entry capacity_ holds the value of empty_key.
+  std::vector<value_type> slots_;
+  size_t capacity_{0};
+  size_t mask_{0};
+  size_t size_{0};
+  bool has_empty_key_{false};
+
+  // Maximum load factor of 3/4 keeps linear probing sequences short.
+  static size_t max_load_(const size_t capacity) { return capacity - capacity / 4; }
+
+  size_t home_(const TypeKey key) const {
+    // Murmur3 finalizer. Keys in embedding tables are often dense ranges.
+    uint64_t h{static_cast<uint64_t>(key)};
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return static_cast<size_t>(h) & mask_;
+  }
+
+  size_t end_pos_() const { return capacity_ + 1; }
+
+  bool is_valid_(const size_t pos) const {
+    return pos < capacity_ ? slots_[pos].first != empty_key : has_empty_key_;
+  }
+
+  size_t next_(size_t pos) const {
+    while (pos < end_pos_() && !is_valid_(pos)) {
+      pos++;
+    }
+    return pos;
+  }
+
+  size_t find_(const TypeKey key) const {
+    if (key == empty_key) {
+      return has_empty_key_ ? capacity_ : end_pos_();
+    }
+    if (!capacity_) {
+      return end_pos_();
+    }
+    for (size_t pos{home_(key)};; pos = (pos + 1) & mask_) {
+      const TypeKey slot_key{slots_[pos].first};
+      if (slot_key == key) {
+        return pos;
+      }
+      if (slot_key == empty_key) {
+        return end_pos_();
+      }
+    }
+  }
+
+  void rehash_(const size_t new_capacity) {
+    std::vector<value_type> old_slots(new_capacity + 1, value_type{empty_key, TypeValue{}});
+    std::swap(slots_, old_slots);
+    const size_t old_capacity{capacity_};
+    capacity_ = new_capacity;
+    mask_ = new_capacity - 1;
+
+    for (size_t i{0}; i < old_capacity; i++) {
+      const value_type& old_slot{old_slots[i]};
+      if (old_slot.first == empty_key) {
+        continue;
+      }
+      size_t pos{home_(old_slot.first)};
+      while (slots_[pos].first != empty_key) {
+        pos = (pos + 1) & mask_;
+      }
+      slots_[pos] = old_slot;
+    }
+    slots_[capacity_].second = old_slots[old_capacity].second;
+  }
+};
+
+}  // namespace HugeCTR
@@ -16,21 +16,57 @@
 
 #pragma once
 
+#include <future>
+#include <limits>
+#include <thread_pool.hpp>
+
 #include "embedding.hpp"
 #include "embedding_training_cache/hmem_cache/hmem_cache.hpp"
+#include "embedding_training_cache/key_index_map.hpp"
 #include "embedding_training_cache/sparse_model_entity.hpp"
 
 namespace HugeCTR {
 
 template <typename TypeKey>
 class ParameterServer {
+  /**
+   * Host memory copy of the keys, slot_ids, embedding vectors and optimizer states of one pass.
+   * data[0] holds the embedding vectors, data[1~data.size()-1] the optimizer states.
+   */
+  struct HostBuffer {
+    std::vector<TypeKey> keys;
+    std::vector<size_t> slot_ids;
+    std::vector<std::vector<float>> data;
+    size_t size{0};
+
+    void resize(size_t capacity, size_t emb_vec_size);
+    BufferBag as_buffer_bag(size_t emb_vec_size);
+  };
+
   TrainPSType_t ps_type_;
   bool use_slot_id_;
+  size_t emb_vec_size_;
+  size_t num_data_per_key_;
   std::unique_ptr<HMemCache<TypeKey>> hmem_cache_;
   std::unique_ptr<SparseModelEntity<TypeKey>> sparse_model_entity_;
 
   std::vector<TypeKey> keyset_;
 
+  // Loading of the next pass, and write-back of the previous pass are done in the background.
+  std::string prefetch_keyset_file_;
+  bool use_prefetched_{false};
+  HostBuffer prefetch_buf_;
+  // Row of each key of the prefetched keyset in prefetch_buf_, or missing_row if not (yet) loaded.
+  static constexpr size_t missing_row{std::numeric_limits<size_t>::max()};
+  KeyIndexMap<TypeKey, size_t> prefetch_key_idx_map_;
+  std::future<void> prefetch_task_;
+  HostBuffer write_back_buf_;
+  std::future<void> write_back_task_;
+  ThreadPool background_worker_{"etc ps", 1};
+
+  void pull_(std::vector<TypeKey> &keys, BufferBag &buf_bag, size_t &hit_size);
+  void push_(BufferBag &buf_bag, size_t dump_size);
+
  public:
   /**
    * @brief Constructs of ParameterServer. Using the sparse_model_file to
@@ -49,14 +85,30 @@ class ParameterServer {
   ParameterServer(const ParameterServer &) = delete;
   ParameterServer &operator=(const ParameterServer &) = delete;
 
-  ~ParameterServer() = default;
+  ~ParameterServer();
 
   /**
    * @brief Load the user-provided keyset from SSD, will be stored in keyset_.
+   *        If keyset_file was prefetched, the prefetched embeddings will be used
+   *        by the next call to pull().
    * @param keyset_file The file storing keyset to be loaded.
    */
   void load_keyset_from_file(std::string keyset_file);
 
+  /**
+   * @brief Load the keyset stored in keyset_file and the corresponding embedding
+   *        vectors (and optimizer states) into a staging buffer in the background.
+   *        Vectors that are pushed before the keyset is loaded will be patched
+   *        into the staging buffer, so that the prefetched data stays consistent.
+   * @param keyset_file The file storing the keyset of the next pass.
+   */
+  void prefetch(const std::string &keyset_file);
+
+  /**
+   * @brief Block until all background prefetches and write-backs have completed.
+   */
+  void sync();
+
   /**
    * @brief Pull embedding vectors from the sparse embedding model according to
    *        keyset_. It only loads embedding vectors that their corresponding
@@ -71,7 +123,7 @@ class ParameterServer {
 
   /**
    * @brief Push the embedding table downloaded from devices to the trained
-   *        sparse model.
+   *        sparse model. The data is copied, and written back in the background.
    * @param buf_bag The buffer bag for keys, slot_id, and hash_table_val.
    * @param dump_size The num of keys (features) in buffer bag to be dumped.
    */
@@ -23,9 +23,15 @@ namespace HugeCTR {
 
 template <typename TypeKey>
 class SparseModelEntity {
-  using HashTableType = std::unordered_map<TypeKey, std::pair<size_t, size_t>>;
+  using HashTableType = typename SparseModelFile<TypeKey>::HashTableType;
+
+  // Rows of host_emb_tabel_ are tracked in groups of rows_per_dirty_group. A group is marked
+  // dirty once any of its rows has been dumped, and flush_emb_tbl_to_ssd only writes back the
+  // existing embedding vectors in dirty groups.
+  static constexpr size_t rows_per_dirty_group{64};
 
   std::vector<float> host_emb_tabel_;
+  std::vector<uint8_t> dirty_groups_;
   HashTableType exist_key_idx_mapping_;
   HashTableType new_key_idx_mapping_;
   bool is_distributed_;
@@ -66,8 +72,8 @@ class SparseModelEntity {
   void dump_vec_by_key(BufferBag &buf_bag, const size_t dump_size);
 
   /**
-   * @brief Write the sparse model stored in the host memory to the disk. This
-   *        function will do nothing when the SSD-based PS is used.
+   * @brief Write the sparse model stored in the host memory to the disk. Only
+   *        embedding vectors that were dumped since the last flush are written.
    */
   void flush_emb_tbl_to_ssd();
 };
@@ -16,15 +16,35 @@
 
 #pragma once
 
+#include <embedding_training_cache/key_index_map.hpp>
 #include <memory>
 #include <resource_manager.hpp>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace HugeCTR {
 
+/**
+ * Location of an embedding vector: slot_id (\p first ) and row index (\p second ), packed into
+ * 8 bytes. Member names follow std::pair so that call sites read the same.
+ */
+struct SlotIndex {
+  static constexpr size_t slot_bits{20};
+  static constexpr size_t index_bits{64 - slot_bits};
+  static constexpr size_t max_slot{(size_t{1} << slot_bits) - 1};
+  static constexpr size_t max_index{(size_t{1} << index_bits) - 1};
+
+  size_t first : slot_bits;
+  size_t second : index_bits;
+};
+static_assert(sizeof(SlotIndex) == sizeof(size_t));
+
 template <typename TypeKey>
 class SparseModelFile {
+ public:
+  using HashTableType = KeyIndexMap<TypeKey, SlotIndex>;
+
+ private:
   struct EmbeddingTableFile;
   struct MmapHandler {
     std::shared_ptr<EmbeddingTableFile> emb_tbl_;
@@ -34,23 +54,43 @@ class SparseModelFile {
     const char* get_key_file() { return emb_tbl_->key_file.c_str(); }
     const char* get_vec_file() { return emb_tbl_->vec_file.c_str(); }
     const char* get_slot_file() { return emb_tbl_->slot_file.c_str(); }
+    const char* get_delta_file() { return emb_tbl_->delta_file.c_str(); }
   };
 
-  using HashTableType = std::unordered_map<TypeKey, std::pair<size_t, size_t>>;
-
   MmapHandler mmap_handler_;
   HashTableType key_idx_map_;
   bool is_distributed_;
   size_t emb_vec_size_;
+  double max_delta_ratio_;
   std::shared_ptr<ResourceManager> resource_manager_;
 
   void map_embedding_to_memory_();
-  void sync_mmaped_embedding_with_disk_();
   void unmap_embedding_from_memory_();
 
+  size_t delta_record_size_() const;
+  /**
+   * Returns the number of rows in the key, slot_id and emb_vector files (\p first ) and in the
+   * delta log (\p second ). Row indices in key_idx_map_ enumerate the base files first, followed
+   * by the delta log, so that they remain valid when the log is compacted.
+   */
+  std::pair<size_t, size_t> get_num_rows_();
+  /**
+   * Writes vecs[vec_indices[i]] to row dst_rows[i]. Rows are sorted and coalesced into pwritev
+   * calls. Each thread kicks off the writeback of its range right away; fdatasync is only
+   * issued once at the end.
+   */
+  void write_rows_(const std::vector<size_t>& dst_rows, const std::vector<size_t>& vec_indices,
+                   const float* vecs);
+
  public:
+  /**
+   * @param max_delta_ratio Appended embedding vectors are written to a delta log first. The log
+   *                        is folded into the base files (see compact) once it holds more than
+   *                        max_delta_ratio times the number of rows in the base files.
+   */
   SparseModelFile(const std::string& sparse_model_file, Embedding_t embedding_type,
-                  size_t emb_vec_size, std::shared_ptr<ResourceManager> resource_manager);
+                  size_t emb_vec_size, std::shared_ptr<ResourceManager> resource_manager,
+                  double max_delta_ratio = 0.125);
 
   HashTableType& get_key_index_map() { return key_idx_map_; }
 
@@ -73,8 +113,9 @@ class SparseModelFile {
    * @brief Dump embedding features (embedding vectors) through provided keys to disk.
    *        The keyset stored in keys (and corresponding embedding vectors) must exist in
    *        the embedding file stored in disk. Or, a run-time error will be thrown out.
+   *        Only the rows of the provided keys are written, and only they are synced to disk.
    *        This API can only be called by a single processor each time because updating
-   *        a file by multiple processors through mmap simultaneous will cause unexpected results.
+   *        a file by multiple processors simultaneous will cause unexpected results.
    *
    * @param keys Vector storing the keyset, their corresponding embedding vectors will be dumped.
    * @param vec_indices The memory indices of vectors in vecs. These indices are corresponding to
@@ -90,8 +131,10 @@ class SparseModelFile {
    *        The keyset stored in keys (and corresponding slot_ids and embedding vectors) must
    *        don't exist in the embedding file stored in disk. It's user's responsibility to
    *        ensure this assumption.
-   *        This API can only be called by a single processor each time because
-   *        dump_exist_vec_by_key is called in this API.
+   *        The records are appended to the delta log and synced to disk before this API returns,
+   *        while the base files are only updated when the log is compacted.
+   *        This API can only be called by a single processor each time because the delta log
+   *        may be compacted in this API.
    *
    * @param keys Vector storing the keyset, their corresponding embedding vectors (and slot_ids
    *             if localized embedding is used) will be dumped.
@@ -116,6 +159,19 @@ class SparseModelFile {
    * @param vecs Vector to store the loaded embedding vectors corresponding to mem_key_index_map.
    */
   void load_emb_tbl_to_mem(HashTableType& mem_key_index_map, std::vector<float>& vecs);
+
+  /**
+   * @brief Fold the delta log into the key, slot_id and emb_vector files, so that they hold
+   *        the complete embedding table. If the process is terminated while compacting, the
+   *        delta log is still intact and will be replayed when the sparse model is opened.
+   *        This API can only be called by a single processor each time.
+   */
+  void compact();
+
+  /**
+   * @brief Number of embedding vectors that are only stored in the delta log.
+   */
+  size_t get_num_delta_rows() { return get_num_rows_().second; }
 };
 
 }  // namespace HugeCTR
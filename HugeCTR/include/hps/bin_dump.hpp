@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <common.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Layout of raw (*.bin) database table dumps, version 2:
+ *
+ *   [header][partition index][keys section][values section]
+ *
+ * Keys and values are stored in separate contiguous arrays, each starting at a page boundary. The
+ * order of the sections may vary, the header contains their offsets. The pairs of each partition
+ * are consecutive in both arrays. Hence, a dump can be memory-mapped and
+ * inserted without copying or parsing, and partitions can be processed in parallel. Version 1
+ * dumps (header followed by interleaved key/value pairs) can still be loaded.
+ */
+struct BinDumpHeader final {
+  char magic[4];            // "bin\0"
+  uint32_t version;         // Must be bin_dump_version.
+  uint32_t key_size;        // Size of each key in bytes.
+  uint32_t value_size;      // Size of each value in bytes.
+  uint64_t num_pairs;       // Total number of key/value pairs.
+  uint32_t num_partitions;  // Number of entries in the partition index.
+  uint32_t partitioner;     // How keys were assigned to partitions (see BinDumpPartitioner_t).
+  uint64_t index_offset;    // File offset of the partition index.
+  uint64_t keys_offset;     // File offset of the keys section.
+  uint64_t values_offset;   // File offset of the values section.
+  uint8_t reserved[8];
+};
+static_assert(sizeof(BinDumpHeader) == 64);
+
+struct BinDumpPartition final {
+  uint64_t first_pair;  // Index of the first pair that belongs to this partition.
+  uint64_t num_pairs;   // Number of pairs in this partition.
+};
+
+enum class BinDumpPartitioner_t : uint32_t {
+  None = 0,  // Partitions are arbitrary chunks of the table.
+  Hash = 1   // Partition = HCTR_KEY_TO_DB_PART_INDEX(key) for num_partitions.
+};
+
+constexpr uint32_t bin_dump_version = 2;
+constexpr size_t bin_dump_alignment = 4096;
+
+/**
+ * Writes a raw table dump. If the size of all partitions is known in advance, the layout is fixed
+ * upon construction, and partitions can be written concurrently by different threads. Otherwise,
+ * pairs can be appended sequentially to a single partition.
+ */
+class BinDumpWriter final {
+ public:
+  DISALLOW_COPY_AND_MOVE(BinDumpWriter);
+
+  /**
+   * Create a dump with a fixed layout.
+   *
+   * @param path File system path of the dump.
+   * @param key_size Size of each key in bytes.
+   * @param value_size Size of each value in bytes.
+   * @param partition_sizes Number of pairs in each partition.
+   * @param partitioner How keys were assigned to the partitions.
+   */
+  BinDumpWriter(const std::string& path, uint32_t key_size, uint32_t value_size,
+                const std::vector<size_t>& partition_sizes, BinDumpPartitioner_t partitioner);
+
+  /**
+   * Create a dump of unknown size that is filled using \p append .
+   *
+   * @param path File system path of the dump.
+   * @param key_size Size of each key in bytes.
+   */
+  BinDumpWriter(const std::string& path, uint32_t key_size);
+
+  ~BinDumpWriter();
+
+  /**
+   * Write pairs to a partition of a dump with fixed layout. Thread-safe, as long as concurrent
+   * calls refer to disjoint ranges.
+   *
+   * @param partition Index of the partition.
+   * @param first_pair Position of the first pair within the partition.
+   * @param num_pairs Number of \p keys and \p values .
+   * @param keys Pointer to the keys.
+   * @param values Pointer to the values.
+   */
+  void write(size_t partition, size_t first_pair, size_t num_pairs, const void* keys,
+             const char* values);
+
+  /**
+   * Append pairs to a dump of unknown size. Not thread-safe.
+   *
+   * @param num_pairs Number of \p keys and \p values .
+   * @param keys Pointer to the keys.
+   * @param values Pointer to the values.
+   * @param value_size The size of each value in bytes. Must be the same for all calls.
+   */
+  void append(size_t num_pairs, const void* keys, const char* values, uint32_t value_size);
+
+  /**
+   * Completes the dump. The header is written last. Hence, incomplete dumps cannot be loaded.
+   */
+  void finish();
+
+ private:
+  const std::string path_;
+  int fd_{-1};
+  int keys_fd_{-1};  // Spill file for keys, if the size is unknown.
+  BinDumpHeader header_;
+  std::vector<BinDumpPartition> index_;
+};
+
+/**
+ * Read-only, memory-mapped view of a raw table dump.
+ */
+class BinDumpReader final {
+ public:
+  DISALLOW_COPY_AND_MOVE(BinDumpReader);
+
+  /**
+   * @param path File system path of the dump. Must be a version 2 dump.
+   */
+  explicit BinDumpReader(const std::string& path);
+
+  ~BinDumpReader();
+
+  /**
+   * @return Format version of the dump at \p path , or 0 if it is not a raw table dump.
+   */
+  static uint32_t peek_version(const std::string& path);
+
+  const BinDumpHeader& header() const { return *header_; }
+  size_t num_partitions() const { return header_->num_partitions; }
+  const BinDumpPartition& partition(const size_t index) const { return index_[index]; }
+
+  /**
+   * @return Pointer to the keys/values of the pair at position \p pair of the file.
+   */
+  const char* keys(const size_t pair) const {
+    return &data_[header_->keys_offset + pair * header_->key_size];
+  }
+  const char* values(const size_t pair) const {
+    return &data_[header_->values_offset + pair * header_->value_size];
+  }
+
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+  const BinDumpHeader* header_{nullptr};
+  const BinDumpPartition* index_{nullptr};
+};
+
+}  // namespace HugeCTR
@@ -24,6 +24,7 @@
 #include <hps/inference_utils.hpp>
 #include <string>
 #include <thread_pool.hpp>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -165,6 +166,58 @@ class DatabaseBackend {
                        const DatabaseMissCallback& on_miss,
                        const std::chrono::nanoseconds& time_budget);
 
+  /**
+   * Attempt to retrieve the stored value for a set of keys in the backing database (direct
+   * indexing). Unlike the callback-based variant, values are copied directly into an output
+   * buffer, which allows implementations to avoid type-erased calls per key.
+   *
+   * @param table_name The name of the table to be queried (see also
+   * paramter_server_base::make_tag_name).
+   * @param num_keys Number of \p keys .
+   * @param keys Pointer to the keys.
+   * @param values Pointer to a preallocated memory area where the values will be stored. The value
+   * of \p keys[i] is written to \p values + i * \p value_stride .
+   * @param value_size The expected size of each value in bytes.
+   * @param value_stride Distance between two consecutive values in \p values in bytes.
+   * @param missing Will be overwritten with the indices of all keys that were not present in this
+   * database (in ascending order).
+   * @param time_budget A budget given to the function to do its work. This is a soft-limit. The
+   * function will try to complete in time.
+   *
+   * @return The number of keys that were successfully retrieved from this database. Will throw if
+   * an recoverable error is encountered.
+   */
+  virtual size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys,
+                       char* values, size_t value_size, size_t value_stride,
+                       std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget);
+
+  /**
+   * Attempt to retrieve the stored value for a set of keys in the backing database. This variant
+   * supports indirect indexing, to allow sparse lookup, and copies values directly into an output
+   * buffer.
+   *
+   * @param table_name The name of the table to be queried (see also
+   * paramter_server_base::make_tag_name).
+   * @param num_indices Number of \p indices .
+   * @param indices Pointer of indices in \p keys that need to be fetched.
+   * @param keys Pointer to the key.
+   * @param values Pointer to a preallocated memory area where the values will be stored. This
+   * function operates sparse and will only update values that correspond to \p keys referenced by
+   * \p indices . The value of \p keys[i] is written to \p values + i * \p value_stride .
+   * @param value_size The expected size of each value in bytes.
+   * @param value_stride Distance between two consecutive values in \p values in bytes.
+   * @param missing Will be overwritten with the indices (in \p keys ) of all keys that were not
+   * present in this database (in ascending order).
+   * @param time_budget A budget given to the function to do its work. This is a soft-limit. The
+   * function will try to complete in time.
+   *
+   * @return The number of keys that were successfully retrieved from this database. Will throw if
+   * an recoverable error is encountered.
+   */
+  virtual size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+                       const Key* keys, char* values, size_t value_size, size_t value_stride,
+                       std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget);
+
   /**
    * Attempt to remove a table and all associated values from the underlying database.
    *
@@ -215,7 +268,14 @@ class DatabaseBackend {
   virtual void dump(const std::string& table_name, const std::string& path,
                     DBTableDumpFormat_t format = DBTableDumpFormat_t::Automatic);
 
-  virtual void dump_bin(const std::string& table_name, std::ofstream& file) = 0;
+  /**
+   * Dumps the contents of an entire table to a raw (*.bin) file. See \p BinDumpHeader for the
+   * file format.
+   *
+   * @param table_name The name of the table to be dumped.
+   * @param path File system path under which the dumped data should be stored.
+   */
+  virtual void dump_bin(const std::string& table_name, const std::string& path) = 0;
 
   virtual void dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) = 0;
 
@@ -227,6 +287,12 @@ class DatabaseBackend {
    */
   virtual void load_dump(const std::string& table_name, const std::string& path);
 
+  /**
+   * Loads a raw (*.bin) dump. Version 2 dumps are memory-mapped and inserted without copying.
+   *
+   * @param table_name The destination table into which to insert the data.
+   * @param path File system path of the dump.
+   */
   virtual void load_dump_bin(const std::string& table_name, const std::string& path);
 
   virtual void load_dump_sst(const std::string& table_name, const std::string& path);
@@ -280,11 +346,14 @@ class VolatileBackend : public DatabaseBackend<Key> {
    * @param keys
    * @param values
    * @param value_size
+   * @param on_complete Called by the background worker with the result of the insertion
+   * (optional).
    */
   std::future<void> insert_async(const std::string& table_name,
                                  const std::shared_ptr<std::vector<Key>>& keys,
                                  const std::shared_ptr<std::vector<char>>& values,
-                                 size_t value_size);
+                                 size_t value_size,
+                                 const std::function<void(bool)>& on_complete = nullptr);
 
   /**
    * Synchronize with the database (await background tasks)!
@@ -316,6 +385,13 @@ class PersistentBackend : public DatabaseBackend<Key> {
   size_t capacity(const std::string& table_name) const override final {
     return std::numeric_limits<size_t>::max();
   }
+
+  /**
+   * Unlike `size`, this is never an approximation.
+   *
+   * @return Whether the table holds no entries (or does not exist).
+   */
+  virtual bool empty(const std::string& table_name) { return this->size(table_name) == 0; }
 };
 
 #define HCTR_ROCKSDB_CHECK(EXPR)                                                  \
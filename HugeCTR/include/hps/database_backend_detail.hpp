@@ -15,7 +15,11 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <base/debug/logger.hpp>
 #include <cstdint>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -39,6 +43,45 @@ inline uint64_t rrxmrrxmsx_0(uint64_t x) {
   return x ^ x >> 28;
 }
 
+/**
+ * Hit and miss handlers for the bulk \p fetch variants of \p DatabaseBackend . Values are copied
+ * straight to their position in the output buffer. Missing indices are collected without locks, so
+ * that the handlers can be invoked concurrently for different indices.
+ */
+class BulkFetchTarget final {
+ public:
+  BulkFetchTarget(char* const values, const size_t value_size, const size_t value_stride,
+                  const size_t max_num_missing, std::vector<size_t>& missing)
+      : values_{values}, value_size_{value_size}, value_stride_{value_stride}, missing_{missing} {
+    missing_.resize(max_num_missing);
+  }
+
+  inline void on_hit(const size_t index, const char* const value, const uint32_t value_size) {
+    HCTR_CHECK_HINT(value_size == value_size_, "Batch[%zu]: Value size mismatch! (%u <> %zu)!",
+                    index, value_size, value_size_);
+    std::copy_n(value, value_size_, &values_[index * value_stride_]);
+  }
+
+  inline void on_miss(const size_t index) {
+    missing_[num_missing_.fetch_add(1, std::memory_order_relaxed)] = index;
+  }
+
+  /**
+   * Must be called once all handlers returned. Trims and sorts the list of missing indices.
+   */
+  void finalize() {
+    missing_.resize(num_missing_);
+    std::sort(missing_.begin(), missing_.end());
+  }
+
+ private:
+  char* const values_;
+  const size_t value_size_;
+  const size_t value_stride_;
+  std::vector<size_t>& missing_;
+  std::atomic<size_t> num_missing_{0};
+};
+
 #ifdef HCTR_KEY_TO_DB_PART_INDEX
 #error "HCTR_KEY_TO_DB_PART_INDEX is already defined. This could lead to unpredictable behavior!"
 #else
@@ -20,6 +20,7 @@
 #include <hps/embedding_cache_base.hpp>
 #include <hps/inference_utils.hpp>
 #include <hps/memory_pool.hpp>
+#include <hps/metrics_registry.hpp>
 #include <hps/unique_op/unique_op.hpp>
 #include <memory>
 #include <nv_gpu_cache.hpp>
@@ -84,6 +85,14 @@ class EmbeddingCache : public EmbeddingCacheBase,
   // The shared thread-safe embedding cache
   std::vector<std::unique_ptr<Cache>> gpu_emb_caches_;
 
+  // Per-table cache metrics
+  struct TableMetrics {
+    MetricCounter& queries;
+    MetricCounter& hits;
+    MetricGauge& hit_rate;
+  };
+  std::vector<TableMetrics> table_metrics_;
+
   // streams for asynchronous parameter server insert threads
   std::vector<cudaStream_t> insert_streams_;
 
@@ -29,6 +29,8 @@
 
 namespace HugeCTR {
 
+struct DatabaseBackendMetrics;
+
 // TODO: Remove me!
 #pragma GCC diagnostic push
 #pragma GCC diagnostic error "-Wconversion"
@@ -88,16 +90,31 @@ class HashMapBackend final : public VolatileBackend<Key> {
                const DatabaseMissCallback& on_miss,
                const std::chrono::nanoseconds& time_budget) override;
 
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_size, size_t value_stride, std::vector<size_t>& missing,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_size, size_t value_stride,
+               std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget) override;
+
   size_t evict(const std::string& table_name) override;
 
   size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
 
   std::vector<std::string> find_tables(const std::string& model_name) override;
 
-  void dump_bin(const std::string& table_name, std::ofstream& file) override;
+  /**
+   * @return All keys that are currently stored in the table.
+   */
+  std::vector<Key> keys(const std::string& table_name) const;
+
+  void dump_bin(const std::string& table_name, const std::string& path) override;
 
   void dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 
+  void load_dump_bin(const std::string& table_name, const std::string& path) override;
+
  protected:
   // Key metrics.
   static constexpr size_t key_size = sizeof(Key);
@@ -132,6 +149,7 @@ class HashMapBackend final : public VolatileBackend<Key> {
 
   const size_t num_partitions_;
   const size_t allocation_rate_;
+  DatabaseBackendMetrics& metrics_;
 
   // Actual data.
   std::unordered_map<std::string, std::vector<Partition>> tables_;
@@ -139,6 +157,15 @@ class HashMapBackend final : public VolatileBackend<Key> {
   // Access control.
   mutable std::shared_mutex read_write_guard_;
 
+  // Lookup implementations, shared by the callback and bulk variants of fetch.
+  template <typename HitFn, typename MissFn>
+  size_t fetch_(const std::string& table_name, size_t num_keys, const Key* keys, HitFn&& on_hit,
+                MissFn&& on_miss, const std::chrono::nanoseconds& time_budget);
+  template <typename HitFn, typename MissFn>
+  size_t fetch_(const std::string& table_name, size_t num_indices, const size_t* indices,
+                const Key* keys, HitFn&& on_hit, MissFn&& on_miss,
+                const std::chrono::nanoseconds& time_budget);
+
   // Overflow resolution.
   size_t resolve_overflow_(const std::string& table_name, Partition& part);
 };
@@ -20,10 +20,15 @@
 #include <hps/embedding_cache_base.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/inference_utils.hpp>
+#include <hps/key_filter.hpp>
 #include <hps/memory_pool.hpp>
 #include <hps/message.hpp>
+#include <hps/metrics_registry.hpp>
+#include <hps/update_applier.hpp>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -74,7 +79,10 @@ class HierParameterServer : public HierParameterServerBase {
   bool volatile_db_cache_missed_embeddings_;
   std::unique_ptr<PersistentBackend<TypeHashKey>> persistent_db_;
   bool persistent_db_initialize_after_startup_;
+  double persistent_db_negative_cache_bits_;
   // Realtime data ingestion.
+  std::unique_ptr<UpdateApplier<TypeHashKey>> volatile_db_applier_;
+  std::unique_ptr<UpdateApplier<TypeHashKey>> persistent_db_applier_;
   std::unique_ptr<MessageSource<TypeHashKey>> volatile_db_source_;
   std::unique_ptr<MessageSource<TypeHashKey>> persistent_db_source_;
   // Buffer pool that manages workspace and refreshspace of embedding caches
@@ -86,6 +94,53 @@ class HierParameterServer : public HierParameterServerBase {
   std::map<std::string, std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>>> model_cache_map_;
   // model configuration of all models deployed on HPS, e.g., {"dcn": dcn_inferenceParamesStruct}
   std::map<std::string, InferenceParams> inference_params_map_;
+  // Storage encoding of the values of each table in the databases (absent = fp32).
+  std::unordered_map<std::string, DatabaseValueCodec_t> value_codecs_;
+  mutable std::shared_mutex value_codecs_guard_;
+  // Filters over the keys in the persistent database of each table (absent = no filter).
+  struct NegativeCache final {
+    KeyFilter filter;
+    std::atomic<size_t> num_queries{0};          // Keys that were checked.
+    std::atomic<size_t> num_skipped{0};          // Keys rejected by the filter (= saved fetches).
+    std::atomic<size_t> num_false_positives{0};  // Keys that passed, but were not found.
+
+    NegativeCache(size_t capacity, double bits_per_key) : filter(capacity, bits_per_key) {}
+  };
+  std::unordered_map<std::string, std::unique_ptr<NegativeCache>> negative_caches_;
+  mutable std::shared_mutex negative_caches_guard_;
+  // Metrics of the database backends, and optional endpoint to scrape them.
+  DatabaseBackendMetrics* volatile_db_metrics_{nullptr};
+  DatabaseBackendMetrics* persistent_db_metrics_{nullptr};
+  std::unique_ptr<MetricsHttpServer> metrics_server_;
+
+  DatabaseValueCodec_t get_value_codec_(const std::string& tag_name) const;
+  /**
+   * Encodes fp32 \p values for storage in the databases, if the table uses a codec.
+   *
+   * @return \p values , or a pointer into \p buffer . \p value_size is updated accordingly.
+   */
+  const char* encode_values_(const std::string& tag_name, size_t num_pairs, const char* values,
+                             size_t& value_size, std::vector<char>& buffer) const;
+
+  void insert_into_negative_cache_(const std::string& tag_name, size_t num_keys,
+                                   const TypeHashKey* keys);
+  /**
+   * Bulk fetch from the volatile database.
+   */
+  size_t fetch_from_volatile_db_(const std::string& tag_name, size_t num_keys,
+                                 const TypeHashKey* keys, char* values, size_t value_size,
+                                 std::vector<size_t>& missing,
+                                 const std::chrono::nanoseconds& time_budget);
+  /**
+   * Bulk fetch from the persistent database. Keys that are rejected by the negative cache of the
+   * table are not queried, but reported as \p missing right away.
+   *
+   * @param indices Indices of the \p keys to fetch (nullptr = all \p num_indices keys).
+   */
+  size_t fetch_from_persistent_db_(const std::string& tag_name, size_t num_indices,
+                                   const size_t* indices, const TypeHashKey* keys, char* values,
+                                   size_t value_size, std::vector<size_t>& missing,
+                                   const std::chrono::nanoseconds& time_budget);
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <hps/database_backend.hpp>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * Layout of an immutable store file (one per table):
+ *
+ *   [header][segments][sorted keys][values]
+ *
+ * The keys are sorted. A piecewise linear model (the segments) maps each key to its approximate
+ * position within the key array. The true position is at most \p max_error slots away from the
+ * prediction. Values are stored in the same order as the keys, with a fixed stride.
+ */
+struct ImmutableStoreHeader final {
+  char magic[4];          // "hims"
+  uint32_t version;       // Must be immutable_store_version.
+  uint32_t key_size;      // Size of each key in bytes.
+  uint32_t value_size;    // Size of each value in bytes (= stride of the values section).
+  uint64_t num_keys;      // Number of key/value pairs.
+  uint64_t num_segments;  // Number of segments of the key index.
+  uint64_t max_error;     // Maximum distance between the predicted and actual key position.
+  uint64_t segments_offset;
+  uint64_t keys_offset;
+  uint64_t values_offset;
+};
+static_assert(sizeof(ImmutableStoreHeader) == 64);
+
+struct ImmutableStoreSegment final {
+  uint64_t first_key;  // Bit pattern of the first key covered by this segment.
+  uint64_t first_pos;  // Position of that key.
+  double slope;        // Positions per unit key distance.
+};
+
+constexpr uint32_t immutable_store_version = 1;
+constexpr const char* immutable_store_extension = ".hims";
+
+/**
+ * \p DatabaseBackend implementation for frozen models. Each table is an immutable file that is
+ * memory-mapped upon construction. Lookups use a learned index over the sorted keys and copy
+ * values directly from the mapping. Unlike RocksDB there is no block cache, compaction or
+ * per-key allocation. Multiple processes can map the same files and share the page cache.
+ *
+ * Tables are normally built offline (see \p build and tools/immutable_store_builder). Inserting
+ * into a table that does not exist yet builds it from the provided pairs. Afterwards, the table
+ * cannot be modified. Further inserts and evictions are ignored.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class ImmutableStoreBackend final : public PersistentBackend<Key> {
+ public:
+  using Base = PersistentBackend<Key>;
+
+  ImmutableStoreBackend() = delete;
+  DISALLOW_COPY_AND_MOVE(ImmutableStoreBackend);
+
+  /**
+   * Construct a new ImmutableStoreBackend object.
+   *
+   * @param path Directory that contains the table files.
+   * @param read_only If \p true , tables cannot be built through \p insert .
+   * @param max_get_batch_size Number of keys that are looked up by a single thread.
+   * @param max_set_batch_size Unused. Kept for symmetry with other backends.
+   * @param max_error Error bound of the key index. Smaller values yield a faster final search,
+   * but a larger index.
+   */
+  ImmutableStoreBackend(const std::string& path, bool read_only = false,
+                        size_t max_get_batch_size = 64L * 1024L,
+                        size_t max_set_batch_size = 64L * 1024L, size_t max_error = 32);
+
+  virtual ~ImmutableStoreBackend();
+
+  const char* get_name() const override { return "ImmutableStore"; }
+
+  bool is_shared() const override { return false; }
+
+  size_t size(const std::string& table_name) const override;
+
+  size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
+                  const std::chrono::nanoseconds& time_budget) const override;
+
+  bool insert(const std::string& table_name, size_t num_pairs, const Key* keys, const char* values,
+              size_t value_size) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys,
+               const DatabaseHitCallback& on_hit, const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, const DatabaseHitCallback& on_hit,
+               const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_size, size_t value_stride, std::vector<size_t>& missing,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_size, size_t value_stride,
+               std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget) override;
+
+  size_t evict(const std::string& table_name) override;
+
+  size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
+
+  std::vector<std::string> find_tables(const std::string& model_name) override;
+
+  void dump_bin(const std::string& table_name, const std::string& path) override;
+
+  void dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
+
+  /**
+   * Build an immutable store file. If \p keys contains duplicates, the last occurrence wins.
+   *
+   * @param path File system path of the store file.
+   * @param num_pairs Number of \p keys and \p values .
+   * @param keys Pointer to the keys.
+   * @param values Pointer to the values.
+   * @param value_size The size of each value in bytes.
+   * @param max_error Error bound of the key index.
+   */
+  static void build(const std::string& path, size_t num_pairs, const Key* keys,
+                    const char* values, size_t value_size, size_t max_error = 32);
+
+ protected:
+  struct Table final {
+    char* data;
+    size_t size;
+    const ImmutableStoreHeader* header;
+    const ImmutableStoreSegment* segments;
+    const Key* keys;
+    const char* values;
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /**
+     * @return Position of \p key , or \p npos if it is not part of the table.
+     */
+    size_t find(Key key) const;
+  };
+
+  const std::string path_;
+  const bool read_only_;
+  const size_t max_error_;
+
+  std::unordered_map<std::string, Table> tables_;
+  mutable std::shared_mutex read_write_guard_;
+
+  void open_table_(const std::string& table_name, const std::string& path);
+
+  // Lookup implementations, shared by the callback and bulk variants of fetch.
+  template <typename HitFn, typename MissFn>
+  size_t fetch_(const std::string& table_name, size_t num_keys, const size_t* indices,
+                const Key* keys, HitFn&& on_hit, MissFn&& on_miss,
+                const std::chrono::nanoseconds& time_budget);
+};
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
@@ -37,13 +37,27 @@ enum class DatabaseType_t {
   HashMap,
   ParallelHashMap,
   MultiProcessHashMap,
+  ShardedHashMap,
   RedisCluster,
   RocksDB,
+  ImmutableStore,
 };
 enum class DatabaseOverflowPolicy_t {
   EvictOldest,
   EvictRandom,
 };
+enum class DatabaseCompression_t {
+  None,
+  Snappy,
+  LZ4,
+  ZSTD,
+};
+enum class DatabaseValueCodec_t {
+  Float32,
+  Float16,
+  BFloat16,
+  Int8,
+};
 enum class UpdateSourceType_t {
   Null,
   KafkaMessageQueue,
@@ -60,10 +74,14 @@ constexpr const char* hctr_enum_to_c_str(const DatabaseType_t value) {
       return "parallel_hash_map";
     case DatabaseType_t::MultiProcessHashMap:
       return "multi_process_hash_map";
+    case DatabaseType_t::ShardedHashMap:
+      return "sharded_hash_map";
     case DatabaseType_t::RedisCluster:
       return "redis_cluster";
     case DatabaseType_t::RocksDB:
       return "rocks_db";
+    case DatabaseType_t::ImmutableStore:
+      return "immutable_store";
     default:
       return "<unknown DatabaseType_t value>";
   }
@@ -79,6 +97,36 @@ constexpr const char* hctr_enum_to_c_str(const DatabaseOverflowPolicy_t value) {
       return "<unknown DatabaseOverflowPolicy_t value>";
   }
 }
+constexpr const char* hctr_enum_to_c_str(const DatabaseCompression_t value) {
+  // Remark: Dependent functions assume lower-case, and underscore separated.
+  switch (value) {
+    case DatabaseCompression_t::None:
+      return "none";
+    case DatabaseCompression_t::Snappy:
+      return "snappy";
+    case DatabaseCompression_t::LZ4:
+      return "lz4";
+    case DatabaseCompression_t::ZSTD:
+      return "zstd";
+    default:
+      return "<unknown DatabaseCompression_t value>";
+  }
+}
+constexpr const char* hctr_enum_to_c_str(const DatabaseValueCodec_t value) {
+  // Remark: Dependent functions assume lower-case, and underscore separated.
+  switch (value) {
+    case DatabaseValueCodec_t::Float32:
+      return "fp32";
+    case DatabaseValueCodec_t::Float16:
+      return "fp16";
+    case DatabaseValueCodec_t::BFloat16:
+      return "bf16";
+    case DatabaseValueCodec_t::Int8:
+      return "int8";
+    default:
+      return "<unknown DatabaseValueCodec_t value>";
+  }
+}
 constexpr const char* hctr_enum_to_c_str(const UpdateSourceType_t value) {
   // Remark: Dependent functions assume lower-case, and underscore separated.
   switch (value) {
@@ -97,6 +145,12 @@ inline std::ostream& operator<<(std::ostream& os, DatabaseType_t value) {
 inline std::ostream& operator<<(std::ostream& os, DatabaseOverflowPolicy_t value) {
   return os << hctr_enum_to_c_str(value);
 }
+inline std::ostream& operator<<(std::ostream& os, DatabaseCompression_t value) {
+  return os << hctr_enum_to_c_str(value);
+}
+inline std::ostream& operator<<(std::ostream& os, DatabaseValueCodec_t value) {
+  return os << hctr_enum_to_c_str(value);
+}
 inline std::ostream& operator<<(std::ostream& os, UpdateSourceType_t value) {
   return os << hctr_enum_to_c_str(value);
 }
@@ -104,6 +158,9 @@ inline std::ostream& operator<<(std::ostream& os, UpdateSourceType_t value) {
 DatabaseType_t get_hps_database_type(const nlohmann::json& json, const std::string key);
 UpdateSourceType_t get_hps_updatesource_type(const nlohmann::json& json, const std::string key);
 DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json, const std::string key);
+DatabaseCompression_t get_hps_database_compression(const nlohmann::json& json,
+                                                   const std::string key);
+DatabaseValueCodec_t get_hps_database_value_codec(const std::string& name);
 
 struct VolatileDatabaseParams {
   DatabaseType_t type;
@@ -119,6 +176,9 @@ struct VolatileDatabaseParams {
   size_t num_node_connections;     // Only used with Redis beckend.
   size_t max_get_batch_size;
   size_t max_set_batch_size;
+  bool async_fetch;           // Only used with Redis backend. Pipeline lookups per cluster node.
+  size_t max_pipeline_depth;  // Only used with Redis backend. HMGET batches in flight per node.
+  bool numa_aware;            // Only used with sharded HashMap backend. Pin shards to NUMA nodes.
 
   // Overflow handling related.
   bool refresh_time_after_fetch;
@@ -144,7 +204,8 @@ struct VolatileDatabaseParams {
       size_t shared_memory_size = 16L * 1024L * 1024L * 1024L,
       const std::string& shared_memory_name = "hctr_mp_hash_map_database",
       size_t num_node_connections = 5, size_t max_get_batch_size = 64L * 1024L,
-      size_t max_set_batch_size = 64L * 1024L,
+      size_t max_set_batch_size = 64L * 1024L, bool async_fetch = false,
+      size_t max_pipeline_depth = 16, bool numa_aware = true,
       // Overflow handling related.
       bool refresh_time_after_fetch = false,
       size_t overflow_margin = std::numeric_limits<size_t>::max(),
@@ -169,9 +230,14 @@ struct PersistentDatabaseParams {
   bool read_only = false;
   size_t max_get_batch_size;
   size_t max_set_batch_size;
+  size_t block_cache_size;            // RocksDB: Capacity of the block cache (bytes).
+  double bloom_filter_bits;           // RocksDB: Bloom filter bits per key (0 = no filter).
+  bool partitioned_index;             // RocksDB: Use two-level index and filter blocks.
+  DatabaseCompression_t compression;  // RocksDB: Compression of data blocks.
 
   // Caching behavior related.
   bool initialize_after_startup;
+  double negative_cache_bits;  // Bloom filter bits per key in front of lookups (0 = disabled).
 
   // Real-time update mechanism related.
   std::vector<std::string> update_filters;  // Should be a regex for Kafka.
@@ -183,8 +249,11 @@ struct PersistentDatabaseParams {
                            size_t num_threads = 16, bool read_only = false,
                            size_t max_get_batch_size = 64L * 1024L,
                            size_t max_set_batch_size = 64L * 1024L,
+                           size_t block_cache_size = 256L * 1024L * 1024L,
+                           double bloom_filter_bits = 10.0, bool partitioned_index = false,
+                           DatabaseCompression_t compression = DatabaseCompression_t::Snappy,
                            // Caching behavior related.
-                           bool initialize_after_startup = true,
+                           bool initialize_after_startup = true, double negative_cache_bits = 0,
                            // Real-time update mechanism related.
                            const std::vector<std::string>& update_filters = {"^hps_.+$"});
 
@@ -204,13 +273,19 @@ struct UpdateSourceParams {
   size_t failure_backoff_ms;
   size_t max_commit_interval;
 
+  // Update application related.
+  size_t apply_max_batch_size;  // 0 = Apply updates synchronously in the consumer thread.
+  size_t apply_max_delay_ms;
+
   UpdateSourceParams(UpdateSourceType_t type = UpdateSourceType_t::Null,
                      // Backend specific.
                      const std::string& brokers = "127.0.0.1:9092",
                      size_t metadata_refresh_interval_ms = 30'000,
                      size_t receive_buffer_size = 256 * 1024, size_t poll_timeout_ms = 500,
                      size_t max_batch_size = 8 * 1024, size_t failure_backoff_ms = 50,
-                     size_t max_commit_interval = 32);
+                     size_t max_commit_interval = 32,
+                     // Update application related.
+                     size_t apply_max_batch_size = 0, size_t apply_max_delay_ms = 100);
 
   bool operator==(const UpdateSourceParams& p) const;
   bool operator!=(const UpdateSourceParams& p) const;
@@ -254,6 +329,10 @@ struct InferenceParams {
   size_t slot_num;
   std::string non_trainable_params_file;
   bool use_static_table;
+  // Storage encoding of the values in the volatile and persistent database (default = fp32).
+  std::vector<DatabaseValueCodec_t> value_codec_per_table;
+  // Run dense layers in INT8 (CPU inference only).
+  bool use_int8_dense;
 
   InferenceParams(const std::string& model_name, size_t max_batchsize, float hit_rate_threshold,
                   const std::string& dense_model_file,
@@ -277,7 +356,9 @@ struct InferenceParams {
                   const std::vector<size_t>& embedding_vecsize_per_table = {128},
                   const std::vector<std::string>& embedding_table_names = {""},
                   const std::string& network_file = "", size_t label_dim = 1, size_t slot_num = 10,
-                  const std::string& non_trainable_params_file = "", bool use_static_table = false);
+                  const std::string& non_trainable_params_file = "", bool use_static_table = false,
+                  const std::vector<DatabaseValueCodec_t>& value_codec_per_table = {},
+                  bool use_int8_dense = false);
 };
 
 struct parameter_server_config {
@@ -308,6 +389,8 @@ struct parameter_server_config {
   VolatileDatabaseParams volatile_db;
   PersistentDatabaseParams persistent_db;
   UpdateSourceParams update_source;
+  // Port of the HTTP endpoint that serves HPS metrics in the Prometheus format (0 = disabled).
+  size_t metrics_port = 0;
   parameter_server_config(
       std::map<std::string, std::vector<std::string>> emb_table_name,
       std::map<std::string, std::vector<size_t>> embedding_vec_size,
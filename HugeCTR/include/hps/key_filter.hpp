@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <common.hpp>
+#include <cstdint>
+#include <hps/database_backend_detail.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * Blocked Bloom filter over the keys of a table. Each key sets / tests 8 bits that all reside in
+ * the same 64-byte block (one bit per 64-bit word). Hence, each query touches a single cache line.
+ *
+ * Bloom filters cannot forget keys. Keys that are removed later will just continue to pass the
+ * filter. That is safe, because the filter is only used to skip lookups for keys that are known to
+ * be absent.
+ *
+ * \p insert and \p may_contain are thread-safe and lock-free.
+ */
+class KeyFilter final {
+ public:
+  DISALLOW_COPY_AND_MOVE(KeyFilter);
+
+  /**
+   * Construct a new KeyFilter object.
+   *
+   * @param capacity Number of keys the filter is sized for. More keys can be inserted, but at the
+   * cost of a higher false positive rate.
+   * @param bits_per_key Number of filter bits per key (10 bits yield about 1% false positives).
+   */
+  KeyFilter(size_t capacity, double bits_per_key);
+
+  template <typename Key>
+  inline void insert(const Key key) {
+    const uint64_t h = hash(key);
+    Block& block = blocks_[block_of(h)];
+    for (size_t i = 0; i < words_per_block; i++) {
+      block.words[i].fetch_or(bit_of(h, i), std::memory_order_relaxed);
+    }
+    num_inserted_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  template <typename Key>
+  inline void insert(const size_t num_keys, const Key* const keys) {
+    for (size_t i = 0; i < num_keys; i++) {
+      insert(keys[i]);
+    }
+  }
+
+  /**
+   * @return \p false if \p key was definitely never inserted.
+   */
+  template <typename Key>
+  inline bool may_contain(const Key key) const {
+    const uint64_t h = hash(key);
+    const Block& block = blocks_[block_of(h)];
+    for (size_t i = 0; i < words_per_block; i++) {
+      const uint64_t bit = bit_of(h, i);
+      if (!(block.words[i].load(std::memory_order_relaxed) & bit)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t capacity() const { return capacity_; }
+
+  size_t num_inserted() const { return num_inserted_.load(std::memory_order_relaxed); }
+
+  size_t size_in_bytes() const { return blocks_.size() * sizeof(Block); }
+
+  /**
+   * @return The expected false positive rate, given the current number of keys.
+   */
+  double expected_false_positive_rate() const;
+
+ private:
+  static constexpr size_t words_per_block = 8;
+
+  struct alignas(64) Block final {
+    std::atomic<uint64_t> words[words_per_block];
+  };
+
+  const size_t capacity_;
+  std::vector<Block> blocks_;
+  std::atomic<size_t> num_inserted_{0};
+
+  template <typename Key>
+  static inline uint64_t hash(const Key key) {
+    return rrxmrrxmsx_0(static_cast<uint64_t>(key) ^ UINT64_C(0x9E3779B97F4A7C15));
+  }
+
+  // Upper half of the hash selects the block (multiply-shift instead of modulo).
+  inline size_t block_of(const uint64_t h) const {
+    return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(blocks_.size())) >> 32);
+  }
+
+  // Lower half of the hash selects one bit per word.
+  static inline uint64_t bit_of(const uint64_t h, const size_t word) {
+    static constexpr uint32_t salts[words_per_block] = {0x47b6137bu, 0x44974d91u, 0x8824ad5bu,
+                                                        0xa2b7289du, 0x705495c7u, 0x2df1424bu,
+                                                        0x9efc4947u, 0x5c6bfb31u};
+    return UINT64_C(1) << ((static_cast<uint32_t>(h) * salts[word]) >> 26);
+  }
+};
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
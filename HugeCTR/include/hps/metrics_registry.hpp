@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * Monotonic counter. Each thread increments one of several cache-line sized shards, so that
+ * concurrent updates neither lock nor contend on the same cache line.
+ */
+class MetricCounter final {
+ public:
+  static constexpr size_t num_shards = 16;
+
+  inline void add(const uint64_t n = 1) {
+    shards_[thread_shard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const;
+
+  static size_t thread_shard() {
+    static thread_local const size_t shard =
+        next_shard_.fetch_add(1, std::memory_order_relaxed) % num_shards;
+    return shard;
+  }
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, num_shards> shards_;
+
+  static std::atomic<size_t> next_shard_;
+};
+
+/**
+ * Value that can go up and down (e.g., a queue length or the most recent hit rate).
+ */
+class MetricGauge final {
+ public:
+  inline void set(const double value) { value_.store(value, std::memory_order_relaxed); }
+
+  void add(double value);
+
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0};
+};
+
+/**
+ * Latency histogram with log-linear buckets (HDR-style): Each power of 2 is split into
+ * \p num_sub_buckets equally wide buckets, so that any recorded value can be reconstructed with
+ * a relative error of at most 1 / \p num_sub_buckets . Values are recorded in nanoseconds.
+ */
+class MetricHistogram final {
+ public:
+  static constexpr size_t sub_bucket_bits = 3;
+  static constexpr size_t num_sub_buckets = size_t{1} << sub_bucket_bits;
+  static constexpr size_t num_buckets = (64 - sub_bucket_bits + 1) * num_sub_buckets;
+
+  inline void record(const uint64_t value) {
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.add(value);
+  }
+
+  inline void record(const std::chrono::nanoseconds duration) {
+    record(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+  }
+
+  static size_t bucket_index(uint64_t value);
+
+  /**
+   * @return Smallest value that falls into bucket \p index .
+   */
+  static uint64_t bucket_lower_bound(size_t index);
+
+  uint64_t count() const;
+  uint64_t sum() const { return sum_.value(); }
+
+  /**
+   * @return Estimate of the \p q -quantile (0 <= q <= 1), or 0 if nothing was recorded.
+   */
+  uint64_t quantile(double q) const;
+
+  /**
+   * @return Number of recorded values that are less than \p value for each given \p value .
+   */
+  std::vector<uint64_t> cumulative_counts(const std::vector<uint64_t>& values) const;
+
+ private:
+  std::array<std::atomic<uint64_t>, num_buckets> buckets_{};
+  MetricCounter sum_;
+};
+
+/**
+ * Records the time from construction to destruction in a \p MetricHistogram .
+ */
+class MetricTimer final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit MetricTimer(MetricHistogram& histogram) : histogram_{histogram} {}
+  MetricTimer(const MetricTimer&) = delete;
+  MetricTimer& operator=(const MetricTimer&) = delete;
+
+  ~MetricTimer() { histogram_.record(Clock::now() - begin_); }
+
+ private:
+  MetricHistogram& histogram_;
+  const Clock::time_point begin_{Clock::now()};
+};
+
+/**
+ * Process-wide collection of named metrics. Creating or looking up a metric takes a lock, hence
+ * callers should keep the returned reference. Metrics are never deleted, and updating them is
+ * lock-free.
+ *
+ * Metrics can be exported in the Prometheus text format, either by calling \p to_prometheus , or by
+ * scraping a \p MetricsHttpServer .
+ */
+class MetricsRegistry final {
+ public:
+  static MetricsRegistry& get();
+
+  MetricCounter& counter(const std::string& name, const std::string& help,
+                         const MetricLabels& labels = {});
+  MetricGauge& gauge(const std::string& name, const std::string& help,
+                     const MetricLabels& labels = {});
+  MetricHistogram& histogram(const std::string& name, const std::string& help,
+                             const MetricLabels& labels = {});
+
+  void write_prometheus(std::ostream& os) const;
+  std::string to_prometheus() const;
+
+ private:
+  MetricsRegistry() = default;
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  enum class Type { Counter, Gauge, Histogram };
+
+  struct Family final {
+    Type type;
+    std::string help;
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+
+  Family& family_(const std::string& name, const std::string& help, Type type);
+};
+
+/**
+ * Minimal HTTP server that answers every GET request with the current content of the
+ * \p MetricsRegistry in the Prometheus text format.
+ */
+class MetricsHttpServer final {
+ public:
+  /**
+   * Starts serving on \p address : \p port in a background thread.
+   */
+  MetricsHttpServer(uint16_t port, const std::string& address = "127.0.0.1");
+  MetricsHttpServer(const MetricsHttpServer&) = delete;
+  MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+  ~MetricsHttpServer();
+
+  uint16_t port() const { return port_; }
+
+ private:
+  int socket_{-1};
+  uint16_t port_;
+  std::atomic<bool> terminate_{false};
+  std::thread thread_;
+
+  void run_();
+};
+
+/**
+ * Metrics of the operations of a database backend, labelled with the backend name.
+ */
+struct DatabaseBackendMetrics final {
+  MetricHistogram& fetch_duration;
+  MetricCounter& fetch_keys;
+  MetricCounter& fetch_hits;
+  MetricHistogram& insert_duration;
+  MetricCounter& insert_pairs;
+  MetricHistogram& evict_duration;
+  MetricCounter& evict_keys;
+  MetricHistogram& overflow_resolution_duration;
+  MetricCounter& overflow_evicted_keys;
+
+  static DatabaseBackendMetrics& get(const std::string& backend);
+};
+
+}  // namespace HugeCTR
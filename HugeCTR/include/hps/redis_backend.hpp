@@ -20,9 +20,14 @@
 
 #include <hps/database_backend.hpp>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
 
 namespace HugeCTR {
 
+struct DatabaseBackendMetrics;
+
 // TODO: Remove me!
 #pragma GCC diagnostic push
 #pragma GCC diagnostic error "-Wconversion"
@@ -55,6 +60,10 @@ class RedisClusterBackend final : public VolatileBackend<Key> {
    * databse transaction.
    * @param max_set_batch_size Maximum number of key/value pairs that can participate in a writing
    * databse transaction.
+   * @param async_fetch If \p true , \p fetch groups partitions by the cluster node that stores
+   * them, and pipelines the HMGET batches for each node. Replies are parsed in place.
+   * @param max_pipeline_depth Maximum number of HMGET batches in flight per node connection.
+   * @param refresh_time_after_fetch Update the access time of fetched pairs.
    * @param overflow_margin Margin at which further inserts will trigger overflow handling.
    * @param overflow_policy Policy to use in case an overflow has been detected.
    * @param overflow_resolution_target Target margin after applying overflow handling policy.
@@ -63,6 +72,7 @@ class RedisClusterBackend final : public VolatileBackend<Key> {
       const std::string& address, const std::string& user_name = "default",
       const std::string& password = "", size_t num_partitions = 8, size_t num_node_connections = 5,
       size_t max_get_batch_size = 64L * 1024L, size_t max_set_batch_size = 64L * 1024L,
+      bool async_fetch = false, size_t max_pipeline_depth = 16,
       bool refresh_time_after_fetch = false,
       size_t overflow_margin = std::numeric_limits<size_t>::max(),
       DatabaseOverflowPolicy_t overflow_policy = DatabaseOverflowPolicy_t::EvictOldest,
@@ -97,6 +107,14 @@ class RedisClusterBackend final : public VolatileBackend<Key> {
                const DatabaseMissCallback& on_miss,
                const std::chrono::nanoseconds& time_budget) override;
 
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_size, size_t value_stride, std::vector<size_t>& missing,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_size, size_t value_stride,
+               std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget) override;
+
   size_t evict(const std::string& table_name) override;
 
   size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
@@ -105,7 +123,7 @@ class RedisClusterBackend final : public VolatileBackend<Key> {
 
   std::vector<Key> keys(const std::string& table_name);
 
-  void dump_bin(const std::string& table_name, std::ofstream& file) override;
+  void dump_bin(const std::string& table_name, const std::string& path) override;
 
   void dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 
@@ -136,13 +154,47 @@ class RedisClusterBackend final : public VolatileBackend<Key> {
   void touch_(const std::string& hkey_t, const std::shared_ptr<std::vector<Key>>& keys,
               time_t time);
 
+  /**
+   * Assignment of hash slots to cluster nodes.
+   */
+  struct ClusterTopology final {
+    size_t num_nodes;
+    std::vector<uint32_t> slot_nodes;  // Index of the node that serves each hash slot.
+  };
+
+  /**
+   * Called internally. Queries the slot assignment from the cluster, unless it is cached.
+   */
+  std::shared_ptr<const ClusterTopology> topology_();
+
+  /**
+   * Called internally. Pipelined lookup, used by all variants of \p fetch if \p async_fetch_ is
+   * enabled. If \p indices is \p nullptr , keys are queried in order.
+   */
+  template <typename HitFn, typename MissFn>
+  size_t fetch_async_(const std::string& table_name, size_t num_keys, const size_t* indices,
+                      const Key* keys, HitFn&& on_hit, MissFn&& on_miss,
+                      const std::chrono::nanoseconds& time_budget);
+
  protected:
+  const size_t num_node_connections_;
+  const bool async_fetch_;
+  const size_t max_pipeline_depth_;
   const bool refresh_time_after_fetch_;
 
   // Do not change this vector, after inserting data for the first time!
   const size_t num_partitions_;
+  DatabaseBackendMetrics& metrics_;
 
   std::unique_ptr<sw::redis::RedisCluster> redis_;
+
+  // Reset if the cluster reports that a slot has moved.
+  std::shared_ptr<const ClusterTopology> topology_cache_;
+  std::mutex topology_guard_;
+
+  // Partitions that were checked for (and migrated from) the previous access time layout.
+  std::unordered_set<std::string> migrated_parts_;
+  std::mutex migrated_parts_guard_;
 };
 
 // TODO: Remove me!
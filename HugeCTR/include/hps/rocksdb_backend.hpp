@@ -18,8 +18,11 @@
 
 #include <rocksdb/db.h>
 
+#include <atomic>
 #include <hps/database_backend.hpp>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace HugeCTR {
 
@@ -52,9 +55,17 @@ class RocksDBBackend final : public PersistentBackend<Key> {
    * databse transaction.
    * @param max_set_batch_size Maximum number of key/value pairs that can participate in a writing
    * databse transaction.
+   * @param block_cache_size Capacity of the block cache in bytes. Shared by all tables.
+   * @param bloom_filter_bits Bits per key of the bloom filters (0 = no filters).
+   * @param partitioned_index If \p true , index and filter blocks are partitioned. Only the top
+   * level is pinned in memory, which limits the memory footprint of very large tables.
+   * @param compression Compression of data blocks.
    */
   RocksDBBackend(const std::string& path, size_t num_threads = 16, bool read_only = false,
-                 size_t max_get_batch_size = 64L * 1024L, size_t max_set_batch_size = 64L * 1024L);
+                 size_t max_get_batch_size = 64L * 1024L, size_t max_set_batch_size = 64L * 1024L,
+                 size_t block_cache_size = 256L * 1024L * 1024L, double bloom_filter_bits = 10.0,
+                 bool partitioned_index = false,
+                 DatabaseCompression_t compression = DatabaseCompression_t::Snappy);
 
   virtual ~RocksDBBackend();
 
@@ -64,6 +75,8 @@ class RocksDBBackend final : public PersistentBackend<Key> {
 
   size_t size(const std::string& table_name) const override;
 
+  bool empty(const std::string& table_name) override;
+
   size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
                   const std::chrono::nanoseconds& time_budget) const override;
 
@@ -79,13 +92,21 @@ class RocksDBBackend final : public PersistentBackend<Key> {
                const DatabaseMissCallback& on_miss,
                const std::chrono::nanoseconds& time_budget) override;
 
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_size, size_t value_stride, std::vector<size_t>& missing,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_size, size_t value_stride,
+               std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget) override;
+
   size_t evict(const std::string& table_name) override;
 
   size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
 
   std::vector<std::string> find_tables(const std::string& model_name) override;
 
-  void dump_bin(const std::string& table_name, std::ofstream& file) override;
+  void dump_bin(const std::string& table_name, const std::string& path) override;
 
   void dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 
@@ -95,9 +116,29 @@ class RocksDBBackend final : public PersistentBackend<Key> {
   rocksdb::DB* db_;
   std::unordered_map<std::string, rocksdb::ColumnFamilyHandle*> column_handles_;
 
+  // Tables that are known to hold pairs, so that insert does not need to probe them for emptiness.
+  std::unordered_set<std::string> populated_tables_;
+  mutable std::mutex populated_tables_mutex_;
+  bool is_empty_(const std::string& table_name, rocksdb::ColumnFamilyHandle* col_handle);
+  void set_populated_(const std::string& table_name, bool populated);
+
+  // Distinguishes concurrent bulk inserts.
+  std::atomic<size_t> num_bulk_inserts_{0};
+
   rocksdb::ColumnFamilyOptions column_family_options_;
   rocksdb::ReadOptions read_options_;
   rocksdb::WriteOptions write_options_;
+
+  // Populates an empty table by writing sorted SST files in parallel, and ingesting them.
+  void bulk_insert_(const std::string& table_name, rocksdb::ColumnFamilyHandle* col_handle,
+                    size_t num_pairs, const Key* keys, const char* values, size_t value_size);
+
+  // Lookup implementation, shared by the callback and bulk variants of fetch. If \p indices is
+  // \p nullptr , keys are queried in order.
+  template <typename HitFn, typename MissFn>
+  size_t fetch_(const std::string& table_name, size_t num_keys, const size_t* indices,
+                const Key* keys, HitFn&& on_hit, MissFn&& on_miss,
+                const std::chrono::nanoseconds& time_budget) const;
 };
 
 // TODO: Remove me!
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <hps/database_backend.hpp>
+#include <hps/hash_map_backend.hpp>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread_pool.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * \p DatabaseBackend implementation that spreads the keys of each table across multiple
+ * independent \p HashMapBackend instances (shards) using consistent hashing. Requests are split
+ * by shard and processed in parallel.
+ *
+ * If \p numa_aware is set, shards are assigned round-robin to the NUMA nodes of the host. All
+ * operations on a shard are executed by worker threads that are bound to its node. Hence, the
+ * memory of each shard is allocated from, and accessed by the local node only.
+ *
+ * The number of shards can be changed at runtime using \p resize . Owing to consistent hashing,
+ * only keys whose owner changed are moved.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class ShardedHashMapBackend final : public VolatileBackend<Key> {
+ public:
+  using Base = VolatileBackend<Key>;
+
+  ShardedHashMapBackend() = delete;
+  DISALLOW_COPY_AND_MOVE(ShardedHashMapBackend);
+
+  /**
+   * Construct a new ShardedHashMapBackend object.
+   * @param num_shards The number of shards (each one behaves like a \p HashMapBackend partition).
+   * @param numa_aware Bind shards to NUMA nodes (ignored if NUMA is not available).
+   * @param allocation_rate Number of additional bytes to allocate per allocation.
+   * @param overflow_margin Margin at which further inserts will trigger overflow handling.
+   * @param overflow_policy Policy to use in case an overflow has been detected.
+   * @param overflow_resolution_target Target margin after applying overflow handling policy.
+   */
+  ShardedHashMapBackend(size_t num_shards = 16, bool numa_aware = true,
+                        size_t allocation_rate = 256L * 1024L * 1024L,
+                        size_t max_get_batch_size = 64L * 1024L,
+                        size_t max_set_batch_size = 64L * 1024L,
+                        size_t overflow_margin = std::numeric_limits<size_t>::max(),
+                        DatabaseOverflowPolicy_t overflow_policy =
+                            DatabaseOverflowPolicy_t::EvictOldest,
+                        double overflow_resolution_target = 0.8);
+
+  bool is_shared() const override final { return false; }
+
+  const char* get_name() const override { return "ShardedHashMapBackend"; }
+
+  size_t capacity(const std::string& table_name) const override;
+
+  size_t size(const std::string& table_name) const override;
+
+  size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
+                  const std::chrono::nanoseconds& time_budget) const override;
+
+  bool insert(const std::string& table_name, size_t num_pairs, const Key* keys, const char* values,
+              size_t value_size) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys,
+               const DatabaseHitCallback& on_hit, const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, const DatabaseHitCallback& on_hit,
+               const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_size, size_t value_stride, std::vector<size_t>& missing,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_size, size_t value_stride,
+               std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget) override;
+
+  size_t evict(const std::string& table_name) override;
+
+  size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
+
+  std::vector<std::string> find_tables(const std::string& model_name) override;
+
+  void dump_bin(const std::string& table_name, const std::string& path) override;
+
+  void dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
+
+  /**
+   * @return The current number of shards.
+   */
+  size_t num_shards() const;
+
+  /**
+   * @return The NUMA node of each shard (-1 = not bound).
+   */
+  std::vector<int> shard_nodes() const;
+
+  /**
+   * Change the number of shards. Pairs whose owner changes are moved to their new shard. Blocks
+   * all other operations until complete.
+   *
+   * @param num_shards The new number of shards.
+   */
+  void resize(size_t num_shards);
+
+  /**
+   * @return Index of the shard that owns \p key .
+   */
+  size_t shard_of(Key key) const;
+
+ protected:
+  static constexpr size_t num_virtual_nodes = 128;  // Points on the hash ring per shard.
+
+  struct Shard final {
+    std::unique_ptr<HashMapBackend<Key>> db;
+    int numa_node;        // -1 = Not bound.
+    ThreadPool* workers;  // nullptr = Default thread pool.
+  };
+
+  const bool numa_aware_;
+  const size_t allocation_rate_;
+  const double shard_overflow_resolution_target_;
+
+  std::vector<Shard> shards_;
+  std::vector<std::pair<uint64_t, uint32_t>> ring_;  // (Point, shard), sorted by point.
+  std::vector<uint32_t> ring_lut_;  // Owner per 2^16 hash range (ring_ambiguous = lookup ring).
+  static constexpr uint32_t ring_ambiguous = std::numeric_limits<uint32_t>::max();
+
+  std::unordered_map<std::string, size_t> value_sizes_;  // Value size of each table.
+  mutable std::mutex value_sizes_guard_;
+
+  // NUMA topology. One worker pool per node.
+  std::vector<int> numa_nodes_;
+  std::vector<std::unique_ptr<ThreadPool>> node_workers_;
+
+  // Access control. Shards synchronize themselves. This guards the set of shards and the ring.
+  mutable std::shared_mutex read_write_guard_;
+
+  void add_shard_();
+  void rebuild_ring_(size_t num_shards);
+  size_t shard_of_(Key key) const;
+
+  /**
+   * Split a request by shard.
+   *
+   * @return Indices into \p keys for each shard.
+   */
+  std::vector<std::vector<size_t>> split_(size_t num_keys, const size_t* indices,
+                                          const Key* keys) const;
+
+  // Run a task on the worker threads of a shard.
+  std::future<void> submit_(size_t shard, std::function<void()> task) const;
+
+  size_t fetch_(const std::string& table_name, size_t num_indices, const size_t* indices,
+                const Key* keys, char* values, size_t value_size, size_t value_stride,
+                std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget);
+
+  std::vector<std::string> tables_() const;
+};
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
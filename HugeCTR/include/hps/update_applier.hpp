@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <hps/database_backend.hpp>
+#include <hps/metrics_registry.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <thread_pool.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Decouples the consumption of update messages (e.g., from a \p MessageSource ) from applying them
+ * to a \p DatabaseBackend .
+ *
+ * Incoming key/value pairs are accumulated per table in a front buffer. A background thread swaps
+ * front and back buffers whenever a table reached \p max_batch_size pairs or the oldest pending
+ * update became older than \p max_delay . The back buffer is then deduplicated (last writer wins)
+ * and applied to the database. Different tables are applied in parallel. Hence, the consumer only
+ * blocks if more than \p max_pending_pairs are waiting to be applied.
+ *
+ * Remark: Updates are acknowledged as soon as they have been queued. Pending updates are lost if
+ * the process terminates abnormally.
+ *
+ * @tparam Key The data-type that is used for keys in the database.
+ */
+template <typename Key>
+class UpdateApplier final {
+ public:
+  DISALLOW_COPY_AND_MOVE(UpdateApplier);
+
+  UpdateApplier() = delete;
+
+  /**
+   * Construct a new \p UpdateApplier object.
+   *
+   * @param db The database to which the updates should be applied.
+   * @param max_batch_size Number of pending pairs in a table that triggers an immediate apply.
+   * @param max_delay Maximum time an update can remain pending before it is applied.
+   * @param max_pending_pairs Upper bound for the number of queued pairs. If exceeded, \p post
+   * blocks until the background thread caught up.
+   * @param num_workers Number of tables that can be applied in parallel.
+   */
+  UpdateApplier(DatabaseBackend<Key>* db, size_t max_batch_size = 256 * 1024,
+                std::chrono::milliseconds max_delay = std::chrono::milliseconds{100},
+                size_t max_pending_pairs = 4 * 1024 * 1024, size_t num_workers = 4);
+
+  ~UpdateApplier();
+
+  /**
+   * Queue a set of key/value pairs. Signature is compatible with \p HCTR_MESSAGE_SOURCE_CALLBACK .
+   *
+   * @param tag The name of the table to be updated.
+   * @param num_pairs Number of \p keys and \p values .
+   * @param keys Pointer to the keys.
+   * @param values Pointer to the values.
+   * @param value_size The size of each value in bytes.
+   *
+   * @return True if the update was queued. False, if the update has to be retried later.
+   */
+  bool post(const std::string& tag, size_t num_pairs, const Key* keys, const char* values,
+            size_t value_size);
+
+  /**
+   * Blocks the caller until all previously posted updates have been applied.
+   */
+  void flush();
+
+  size_t num_pairs_received() const { return num_pairs_received_; }
+  size_t num_pairs_applied() const { return num_pairs_applied_; }
+  size_t num_pairs_deduplicated() const { return num_pairs_deduplicated_; }
+  size_t num_pairs_pending() const { return num_pairs_pending_; }
+  size_t num_applies() const { return num_applies_; }
+
+  /**
+   * @return Time between receiving and applying an update (most recent apply).
+   */
+  std::chrono::nanoseconds last_lag() const { return std::chrono::nanoseconds{last_lag_ns_}; }
+
+  /**
+   * @return Time between receiving and applying an update (worst case since construction).
+   */
+  std::chrono::nanoseconds max_lag() const { return std::chrono::nanoseconds{max_lag_ns_}; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct TableBuffer final {
+    size_t value_size = 0;
+    std::vector<Key> keys;
+    std::vector<char> values;
+    Clock::time_point first_post;
+  };
+  using Queue = std::unordered_map<std::string, TableBuffer>;
+
+  DatabaseBackend<Key>* const db_;
+  const size_t max_batch_size_;
+  const std::chrono::milliseconds max_delay_;
+  const size_t max_pending_pairs_;
+
+  // Double buffer. Consumers append to the front. The background thread applies the back.
+  Queue front_;
+  Queue back_;
+  size_t front_size_ = 0;
+  bool swap_requested_ = false;
+  size_t num_swaps_ = 0;
+  size_t num_rounds_completed_ = 0;
+
+  mutable std::mutex barrier_;
+  std::condition_variable post_semaphore_;
+  std::condition_variable swap_semaphore_;
+
+  // Background thread. Written under barrier_, but also polled while inserting without it.
+  std::atomic<bool> terminate_{false};
+  std::thread applier_;
+  ThreadPool workers_;
+  void run_();
+  size_t apply_(const std::string& tag, TableBuffer& buf);
+
+  // Metrics.
+  std::atomic<size_t> num_pairs_received_{0};
+  std::atomic<size_t> num_pairs_applied_{0};
+  std::atomic<size_t> num_pairs_deduplicated_{0};
+  std::atomic<size_t> num_pairs_pending_{0};
+  std::atomic<size_t> num_applies_{0};
+  std::atomic<int64_t> last_lag_ns_{0};
+  std::atomic<int64_t> max_lag_ns_{0};
+
+  // Exported metrics (see \p MetricsRegistry ).
+  MetricHistogram* lag_metric_;
+  MetricCounter* pairs_received_metric_;
+  MetricCounter* pairs_applied_metric_;
+  MetricGauge* pairs_pending_metric_;
+};
+
+}  // namespace HugeCTR
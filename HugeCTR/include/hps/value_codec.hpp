@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <hps/inference_utils.hpp>
+
+namespace HugeCTR {
+
+/**
+ * Storage layout of an embedding vector with \p dim elements for each value codec:
+ *
+ *   fp32: dim x float (raw, as delivered by the model)
+ *   fp16: dim x IEEE 754 half precision float
+ *   bf16: dim x bfloat16 (upper half of the fp32 bit pattern)
+ *   int8: [float scale][float offset] dim x uint8, where x = offset + scale * q
+ *
+ * Rounding is to nearest. For int8, scale and offset are chosen per row, so that [min, max] of the
+ * row maps to [0, 255]. Encoded values are plain byte sequences without alignment requirements.
+ */
+
+/**
+ * @return Size of an encoded embedding vector with \p dim elements in bytes.
+ */
+size_t value_codec_size(DatabaseValueCodec_t codec, size_t dim);
+
+/**
+ * Encode \p num_values embedding vectors.
+ *
+ * @param codec The value codec.
+ * @param num_values Number of embedding vectors.
+ * @param dim Number of elements per embedding vector.
+ * @param src Densely packed input vectors (\p num_values x \p dim floats).
+ * @param dst Output buffer (\p num_values x \p value_codec_size bytes).
+ */
+void encode_values(DatabaseValueCodec_t codec, size_t num_values, size_t dim, const float* src,
+                   char* dst);
+
+/**
+ * Decode \p num_values embedding vectors. Inverse of \p encode_values .
+ *
+ * @param codec The value codec.
+ * @param num_values Number of embedding vectors.
+ * @param dim Number of elements per embedding vector.
+ * @param src Encoded vectors (\p num_values x \p value_codec_size bytes).
+ * @param dst Output buffer (\p num_values x \p dim floats).
+ */
+void decode_values(DatabaseValueCodec_t codec, size_t num_values, size_t dim, const char* src,
+                   float* dst);
+
+}  // namespace HugeCTR
@@ -251,10 +251,34 @@ void CommonPybind(pybind11::module& m) {
              HugeCTR::DatabaseType_t::ParallelHashMap)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::MultiProcessHashMap),
              HugeCTR::DatabaseType_t::MultiProcessHashMap)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::ShardedHashMap),
+             HugeCTR::DatabaseType_t::ShardedHashMap)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::RedisCluster),
              HugeCTR::DatabaseType_t::RedisCluster)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::RocksDB),
              HugeCTR::DatabaseType_t::RocksDB)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::ImmutableStore),
+             HugeCTR::DatabaseType_t::ImmutableStore)
+      .export_values();
+  pybind11::enum_<HugeCTR::DatabaseCompression_t>(m, "DatabaseCompression_t")
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseCompression_t::None),
+             HugeCTR::DatabaseCompression_t::None)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseCompression_t::Snappy),
+             HugeCTR::DatabaseCompression_t::Snappy)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseCompression_t::LZ4),
+             HugeCTR::DatabaseCompression_t::LZ4)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseCompression_t::ZSTD),
+             HugeCTR::DatabaseCompression_t::ZSTD)
+      .export_values();
+  pybind11::enum_<HugeCTR::DatabaseValueCodec_t>(m, "DatabaseValueCodec_t")
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueCodec_t::Float32),
+             HugeCTR::DatabaseValueCodec_t::Float32)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueCodec_t::Float16),
+             HugeCTR::DatabaseValueCodec_t::Float16)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueCodec_t::BFloat16),
+             HugeCTR::DatabaseValueCodec_t::BFloat16)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueCodec_t::Int8),
+             HugeCTR::DatabaseValueCodec_t::Int8)
       .export_values();
   pybind11::enum_<HugeCTR::DatabaseOverflowPolicy_t>(m, "DatabaseOverflowPolicy_t")
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseOverflowPolicy_t::EvictOldest),
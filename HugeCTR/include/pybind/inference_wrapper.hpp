@@ -447,7 +447,8 @@ void InferencePybind(pybind11::module& m) {
       .def(pybind11::init<DatabaseType_t,
                           // Backend specific.
                           const std::string&, const std::string&, const std::string&, size_t,
-                          size_t, size_t, const std::string&, size_t, size_t, size_t,
+                          size_t, size_t, const std::string&, size_t, size_t, size_t, bool,
+                          size_t, bool,
                           // Overflow handling related.
                           bool, size_t, DatabaseOverflowPolicy_t, double,
                           // Caching behavior related.
@@ -465,6 +466,8 @@ void InferencePybind(pybind11::module& m) {
            pybind11::arg("num_node_connections") = 5,
            pybind11::arg("max_get_batch_size") = 64L * 1024L,
            pybind11::arg("max_set_batch_size") = 64L * 1024L,
+           pybind11::arg("async_fetch") = false, pybind11::arg("max_pipeline_depth") = 16,
+           pybind11::arg("numa_aware") = true,
            // Overflow handling related.
            pybind11::arg("refresh_time_after_fetch") = false,
            pybind11::arg("overflow_margin") = std::numeric_limits<size_t>::max(),
@@ -482,9 +485,10 @@ void InferencePybind(pybind11::module& m) {
                                                                        "PersistentDatabaseParams")
       .def(pybind11::init<DatabaseType_t,
                           // Backend specific.
-                          const std::string&, size_t, bool, size_t, size_t,
+                          const std::string&, size_t, bool, size_t, size_t, size_t, double, bool,
+                          DatabaseCompression_t,
                           // Caching behavior related.
-                          bool,
+                          bool, double,
                           // Real-time update mechanism related.
                           const std::vector<std::string>&>(),
            pybind11::arg("backend") = DatabaseType_t::Disabled,
@@ -493,8 +497,12 @@ void InferencePybind(pybind11::module& m) {
            pybind11::arg("num_threads") = 16, pybind11::arg("read_only") = false,
            pybind11::arg("max_get_batch_size") = 64L * 1024L,
            pybind11::arg("max_set_batch_size") = 64L * 1024L,
+           pybind11::arg("block_cache_size") = 256L * 1024L * 1024L,
+           pybind11::arg("bloom_filter_bits") = 10.0, pybind11::arg("partitioned_index") = false,
+           pybind11::arg("compression") = DatabaseCompression_t::Snappy,
            // Caching behavior related.
            pybind11::arg("initialize_after_startup") = true,
+           pybind11::arg("negative_cache_bits") = 0.0,
            // Real-time update mechanism related.
            pybind11::arg("update_filters") = std::vector<std::string>{"^hps_.+$"});
 
@@ -502,14 +510,18 @@ void InferencePybind(pybind11::module& m) {
       infer, "UpdateSourceParams")
       .def(pybind11::init<UpdateSourceType_t,
                           // Backend specific.
-                          const std::string&, size_t, size_t, size_t, size_t, size_t, size_t>(),
+                          const std::string&, size_t, size_t, size_t, size_t, size_t, size_t,
+                          // Update application related.
+                          size_t, size_t>(),
            pybind11::arg("type") = UpdateSourceType_t::Null,
            // Backend specific.
            pybind11::arg("brokers") = "127.0.0.1:9092",
            pybind11::arg("metadata_refresh_interval_ms") = 30'000,
            pybind11::arg("receive_buffer_size") = 256 * 1024,
            pybind11::arg("poll_timeout_ms") = 500, pybind11::arg("max_batch_size") = 8 * 1024,
-           pybind11::arg("failure_backoff_ms") = 50, pybind11::arg("max_commit_interval") = 32);
+           pybind11::arg("failure_backoff_ms") = 50, pybind11::arg("max_commit_interval") = 32,
+           // Update application related.
+           pybind11::arg("apply_max_batch_size") = 0, pybind11::arg("apply_max_delay_ms") = 100);
 
   pybind11::class_<HugeCTR::InferenceParams, std::shared_ptr<HugeCTR::InferenceParams>>(
       infer, "InferenceParams")
@@ -524,7 +536,7 @@ void InferencePybind(pybind11::module& m) {
                           const float, const float, const std::vector<size_t>&,
                           const std::vector<size_t>&, const std::vector<std::string>&,
                           const std::string&, const size_t, const size_t, const std::string&,
-                          bool>(),
+                          bool, const std::vector<DatabaseValueCodec_t>&, bool>(),
 
            pybind11::arg("model_name"), pybind11::arg("max_batchsize"),
            pybind11::arg("hit_rate_threshold"), pybind11::arg("dense_model_file"),
@@ -551,7 +563,9 @@ void InferencePybind(pybind11::module& m) {
            pybind11::arg("embedding_table_names") = std::vector<std::string>{""},
            pybind11::arg("network_file") = "", pybind11::arg("label_dim") = 1,
            pybind11::arg("slot_num") = 10, pybind11::arg("non_trainable_params_file") = "",
-           pybind11::arg("use_static_table") = false);
+           pybind11::arg("use_static_table") = false,
+           pybind11::arg("value_codec_per_table") = std::vector<DatabaseValueCodec_t>{},
+           pybind11::arg("use_int8_dense") = false);
 
   infer.def("CreateInferenceSession", &HugeCTR::python_lib::CreateInferenceSession,
             pybind11::arg("model_config_path"), pybind11::arg("inference_params"));
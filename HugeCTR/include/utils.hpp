@@ -267,7 +267,7 @@ class CudaCPUDeviceContext {
     };
 
     {
-      auto log = HCTR_LOG_S(INFO, ROOT);
+      auto log = HCTR_LOG_ENTRY(INFO, ROOT);
       log << "Device to NUMA mapping:" << std::endl;
 
       for (auto device_id : device_ids) {
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/debug/async_log_sink.hpp>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace HugeCTR {
+
+AsyncLogSink::AsyncLogSink(const size_t capacity, const WriteFunction& write,
+                           const FlushFunction& flush)
+    : capacity_{[capacity]() {
+        size_t n = 1;
+        while (n < capacity) {
+          n <<= 1;
+        }
+        return n;
+      }()},
+      slots_{std::make_unique<Slot[]>(capacity_)},
+      write_{write},
+      flush_{flush} {
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  writer_ = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  terminate_.store(true, std::memory_order_release);
+  writer_.join();
+}
+
+bool AsyncLogSink::push(const int level, std::string&& message) {
+  // Bounded MPMC queue after D. Vyukov. A slot can be claimed by the producer at position `pos` if
+  // its sequence equals `pos`, and is ready for the consumer once its sequence is `pos + 1`.
+  size_t pos = head_.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &slots_[pos & (capacity_ - 1)];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      num_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->level = level;
+  slot->message = std::move(message);
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+void AsyncLogSink::flush() const {
+  const size_t target = head_.load(std::memory_order_acquire);
+  while (written_.load(std::memory_order_acquire) < target) {
+    std::this_thread::yield();
+  }
+}
+
+size_t AsyncLogSink::drain() {
+  size_t num_written = 0;
+  while (true) {
+    Slot& slot = slots_[tail_ & (capacity_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+      break;
+    }
+    write_(slot.level, slot.message);
+    slot.message.clear();
+    slot.sequence.store(tail_ + capacity_, std::memory_order_release);
+    tail_++;
+    num_written++;
+  }
+  if (num_written) {
+    flush_();
+    written_.store(tail_, std::memory_order_release);
+  }
+  return num_written;
+}
+
+void AsyncLogSink::run() {
+  hctr_set_thread_name("log writer");
+  while (true) {
+    const bool terminate = terminate_.load(std::memory_order_acquire);
+    if (drain() == 0) {
+      if (terminate) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+}  // namespace HugeCTR
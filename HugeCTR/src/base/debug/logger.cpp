@@ -19,6 +19,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <base/debug/async_log_sink.hpp>
 #include <base/debug/logger.hpp>
 #include <chrono>
 #include <common.hpp>
@@ -55,14 +56,19 @@ void Logger::print_exception(const std::exception& e, int depth) {
 }
 
 Logger& Logger::get() {
-  static std::unique_ptr<Logger> instance;
-  static std::once_flag once_flag;
-
-  std::call_once(once_flag, []() { instance.reset(new Logger()); });
+  static std::unique_ptr<Logger> instance{new Logger()};
   return *instance;
 }
 
 Logger::~Logger() {
+  if (async_sink_) {
+    const size_t num_dropped = async_sink_->get_num_dropped();
+    async_sink_.reset();
+    if (num_dropped && log_to_std_) {
+      fprintf(log_std_.at(LOG_ERROR_LEVEL), "[HCTR] %zu log messages were dropped.\n", num_dropped);
+    }
+  }
+
   // if stdout and stderr are in use, we don't do fclose to prevent the situations where
   //   (1) the fds are taken in opening other files or
   //   (2) writing to the closed fds occurs, which is UB.
@@ -77,58 +83,41 @@ Logger::~Logger() {
 }
 
 void Logger::log(const int level, bool per_rank, bool with_prefix, const char* format, ...) const {
-  if (level == LOG_SILENCE_LEVEL || level > max_level_) {
+  if (!is_enabled(level, per_rank)) {
     return;
   }
 
-  if (rank_ == 0 || per_rank) {
-    std::ostringstream os;
-    if (with_prefix) {
-      write_log_prefix(os, level);
-    }
-    os << format;
-    const std::string& new_format = os.str();
-
-    if (log_to_std_) {
-      va_list args;
-      va_start(args, format);
-      FILE* const file = log_std_.at(level);
-      vfprintf(file, new_format.c_str(), args);
-      va_end(args);
-      fflush(file);
-    }
+  std::ostringstream os;
+  if (with_prefix) {
+    write_log_prefix(os, level);
+  }
+  os << format;
+  const std::string& new_format = os.str();
 
-    if (log_to_file_) {
-      va_list args;
-      va_start(args, format);
-      FILE* const file = log_file_.at(level);
-      vfprintf(file, new_format.c_str(), args);
-      va_end(args);
-      fflush(file);
-    }
+  std::string message;
+  {
+    va_list args;
+    va_start(args, format);
+    message.resize(vsnprintf(nullptr, 0, new_format.c_str(), args));
+    va_end(args);
+  }
+  {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message.data(), message.size() + 1, new_format.c_str(), args);
+    va_end(args);
   }
+  write(level, std::move(message));
 }
 
 Logger::DeferredEntry::~DeferredEntry() {
   if (logger_) {
-    if (logger_->log_to_std_) {
-      FILE* const file = logger_->log_std_.at(level_);
-      fputs(os_.str().c_str(), file);
-      fflush(file);
-    }
-
-    if (logger_->log_to_file_) {
-      FILE* const file = logger_->log_file_.at(level_);
-      fputs(os_.str().c_str(), file);
-      fflush(file);
-    }
+    logger_->write(level_, os_->str());
   }
 }
 
 Logger::DeferredEntry Logger::log(const int level, bool per_rank, bool with_prefix) const {
-  if (level == LOG_SILENCE_LEVEL || level > max_level_) {
-    return {nullptr, level, per_rank, false};
-  } else if (rank_ == 0 || per_rank) {
+  if (is_enabled(level, per_rank)) {
     return {this, level, per_rank, with_prefix};
   } else {
     return {nullptr, level, per_rank, false};
@@ -178,6 +167,42 @@ void Logger::do_throw(HugeCTR::Error_t error_type, const SrcLoc& loc,
 
 int Logger::get_rank() { return rank_; }
 
+void Logger::flush() const {
+  if (async_sink_) {
+    async_sink_->flush();
+  }
+}
+
+void Logger::write(const int level, std::string&& message) const {
+  if (async_sink_) {
+    // Errors usually precede an abort, so they bypass the queue (after everything before them).
+    if (level != LOG_ERROR_LEVEL) {
+      async_sink_->push(level, std::move(message));
+      return;
+    }
+    async_sink_->flush();
+  }
+  write_sync(level, message, true);
+}
+
+void Logger::write_sync(const int level, const std::string& message, const bool flush) const {
+  if (log_to_std_) {
+    FILE* const file = log_std_.at(level);
+    fputs(message.c_str(), file);
+    if (flush) {
+      fflush(file);
+    }
+  }
+
+  if (log_to_file_) {
+    FILE* const file = log_file_.at(level);
+    fputs(message.c_str(), file);
+    if (flush) {
+      fflush(file);
+    }
+  }
+}
+
 #ifdef HCTR_LEVEL_MAP_
 #error HCTR_LEVEL_MAP_ already defined!
 #else
@@ -241,6 +266,31 @@ Logger::Logger() : rank_(0), max_level_(DEFAULT_LOG_LEVEL), log_to_std_(true), l
       log_std_[level] = stdout;
     }
   }
+
+  const char* const log_async_str = std::getenv("HUGECTR_LOG_ASYNC");
+  if (log_async_str != nullptr && log_async_str[0] != '\0') {
+    int log_async_val = 0;
+    if (sscanf(log_async_str, "%d", &log_async_val) == 1 && log_async_val > 0) {
+      async_sink_ = std::make_unique<AsyncLogSink>(
+          16384,
+          [this](const int level, const std::string& message) {
+            write_sync(level, message, false);
+          },
+          [this]() {
+            if (log_to_std_) {
+              fflush(stdout);
+              fflush(stderr);
+            }
+            if (log_to_file_) {
+              for (const auto& file : log_file_) {
+                if (file.second) {
+                  fflush(file.second);
+                }
+              }
+            }
+          });
+    }
+  }
 }
 
 void Logger::write_log_prefix(std::ostringstream& os, const int level) const {
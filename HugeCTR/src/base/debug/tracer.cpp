@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <base/debug/tracer.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace HugeCTR {
+
+namespace {
+
+void write_json_string(std::ostream& os, const char* s) {
+  os << '"';
+  for (; *s; s++) {
+    switch (*s) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        os << *s;
+    }
+  }
+  os << '"';
+}
+
+// Writes the trace on exit, if requested through 'HUGECTR_TRACE_FILE'.
+struct TraceFileWriter final {
+  std::string path;
+
+  TraceFileWriter() {
+    if (const char* const trace_file = std::getenv("HUGECTR_TRACE_FILE")) {
+      path = trace_file;
+      // Construct the logger first, so that it is still alive when the trace is written.
+      Logger::get();
+    }
+  }
+
+  ~TraceFileWriter() {
+    if (!path.empty()) {
+      Tracer::get().dump(path);
+    }
+  }
+};
+
+TraceFileWriter trace_file_writer;
+
+}  // namespace
+
+Tracer& Tracer::get() {
+  // Never destroyed, because spans may still be recorded by threads that outlive main().
+  static Tracer* const instance = new Tracer();
+  return *instance;
+}
+
+Tracer::Tracer() : max_events_per_thread_{size_t{1} << 20} {
+  if (const char* const max_events = std::getenv("HUGECTR_TRACE_MAX_EVENTS")) {
+    max_events_per_thread_ = std::strtoull(max_events, nullptr, 10);
+  }
+  if (std::getenv("HUGECTR_TRACE_FILE")) {
+    enabled_ = true;
+  }
+}
+
+void Tracer::set_enabled(const bool enabled) { enabled_.store(enabled); }
+
+Tracer::ThreadBuffer& Tracer::thread_buffer_() {
+  static thread_local ThreadBuffer* buffer = nullptr;
+  if (!buffer) {
+    // The tracer co-owns the buffer, so that spans of finished threads are kept.
+    auto new_buffer = std::make_shared<ThreadBuffer>();
+    new_buffer->thread_name = hctr_get_thread_name();
+
+    const std::lock_guard lock(mutex_);
+    new_buffer->tid = buffers_.size() + 1;
+    buffers_.emplace_back(new_buffer);
+    buffer = new_buffer.get();
+  }
+  return *buffer;
+}
+
+void Tracer::record(const char* const category, const char* const name, const int64_t begin,
+                    const int64_t end) {
+  ThreadBuffer& buffer = thread_buffer_();
+  const std::lock_guard lock(buffer.mutex);
+  if (buffer.events.size() >= max_events_per_thread_) {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events.push_back({category, name, begin, end});
+}
+
+const char* Tracer::intern(const std::string& name) {
+  const std::lock_guard lock(mutex_);
+  return interned_names_.insert(name).first->c_str();
+}
+
+void Tracer::write_chrome_trace(std::ostream& os) const {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    const std::lock_guard lock(mutex_);
+    buffers = buffers_;
+  }
+  const pid_t pid = getpid();
+
+  // Timestamps are in microseconds, relative to the first span.
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (const auto& buffer : buffers) {
+    const std::lock_guard lock(buffer->mutex);
+    for (const Event& event : buffer->events) {
+      origin = std::min(origin, event.begin);
+    }
+  }
+
+  os << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (const auto& buffer : buffers) {
+    const std::lock_guard lock(buffer->mutex);
+    if (buffer->events.empty()) {
+      continue;
+    }
+
+    os << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+    const std::string thread_name =
+        buffer->thread_name.empty() ? "thread " + std::to_string(buffer->tid) : buffer->thread_name;
+    write_json_string(os, thread_name.c_str());
+    os << "}}";
+    first = false;
+
+    for (const Event& event : buffer->events) {
+      os << ",\n{\"name\":";
+      write_json_string(os, event.name);
+      os << ",\"cat\":";
+      write_json_string(os, event.category);
+      os << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+         << ",\"ts\":" << static_cast<double>(event.begin - origin) * 1e-3
+         << ",\"dur\":" << static_cast<double>(event.end - event.begin) * 1e-3 << '}';
+    }
+  }
+  os << "\n]}\n";
+}
+
+void Tracer::dump(const std::string& path) const {
+  std::ofstream os(path);
+  if (!os.is_open()) {
+    HCTR_LOG_S(ERROR, WORLD) << "Unable to write trace to '" << path << "'." << std::endl;
+    return;
+  }
+  write_chrome_trace(os);
+  HCTR_LOG_S(INFO, WORLD) << "Wrote " << get_num_events() << " trace events to '" << path << "' ("
+                          << get_num_dropped() << " dropped)." << std::endl;
+}
+
+void Tracer::clear() {
+  const std::lock_guard lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    const std::lock_guard buffer_lock(buffer->mutex);
+    buffer->events.clear();
+  }
+  num_dropped_ = 0;
+}
+
+size_t Tracer::get_num_events() const {
+  const std::lock_guard lock(mutex_);
+  size_t num_events = 0;
+  for (const auto& buffer : buffers_) {
+    const std::lock_guard buffer_lock(buffer->mutex);
+    num_events += buffer->events.size();
+  }
+  return num_events;
+}
+
+}  // namespace HugeCTR
@@ -173,14 +173,14 @@ void IbComm::print_distance_matrix(size_t my_rank, std::vector<std::vector<size_
   // Print distance matrix
   if (my_rank == 0) {
     {
-      auto log = HCTR_LOG_S(INFO, WORLD);
+      auto log = HCTR_LOG_ENTRY(INFO, WORLD);
       for (size_t n = 0; n < ib_dev_list_.size(); n++) {
         log << std::setfill(' ') << std::setw(24) << ib_dev_list_[n].dev_name;
       }
       log << std::endl;
     }
     {
-      auto log = HCTR_LOG_S(INFO, WORLD);
+      auto log = HCTR_LOG_ENTRY(INFO, WORLD);
       for (size_t g = 0; g < num_gpus_; g++) {
         for (size_t n = 0; n < ib_dev_list_.size(); n++) {
           log << std::setfill(' ') << std::setw(24) << gpu_nic_dist[g][n];
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <cpu/batching_inference_session_cpu.hpp>
+#include <type_traits>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+template <typename TypeHashKey>
+BatchingInferenceSessionCPU<TypeHashKey>::BatchingInferenceSessionCPU(
+    const std::string& model_config_path, const InferenceParams& inference_params,
+    const std::shared_ptr<HierParameterServerBase>& parameter_server, const size_t num_replicas,
+    const std::chrono::microseconds max_batch_delay)
+    : inference_parser_(read_json_file(model_config_path)),
+      max_batchsize_(inference_params.max_batchsize),
+      max_batch_delay_(max_batch_delay) {
+  HCTR_CHECK_HINT(num_replicas > 0, "At least one session replica is required!");
+  HCTR_CHECK_HINT((inference_params.i64_input_key == std::is_same<TypeHashKey, long long>::value),
+                  "Key type does not match InferenceParams::i64_input_key!");
+
+  size_t row_ptrs_size = 0;
+  for (const size_t slot_num : inference_parser_.slot_num_for_tables) {
+    row_ptrs_size += max_batchsize_ * slot_num + 1;
+  }
+
+  // Create all replicas first. Workers are only started once construction cannot fail anymore.
+  for (size_t i = 0; i < num_replicas; i++) {
+    auto replica = std::make_unique<Replica>();
+    replica->session = std::make_unique<InferenceSessionCPU<TypeHashKey>>(
+        model_config_path, inference_params, parameter_server);
+    replica->dense.resize(max_batchsize_ * inference_parser_.dense_dim);
+    replica->keys.resize(max_batchsize_ * inference_parser_.max_feature_num_per_sample);
+    replica->row_ptrs.resize(row_ptrs_size);
+    replica->output.resize(max_batchsize_ * inference_parser_.label_dim);
+    replicas_.emplace_back(std::move(replica));
+  }
+  for (auto& replica : replicas_) {
+    replica->worker = std::thread(&BatchingInferenceSessionCPU::run_, this, std::ref(*replica));
+  }
+}
+
+template <typename TypeHashKey>
+BatchingInferenceSessionCPU<TypeHashKey>::~BatchingInferenceSessionCPU() {
+  // Workers drain the queue before they exit.
+  {
+    const std::lock_guard<std::mutex> lock(queue_guard_);
+    terminate_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& replica : replicas_) {
+    replica->worker.join();
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "BatchingInferenceSessionCPU processed " << num_requests_
+                          << " requests in " << num_batches_ << " batches." << std::endl;
+}
+
+template <typename TypeHashKey>
+std::future<void> BatchingInferenceSessionCPU<TypeHashKey>::predict_async(
+    const float* const h_dense, const void* const h_embeddingcolumns, const int* const h_row_ptrs,
+    float* const h_output, const int num_samples) {
+  if (num_samples <= 0 || static_cast<size_t>(num_samples) > max_batchsize_) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Number of samples must be in [1, max_batchsize]!");
+  }
+
+  Request request;
+  request.h_dense = h_dense;
+  request.h_keys = static_cast<const TypeHashKey*>(h_embeddingcolumns);
+  request.h_row_ptrs = h_row_ptrs;
+  request.h_output = h_output;
+  request.num_samples = static_cast<size_t>(num_samples);
+  std::future<void> done = request.done.get_future();
+
+  {
+    const std::lock_guard<std::mutex> lock(queue_guard_);
+    HCTR_CHECK_HINT(!terminate_, "Session is shutting down!");
+    request.enqueue_time = Clock::now();
+    queue_.emplace_back(std::move(request));
+  }
+  // Wake idle workers, and the worker that is collecting a batch.
+  queue_cv_.notify_all();
+
+  return done;
+}
+
+template <typename TypeHashKey>
+void BatchingInferenceSessionCPU<TypeHashKey>::predict(const float* const h_dense,
+                                                       const void* const h_embeddingcolumns,
+                                                       const int* const h_row_ptrs,
+                                                       float* const h_output,
+                                                       const int num_samples) {
+  predict_async(h_dense, h_embeddingcolumns, h_row_ptrs, h_output, num_samples).get();
+}
+
+template <typename TypeHashKey>
+size_t BatchingInferenceSessionCPU<TypeHashKey>::num_batches() const {
+  const std::lock_guard<std::mutex> lock(queue_guard_);
+  return num_batches_;
+}
+
+template <typename TypeHashKey>
+size_t BatchingInferenceSessionCPU<TypeHashKey>::num_requests() const {
+  const std::lock_guard<std::mutex> lock(queue_guard_);
+  return num_requests_;
+}
+
+template <typename TypeHashKey>
+std::vector<typename BatchingInferenceSessionCPU<TypeHashKey>::Request>
+BatchingInferenceSessionCPU<TypeHashKey>::next_batch_() {
+  std::unique_lock<std::mutex> lock(queue_guard_);
+
+  // Only one worker at a time assembles a batch. The others wait for their turn.
+  queue_cv_.wait(lock, [&]() { return !collecting_ && (terminate_ || !queue_.empty()); });
+  std::vector<Request> batch;
+  if (queue_.empty()) {
+    return batch;
+  }
+  collecting_ = true;
+
+  // Requests are taken in order. Stop at the first one that does not fit, or once the oldest
+  // request in the batch is due.
+  const Clock::time_point deadline = queue_.front().enqueue_time + max_batch_delay_;
+  size_t num_samples = 0;
+  while (true) {
+    while (!queue_.empty() && num_samples + queue_.front().num_samples <= max_batchsize_) {
+      num_samples += queue_.front().num_samples;
+      batch.emplace_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    if (!queue_.empty() || num_samples == max_batchsize_ || terminate_ ||
+        Clock::now() >= deadline) {
+      break;
+    }
+    queue_cv_.wait_until(lock, deadline);
+  }
+
+  collecting_ = false;
+  num_batches_++;
+  num_requests_ += batch.size();
+  lock.unlock();
+
+  // Let the next worker pick up the remaining requests.
+  queue_cv_.notify_all();
+  return batch;
+}
+
+template <typename TypeHashKey>
+void BatchingInferenceSessionCPU<TypeHashKey>::run_(Replica& replica) {
+  while (true) {
+    std::vector<Request> batch = next_batch_();
+    if (batch.empty()) {
+      break;
+    }
+    process_(replica, batch);
+  }
+}
+
+template <typename TypeHashKey>
+void BatchingInferenceSessionCPU<TypeHashKey>::process_(Replica& replica,
+                                                        std::vector<Request>& batch) {
+  try {
+    const size_t dense_dim = inference_parser_.dense_dim;
+    const size_t label_dim = inference_parser_.label_dim;
+    const std::vector<size_t>& slot_num_for_tables = inference_parser_.slot_num_for_tables;
+
+    // Dense features and keys are sample first. Hence, they can be concatenated.
+    size_t num_samples = 0;
+    size_t num_keys = 0;
+    for (const Request& request : batch) {
+      std::copy_n(request.h_dense, request.num_samples * dense_dim,
+                  &replica.dense[num_samples * dense_dim]);
+
+      size_t request_num_keys = 0;
+      const int* row_ptrs = request.h_row_ptrs;
+      for (const size_t slot_num : slot_num_for_tables) {
+        const size_t num_rows = request.num_samples * slot_num;
+        request_num_keys += static_cast<size_t>(row_ptrs[num_rows] - row_ptrs[0]);
+        row_ptrs += num_rows + 1;
+      }
+      HCTR_CHECK_HINT(num_keys + request_num_keys <= replica.keys.size(),
+                      "Too many keys in request!");
+      std::copy_n(request.h_keys, request_num_keys, &replica.keys[num_keys]);
+
+      num_samples += request.num_samples;
+      num_keys += request_num_keys;
+    }
+
+    // Row pointers are per table. Merge the row pointers of all requests for each table. In the
+    // input of a request, table i starts at num_samples * (slot_num_0 + ... + slot_num_i-1) + i.
+    int* dst = replica.row_ptrs.data();
+    size_t src_offset = 0;
+    for (size_t i = 0; i < slot_num_for_tables.size(); i++) {
+      const size_t slot_num = slot_num_for_tables[i];
+      int acc = 0;
+      *dst++ = acc;
+      for (const Request& request : batch) {
+        const size_t num_rows = request.num_samples * slot_num;
+        const int* const src = request.h_row_ptrs + request.num_samples * src_offset + i;
+        const int* const src_end = src + num_rows;
+        dst = std::transform(src + 1, src_end + 1, dst,
+                             [acc, base = *src](const int r) { return acc + r - base; });
+        acc += *src_end - *src;
+      }
+      src_offset += slot_num;
+    }
+
+    replica.session->predict(replica.dense.data(), replica.keys.data(), replica.row_ptrs.data(),
+                             replica.output.data(), static_cast<int>(num_samples));
+
+    // Scatter predictions.
+    const float* output = replica.output.data();
+    for (Request& request : batch) {
+      const size_t output_size = request.num_samples * label_dim;
+      std::copy_n(output, output_size, request.h_output);
+      output += output_size;
+    }
+  } catch (...) {
+    for (Request& request : batch) {
+      request.done.set_exception(std::current_exception());
+    }
+    return;
+  }
+
+  for (Request& request : batch) {
+    request.done.set_value();
+  }
+}
+
+template class BatchingInferenceSessionCPU<unsigned int>;
+template class BatchingInferenceSessionCPU<long long>;
+
+}  // namespace HugeCTR
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <base/debug/tracer.hpp>
 #include <cpu/layer_cpu.hpp>
 #include <cpu/layers/add_layer_cpu.hpp>
 #include <cpu/layers/batch_norm_layer_cpu.hpp>
@@ -33,7 +34,10 @@
 #include <cpu/layers/sigmoid_layer_cpu.hpp>
 #include <cpu/layers/slice_layer_cpu.hpp>
 #include <cpu/layers/weight_multiply_layer_cpu.hpp>
+#include <cpu/memory_planner_cpu.hpp>
 #include <cpu/network_cpu.hpp>
+#include <map>
+#include <set>
 
 #ifdef ENABLE_MPI
 #include <mpi.h>
@@ -43,9 +47,27 @@ namespace HugeCTR {
 
 struct InputOutputInfo {
   std::vector<TensorBag2> inputs;
+  std::vector<std::string> input_names;
   std::vector<std::string> output_names;
 };
 
+/**
+ * Graph optimizations that are applied while the layers are created. All of them are exact.
+ */
+struct GraphPlan {
+  std::set<size_t> skipped;                      // Layers that are fused into their producer.
+  std::map<size_t, std::string> fused_relu_tops;  // InnerProduct -> top of the fused ReLU.
+  std::set<size_t> fused_concats;                // Concats that their consumer reads in place.
+};
+
+/**
+ * Inputs of a Concat that is fused into the following InnerProduct.
+ */
+struct FusedConcat {
+  Tensors2<float> tensors;
+  std::vector<std::string> names;
+};
+
 static bool get_tensor_from_entries(const std::vector<TensorEntry> tensor_entries,
                                     const std::string& name, TensorBag2* bag) {
   for (const TensorEntry& entry : tensor_entries) {
@@ -79,7 +101,88 @@ static InputOutputInfo get_input_tensor_and_output_name(
     }
     bottom_bags.push_back(bag);
   }
-  return {bottom_bags, top_names};
+  return {bottom_bags, bottom_names, top_names};
+}
+
+static GraphPlan plan_graph(const nlohmann::json& j_array, bool use_mixed_precision) {
+  const auto& layer_map = use_mixed_precision ? LAYER_TYPE_MAP_MP : LAYER_TYPE_MAP;
+
+  // Dense layers, and the layers that read each tensor.
+  std::map<size_t, Layer_t> layer_types;
+  std::map<std::string, std::vector<size_t>> consumers;
+  for (size_t i = 1; i < j_array.size(); i++) {
+    const nlohmann::json& j = j_array[i];
+    Layer_t layer_type;
+    if (find_item_in_map(layer_type, get_value_from_json<std::string>(j, "type"), layer_map)) {
+      layer_types[i] = layer_type;
+      for (const std::string& bottom_name : get_layer_names(get_json(j, "bottom"))) {
+        consumers[bottom_name].push_back(i);
+      }
+    }
+  }
+
+  GraphPlan plan;
+  for (const auto& layer : layer_types) {
+    const size_t i = layer.first;
+    const std::vector<std::string> top_names = get_layer_names(get_json(j_array[i], "top"));
+    if (top_names.size() != 1) {
+      continue;
+    }
+    const auto it = consumers.find(top_names[0]);
+    if (it == consumers.end() || it->second.size() != 1) {
+      continue;
+    }
+    const size_t consumer = it->second[0];
+    const Layer_t consumer_type = layer_types.at(consumer);
+
+    // The ReLU must follow immediately. Otherwise, its output would change place in the tensor
+    // entries (the last entry is the prediction).
+    if (layer.second == Layer_t::InnerProduct && consumer_type == Layer_t::ReLU &&
+        consumer == i + 1) {
+      plan.fused_relu_tops[i] = get_layer_names(get_json(j_array[consumer], "top"))[0];
+      plan.skipped.insert(consumer);
+    } else if (layer.second == Layer_t::Concat && consumer_type == Layer_t::InnerProduct &&
+               !use_mixed_precision) {
+      plan.fused_concats.insert(i);
+    }
+  }
+  return plan;
+}
+
+/**
+ * A reshape without selection only changes the dimensions. Hence, its output can be a view of the
+ * input. Returns false for invalid shapes, which are then reported by the layer.
+ */
+template <typename T>
+static bool reshape_view(const Tensor2<T>& in_tensor, size_t leading_dim, Tensor2<T>* out_tensor) {
+  const size_t n_in_elems = in_tensor.get_num_elements();
+  const size_t in_width = in_tensor.get_dimensions().back();
+  if (leading_dim < in_width || leading_dim % in_width != 0 || leading_dim > n_in_elems ||
+      n_in_elems % leading_dim != 0) {
+    return false;
+  }
+  *out_tensor = Tensor2<T>({n_in_elems / leading_dim, leading_dim}, in_tensor.get_buffer());
+  return true;
+}
+
+/**
+ * Slices that span the whole input are copies of it (e.g., to feed several branches). Hence, they
+ * can be views of the input.
+ */
+template <typename T>
+static bool slice_views(const Tensor2<T>& in_tensor, const std::vector<std::pair<int, int>>& ranges,
+                        Tensors2<T>* out_tensors) {
+  const auto& in_dims = in_tensor.get_dimensions();
+  if (in_dims.size() != 2 || ranges.empty()) {
+    return false;
+  }
+  for (const auto& range : ranges) {
+    if (range.first != 0 || static_cast<size_t>(range.second) != in_dims[1]) {
+      return false;
+    }
+  }
+  out_tensors->assign(ranges.size(), in_tensor);
+  return true;
 }
 
 void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tensor_entries,
@@ -88,11 +191,43 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
                    const std::shared_ptr<BufferBlock2<__half>>& weight_buff_half,
                    const std::shared_ptr<BufferBlock2<float>>& wgrad_buff,
                    const std::shared_ptr<BufferBlock2<__half>>& wgrad_buff_half,
-                   bool use_mixed_precision, std::vector<std::unique_ptr<LayerCPU>>& layers) {
+                   bool use_mixed_precision, bool optimize_graph, MemoryPlannerCPU& planner,
+                   std::vector<std::unique_ptr<LayerCPU>>& layers,
+                   std::vector<std::string>& layer_names) {
+  const GraphPlan plan = optimize_graph ? plan_graph(j_array, use_mixed_precision) : GraphPlan();
+
+  // Output tensors reserved below are planned by liveness if the graph is optimized. Views share
+  // the id of their source. Tensors that layers reserve internally remain in blobs_buff.
+  std::map<std::string, size_t> planned_tensors;
+  std::map<std::string, FusedConcat> fused_concats;
+  std::vector<size_t> reserved_ids;
+  size_t num_views = 0;
+  unsigned int step = 0;
+  const auto reserve_output = [&](const std::vector<size_t>& dimensions, auto* tensor) {
+    if (optimize_graph) {
+      reserved_ids.push_back(planner.reserve(dimensions, step, tensor));
+    } else {
+      blobs_buff->reserve(dimensions, tensor);
+    }
+  };
+  const auto use_tensor = [&](const std::string& name) {
+    const auto it = planned_tensors.find(name);
+    if (it != planned_tensors.end()) {
+      planner.use(it->second, step);
+    }
+  };
+
   for (unsigned int i = 1; i < j_array.size(); i++) {
     const nlohmann::json& j = j_array[i];
     const auto layer_type_name = get_value_from_json<std::string>(j, "type");
     Layer_t layer_type;
+    if (plan.skipped.count(i)) {
+      continue;
+    }
+    step = i;
+    reserved_ids.clear();
+    bool is_view = false;
+    const bool fuse_relu = plan.fused_relu_tops.count(i) != 0;
 
     const auto& layer_map = use_mixed_precision ? LAYER_TYPE_MAP_MP : LAYER_TYPE_MAP;
 
@@ -110,6 +245,16 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         layer_type == Layer_t::MultiCrossEntropyLoss) {
       HCTR_OWN_THROW(Error_t::WrongInput, "Loss layer is not supported for NetworkCPU");
     }
+    for (const std::string& name : input_output_info.input_names) {
+      const auto fused_concat = fused_concats.find(name);
+      if (fused_concat != fused_concats.end()) {
+        for (const std::string& concat_input_name : fused_concat->second.names) {
+          use_tensor(concat_input_name);
+        }
+      } else {
+        use_tensor(name);
+      }
+    }
     switch (layer_type) {
       case Layer_t::BatchNorm: {
         // get BN params
@@ -141,7 +286,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           Tensor2<__half> bn_in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           // establish out tensor
           Tensor2<__half> bn_out_tensor;
-          blobs_buff->reserve(bn_in_tensor.get_dimensions(), &bn_out_tensor);
+          reserve_output(bn_in_tensor.get_dimensions(), &bn_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], bn_out_tensor.shrink()});
 
@@ -152,7 +297,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           Tensor2<float> bn_in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           // establish out tensor
           Tensor2<float> bn_out_tensor;
-          blobs_buff->reserve(bn_in_tensor.get_dimensions(), &bn_out_tensor);
+          reserve_output(bn_in_tensor.get_dimensions(), &bn_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], bn_out_tensor.shrink()});
 
@@ -176,6 +321,13 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           for (const TensorBag2& bag : input_output_info.inputs) {
             in_tensors.push_back(Tensor2<float>::stretch_from(bag));
           }
+          if (plan.fused_concats.count(i)) {
+            // The consumer reads the inputs directly. The entry only resolves the name.
+            fused_concats[input_output_info.output_names[0]] = {in_tensors,
+                                                                input_output_info.input_names};
+            output_tensor_entries.push_back({input_output_info.output_names[0], TensorBag2()});
+            break;
+          }
           Tensor2<float> out_tensor;
           layers.emplace_back(new ConcatLayerCPU<float>(in_tensors, out_tensor, blobs_buff));
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
@@ -183,11 +335,18 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         break;
       }
       case Layer_t::Dropout: {
+        // Dropout is the identity in inference.
+        if (optimize_graph) {
+          output_tensor_entries.push_back(
+              {input_output_info.output_names[0], input_output_info.inputs[0]});
+          is_view = true;
+          break;
+        }
         if (use_mixed_precision) {
           Tensor2<__half> do_in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           // establish out tensor
           Tensor2<__half> do_out_tensor;
-          blobs_buff->reserve(do_in_tensor.get_dimensions(), &do_out_tensor);
+          reserve_output(do_in_tensor.get_dimensions(), &do_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], do_out_tensor.shrink()});
           // get ELU params
@@ -199,7 +358,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           // establish out tensor
           Tensor2<float> do_in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           Tensor2<float> do_out_tensor;
-          blobs_buff->reserve(do_in_tensor.get_dimensions(), &do_out_tensor);
+          reserve_output(do_in_tensor.get_dimensions(), &do_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], do_out_tensor.shrink()});
           // get ELU params
@@ -217,7 +376,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
 
           // establish out tensor
           Tensor2<__half> elu_out_tensor;
-          blobs_buff->reserve(elu_in_tensor.get_dimensions(), &elu_out_tensor);
+          reserve_output(elu_in_tensor.get_dimensions(), &elu_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], elu_out_tensor.shrink()});
           // get ELU params
@@ -230,7 +389,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
 
           // establish out tensor
           Tensor2<float> elu_out_tensor;
-          blobs_buff->reserve(elu_in_tensor.get_dimensions(), &elu_out_tensor);
+          reserve_output(elu_in_tensor.get_dimensions(), &elu_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], elu_out_tensor.shrink()});
           // get ELU params
@@ -268,7 +427,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         if (use_mixed_precision) {
           Tensor2<__half> in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensor2<__half> fc_out_tensor;
-          blobs_buff->reserve({(in_tensor.get_dimensions())[0], output}, &fc_out_tensor);
+          reserve_output({(in_tensor.get_dimensions())[0], output}, &fc_out_tensor);
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], fc_out_tensor.shrink()});
 
@@ -286,13 +445,13 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         if (use_mixed_precision) {
           Tensor2<float> in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           Tensor2<__half> out_tensor;
-          blobs_buff->reserve(in_tensor.get_dimensions(), &out_tensor);
+          reserve_output(in_tensor.get_dimensions(), &out_tensor);
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
           layers.emplace_back(new CastLayerCPU<float, __half>(in_tensor, out_tensor));
         } else {
           Tensor2<__half> in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensor2<float> out_tensor;
-          blobs_buff->reserve(in_tensor.get_dimensions(), &out_tensor);
+          reserve_output(in_tensor.get_dimensions(), &out_tensor);
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
           layers.emplace_back(new CastLayerCPU<__half, float>(in_tensor, out_tensor));
         }
@@ -328,21 +487,25 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         if (use_mixed_precision) {
           Tensor2<__half> in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensor2<__half> fc_out_tensor;
-          blobs_buff->reserve({in_tensor.get_dimensions()[0], output}, &fc_out_tensor);
+          reserve_output({in_tensor.get_dimensions()[0], output}, &fc_out_tensor);
 
           // establish layer
-          layers.emplace_back(new FullyConnectedLayerCPU<__half>(weight_buff, weight_buff_half,
-                                                                 wgrad_buff_half, blobs_buff,
-                                                                 in_tensor, fc_out_tensor));
+          layers.emplace_back(new FullyConnectedLayerCPU<__half>(
+              weight_buff, weight_buff_half, wgrad_buff_half, blobs_buff, in_tensor, fc_out_tensor,
+              fuse_relu));
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], fc_out_tensor.shrink()});
         } else {
-          Tensor2<float> in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
+          const auto fused_concat = fused_concats.find(input_output_info.input_names[0]);
+          const Tensors2<float> in_tensors =
+              fused_concat != fused_concats.end()
+                  ? fused_concat->second.tensors
+                  : Tensors2<float>{Tensor2<float>::stretch_from(input_output_info.inputs[0])};
           Tensor2<float> fc_out_tensor;
-          blobs_buff->reserve({in_tensor.get_dimensions()[0], output}, &fc_out_tensor);
+          reserve_output({in_tensors[0].get_dimensions()[0], output}, &fc_out_tensor);
           // establish layer
           layers.emplace_back(new FullyConnectedLayerCPU<float>(
-              weight_buff, wgrad_buff, in_tensor, fc_out_tensor, use_mixed_precision));
+              weight_buff, wgrad_buff, in_tensors, fc_out_tensor, use_mixed_precision, fuse_relu));
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], fc_out_tensor.shrink()});
         }
@@ -400,13 +563,19 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
 
         // establish out tensor
         auto num_layers = get_value_from_json<int>(j_mc_param, "num_layers");
+        // DCNv2 if a projection_dim is given, as in MultiCrossLayer
+        auto projection_dim = get_value_from_json_soft<int>(j_mc_param, "projection_dim", 0);
+        if (projection_dim < 0) {
+          HCTR_OWN_THROW(Error_t::WrongInput, "projection_dim must not be negative");
+        }
         Tensor2<float> mc_in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
         Tensor2<float> out_tensor;
-        blobs_buff->reserve(mc_in_tensor.get_dimensions(), &out_tensor);
+        reserve_output(mc_in_tensor.get_dimensions(), &out_tensor);
         output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
         // establish layer
         layers.emplace_back(new MultiCrossLayerCPU(weight_buff, wgrad_buff, blobs_buff,
-                                                   mc_in_tensor, out_tensor, num_layers));
+                                                   mc_in_tensor, out_tensor, num_layers,
+                                                   projection_dim));
         break;
       }
       case Layer_t::ReLU: {
@@ -414,7 +583,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           Tensor2<__half> relu_in_tensor =
               Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensor2<__half> relu_out_tensor;
-          blobs_buff->reserve(relu_in_tensor.get_dimensions(), &relu_out_tensor);
+          reserve_output(relu_in_tensor.get_dimensions(), &relu_out_tensor);
           layers.emplace_back(new ReluLayerCPU<__half>(relu_in_tensor, relu_out_tensor));
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], relu_out_tensor.shrink()});
@@ -422,7 +591,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           // establish out tensor
           Tensor2<float> relu_in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           Tensor2<float> relu_out_tensor;
-          blobs_buff->reserve(relu_in_tensor.get_dimensions(), &relu_out_tensor);
+          reserve_output(relu_in_tensor.get_dimensions(), &relu_out_tensor);
           layers.emplace_back(new ReluLayerCPU<float>(relu_in_tensor, relu_out_tensor));
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], relu_out_tensor.shrink()});
@@ -473,8 +642,11 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
             size_t leading_dim = (leading_dim_it != j.end())
                                      ? (*leading_dim_it).get<int>()
                                      : in_tensor.get_num_elements() / in_dims[0];
-            layers.emplace_back(
-                new ReshapeLayerCPU<__half>(in_tensor, out_tensor, blobs_buff, leading_dim));
+            is_view = optimize_graph && reshape_view(in_tensor, leading_dim, &out_tensor);
+            if (!is_view) {
+              layers.emplace_back(
+                  new ReshapeLayerCPU<__half>(in_tensor, out_tensor, blobs_buff, leading_dim));
+            }
             output_tensor_entries.push_back(
                 {input_output_info.output_names[0], out_tensor.shrink()});
           } else {
@@ -484,8 +656,11 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
             size_t leading_dim = (leading_dim_it != j.end())
                                      ? (*leading_dim_it).get<int>()
                                      : in_tensor.get_num_elements() / in_dims[0];
-            layers.emplace_back(
-                new ReshapeLayerCPU<float>(in_tensor, out_tensor, blobs_buff, leading_dim));
+            is_view = optimize_graph && reshape_view(in_tensor, leading_dim, &out_tensor);
+            if (!is_view) {
+              layers.emplace_back(
+                  new ReshapeLayerCPU<float>(in_tensor, out_tensor, blobs_buff, leading_dim));
+            }
             output_tensor_entries.push_back(
                 {input_output_info.output_names[0], out_tensor.shrink()});
           }
@@ -497,7 +672,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           Tensor2<__half> sigmoid_in_tensor =
               Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensor2<__half> sigmoid_out_tensor;
-          blobs_buff->reserve(sigmoid_in_tensor.get_dimensions(), &sigmoid_out_tensor);
+          reserve_output(sigmoid_in_tensor.get_dimensions(), &sigmoid_out_tensor);
           layers.emplace_back(new SigmoidLayerCPU<__half>(sigmoid_in_tensor, sigmoid_out_tensor));
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], sigmoid_out_tensor.shrink()});
@@ -506,7 +681,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
           Tensor2<float> sigmoid_in_tensor =
               Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           Tensor2<float> sigmoid_out_tensor;
-          blobs_buff->reserve(sigmoid_in_tensor.get_dimensions(), &sigmoid_out_tensor);
+          reserve_output(sigmoid_in_tensor.get_dimensions(), &sigmoid_out_tensor);
           layers.emplace_back(new SigmoidLayerCPU<float>(sigmoid_in_tensor, sigmoid_out_tensor));
           output_tensor_entries.push_back(
               {input_output_info.output_names[0], sigmoid_out_tensor.shrink()});
@@ -525,8 +700,11 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         if (use_mixed_precision) {
           Tensor2<__half> in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensors2<__half> out_tensors;
-          layers.emplace_back(
-              new SliceLayerCPU<__half>(in_tensor, out_tensors, blobs_buff, ranges));
+          is_view = optimize_graph && slice_views(in_tensor, ranges, &out_tensors);
+          if (!is_view) {
+            layers.emplace_back(
+                new SliceLayerCPU<__half>(in_tensor, out_tensors, blobs_buff, ranges));
+          }
           for (size_t i = 0; i < out_tensors.size(); i++) {
             output_tensor_entries.push_back(
                 {input_output_info.output_names[i], out_tensors[i].shrink()});
@@ -534,7 +712,11 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         } else {
           Tensor2<float> in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           Tensors2<float> out_tensors;
-          layers.emplace_back(new SliceLayerCPU<float>(in_tensor, out_tensors, blobs_buff, ranges));
+          is_view = optimize_graph && slice_views(in_tensor, ranges, &out_tensors);
+          if (!is_view) {
+            layers.emplace_back(
+                new SliceLayerCPU<float>(in_tensor, out_tensors, blobs_buff, ranges));
+          }
           for (size_t i = 0; i < out_tensors.size(); i++) {
             output_tensor_entries.push_back(
                 {input_output_info.output_names[i], out_tensors[i].shrink()});
@@ -583,14 +765,14 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
         if (use_mixed_precision) {
           Tensor2<__half> in_tensor = Tensor2<__half>::stretch_from(input_output_info.inputs[0]);
           Tensor2<__half> out_tensor;
-          blobs_buff->reserve({in_tensor.get_dimensions()[0], out_dim}, &out_tensor);
+          reserve_output({in_tensor.get_dimensions()[0], out_dim}, &out_tensor);
 
           layers.emplace_back(new FmOrder2LayerCPU<__half>(in_tensor, out_tensor));
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
         } else {
           Tensor2<float> in_tensor = Tensor2<float>::stretch_from(input_output_info.inputs[0]);
           Tensor2<float> out_tensor;
-          blobs_buff->reserve({in_tensor.get_dimensions()[0], out_dim}, &out_tensor);
+          reserve_output({in_tensor.get_dimensions()[0], out_dim}, &out_tensor);
 
           layers.emplace_back(new FmOrder2LayerCPU<float>(in_tensor, out_tensor));
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
@@ -604,7 +786,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
             in_tensors.push_back(Tensor2<__half>::stretch_from(bag));
           }
           Tensor2<__half> out_tensor;
-          blobs_buff->reserve(in_tensors[0].get_dimensions(), &out_tensor);
+          reserve_output(in_tensors[0].get_dimensions(), &out_tensor);
           layers.emplace_back(new AddLayerCPU<__half>(in_tensors, out_tensor, blobs_buff));
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
         } else {
@@ -613,7 +795,7 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
             in_tensors.push_back(Tensor2<float>::stretch_from(bag));
           }
           Tensor2<float> out_tensor;
-          blobs_buff->reserve(in_tensors[0].get_dimensions(), &out_tensor);
+          reserve_output(in_tensors[0].get_dimensions(), &out_tensor);
           layers.emplace_back(new AddLayerCPU<float>(in_tensors, out_tensor, blobs_buff));
           output_tensor_entries.push_back({input_output_info.output_names[0], out_tensor.shrink()});
         }
@@ -640,11 +822,37 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
       default:
         assert(!"Error: no such layer && should never get here!");
     }  // end of switch
-
+    layer_names.resize(layers.size(), has_key_(j, "name")
+                                          ? get_value_from_json<std::string>(j, "name")
+                                          : layer_type_name);
+
+    num_views += is_view;
+    // The fused ReLU writes to the output of the InnerProduct.
+    if (fuse_relu) {
+      output_tensor_entries.push_back(
+          {plan.fused_relu_tops.at(i), output_tensor_entries.back().bag});
+    }
     for (auto& output_tensor_entry : output_tensor_entries) {
+      if (is_view) {
+        const auto source = planned_tensors.find(input_output_info.input_names[0]);
+        if (source != planned_tensors.end()) {
+          planned_tensors[output_tensor_entry.name] = source->second;
+        }
+      } else if (reserved_ids.size() == 1) {
+        planned_tensors[output_tensor_entry.name] = reserved_ids[0];
+      }
       tensor_entries.push_back(output_tensor_entry);
     }
   }  // for layers
+
+  // The prediction must survive all layers.
+  step = j_array.size();
+  use_tensor(tensor_entries.back().name);
+  if (optimize_graph) {
+    HCTR_LOG_S(INFO, ROOT) << "NetworkCPU: fused " << plan.skipped.size() << " ReLU and "
+                           << plan.fused_concats.size() << " Concat layers, " << num_views
+                           << " layers replaced by views." << std::endl;
+  }
   for (auto entry : tensor_entries) {
     HCTR_LOG_S(INFO, WORLD) << "layer: " << entry.name << std::endl;
   }
@@ -657,8 +865,9 @@ void create_layers(const nlohmann::json& j_array, std::vector<TensorEntry>& tens
 NetworkCPU* NetworkCPU::create_network(const nlohmann::json& j_array,
                                        std::vector<TensorEntry>& tensor_entries,
                                        const std::shared_ptr<CPUResource>& cpu_resource,
-                                       bool use_mixed_precision) {
-  NetworkCPU* network = new NetworkCPU(cpu_resource, use_mixed_precision);
+                                       bool use_mixed_precision, bool use_int8,
+                                       bool optimize_graph) {
+  NetworkCPU* network = new NetworkCPU(cpu_resource, use_mixed_precision, use_int8);
 
   auto& layers = network->layers_;
 
@@ -671,8 +880,14 @@ NetworkCPU* NetworkCPU::create_network(const nlohmann::json& j_array,
   std::shared_ptr<BufferBlock2<__half>> wgrad_buff_half = blobs_buff->create_block<__half>();
 
   // create layers
+  MemoryPlannerCPU planner;
+  std::vector<std::string> layer_names;
   create_layers(j_array, tensor_entries, blobs_buff, weight_buff, weight_buff_half, wgrad_buff,
-                wgrad_buff_half, use_mixed_precision, layers);
+                wgrad_buff_half, use_mixed_precision, optimize_graph, planner, layers,
+                layer_names);
+  for (const std::string& layer_name : layer_names) {
+    network->layer_trace_names_.emplace_back(Tracer::get().intern(layer_name));
+  }
 
   TensorEntry pred_tensor_entry = tensor_entries.back();
   network->pred_tensor_ = Tensor2<float>::stretch_from(pred_tensor_entry.bag);
@@ -681,6 +896,13 @@ NetworkCPU* NetworkCPU::create_network(const nlohmann::json& j_array,
   network->wgrad_tensor_ = wgrad_buff->as_tensor();
   network->wgrad_tensor_half_ = wgrad_buff_half->as_tensor();
   blobs_buff->allocate();
+  planner.allocate();
+  network->buffer_size_in_bytes_ = blobs_buff->get_size_in_bytes() + planner.get_size_in_bytes();
+  if (optimize_graph) {
+    HCTR_LOG_S(INFO, ROOT) << "NetworkCPU: planned activations need " << planner.get_size_in_bytes()
+                           << " bytes instead of " << planner.get_reserved_size_in_bytes()
+                           << " bytes." << std::endl;
+  }
 
   return network;
 }
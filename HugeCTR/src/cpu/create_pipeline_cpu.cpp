@@ -53,7 +53,8 @@ void create_pipeline_inference_cpu(const nlohmann::json& config,
   input_buffer->allocate();
 
   *network = NetworkCPU::create_network(j_layers_array, tensor_entries, cpu_resource,
-                                        inference_params.use_mixed_precision);
+                                        inference_params.use_mixed_precision,
+                                        inference_params.use_int8_dense);
 }
 
 void create_pipeline_cpu(const nlohmann::json& config, std::map<std::string, bool> tensor_active,
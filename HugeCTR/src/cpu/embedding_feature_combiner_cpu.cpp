@@ -16,7 +16,9 @@
 
 #include <algorithm>
 #include <cpu/embedding_feature_combiner_cpu.hpp>
+#include <cstring>
 #include <functional>
+#include <type_traits>
 #include <utils.hpp>
 
 #ifndef NDEBUG
@@ -27,54 +29,64 @@ namespace HugeCTR {
 
 namespace {
 
+inline void accumulate(float* const acc, const float* const vec, const int embedding_vec_size) {
+#pragma omp simd
+  for (int k = 0; k < embedding_vec_size; k++) {
+    acc[k] += vec[k];
+  }
+}
+
+// Vectors are summed up in place for fp32 outputs, and in a temporary row otherwise.
 template <typename TypeEmbedding>
-void embedding_feature_combine_cpu(const float* input, TypeEmbedding* output, const int* row_ptrs,
-                                   int batch_size, int slot_num, int embedding_vec_size,
-                                   EmbeddingFeatureCombiner_t combiner_type) {
-  for (int i = 0; i < batch_size; i++) {
-    for (int j = 0; j < slot_num; j++) {
-      int feature_row_index = i * slot_num + j;
-      int row_offset = row_ptrs[feature_row_index];  // row offset within input
-      int feature_num =
-          row_ptrs[feature_row_index + 1] - row_offset;  // num of feature vectors in one slot
-
-      for (int k = 0; k < embedding_vec_size; k++) {
-        float tmp = 0.0f;
-        for (int l = 0; l < feature_num; l++) {
-          tmp += input[(row_offset + l) * embedding_vec_size + k];
-        }  // end for l
-        if (combiner_type == EmbeddingFeatureCombiner_t::Mean) tmp /= feature_num;
-        output[feature_row_index * embedding_vec_size + k] = tmp;
-      }  // end for k
-    }    // end for j
-  }      // end for i
+inline float* begin_row(TypeEmbedding* const out_row, std::vector<float>& acc_row,
+                        const int embedding_vec_size) {
+  float* const acc = std::is_same_v<TypeEmbedding, float> ? reinterpret_cast<float*>(out_row)
+                                                           : acc_row.data();
+  std::fill_n(acc, embedding_vec_size, 0.0f);
+  return acc;
+}
+
+template <typename TypeEmbedding>
+inline void end_row(float* const acc, const int feature_num, const int embedding_vec_size,
+                    const EmbeddingFeatureCombiner_t combiner_type, TypeEmbedding* const out_row) {
+  if (combiner_type == EmbeddingFeatureCombiner_t::Mean && feature_num > 1) {
+    const float n = static_cast<float>(feature_num);
+#pragma omp simd
+    for (int k = 0; k < embedding_vec_size; k++) {
+      acc[k] /= n;
+    }
+  }
+  if constexpr (!std::is_same_v<TypeEmbedding, float>) {
+    for (int k = 0; k < embedding_vec_size; k++) {
+      out_row[k] = __float2half(acc[k]);
+    }
+  }
 }
 
-template <>
-void embedding_feature_combine_cpu(const float* input, __half* output, const int* row_ptrs,
+// The input holds the vectors of the keys starting at key_offset.
+template <typename TypeEmbedding>
+void embedding_feature_combine_cpu(const float* input, TypeEmbedding* output, const int* row_ptrs,
                                    int batch_size, int slot_num, int embedding_vec_size,
-                                   EmbeddingFeatureCombiner_t combiner_type) {
-  for (int i = 0; i < batch_size; i++) {
-    for (int j = 0; j < slot_num; j++) {
-      int feature_row_index = i * slot_num + j;
-      int row_offset = row_ptrs[feature_row_index];  // row offset within input
-      int feature_num =
-          row_ptrs[feature_row_index + 1] - row_offset;  // num of feature vectors in one slot
-
-      for (int k = 0; k < embedding_vec_size; k++) {
-        float tmp = 0.0f;
-        for (int l = 0; l < feature_num; l++) {
-          tmp += __half2float(input[(row_offset + l) * embedding_vec_size + k]);
-        }  // end for l
-        if (combiner_type == EmbeddingFeatureCombiner_t::Mean && feature_num > 1) {
-          tmp /= feature_num;
-        }
-        output[feature_row_index * embedding_vec_size + k] = __float2half(tmp);
-      }  // end for k
-    }    // end for j
-  }      // end for i
+                                   EmbeddingFeatureCombiner_t combiner_type, int key_offset = 0) {
+  std::vector<float> acc_row(embedding_vec_size);
+  for (int i = 0; i < batch_size * slot_num; i++) {
+    const int row_offset = row_ptrs[i] - key_offset;        // row offset within input
+    const int feature_num = row_ptrs[i + 1] - row_ptrs[i];  // num of feature vectors in one slot
+
+    // Vectors are added one by one, so that the inner loop runs over contiguous memory.
+    TypeEmbedding* const out_row = &output[static_cast<size_t>(i) * embedding_vec_size];
+    float* const acc = begin_row(out_row, acc_row, embedding_vec_size);
+    for (int l = 0; l < feature_num; l++) {
+      accumulate(acc, &input[static_cast<size_t>(row_offset + l) * embedding_vec_size],
+                 embedding_vec_size);
+    }
+    end_row(acc, feature_num, embedding_vec_size, combiner_type, out_row);
+  }
 }
 
+// Fused lookup: Size of one chunk of embedding vectors.
+constexpr size_t lookup_chunk_bytes = 4 * 1024 * 1024;
+
 }  // end of namespace
 
 template <typename TypeEmbedding>
@@ -135,6 +147,45 @@ void EmbeddingFeatureCombinerCPU<TypeEmbedding>::fprop(bool is_train) {
                                 embedding_vec_size_, combiner_type_);
 }
 
+template <typename TypeEmbedding>
+void EmbeddingFeatureCombinerCPU<TypeEmbedding>::fprop_fused(const EmbeddingLookupFunc& lookup,
+                                                             const int num_samples) {
+  TypeEmbedding* const output = out_tensors_[0].get_ptr();
+  const int* const row_ptrs = row_ptrs_tensors_[0]->get_ptr();
+  const int num_rows = std::min(num_samples, batch_size_) * slot_num_;
+
+  // Vectors are fetched in chunks of whole rows, and pooled into the output right away, so that
+  // they are still in cache when they are accumulated. Each lookup has a fixed cost in the
+  // parameter server, so chunks must not get too small either.
+  const size_t max_chunk_keys =
+      std::max(lookup_chunk_bytes / (embedding_vec_size_ * sizeof(float)), size_t{1});
+  for (int first_row = 0; first_row < num_rows;) {
+    const int key_offset = row_ptrs[first_row];
+    const int* const chunk_end = std::upper_bound(&row_ptrs[first_row + 1], &row_ptrs[num_rows + 1],
+                                                  key_offset + static_cast<int>(max_chunk_keys));
+    const int end_row = std::max(static_cast<int>(chunk_end - row_ptrs) - 1, first_row + 1);
+
+    // A single row may exceed the chunk size.
+    const size_t num_keys = row_ptrs[end_row] - key_offset;
+    if (lookup_buffer_.size() < num_keys * embedding_vec_size_) {
+      lookup_buffer_.resize(num_keys * embedding_vec_size_);
+    }
+    if (num_keys > 0) {
+      lookup(num_keys, lookup_buffer_.data());
+    }
+    embedding_feature_combine_cpu(lookup_buffer_.data(),
+                                  &output[static_cast<size_t>(first_row) * embedding_vec_size_],
+                                  &row_ptrs[first_row], end_row - first_row, 1, embedding_vec_size_,
+                                  combiner_type_, key_offset);
+    first_row = end_row;
+  }
+
+  // Padding samples.
+  const size_t num_out = static_cast<size_t>(batch_size_) * slot_num_ * embedding_vec_size_;
+  const size_t num_valid = static_cast<size_t>(num_rows) * embedding_vec_size_;
+  std::memset(&output[num_valid], 0, (num_out - num_valid) * sizeof(TypeEmbedding));
+}
+
 template class EmbeddingFeatureCombinerCPU<float>;
 template class EmbeddingFeatureCombinerCPU<__half>;
 
@@ -21,6 +21,21 @@
 #include <vector>
 namespace HugeCTR {
 
+namespace {
+
+void combine_embedding_features(LayerCPU* const layer, const EmbeddingLookupFunc& lookup,
+                                const int num_samples) {
+  if (auto combiner = dynamic_cast<EmbeddingFeatureCombinerCPU<float>*>(layer)) {
+    combiner->fprop_fused(lookup, num_samples);
+  } else if (auto combiner = dynamic_cast<EmbeddingFeatureCombinerCPU<__half>*>(layer)) {
+    combiner->fprop_fused(lookup, num_samples);
+  } else {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "unsupported embedding feature combiner");
+  }
+}
+
+}  // namespace
+
 template <typename TypeHashKey>
 InferenceSessionCPU<TypeHashKey>::InferenceSessionCPU(
     const std::string& model_config_path, const InferenceParams& inference_params,
@@ -47,11 +62,9 @@ InferenceSessionCPU<TypeHashKey>::InferenceSessionCPU(
 
     // allocate memory for embedding vector lookup
     // h_keys_ is a void pointer, which serves key types of both long long and unsigned int
+    // embedding vectors are staged and pooled by the feature combiner of each table
     h_keys_ = malloc(inference_params_.max_batchsize *
                      inference_parser_.max_feature_num_per_sample * sizeof(long long));
-    h_embedding_vectors_ =
-        (float*)malloc(inference_params_.max_batchsize *
-                       inference_parser_.max_embedding_vector_size_per_sample * sizeof(float));
   } catch (const std::runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -59,10 +72,7 @@ InferenceSessionCPU<TypeHashKey>::InferenceSessionCPU(
 }
 
 template <typename TypeHashKey>
-InferenceSessionCPU<TypeHashKey>::~InferenceSessionCPU() {
-  free(h_embedding_vectors_);
-  free(h_keys_);
-}
+InferenceSessionCPU<TypeHashKey>::~InferenceSessionCPU() { free(h_keys_); }
 
 template <typename TypeHashKey>
 void InferenceSessionCPU<TypeHashKey>::predict(float* h_dense, void* h_embeddingcolumns,
@@ -85,29 +95,6 @@ void InferenceSessionCPU<TypeHashKey>::predict(float* h_dense, void* h_embedding
                               num_samples, inference_parser_.slot_num_for_tables);
   }
 
-  // parameter server lookup
-  size_t acc_vectors_offset{0};
-  size_t acc_row_ptrs_offset{0};
-  size_t acc_keys_offset{0};
-  size_t num_keys{0};
-  for (size_t i = 0; i < num_embedding_tables; ++i) {
-    acc_row_ptrs_offset += num_samples * inference_parser_.slot_num_for_tables[i] + 1;
-    num_keys = h_row_ptrs[acc_row_ptrs_offset - 1];
-    if (inference_params_.i64_input_key) {
-      parameter_server_->lookup(static_cast<const long long*>(h_keys_) + acc_keys_offset, num_keys,
-                                h_embedding_vectors_ + acc_vectors_offset,
-                                inference_params_.model_name, i);
-    } else {
-      parameter_server_->lookup(static_cast<const unsigned int*>(h_keys_) + acc_keys_offset,
-                                num_keys, h_embedding_vectors_ + acc_vectors_offset,
-                                inference_params_.model_name, i);
-    }
-    acc_keys_offset += num_keys;
-    acc_vectors_offset += inference_params_.max_batchsize *
-                          inference_parser_.max_feature_num_for_tables[i] *
-                          inference_parser_.embed_vec_size_for_tables[i];
-  }
-
   // copy dense input to dense tensor
   auto dense_dims = dense_input_tensor_.get_dimensions();
   size_t dense_size = 1;
@@ -117,8 +104,11 @@ void InferenceSessionCPU<TypeHashKey>::predict(float* h_dense, void* h_embedding
   size_t dense_size_in_bytes = dense_size * sizeof(float);
   memcpy(dense_input_tensor_.get_ptr(), h_dense, dense_size_in_bytes);
 
-  acc_vectors_offset = 0;
-  acc_row_ptrs_offset = 0;
+  // parameter server lookup fused with the feature combiners (embedding bag)
+  const size_t key_size =
+      inference_params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int);
+  size_t acc_row_ptrs_offset{0};
+  size_t acc_keys_offset{0};
   for (size_t i = 0; i < num_embedding_tables; ++i) {
     // bind row ptrs input to row ptrs tensor
     auto row_ptrs_dims = row_ptrs_tensors_[i]->get_dimensions();
@@ -126,18 +116,18 @@ void InferenceSessionCPU<TypeHashKey>::predict(float* h_dense, void* h_embedding
         PreallocatedBuffer2<int>::create(h_row_ptrs + acc_row_ptrs_offset, row_ptrs_dims);
     bind_tensor_to_buffer(row_ptrs_dims, row_ptrs_buff, row_ptrs_tensors_[i]);
     acc_row_ptrs_offset += num_samples * inference_parser_.slot_num_for_tables[i] + 1;
+    const size_t num_keys = h_row_ptrs[acc_row_ptrs_offset - 1];
 
-    // bind embedding vectors from looking up to embedding features tensor
-    auto embedding_features_dims = embedding_features_tensors_[i]->get_dimensions();
-    std::shared_ptr<TensorBuffer2> embeddding_features_buff = PreallocatedBuffer2<float>::create(
-        h_embedding_vectors_ + acc_vectors_offset, embedding_features_dims);
-    bind_tensor_to_buffer(embedding_features_dims, embeddding_features_buff,
-                          embedding_features_tensors_[i]);
-    acc_vectors_offset += inference_params_.max_batchsize *
-                          inference_parser_.max_feature_num_for_tables[i] *
-                          inference_parser_.embed_vec_size_for_tables[i];
-    // feature combiner feedforward
-    embedding_feature_combiners_[i]->fprop(false);
+    // lookup the embedding vectors of the table chunk by chunk, and pool them
+    const char* next_keys = static_cast<const char*>(h_keys_) + acc_keys_offset * key_size;
+    combine_embedding_features(
+        embedding_feature_combiners_[i].get(),
+        [&](const size_t count, float* const vectors) {
+          parameter_server_->lookup(next_keys, count, vectors, inference_params_.model_name, i);
+          next_keys += count * key_size;
+        },
+        num_samples);
+    acc_keys_offset += num_keys;
   }
 
   // dense network feedforward
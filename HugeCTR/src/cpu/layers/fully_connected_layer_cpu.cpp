@@ -16,6 +16,7 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <cpu/layers/fully_connected_layer_cpu.hpp>
 #include <utils.hpp>
 #include <vector>
@@ -24,19 +25,20 @@ namespace HugeCTR {
 
 namespace {
 
-void cpu_mm(float* a, float* b, float* c, int m, int k, int n) {
+void cpu_mm(float* a, float* b, float* c, int m, int k, int n, bool accumulate) {
   for (int i = 0; i < m; ++i) {
     for (int j = 0; j < n; ++j) {
-      c[i * n + j] = 0.0f;
+      if (!accumulate) c[i * n + j] = 0.0f;
       for (int kk = 0; kk < k; ++kk) c[i * n + j] += a[i * k + kk] * b[kk * n + j];
     }
   }
 }
 
-void cpu_add_bias(float* out, float* bias, int m, int n) {
+void cpu_add_bias(float* out, float* bias, int m, int n, bool relu) {
   for (int i = 0; i < m; ++i) {
     for (int j = 0; j < n; ++j) {
-      out[i * n + j] += bias[j];
+      const float t = out[i * n + j] + bias[j];
+      out[i * n + j] = (relu && t < 0.0f) ? 0.0f : t;
     }
   }
 }
@@ -53,23 +55,35 @@ void transpose(float* a, int m, int n) {
 FullyConnectedLayerCPU<float>::FullyConnectedLayerCPU(
     const std::shared_ptr<BufferBlock2<float>>& weight_buff,
     const std::shared_ptr<BufferBlock2<float>>& wgrad_buff, const Tensor2<float>& in_tensor,
-    const Tensor2<float>& out_tensor, bool use_mixed_precision)
-    : LayerCPU(), use_mixed_precision_(use_mixed_precision) {
+    const Tensor2<float>& out_tensor, bool use_mixed_precision, bool fuse_relu)
+    : FullyConnectedLayerCPU(weight_buff, wgrad_buff, Tensors2<float>{in_tensor}, out_tensor,
+                             use_mixed_precision, fuse_relu) {}
+
+FullyConnectedLayerCPU<float>::FullyConnectedLayerCPU(
+    const std::shared_ptr<BufferBlock2<float>>& weight_buff,
+    const std::shared_ptr<BufferBlock2<float>>& wgrad_buff, const Tensors2<float>& in_tensors,
+    const Tensor2<float>& out_tensor, bool use_mixed_precision, bool fuse_relu)
+    : LayerCPU(), use_mixed_precision_(use_mixed_precision), fuse_relu_(fuse_relu) {
   try {
-    // check the in_tensor and out_tensor
-    const auto& in_tensor_dim = in_tensor.get_dimensions();
+    // check the in_tensors and out_tensor
     const auto& out_tensor_dim = out_tensor.get_dimensions();
     // 1. two dim?
-    if (in_tensor_dim.size() != 2 || out_tensor_dim.size() != 2) {
+    if (in_tensors.empty() || out_tensor_dim.size() != 2) {
       HCTR_OWN_THROW(Error_t::WrongInput, "input or output tensor doesn't has two dimensions");
     }
     // 2. dim match?
-    size_t m = in_tensor_dim[0];
+    size_t m = out_tensor_dim[0];
     size_t n = out_tensor_dim[1];
-    size_t k = in_tensor_dim[1];
-    size_t m_ck = out_tensor_dim[0];
-    if (m != m_ck) {
-      HCTR_OWN_THROW(Error_t::WrongInput, "size of input / output tensor doesn't match");
+    size_t k = 0;
+    for (const Tensor2<float>& in_tensor : in_tensors) {
+      const auto& in_tensor_dim = in_tensor.get_dimensions();
+      if (in_tensor_dim.size() != 2) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "input or output tensor doesn't has two dimensions");
+      }
+      if (in_tensor_dim[0] != m) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "size of input / output tensor doesn't match");
+      }
+      k += in_tensor_dim[1];
     }
 
     std::vector<size_t> weight_dim = {k, n};
@@ -95,7 +109,7 @@ FullyConnectedLayerCPU<float>::FullyConnectedLayerCPU(
       wgrad_buff->reserve(bias_dim, &tensor);
       wgrad_.push_back(tensor);
     }
-    in_tensors_.push_back(in_tensor);
+    in_tensors_ = in_tensors;
     out_tensors_.push_back(out_tensor);
     // Where should we create this cuBLAS handle?
   } catch (const std::runtime_error& rt_err) {
@@ -105,29 +119,58 @@ FullyConnectedLayerCPU<float>::FullyConnectedLayerCPU(
 }
 
 void FullyConnectedLayerCPU<float>::fprop(bool is_train) {
-  Tensor2<float>& in_tensor = get_in_tensors(is_train)[0];
+  Tensors2<float>& in_tensors = get_in_tensors(is_train);
   Tensor2<float>& out_tensor = out_tensors_[0];
 
   float* weight = weights_[0].get_ptr();
   float* bias = weights_[1].get_ptr();
-  float* in = in_tensor.get_ptr();
   float* out = out_tensor.get_ptr();
 
-  const auto& in_tensor_dim = in_tensor.get_dimensions();
+  const auto& weight_dim = weights_[0].get_dimensions();
   const auto& out_tensor_dim = out_tensor.get_dimensions();
 
   int m, n, k;
 
-  m = in_tensor_dim[0];
+  m = out_tensor_dim[0];
   n = out_tensor_dim[1];
-  k = in_tensor_dim[1];
-
-  cpu_mm(in, weight, out, m, k, n);
-  cpu_add_bias(out, bias, m, n);
+  k = weight_dim[0];
+
+  if (quantized_) {
+    float* in = in_tensors[0].get_ptr();
+    if (in_tensors.size() > 1) {
+      int8_concat_in_.resize(static_cast<size_t>(m) * k);
+      for (int i = 0; i < m; ++i) {
+        float* dst = &int8_concat_in_[static_cast<size_t>(i) * k];
+        for (Tensor2<float>& in_tensor : in_tensors) {
+          const size_t w = in_tensor.get_dimensions()[1];
+          dst = std::copy_n(in_tensor.get_ptr() + i * w, w, dst);
+        }
+      }
+      in = int8_concat_in_.data();
+    }
+    int8_in_.quantize(in, m, k);
+    int8_gemm_cpu(int8_in_, int8_weights_, out);
+  } else {
+    // Each input covers its own rows of the weights. Accumulating in order yields the same sums
+    // as a single product over the concatenated input.
+    size_t k_offset = 0;
+    for (size_t i = 0; i < in_tensors.size(); ++i) {
+      const int k_i = in_tensors[i].get_dimensions()[1];
+      cpu_mm(in_tensors[i].get_ptr(), weight + k_offset * n, out, m, k_i, n, i > 0);
+      k_offset += k_i;
+    }
+  }
+  cpu_add_bias(out, bias, m, n, fuse_relu_);
 }
 
 void FullyConnectedLayerCPU<float>::bprop() {}
 
+void FullyConnectedLayerCPU<float>::quantize() {
+  const auto& weight_dim = weights_[0].get_dimensions();
+  int8_weights_.quantize(weights_[0].get_ptr(), weight_dim[0], weight_dim[1]);
+  quantized_ = true;
+}
+
 template class FullyConnectedLayerCPU<float>;
 
 }  // namespace HugeCTR
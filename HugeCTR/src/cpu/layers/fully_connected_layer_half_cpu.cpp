@@ -36,10 +36,11 @@ void cpu_mm(__half* c, const __half* a, bool transpose_a, const __half* b, bool
   }
 }
 
-void cpu_add_bias(__half* top, const __half* bias, int m, int n) {
+void cpu_add_bias(__half* top, const __half* bias, int m, int n, bool relu) {
   for (int i = 0; i < m; ++i) {
     for (int j = 0; j < n; ++j) {
-      top[i * n + j] = top[i * n + j] + bias[j];
+      __half t = top[i * n + j] + bias[j];
+      top[i * n + j] = (relu && t < 0) ? __float2half(0.0f) : t;
     }
   }
 }
@@ -59,8 +60,8 @@ FullyConnectedLayerCPU<__half>::FullyConnectedLayerCPU(
     const std::shared_ptr<BufferBlock2<__half>>& weights_buff,
     const std::shared_ptr<BufferBlock2<__half>>& weights_grad_buff,
     const std::shared_ptr<GeneralBuffer2<HostAllocator>>& blobs_buff,
-    const Tensor2<__half>& bottom_tensor, const Tensor2<__half>& top_tensor)
-    : LayerCPU() {
+    const Tensor2<__half>& bottom_tensor, const Tensor2<__half>& top_tensor, bool fuse_relu)
+    : LayerCPU(), fuse_relu_(fuse_relu) {
   const auto& bottom_tensor_dim = bottom_tensor.get_dimensions();
   const auto& top_tensor_dim = top_tensor.get_dimensions();
 
@@ -125,12 +126,32 @@ void FullyConnectedLayerCPU<__half>::fprop(bool is_train) {
   size_t n = top_tensor_dim[1];
   size_t k = bottom_tensor_dim[1];
 
+  if (quantized_) {
+    const float* master_bias = weights_[1].get_ptr();
+    int8_bottom_.quantize(bottom, m, k);
+    int8_top_.resize(m * n);
+    int8_gemm_cpu(int8_bottom_, int8_weights_, int8_top_.data());
+    for (size_t i = 0; i < m; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        const float t = int8_top_[i * n + j] + master_bias[j];
+        top[i * n + j] = __float2half((fuse_relu_ && t < 0.0f) ? 0.0f : t);
+      }
+    }
+    return;
+  }
+
   cpu_mm(top, bottom, false, kernel, false, m, k, n);
-  cpu_add_bias(top, bias, m, n);
+  cpu_add_bias(top, bias, m, n, fuse_relu_);
 }
 
 void FullyConnectedLayerCPU<__half>::bprop() {}
 
+void FullyConnectedLayerCPU<__half>::quantize() {
+  const auto& kernel_dim = weights_[0].get_dimensions();
+  int8_weights_.quantize(weights_[0].get_ptr(), kernel_dim[0], kernel_dim[1]);
+  quantized_ = true;
+}
+
 template class FullyConnectedLayerCPU<__half>;
 
 }  // namespace HugeCTR
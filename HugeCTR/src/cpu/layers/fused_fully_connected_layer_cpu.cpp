@@ -145,10 +145,31 @@ void FusedFullyConnectedLayerCPU::fprop(bool is_train) {
   size_t n = top_tensor_dim[1];
   size_t k = bottom_tensor_dim[1];
 
+  if (quantized_) {
+    const float* master_bias = weights_[1].get_ptr();
+    int8_bottom_.quantize(bottom, m, k);
+    int8_top_.resize(m * n);
+    int8_gemm_cpu(int8_bottom_, int8_weights_, int8_top_.data());
+    for (size_t i = 0; i < m; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        const float t = int8_top_[i * n + j] + master_bias[j];
+        middle[i * n + j] = __float2half(t);
+        top[i * n + j] = __float2half(t < 0 ? 0.0f : t);
+      }
+    }
+    return;
+  }
+
   cpu_mm(top, bottom, false, kernel, false, m, k, n);
   cpu_add_bias_and_re(top, middle, bias, m, n);
 }
 
 void FusedFullyConnectedLayerCPU::bprop() {}
 
+void FusedFullyConnectedLayerCPU::quantize() {
+  const auto& kernel_dim = weights_[0].get_dimensions();
+  int8_weights_.quantize(weights_[0].get_ptr(), kernel_dim[0], kernel_dim[1]);
+  quantized_ = true;
+}
+
 }  // namespace HugeCTR
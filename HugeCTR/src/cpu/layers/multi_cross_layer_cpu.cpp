@@ -16,6 +16,7 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <cpu/layers/multi_cross_layer_cpu.hpp>
 #include <utils.hpp>
 #include <vector>
@@ -24,50 +25,131 @@ namespace HugeCTR {
 
 namespace {
 
-void matrix_vec_mul(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    out[j] = 0.0f;
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[j] += in_m[k] * in_v[i];
-    }
+// Rows of a tile share each load of the DCNv2 weights.
+constexpr size_t tile_rows = 8;
+// Smaller batches (in multiply-adds) run on the calling thread, where waking up the OpenMP team
+// would dominate. This also keeps concurrent inference sessions from oversubscribing the CPU.
+constexpr size_t min_parallel_work = size_t{1} << 17;
+
+inline float dot(const float* a, const float* b, size_t n) {
+  float sum = 0.0f;
+#pragma omp simd reduction(+ : sum)
+  for (size_t i = 0; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+// y += alpha * x
+inline void axpy(float* y, float alpha, const float* x, size_t n) {
+#pragma omp simd
+  for (size_t i = 0; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+
+// DCNv1: out = x0 * hidden + b + xl
+inline void cross_combine(float* out, const float* x0, float hidden, const float* bias,
+                          const float* xl, size_t w) {
+#pragma omp simd
+  for (size_t i = 0; i < w; i++) {
+    out[i] = x0[i] * hidden + bias[i] + xl[i];
+  }
+}
+
+// DCNv2: out = x0 .* (hidden + b) + xl. hidden may alias out.
+inline void cross_combine(float* out, const float* x0, const float* hidden, const float* bias,
+                          const float* xl, size_t w) {
+#pragma omp simd
+  for (size_t i = 0; i < w; i++) {
+    out[i] = x0[i] * (hidden[i] + bias[i]) + xl[i];
   }
 }
 
-void row_scaling(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[k] = in_m[k] * in_v[j];
+// Each row passes through all cross layers while it is in cache.
+void multi_cross_fprop_cpu(int layers, size_t batchsize, size_t w, float** h_outputs,
+                           const float* h_input, float** h_kernels, float** h_biases) {
+#pragma omp parallel for schedule(static) if (batchsize * w * layers >= min_parallel_work)
+  for (size_t r = 0; r < batchsize; r++) {
+    const float* x0 = h_input + r * w;
+    const float* xl = x0;
+    for (int i = 0; i < layers; i++) {
+      float* out = h_outputs[i] + r * w;
+      cross_combine(out, x0, dot(xl, h_kernels[i], w), h_biases[i], xl, w);
+      xl = out;
     }
   }
 }
 
-void matrix_add(float* out, const float* in_m_1, const float* in_m_2, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[k] = in_m_1[k] + in_m_2[k];
+// Tiles of rows pass through all cross layers while they are in cache. x * U is accumulated
+// row-wise (axpy over the rows of U), and so is (x * U) * V.
+void multi_cross_v2_fprop_cpu(int layers, size_t batchsize, size_t w, size_t p, float** h_outputs,
+                              const float* h_input, float* h_xu, float** h_u_kernels,
+                              float** h_v_kernels, float** h_biases) {
+  const size_t num_tiles = (batchsize + tile_rows - 1) / tile_rows;
+#pragma omp parallel for schedule(static) if (batchsize * w * p * layers >= min_parallel_work)
+  for (size_t t = 0; t < num_tiles; t++) {
+    const size_t row = t * tile_rows;
+    const size_t rows = std::min(tile_rows, batchsize - row);
+    const float* x0 = h_input + row * w;
+    const float* xl = x0;
+    float* xu = h_xu + row * p;
+    for (int i = 0; i < layers; i++) {
+      float* out = h_outputs[i] + row * w;
+      std::fill(xu, xu + rows * p, 0.0f);
+      for (size_t k = 0; k < w; k++) {
+        const float* u = h_u_kernels[i] + k * p;
+        for (size_t r = 0; r < rows; r++) {
+          axpy(xu + r * p, xl[r * w + k], u, p);
+        }
+      }
+      std::fill(out, out + rows * w, 0.0f);
+      for (size_t j = 0; j < p; j++) {
+        const float* v = h_v_kernels[i] + j * w;
+        for (size_t r = 0; r < rows; r++) {
+          axpy(out + r * w, xu[r * p + j], v, w);
+        }
+      }
+      for (size_t r = 0; r < rows; r++) {
+        cross_combine(out + r * w, x0 + r * w, out + r * w, h_biases[i], xl + r * w, w);
+      }
+      xl = out;
     }
   }
 }
 
-void matrix_vec_add(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[k] = in_m[k] + in_v[i];
+// The INT8 GEMMs are computed layer by layer. Only the combination with x0 and xl is fused.
+void multi_cross_int8_fprop_cpu(int layers, size_t batchsize, size_t w, float** h_outputs,
+                                const float* h_input, float** h_hiddens, float** h_biases,
+                                Int8ActivationsCPU* int8_in, const Int8WeightsCPU* int8_kernels) {
+  for (int i = 0; i < layers; i++) {
+    const float* xl = i == 0 ? h_input : h_outputs[i - 1];
+    int8_in->quantize(xl, batchsize, w);
+    int8_gemm_cpu(*int8_in, int8_kernels[i], h_hiddens[i]);
+#pragma omp parallel for schedule(static) if (batchsize * w >= min_parallel_work)
+    for (size_t r = 0; r < batchsize; r++) {
+      cross_combine(h_outputs[i] + r * w, h_input + r * w, h_hiddens[i][r], h_biases[i],
+                    xl + r * w, w);
     }
   }
 }
 
-void multi_cross_fprop_cpu(int layers, size_t batchsize, size_t w, float** h_outputs,
-                           float* h_input, float** h_hiddens, float** h_kernels, float** h_biases) {
+void multi_cross_v2_int8_fprop_cpu(int layers, size_t batchsize, size_t w, size_t p,
+                                   float** h_outputs, const float* h_input, float* h_xu,
+                                   float* h_hidden, float** h_biases, Int8ActivationsCPU* int8_in,
+                                   Int8ActivationsCPU* int8_xu,
+                                   const Int8WeightsCPU* int8_kernels) {
   for (int i = 0; i < layers; i++) {
-    matrix_vec_mul(h_hiddens[i], i == 0 ? h_input : h_outputs[i - 1], h_kernels[i], batchsize, w);
-    row_scaling(h_outputs[i], h_input, h_hiddens[i], batchsize, w);
-    matrix_add(h_outputs[i], h_outputs[i], i == 0 ? h_input : h_outputs[i - 1], batchsize, w);
-    matrix_vec_add(h_outputs[i], h_outputs[i], h_biases[i], batchsize, w);
+    const float* xl = i == 0 ? h_input : h_outputs[i - 1];
+    int8_in->quantize(xl, batchsize, w);
+    int8_gemm_cpu(*int8_in, int8_kernels[2 * i], h_xu);
+    int8_xu->quantize(h_xu, batchsize, p);
+    int8_gemm_cpu(*int8_xu, int8_kernels[2 * i + 1], h_hidden);
+#pragma omp parallel for schedule(static) if (batchsize * w >= min_parallel_work)
+    for (size_t r = 0; r < batchsize; r++) {
+      cross_combine(h_outputs[i] + r * w, h_input + r * w, h_hidden + r * w, h_biases[i],
+                    xl + r * w, w);
+    }
   }
 }
 
@@ -77,8 +159,9 @@ MultiCrossLayerCPU::MultiCrossLayerCPU(
     const std::shared_ptr<BufferBlock2<float>>& weight_buff,
     const std::shared_ptr<BufferBlock2<float>>& wgrad_buff,
     const std::shared_ptr<GeneralBuffer2<HostAllocator>>& blobs_buff,
-    const Tensor2<float>& in_tensor, const Tensor2<float>& out_tensor, int num_layers)
-    : LayerCPU(), num_layers_(num_layers) {
+    const Tensor2<float>& in_tensor, const Tensor2<float>& out_tensor, int num_layers,
+    size_t projection_dim)
+    : LayerCPU(), num_layers_(num_layers), projection_dim_(projection_dim) {
   try {
     // check the in_tensor and out_tensor
     const auto& in_tensor_dim = in_tensor.get_dimensions();
@@ -101,30 +184,24 @@ MultiCrossLayerCPU::MultiCrossLayerCPU(
       HCTR_OWN_THROW(Error_t::WrongInput, "num_layers < 1");
     }
 
-    std::vector<size_t> weight_bias_dim = {1, vec_length};
+    // DCNv1: kernel [1,w], bias [1,w]. DCNv2: U [w,p], V [p,w], bias [1,w].
+    std::vector<std::vector<size_t>> weight_dims;
+    if (projection_dim_) {
+      weight_dims = {{vec_length, projection_dim_}, {projection_dim_, vec_length}, {1, vec_length}};
+    } else {
+      weight_dims = {{1, vec_length}, {1, vec_length}};
+    }
     for (int i = 0; i < num_layers; i++) {
-      // setup weights
-      {
-        Tensor2<float> tensor;
-        weight_buff->reserve(weight_bias_dim, &tensor);
-        weights_.push_back(tensor);
-      }
-      // setup bias
-      {
+      // setup weights and bias
+      for (const auto& dim : weight_dims) {
         Tensor2<float> tensor;
-        weight_buff->reserve(weight_bias_dim, &tensor);
+        weight_buff->reserve(dim, &tensor);
         weights_.push_back(tensor);
       }
-      // setup weight gradient
-      {
-        Tensor2<float> tensor;
-        wgrad_buff->reserve(weight_bias_dim, &tensor);
-        wgrad_.push_back(tensor);
-      }
-      // setup bias gradient
-      {
+      // setup weight and bias gradients
+      for (const auto& dim : weight_dims) {
         Tensor2<float> tensor;
-        wgrad_buff->reserve(weight_bias_dim, &tensor);
+        wgrad_buff->reserve(dim, &tensor);
         wgrad_.push_back(tensor);
       }
     }
@@ -152,6 +229,9 @@ MultiCrossLayerCPU::MultiCrossLayerCPU(
       blobs_buff->reserve(tmp_vec_dim, &tensor);
       vec_tensors_.push_back(tensor);
     }
+    if (projection_dim_) {
+      blobs_buff->reserve({batchsize, projection_dim_}, &xu_tensor_);
+    }
 
   } catch (const std::runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
@@ -162,35 +242,64 @@ MultiCrossLayerCPU::MultiCrossLayerCPU(
 void MultiCrossLayerCPU::fprop(bool is_train) {
   size_t vec_length = in_tensors_[0].get_dimensions()[1];
   size_t batchsize = in_tensors_[0].get_dimensions()[0];
-  Tensors2<float> kernel_tensors;
-  Tensors2<float> bias_tensors;
-  Tensors2<float> output_tensors;
-  Tensors2<float> hidden_tensors;
+  const size_t num_weights = projection_dim_ ? 3 : 2;
 
-  for (int i = 0; i < num_layers_; i++) {
-    kernel_tensors.push_back(weights_[2 * i]);
-    bias_tensors.push_back(weights_[2 * i + 1]);
-  }
-
-  for (int i = 0; i < num_layers_; i++) {
-    output_tensors.push_back(blob_tensors_[i + 1]);
-    hidden_tensors.push_back(vec_tensors_[i]);
-  }
   std::vector<float*> h_hiddens;
-  std::vector<float*> h_kernels;
+  std::vector<float*> h_kernels;    // DCNv1 kernels, or U of DCNv2
+  std::vector<float*> h_v_kernels;  // V of DCNv2
   std::vector<float*> h_biases;
   std::vector<float*> h_outputs;
   for (int i = 0; i < num_layers_; i++) {
-    h_hiddens.push_back(hidden_tensors[i].get_ptr());
-    h_kernels.push_back(kernel_tensors[i].get_ptr());
-    h_biases.push_back(bias_tensors[i].get_ptr());
-    h_outputs.push_back(output_tensors[i].get_ptr());
+    h_kernels.push_back(weights_[num_weights * i].get_ptr());
+    if (projection_dim_) {
+      h_v_kernels.push_back(weights_[num_weights * i + 1].get_ptr());
+    }
+    h_biases.push_back(weights_[num_weights * i + num_weights - 1].get_ptr());
+    h_hiddens.push_back(vec_tensors_[i].get_ptr());
+    h_outputs.push_back(blob_tensors_[i + 1].get_ptr());
+  }
+  const float* h_input = blob_tensors_[0].get_ptr();
+
+  if (projection_dim_) {
+    if (int8_kernels_.empty()) {
+      multi_cross_v2_fprop_cpu(num_layers_, batchsize, vec_length, projection_dim_,
+                               h_outputs.data(), h_input, xu_tensor_.get_ptr(), h_kernels.data(),
+                               h_v_kernels.data(), h_biases.data());
+    } else {
+      multi_cross_v2_int8_fprop_cpu(num_layers_, batchsize, vec_length, projection_dim_,
+                                    h_outputs.data(), h_input, xu_tensor_.get_ptr(),
+                                    tmp_mat_tensors_[0].get_ptr(), h_biases.data(), &int8_in_,
+                                    &int8_xu_, int8_kernels_.data());
+    }
+  } else if (int8_kernels_.empty()) {
+    multi_cross_fprop_cpu(num_layers_, batchsize, vec_length, h_outputs.data(), h_input,
+                          h_kernels.data(), h_biases.data());
+  } else {
+    multi_cross_int8_fprop_cpu(num_layers_, batchsize, vec_length, h_outputs.data(), h_input,
+                               h_hiddens.data(), h_biases.data(), &int8_in_,
+                               int8_kernels_.data());
   }
-  multi_cross_fprop_cpu(num_layers_, batchsize, vec_length, h_outputs.data(),
-                        blob_tensors_[0].get_ptr(), h_hiddens.data(), h_kernels.data(),
-                        h_biases.data());
 }
 
 void MultiCrossLayerCPU::bprop() {}
 
+void MultiCrossLayerCPU::quantize() {
+  size_t vec_length = in_tensors_[0].get_dimensions()[1];
+  if (projection_dim_) {
+    // U (w x p) and V (p x w) are dense layers of their own.
+    int8_kernels_.resize(2 * num_layers_);
+    for (int i = 0; i < num_layers_; i++) {
+      int8_kernels_[2 * i].quantize(weights_[3 * i].get_ptr(), vec_length, projection_dim_);
+      int8_kernels_[2 * i + 1].quantize(weights_[3 * i + 1].get_ptr(), projection_dim_,
+                                        vec_length);
+    }
+    return;
+  }
+  // Each kernel is a (1 x w) vector, i.e. a dense layer with w inputs and a single output.
+  int8_kernels_.resize(num_layers_);
+  for (int i = 0; i < num_layers_; i++) {
+    int8_kernels_[i].quantize(weights_[2 * i].get_ptr(), vec_length, 1);
+  }
+}
+
 }  // namespace HugeCTR
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cpu/memory_planner_cpu.hpp>
+#include <cstdlib>
+#include <numeric>
+
+namespace HugeCTR {
+
+class MemoryPlannerCPU::Arena {
+ public:
+  void* ptr{nullptr};
+
+  ~Arena() { std::free(ptr); }
+};
+
+class MemoryPlannerCPU::PlannedBuffer : public TensorBuffer2 {
+ public:
+  std::shared_ptr<Arena> arena;
+  size_t offset{0};
+
+  bool allocated() const override { return arena && arena->ptr; }
+  void* get_ptr() override { return forward_void_pointer(arena->ptr, offset); }
+};
+
+namespace {
+
+size_t align_size(const size_t size_in_bytes) {
+  constexpr size_t alignment = MemoryPlannerCPU::alignment;
+  return (size_in_bytes + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+std::shared_ptr<TensorBuffer2> MemoryPlannerCPU::reserve_(const size_t size_in_bytes,
+                                                          const size_t step) {
+  if (arena_) {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Memory planner is finalized.");
+  }
+  auto buffer = std::make_shared<PlannedBuffer>();
+  blocks_.push_back({align_size(size_in_bytes), step, step, buffer});
+  return buffer;
+}
+
+void MemoryPlannerCPU::use(const size_t id, const size_t step) {
+  Block& block = blocks_.at(id);
+  block.last_step = std::max(block.last_step, step);
+}
+
+void MemoryPlannerCPU::allocate() {
+  if (arena_) {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Memory has already been allocated.");
+  }
+  arena_ = std::make_shared<Arena>();
+
+  // Greedy by size: Place the largest tensors first, each at the lowest offset that does not
+  // collide with a placed tensor whose lifetime overlaps.
+  std::vector<size_t> order(blocks_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) {
+    return blocks_[a].size_in_bytes > blocks_[b].size_in_bytes;
+  });
+
+  std::vector<size_t> placed;
+  std::vector<std::pair<size_t, size_t>> conflicts;
+  for (const size_t i : order) {
+    Block& block = blocks_[i];
+
+    conflicts.clear();
+    for (const size_t j : placed) {
+      const Block& other = blocks_[j];
+      if (block.first_step <= other.last_step && other.first_step <= block.last_step) {
+        conflicts.emplace_back(other.buffer->offset, other.buffer->offset + other.size_in_bytes);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+
+    size_t offset = 0;
+    for (const auto& conflict : conflicts) {
+      if (offset + block.size_in_bytes <= conflict.first) {
+        break;
+      }
+      offset = std::max(offset, conflict.second);
+    }
+
+    block.buffer->arena = arena_;
+    block.buffer->offset = offset;
+    size_in_bytes_ = std::max(size_in_bytes_, offset + block.size_in_bytes);
+    placed.push_back(i);
+  }
+
+  if (size_in_bytes_ != 0) {
+    arena_->ptr = std::aligned_alloc(alignment, size_in_bytes_);
+    if (!arena_->ptr) {
+      HCTR_OWN_THROW(Error_t::OutOfMemory, "Cannot allocate activation memory.");
+    }
+  }
+}
+
+size_t MemoryPlannerCPU::get_reserved_size_in_bytes() const {
+  size_t size_in_bytes = 0;
+  for (const Block& block : blocks_) {
+    size_in_bytes += block.size_in_bytes;
+  }
+  return size_in_bytes;
+}
+
+}  // namespace HugeCTR
@@ -14,12 +14,14 @@
  * limitations under the License.
  */
 
+#include <base/debug/tracer.hpp>
 #include <cpu/network_cpu.hpp>
 
 namespace HugeCTR {
 
-NetworkCPU::NetworkCPU(const std::shared_ptr<CPUResource>& cpu_resource, bool use_mixed_precision)
-    : cpu_resource_(cpu_resource), use_mixed_precision_(use_mixed_precision) {}
+NetworkCPU::NetworkCPU(const std::shared_ptr<CPUResource>& cpu_resource, bool use_mixed_precision,
+                       bool use_int8)
+    : cpu_resource_(cpu_resource), use_mixed_precision_(use_mixed_precision), use_int8_(use_int8) {}
 
 void NetworkCPU::conv_weight_(Tensor2<__half>& target, const Tensor2<float>& source) {
   size_t elems = source.get_num_elements();
@@ -33,12 +35,14 @@ void NetworkCPU::conv_weight_(Tensor2<__half>& target, const Tensor2<float>& sou
 }
 
 void NetworkCPU::predict() {
+  HCTR_TRACE_SCOPE("inference", "NetworkCPU::predict");
   if (use_mixed_precision_) {
     conv_weight_(weight_tensor_half_, weight_tensor_);
   }
   // forward
-  for (auto& layer : layers_) {
-    layer->fprop(false);
+  for (size_t i = 0; i < layers_.size(); i++) {
+    HCTR_TRACE_SCOPE("inference", layer_trace_names_[i]);
+    layers_[i]->fprop(false);
   }
   return;
 }
@@ -52,6 +56,9 @@ void NetworkCPU::load_params_from_model(const std::string& model_file) {
   }
   model_stream.read((char*)weight_tensor_.get_ptr(), weight_tensor_.get_size_in_bytes());
   model_stream.close();
+  if (use_int8_) {
+    quantize_();
+  }
   return;
 }
 
@@ -59,6 +66,17 @@ void NetworkCPU::initialize() {
   for (auto& layer : layers_) {
     layer->initialize();
   }
+  if (use_int8_) {
+    quantize_();
+  }
+}
+
+void NetworkCPU::quantize_() {
+  // Per-channel weight scales are derived from the current weights. Hence, this must be redone
+  // whenever the weights change.
+  for (auto& layer : layers_) {
+    layer->quantize();
+  }
 }
 
 }  // namespace HugeCTR
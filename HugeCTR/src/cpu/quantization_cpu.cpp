@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cpu/quantization_cpu.hpp>
+#include <type_traits>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+inline size_t pad_k(const size_t k) {
+  return (k + Int8WeightsCPU::k_alignment - 1) / Int8WeightsCPU::k_alignment *
+         Int8WeightsCPU::k_alignment;
+}
+
+// Rounds half away from zero (the SIMD kernels below do exactly the same).
+inline int8_t quantize_value(const float x, const float inv_scale) {
+  const float y = x * inv_scale;
+  const float r = y + (y < 0 ? -0.5f : 0.5f);
+  return static_cast<int8_t>(std::max(std::min(r, 127.f), -127.f));
+}
+
+inline float scale_of(const float max_abs) { return max_abs > 0 ? max_abs / 127.f : 1.f; }
+
+// Quantize a row of activations. Returns its scale.
+float quantize_row_generic(const float* const in, const size_t k, int8_t* const out) {
+  float max_abs = 0;
+  for (size_t kk = 0; kk < k; kk++) {
+    max_abs = std::max(max_abs, std::abs(in[kk]));
+  }
+  const float scale = scale_of(max_abs);
+  const float inv_scale = 1.f / scale;
+  for (size_t kk = 0; kk < k; kk++) {
+    out[kk] = quantize_value(in[kk], inv_scale);
+  }
+  return scale;
+}
+
+// Row i of the output, columns [j, j + NR).
+template <size_t NR>
+inline void store(const int32_t* const dots, const Int8ActivationsCPU& a, const size_t i,
+                  const Int8WeightsCPU& w, const size_t j, float* const out) {
+  for (size_t c = 0; c < NR; c++) {
+    out[i * w.n + j + c] = static_cast<float>(dots[c]) * a.scales[i] * w.scales[j + c];
+  }
+}
+
+void int8_gemm_generic(const Int8ActivationsCPU& a, const Int8WeightsCPU& w, float* const out) {
+  for (size_t i = 0; i < a.m; i++) {
+    const int8_t* const a_row = &a.values[i * a.k_padded];
+    for (size_t j = 0; j < w.n; j++) {
+      const int8_t* const w_row = &w.values[j * w.k_padded];
+      int32_t dot = 0;
+#pragma omp simd reduction(+ : dot)
+      for (size_t k = 0; k < a.k; k++) {
+        dot += static_cast<int32_t>(a_row[k]) * static_cast<int32_t>(w_row[k]);
+      }
+      store<1>(&dot, a, i, w, j, out);
+    }
+  }
+}
+
+#if defined(__x86_64__)
+// Micro-kernels compute MR rows x NR columns of the output. Each weight channel is loaded once
+// for MR rows, and each activation row once for NR channels.
+
+// AVX2 lacks a signed 8-bit dot product without saturation. Hence, both operands are widened to
+// 16 bit, and multiplied and added pairwise (exact).
+template <size_t MR, size_t NR>
+__attribute__((target("avx2"))) inline void int8_gemm_avx2_tile(const Int8ActivationsCPU& a,
+                                                                const size_t i,
+                                                                const Int8WeightsCPU& w,
+                                                                const size_t j, float* const out) {
+  __m256i acc[MR][NR];
+  for (size_t r = 0; r < MR; r++) {
+    for (size_t c = 0; c < NR; c++) {
+      acc[r][c] = _mm256_setzero_si256();
+    }
+  }
+  for (size_t k = 0; k < a.k_padded; k += 16) {
+    __m256i av[MR];
+    for (size_t r = 0; r < MR; r++) {
+      av[r] = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&a.values[(i + r) * a.k_padded + k])));
+    }
+    for (size_t c = 0; c < NR; c++) {
+      const __m256i wv = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&w.values[(j + c) * w.k_padded + k])));
+      for (size_t r = 0; r < MR; r++) {
+        acc[r][c] = _mm256_add_epi32(acc[r][c], _mm256_madd_epi16(av[r], wv));
+      }
+    }
+  }
+  for (size_t r = 0; r < MR; r++) {
+    int32_t dots[NR];
+    for (size_t c = 0; c < NR; c++) {
+      __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc[r][c]),
+                                _mm256_extracti128_si256(acc[r][c], 1));
+      s = _mm_hadd_epi32(s, s);
+      s = _mm_hadd_epi32(s, s);
+      dots[c] = _mm_cvtsi128_si32(s);
+    }
+    store<NR>(dots, a, i + r, w, j, out);
+  }
+}
+
+// VNNI multiplies unsigned with signed bytes. Activations are offset by 128 (flipping the sign
+// bit), which adds 128 * sum(w) to each dot product.
+template <size_t MR, size_t NR>
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) inline void int8_gemm_vnni_tile(
+    const Int8ActivationsCPU& a, const size_t i, const Int8WeightsCPU& w, const size_t j,
+    float* const out) {
+  const __m512i offset = _mm512_set1_epi8(static_cast<char>(0x80));
+  __m512i acc[MR][NR];
+  for (size_t r = 0; r < MR; r++) {
+    for (size_t c = 0; c < NR; c++) {
+      acc[r][c] = _mm512_setzero_si512();
+    }
+  }
+  for (size_t k = 0; k < a.k_padded; k += 64) {
+    __m512i av[MR];
+    for (size_t r = 0; r < MR; r++) {
+      av[r] = _mm512_xor_si512(_mm512_loadu_si512(&a.values[(i + r) * a.k_padded + k]), offset);
+    }
+    for (size_t c = 0; c < NR; c++) {
+      const __m512i wv = _mm512_loadu_si512(&w.values[(j + c) * w.k_padded + k]);
+      for (size_t r = 0; r < MR; r++) {
+        acc[r][c] = _mm512_dpbusd_epi32(acc[r][c], av[r], wv);
+      }
+    }
+  }
+  for (size_t r = 0; r < MR; r++) {
+    int32_t dots[NR];
+    for (size_t c = 0; c < NR; c++) {
+      dots[c] = _mm512_reduce_add_epi32(acc[r][c]) - 128 * w.sums[j + c];
+    }
+    store<NR>(dots, a, i + r, w, j, out);
+  }
+}
+
+// Channels are processed in blocks of NR for all rows, so that they stay in L1 cache.
+#define HCTR_INT8_GEMM_TILED(TILE)                                       \
+  {                                                                      \
+    constexpr size_t MR = 2;                                             \
+    constexpr size_t NR = 4;                                             \
+    size_t j = 0;                                                        \
+    for (; j + NR <= w.n; j += NR) {                                     \
+      size_t i = 0;                                                      \
+      for (; i + MR <= a.m; i += MR) TILE<MR, NR>(a, i, w, j, out);      \
+      for (; i < a.m; i++) TILE<1, NR>(a, i, w, j, out);                 \
+    }                                                                    \
+    for (; j < w.n; j++) {                                               \
+      size_t i = 0;                                                      \
+      for (; i + MR <= a.m; i += MR) TILE<MR, 1>(a, i, w, j, out);       \
+      for (; i < a.m; i++) TILE<1, 1>(a, i, w, j, out);                  \
+    }                                                                    \
+  }
+
+__attribute__((target("avx2"))) void int8_gemm_avx2(const Int8ActivationsCPU& a,
+                                                    const Int8WeightsCPU& w, float* const out) {
+  HCTR_INT8_GEMM_TILED(int8_gemm_avx2_tile);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) void int8_gemm_vnni(
+    const Int8ActivationsCPU& a, const Int8WeightsCPU& w, float* const out) {
+  HCTR_INT8_GEMM_TILED(int8_gemm_vnni_tile);
+}
+
+#undef HCTR_INT8_GEMM_TILED
+
+__attribute__((target("avx2"))) float quantize_row_avx2(const float* const in, const size_t k,
+                                                        int8_t* const out) {
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  __m256 max_abs_v = _mm256_setzero_ps();
+  size_t kk = 0;
+  for (; kk + 8 <= k; kk += 8) {
+    max_abs_v = _mm256_max_ps(max_abs_v, _mm256_andnot_ps(sign_mask, _mm256_loadu_ps(&in[kk])));
+  }
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(max_abs_v), _mm256_extractf128_ps(max_abs_v, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_movehdup_ps(m));
+  float max_abs = _mm_cvtss_f32(m);
+  for (; kk < k; kk++) {
+    max_abs = std::max(max_abs, std::abs(in[kk]));
+  }
+  const float scale = scale_of(max_abs);
+  const float inv_scale = 1.f / scale;
+
+  const __m256 inv_scale_v = _mm256_set1_ps(inv_scale);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256i q_max = _mm256_set1_epi32(127);
+  const __m256i q_min = _mm256_set1_epi32(-127);
+  for (kk = 0; kk + 8 <= k; kk += 8) {
+    const __m256 y = _mm256_mul_ps(_mm256_loadu_ps(&in[kk]), inv_scale_v);
+    const __m256 r = _mm256_add_ps(y, _mm256_or_ps(half, _mm256_and_ps(y, sign_mask)));
+    __m256i q = _mm256_cvttps_epi32(r);
+    q = _mm256_max_epi32(_mm256_min_epi32(q, q_max), q_min);
+    const __m128i q16 = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[kk]), _mm_packs_epi16(q16, q16));
+  }
+  for (; kk < k; kk++) {
+    out[kk] = quantize_value(in[kk], inv_scale);
+  }
+  return scale;
+}
+
+__attribute__((target("avx512f"))) inline __m512i quantize_avx512(const __m512 x,
+                                                                  const __m512 inv_scale) {
+  const __m512i sign_mask = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+  const __m512i half = _mm512_castps_si512(_mm512_set1_ps(0.5f));
+  const __m512 y = _mm512_mul_ps(x, inv_scale);
+  const __m512 r = _mm512_add_ps(
+      y, _mm512_castsi512_ps(
+             _mm512_or_si512(half, _mm512_and_si512(_mm512_castps_si512(y), sign_mask))));
+  const __m512i q = _mm512_cvttps_epi32(r);
+  return _mm512_max_epi32(_mm512_min_epi32(q, _mm512_set1_epi32(127)), _mm512_set1_epi32(-127));
+}
+
+__attribute__((target("avx512f"))) float quantize_row_avx512(const float* const in,
+                                                             const size_t k, int8_t* const out) {
+  __m512 max_abs_v = _mm512_setzero_ps();
+  size_t kk = 0;
+  for (; kk + 16 <= k; kk += 16) {
+    max_abs_v = _mm512_max_ps(max_abs_v, _mm512_abs_ps(_mm512_loadu_ps(&in[kk])));
+  }
+  if (kk < k) {
+    const __mmask16 mask = static_cast<__mmask16>((1u << (k - kk)) - 1);
+    max_abs_v = _mm512_max_ps(max_abs_v, _mm512_abs_ps(_mm512_maskz_loadu_ps(mask, &in[kk])));
+  }
+  const float scale = scale_of(_mm512_reduce_max_ps(max_abs_v));
+  const float inv_scale = 1.f / scale;
+
+  const __m512 inv_scale_v = _mm512_set1_ps(inv_scale);
+  for (kk = 0; kk + 16 <= k; kk += 16) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[kk]),
+                     _mm512_cvtsepi32_epi8(quantize_avx512(_mm512_loadu_ps(&in[kk]), inv_scale_v)));
+  }
+  if (kk < k) {
+    const __mmask16 mask = static_cast<__mmask16>((1u << (k - kk)) - 1);
+    _mm512_mask_cvtsepi32_storeu_epi8(
+        &out[kk], mask, quantize_avx512(_mm512_maskz_loadu_ps(mask, &in[kk]), inv_scale_v));
+  }
+  return scale;
+}
+
+const bool has_vnni = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                      __builtin_cpu_supports("avx512vnni");
+const bool has_avx2 = __builtin_cpu_supports("avx2");
+const bool has_avx512 = __builtin_cpu_supports("avx512f");
+#endif
+
+float quantize_row(const float* const in, const size_t k, int8_t* const out) {
+#if defined(__x86_64__)
+  if (has_avx512) {
+    return quantize_row_avx512(in, k, out);
+  }
+  if (has_avx2) {
+    return quantize_row_avx2(in, k, out);
+  }
+#endif
+  return quantize_row_generic(in, k, out);
+}
+
+}  // namespace
+
+void Int8WeightsCPU::quantize(const float* const weights, const size_t k, const size_t n) {
+  this->k = k;
+  this->n = n;
+  k_padded = pad_k(k);
+  values.assign(n * k_padded, 0);
+  scales.resize(n);
+  sums.resize(n);
+
+  for (size_t j = 0; j < n; j++) {
+    float max_abs = 0;
+    for (size_t kk = 0; kk < k; kk++) {
+      max_abs = std::max(max_abs, std::abs(weights[kk * n + j]));
+    }
+    scales[j] = scale_of(max_abs);
+
+    const float inv_scale = 1.f / scales[j];
+    int32_t sum = 0;
+    for (size_t kk = 0; kk < k; kk++) {
+      const int8_t q = quantize_value(weights[kk * n + j], inv_scale);
+      values[j * k_padded + kk] = q;
+      sum += q;
+    }
+    sums[j] = sum;
+  }
+}
+
+template <typename T>
+void Int8ActivationsCPU::quantize(const T* const in, const size_t m, const size_t k) {
+  if (this->m != m || this->k != k) {
+    this->m = m;
+    this->k = k;
+    k_padded = pad_k(k);
+    values.assign(m * k_padded, 0);
+    scales.resize(m);
+  }
+
+  if constexpr (std::is_same<T, float>::value) {
+    for (size_t i = 0; i < m; i++) {
+      scales[i] = quantize_row(&in[i * k], k, &values[i * k_padded]);
+    }
+  } else {
+    std::vector<float> row(k);
+    for (size_t i = 0; i < m; i++) {
+      std::transform(&in[i * k], &in[(i + 1) * k], row.begin(),
+                     [](const T x) { return __half2float(x); });
+      scales[i] = quantize_row(row.data(), k, &values[i * k_padded]);
+    }
+  }
+}
+
+template void Int8ActivationsCPU::quantize(const float* in, size_t m, size_t k);
+template void Int8ActivationsCPU::quantize(const __half* in, size_t m, size_t k);
+
+void int8_gemm_cpu(const Int8ActivationsCPU& a, const Int8WeightsCPU& w, float* const out) {
+  if (a.k != w.k) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "inner dimensions of activations and weights don't match");
+  }
+#if defined(__x86_64__)
+  if (has_vnni) {
+    int8_gemm_vnni(a, w, out);
+    return;
+  }
+  if (has_avx2) {
+    int8_gemm_avx2(a, w, out);
+    return;
+  }
+#endif
+  int8_gemm_generic(a, w, out);
+}
+
+void int8_gemm_cpu(const Int8ActivationsCPU& a, const Int8WeightsCPU& w, float* const out,
+                   const Int8GemmKernel_t kernel) {
+  if (a.k != w.k) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "inner dimensions of activations and weights don't match");
+  }
+  switch (kernel) {
+    case Int8GemmKernel_t::Generic: {
+      int8_gemm_generic(a, w, out);
+      return;
+    }
+#if defined(__x86_64__)
+    case Int8GemmKernel_t::AVX2: {
+      if (has_avx2) {
+        int8_gemm_avx2(a, w, out);
+        return;
+      }
+    } break;
+    case Int8GemmKernel_t::AVX512VNNI: {
+      if (has_vnni) {
+        int8_gemm_vnni(a, w, out);
+        return;
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+  HCTR_OWN_THROW(Error_t::IllegalCall, "INT8 GEMM kernel is not supported by this CPU");
+}
+
+std::vector<Int8GemmKernel_t> int8_gemm_cpu_kernels() {
+  std::vector<Int8GemmKernel_t> kernels;
+#if defined(__x86_64__)
+  if (has_vnni) {
+    kernels.push_back(Int8GemmKernel_t::AVX512VNNI);
+  }
+  if (has_avx2) {
+    kernels.push_back(Int8GemmKernel_t::AVX2);
+  }
+#endif
+  kernels.push_back(Int8GemmKernel_t::Generic);
+  return kernels;
+}
+
+const char* int8_gemm_cpu_kernel() {
+#if defined(__x86_64__)
+  if (has_vnni) {
+    return "avx512_vnni";
+  }
+  if (has_avx2) {
+    return "avx2";
+  }
+#endif
+  return "generic";
+}
+
+}  // namespace HugeCTR
@@ -138,6 +138,7 @@ void AsyncReaderImpl::load_async() {
       int raw_id = thid % num_devices_;
       int device_id = resource_manager_->get_local_gpu(raw_id)->get_device_id();
       CudaCPUDeviceContext ctx(device_id);
+      hctr_set_thread_name("async reader #" + std::to_string(thid));
 
       local_readers_[thid]->load();
     }));
@@ -10,6 +10,7 @@
 #include <numeric>
 #include <stdexcept>
 
+#include "base/debug/tracer.hpp"
 #include "common.hpp"
 #include "data_readers/async_reader/async_reader_common.hpp"
 #include "data_readers/async_reader/broadcast.hpp"
@@ -194,6 +195,7 @@ void ThreadAsyncReader::try_submit_io(size_t batch_id, int io_id) {
     req->data = (void*)buffer;
   }
 
+  buffer->trace_begin = HCTR_TRACE_NOW();
   int ret = io_submit(ioctx_, num_blocks, buffer->io_reqs.data());
   num_buffers_waiting_io_ += 1;
   if (ret < 0) {
@@ -219,6 +221,8 @@ void ThreadAsyncReader::wait_io() {
     buffer->num_outstanding_reqs--;
     assert(buffer->num_outstanding_reqs >= 0);
     if (buffer->num_outstanding_reqs == 0) {
+      HCTR_TRACE_RECORD("data", "ThreadAsyncReader::read_batch", buffer->trace_begin);
+      buffer->trace_begin = HCTR_TRACE_NOW();
       num_buffers_waiting_io_ -= 1;
       buffer->status.store(BufferStatus::UploadInProcess);
       if (params_.wait_for_gpu_idle) {
@@ -304,6 +308,7 @@ bool ThreadAsyncReader::check_completion(InternalBatchBuffer* buffer) {
 
   auto res = cudaEventQuery(buffer->event);
   if (res == cudaSuccess) {
+    HCTR_TRACE_RECORD("data", "ThreadAsyncReader::upload_batch", buffer->trace_begin);
     buffer->status.store(BufferStatus::ReadReady);
     return true;
   }
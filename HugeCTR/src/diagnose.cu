@@ -138,7 +138,7 @@ void sample_and_print(const char* category, const Tensor2<T>& tensor, size_t sam
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 
   {
-    auto log = HCTR_LOG_S(INFO, ROOT);
+    auto log = HCTR_LOG_ENTRY(INFO, ROOT);
     log << "Diagnose for (" << category << "), Sampling [";
     for (size_t i = 0; i < min(sample_count, tensor.get_num_elements()); i++) {
       if (i != 0) log << ",";
@@ -167,7 +167,7 @@ void sample_and_print(const char* category, const Tensor2<T>& tensor, int begin,
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 
   {
-    auto log = HCTR_LOG_S(INFO, ROOT);
+    auto log = HCTR_LOG_ENTRY(INFO, ROOT);
     log << "Diagnose for (" << category << "), Sampling [";
     for (size_t i = 0; i < end - begin; i++) {
       if (i != 0) log << ",";
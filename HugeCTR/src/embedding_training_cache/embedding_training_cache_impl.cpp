@@ -16,6 +16,7 @@
 
 #include "HugeCTR/include/embedding_training_cache/embedding_training_cache_impl.hpp"
 
+#include <base/debug/tracer.hpp>
 #include <sstream>
 #include <string>
 
@@ -47,6 +48,7 @@ EmbeddingTrainingCacheImpl<TypeKey>::EmbeddingTrainingCacheImpl(
 
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::load_(std::vector<std::string>& keyset_file_list) {
+  HCTR_TRACE_SCOPE("etc", "EmbeddingTrainingCache::load");
   try {
     if (keyset_file_list.size() != embeddings_.size()) {
       HCTR_OWN_THROW(Error_t::WrongInput, "num of keyset_file and num of embeddings don't equal");
@@ -71,6 +73,7 @@ void EmbeddingTrainingCacheImpl<TypeKey>::load_(std::vector<std::string>& keyset
 
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::dump() {
+  HCTR_TRACE_SCOPE("etc", "EmbeddingTrainingCache::dump");
   try {
     for (size_t i = 0; i < embeddings_.size(); i++) {
       auto ptr_ps = ps_manager_.get_parameter_server(i);
@@ -93,6 +96,7 @@ void EmbeddingTrainingCacheImpl<TypeKey>::dump() {
 
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::update(std::vector<std::string>& keyset_file_list) {
+  HCTR_TRACE_SCOPE("etc", "EmbeddingTrainingCache::update");
   try {
 #ifndef KEY_HIT_RATIO
     HCTR_LOG(INFO, ROOT, "Preparing embedding table for next pass\n");
@@ -121,6 +125,31 @@ void EmbeddingTrainingCacheImpl<TypeKey>::update(std::string& keyset_file) {
   update(keyset_file_list);
 }
 
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::prefetch(std::vector<std::string>& keyset_file_list) {
+  HCTR_TRACE_SCOPE("etc", "EmbeddingTrainingCache::prefetch");
+  try {
+    if (keyset_file_list.size() != embeddings_.size()) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "num of keyset_file and num of embeddings don't equal");
+    }
+    for (size_t i = 0; i < ps_manager_.get_size(); i++) {
+      ps_manager_.get_parameter_server(i)->prefetch(keyset_file_list[i]);
+    }
+  } catch (const internal_runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    throw rt_err;
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+    throw err;
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::prefetch(std::string& keyset_file) {
+  std::vector<std::string> keyset_file_list(embeddings_.size(), keyset_file);
+  prefetch(keyset_file_list);
+}
+
 template <typename TypeKey>
 std::vector<std::pair<std::vector<long long>, std::vector<float>>>
 EmbeddingTrainingCacheImpl<TypeKey>::get_incremental_model(
@@ -14,25 +14,101 @@
  * limitations under the License.
  */
 
+#include <numa.h>
 #include <omp.h>
 #include <tqdm.h>
 
 #include <HugeCTR/include/optimizer.hpp>
+#include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <embedding_training_cache/hmem_cache/hmem_cache.hpp>
 #include <execution>
 #include <iomanip>
+#include <numeric>
 
 namespace HugeCTR {
 
+namespace {
+
+// Lines that were accessed in at least this many passes survive the eviction of their block.
+constexpr uint32_t hot_line_freq{2};
+
+constexpr size_t cache_line_size{64};
+constexpr size_t page_size{4096};
+
+size_t align_up(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+void *allocate_arena(size_t size, bool &numa_allocated) {
+  void *ptr{nullptr};
+  numa_allocated = (numa_available() >= 0) && (numa_num_configured_nodes() > 1);
+  if (numa_allocated) {
+    // Blocks are accessed by all threads. Hence, spread the pages evenly across the nodes.
+    ptr = numa_alloc_interleaved(size);
+  } else {
+    ptr = std::aligned_alloc(page_size, size);
+  }
+  if (!ptr) {
+    HCTR_OWN_THROW(Error_t::OutOfMemory,
+                   "Cannot allocate " + std::to_string(size) + " bytes for HMEM-Cache block");
+  }
+  return ptr;
+}
+
+}  // namespace
+
+template <typename TypeKey>
+HMemCache<TypeKey>::Block::Block(size_t capacity, bool use_slot_id, size_t vec_per_line,
+                                 size_t emb_vec_size, size_t num_threads) {
+  size_t const slot_id_bytes{use_slot_id ? align_up(capacity * sizeof(size_t), cache_line_size)
+                                         : 0};
+  size_t const freq_bytes{align_up(capacity * sizeof(uint32_t), cache_line_size)};
+  size_t const line_bytes{align_up(capacity * emb_vec_size * sizeof(float), cache_line_size)};
+  arena_size_ = align_up(slot_id_bytes + freq_bytes + vec_per_line * line_bytes, page_size);
+  arena_ = allocate_arena(arena_size_, numa_allocated_);
+
+  // Commit the pages in parallel (first touch places them close to the touching threads).
+  size_t const num_pages{arena_size_ / page_size};
+#pragma omp parallel for num_threads(num_threads)
+  for (size_t i = 0; i < num_pages; i++) {
+    memset(static_cast<char *>(arena_) + i * page_size, 0, page_size);
+  }
+
+  char *ptr{static_cast<char *>(arena_)};
+  if (use_slot_id) {
+    slot_ids = reinterpret_cast<size_t *>(ptr);
+  }
+  ptr += slot_id_bytes;
+  freqs = reinterpret_cast<uint32_t *>(ptr);
+  ptr += freq_bytes;
+  for (size_t i{0}; i < vec_per_line; i++) {
+    data_ptrs.push_back(reinterpret_cast<float *>(ptr));
+    ptr += line_bytes;
+  }
+  key_idx_map.reserve(capacity);
+}
+
+template <typename TypeKey>
+HMemCache<TypeKey>::Block::~Block() {
+  if (numa_allocated_) {
+    numa_free(arena_, arena_size_);
+  } else {
+    std::free(arena_);
+  }
+}
+
 template <typename TypeKey>
 size_t HMemCache<TypeKey>::find_(TypeKey key) {
   if (!is_full_ && head_id_ == -1) return end_flag;
   auto num_blk{is_full_ ? num_block_ : (head_id_ + 1)};
   for (int cnt{0}; cnt < num_blk; cnt++) {
     auto blk_idx{(head_id_ + num_block_ - cnt) % num_block_};
-    auto it{key_idx_maps_[blk_idx].find(key)};
-    if (it != key_idx_maps_[blk_idx].end()) {
+    auto const &key_idx_map{blocks_[blk_idx]->key_idx_map};
+    auto it{key_idx_map.find(key)};
+    if (it != key_idx_map.end()) {
       return (blk_idx * block_capacity_ + it->second);
     }
   }
@@ -48,6 +124,66 @@ std::pair<int, size_t> HMemCache<TypeKey>::cascade_find_(TypeKey key) {
   return std::make_pair(-1, 0);
 }
 
+/**
+ * Copies the most frequently accessed lines of the evicted block src, which are not cached
+ * elsewhere, into the unused lines of dst. Their frequency is halved, such that lines which are
+ * no longer accessed eventually leave the cache.
+ */
+template <typename TypeKey>
+size_t HMemCache<TypeKey>::retain_hot_lines_(Block &dst, size_t dst_offset, Block &src) {
+  if (dst_offset >= block_capacity_) return 0;
+
+  std::vector<std::pair<TypeKey, size_t>> src_lines;
+  src_lines.reserve(src.key_idx_map.size());
+  for (auto const &pair : src.key_idx_map) {
+    if (src.freqs[pair.second] >= hot_line_freq) {
+      src_lines.push_back(pair);
+    }
+  }
+
+  // Lines with a newer copy in the cache are outdated.
+  std::vector<std::vector<std::pair<TypeKey, size_t>>> sub_hot_lines(num_threads_);
+#pragma omp parallel num_threads(num_threads_)
+  {
+    auto const tid{static_cast<size_t>(omp_get_thread_num())};
+#pragma omp for
+    for (size_t i = 0; i < src_lines.size(); i++) {
+      if (find_(src_lines[i].first) == end_flag) {
+        sub_hot_lines[tid].push_back(src_lines[i]);
+      }
+    }
+  }
+  std::vector<std::pair<TypeKey, size_t>> hot_lines;
+  for (auto const &sub_hot_line : sub_hot_lines) {
+    hot_lines.insert(hot_lines.end(), sub_hot_line.begin(), sub_hot_line.end());
+  }
+
+  size_t const num_retain{std::min(hot_lines.size(), block_capacity_ - dst_offset)};
+  if (num_retain == 0) return 0;
+  auto const by_freq{
+      [&src](auto const &a, auto const &b) { return src.freqs[a.second] > src.freqs[b.second]; }};
+  std::nth_element(hot_lines.begin(), hot_lines.begin() + num_retain - 1, hot_lines.end(),
+                   by_freq);
+
+  std::vector<TypeKey> keys(num_retain);
+  std::vector<size_t> dst_idx_vec(num_retain);
+  std::iota(dst_idx_vec.begin(), dst_idx_vec.end(), dst_offset);
+#pragma omp parallel for num_threads(num_threads_)
+  for (size_t cnt = 0; cnt < num_retain; cnt++) {
+    auto const src_idx{hot_lines[cnt].second};
+    auto const dst_idx{dst_offset + cnt};
+    keys[cnt] = hot_lines[cnt].first;
+    if (use_slot_id_) dst.slot_ids[dst_idx] = src.slot_ids[src_idx];
+    dst.freqs[dst_idx] = src.freqs[src_idx] / 2;
+    for (size_t i{0}; i < vec_per_line_; i++) {
+      memcpy(dst.data_ptrs[i] + dst_idx * emb_vec_size_, src.data_ptrs[i] + src_idx * emb_vec_size_,
+             emb_vec_size_ * sizeof(float));
+    }
+  }
+  dst.key_idx_map.bulk_insert(num_retain, keys.data(), dst_idx_vec.data(), num_threads_);
+  return num_retain;
+}
+
 template <typename TypeKey>
 HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, size_t max_num_evict,
                               size_t max_vocabulary_size, std::string sparse_model_file,
@@ -61,23 +197,14 @@ HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, si
       use_slot_id_{use_slot_id},
       emb_vec_size_{emb_vec_size},
       vec_per_line_{1 + OptParams::num_parameters_per_weight(opt_type)},
+      num_threads_{static_cast<size_t>(omp_get_max_threads())},
       resource_manager_{resource_manager},
       sparse_model_file_ptr_(std::make_shared<SparseModelFileTS<TypeKey>>(
           sparse_model_file, local_path, use_slot_id, opt_type, emb_vec_size, resource_manager)) {
   // +1 is reserved for a temp buffer
-  key_idx_maps_.resize(num_block_ + 1);
-  slot_ids_.resize(num_block_ + 1);
-  cache_datas_.resize(num_block_ + 1);
-#pragma omp parallel for num_threads(num_block_ + 1)
-  for (auto i = 0; i < num_block_ + 1; i++) {
-    key_idx_maps_[i].reserve(block_capacity_);
-    if (use_slot_id_) {
-      slot_ids_[i].resize(block_capacity_);
-    }
-    cache_datas_[i].resize(vec_per_line_);
-    for (auto &cache_data : cache_datas_[i]) {
-      cache_data.resize(block_capacity_ * emb_vec_size_);
-    }
+  for (int i{0}; i < num_block_ + 1; i++) {
+    blocks_.emplace_back(std::make_unique<Block>(block_capacity_, use_slot_id_, vec_per_line_,
+                                                 emb_vec_size_, num_threads_));
   }
 }
 
@@ -113,7 +240,7 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
   if (data_ptrs.size() != vec_per_line_) {
     HCTR_OWN_THROW(Error_t::WrongInput, "Num of data files and pointers doesn't equal");
   }
-  auto const num_thread{24};
+  auto const num_thread{num_threads_};
   std::vector<std::vector<std::vector<TypeKey>>> sub_exist_keys(
       num_thread, std::vector<std::vector<TypeKey>>(2));
   std::vector<std::vector<std::vector<size_t>>> sub_idx_vecs(num_thread,
@@ -169,48 +296,61 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
     len += key_vec.size();
   }
 
-  size_t static pass_counter{0};
   auto const tail_id{(head_id_ + 1) % num_block_};
   auto hit_rate{(len != 0) ? (1.0 * keys_vec[0].size() / len) : 0.};
+  hit_rate_ = hit_rate;
+  bool const add_block{!is_full_ ||
+                       (hit_rate < target_hit_rate_ && pass_counter_ < max_num_evict_)};
 
-#pragma omp parallel for num_threads(24)
+  // Lines hit in the cache are either moved to the new block, or counted in place.
+  std::vector<uint32_t> hit_freqs(add_block ? idx_vecs[0].size() : 0);
+#pragma omp parallel for num_threads(num_thread)
   for (size_t cnt = 0; cnt < idx_vecs[0].size(); cnt++) {
     size_t blk_idx{idx_vecs[0][cnt] / block_capacity_};
     size_t line_idx{idx_vecs[0][cnt] % block_capacity_};
+    Block &block{*blocks_[blk_idx]};
     if (use_slot_id_) {
-      slot_id_ptr[cnt] = slot_ids_[blk_idx][line_idx];
+      slot_id_ptr[cnt] = block.slot_ids[line_idx];
     }
     for (size_t i{0}; i < vec_per_line_; i++) {
-      float *src_ptr{cache_datas_[blk_idx][i].data() + line_idx * emb_vec_size_};
+      float *src_ptr{block.data_ptrs[i] + line_idx * emb_vec_size_};
       float *dst_ptr{data_ptrs[i] + cnt * emb_vec_size_};
       memcpy(dst_ptr, src_ptr, emb_vec_size_ * sizeof(float));
     }
+    if (add_block) {
+      hit_freqs[cnt] = block.freqs[line_idx] + 1;
+    } else {
+      block.freqs[line_idx]++;
+    }
+  }
+
+  if (add_block && is_full_) {
+    std::swap(blocks_[tail_id], blocks_[num_block_]);
   }
+  Block &new_block{*blocks_[tail_id]};
 
   omp_set_nested(2);
 #pragma omp parallel sections
   {
 #pragma omp section
     {
-      if (!is_full_ || (hit_rate < target_hit_rate_ && pass_counter < max_num_evict_)) {
-        if (is_full_) {
-          std::swap(key_idx_maps_[tail_id], key_idx_maps_[num_block_]);
-          std::swap(slot_ids_[tail_id], slot_ids_[num_block_]);
-          std::swap(cache_datas_[tail_id], cache_datas_[num_block_]);
-        }
-        key_idx_maps_[tail_id].clear();
-        for (size_t i{0}; i < len; i++) {
-          key_idx_maps_[tail_id].insert({key_ptr[i], i});
-        }
+      if (add_block) {
+        std::vector<size_t> line_idx_vec(len);
+        std::iota(line_idx_vec.begin(), line_idx_vec.end(), 0);
+        new_block.key_idx_map.clear();
+        new_block.key_idx_map.bulk_insert(len, key_ptr, line_idx_vec.data(), num_thread / 2);
         bool is_empty{idx_vecs[0].size() == 0};
         if (use_slot_id_ && !is_empty) {
           size_t *src_ptr{slot_id_ptr};
-          size_t *dst_ptr{slot_ids_[tail_id].data()};
+          size_t *dst_ptr{new_block.slot_ids};
           memcpy(dst_ptr, src_ptr, idx_vecs[0].size() * sizeof(size_t));
         }
+        if (!is_empty) {
+          memcpy(new_block.freqs, hit_freqs.data(), hit_freqs.size() * sizeof(uint32_t));
+        }
         for (size_t i{0}; (i < vec_per_line_) && !is_empty; i++) {
           float *src_ptr{data_ptrs[i]};
-          float *dst_ptr{cache_datas_[tail_id][i].data()};
+          float *dst_ptr{new_block.data_ptrs[i]};
           memcpy(dst_ptr, src_ptr, idx_vecs[0].size() * emb_vec_size_ * sizeof(float));
         }
       }
@@ -222,28 +362,33 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
       std::transform(data_ptrs.begin(), data_ptrs.end(), tmp_data_ptrs.begin(),
                      [&](float *ptr) { return ptr + idx_vecs[0].size() * emb_vec_size_; });
       sparse_model_file_ptr_->load(idx_vecs[1], tmp_slot_id_ptr, tmp_data_ptrs);
-      if (!is_full_ || (hit_rate < target_hit_rate_ && pass_counter < max_num_evict_)) {
+      if (add_block) {
         size_t offset{idx_vecs[0].size()};
         bool is_empty{idx_vecs[1].size() == 0};
         if (use_slot_id_ && !is_empty) {
           size_t *src_ptr{tmp_slot_id_ptr};
-          size_t *dst_ptr{slot_ids_[tail_id].data() + offset};
+          size_t *dst_ptr{new_block.slot_ids + offset};
           memcpy(dst_ptr, src_ptr, idx_vecs[1].size() * sizeof(size_t));
         }
+        std::fill_n(new_block.freqs + offset, idx_vecs[1].size(), 1);
         for (size_t i{0}; (i < vec_per_line_) && !is_empty; i++) {
           float *src_ptr{tmp_data_ptrs[i]};
-          float *dst_ptr{cache_datas_[tail_id][i].data() + offset * emb_vec_size_};
+          float *dst_ptr{new_block.data_ptrs[i] + offset * emb_vec_size_};
           memcpy(dst_ptr, src_ptr, idx_vecs[1].size() * emb_vec_size_ * sizeof(float));
         }
       }
     }
   }
 
-  if (!is_full_ || (hit_rate < target_hit_rate_ && pass_counter < max_num_evict_)) {
+  if (add_block) {
     if (is_full_) {
-      sparse_model_file_ptr_->dump_update(key_idx_maps_[num_block_], slot_ids_[num_block_],
-                                          cache_datas_[num_block_]);
-      pass_counter++;
+      Block &evicted_block{*blocks_[num_block_]};
+      size_t const num_retained{retain_hot_lines_(new_block, len, evicted_block)};
+      sparse_model_file_ptr_->dump_update(evicted_block.key_idx_map, evicted_block.slot_ids,
+                                          evicted_block.data_ptrs);
+      pass_counter_++;
+      HCTR_LOG_S(DEBUG, WORLD) << "HMEM-Cache PS: Retained " << num_retained
+                               << " hot keys of the evicted block" << std::endl;
     }
     head_id_ = tail_id;
     if (!is_full_ && (head_id_ == num_block_ - 1)) {
@@ -257,7 +402,7 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
 template <typename TypeKey>
 void HMemCache<TypeKey>::write(const TypeKey *key_ptr, size_t len, size_t const *slot_id_ptr,
                                std::vector<float *> &data_ptrs) {
-  size_t const num_thread(24);
+  size_t const num_thread(num_threads_);
   std::vector<std::vector<std::vector<size_t>>> sub_src_idx_vecs(num_thread);
   std::vector<std::vector<std::vector<size_t>>> sub_dst_idx_vecs(num_thread);
   std::vector<std::vector<size_t>> sub_new_key_src_idx_vecs(num_thread);
@@ -335,15 +480,16 @@ void HMemCache<TypeKey>::write(const TypeKey *key_ptr, size_t len, size_t const
   {
 #pragma omp section
     {
-#pragma omp parallel for num_threads(24)
+#pragma omp parallel for num_threads(num_thread)
       for (size_t cnt = 0; cnt < src_idx_vecs[0].size(); cnt++) {
         auto src_idx{src_idx_vecs[0][cnt]};
         auto blk_idx{dst_idx_vecs[0][cnt] / block_capacity_};
         auto dst_idx{dst_idx_vecs[0][cnt] % block_capacity_};
-        if (use_slot_id_) slot_ids_[blk_idx][dst_idx] = slot_id_ptr[src_idx];
+        Block &block{*blocks_[blk_idx]};
+        if (use_slot_id_) block.slot_ids[dst_idx] = slot_id_ptr[src_idx];
         for (size_t i{0}; i < vec_per_line_; i++) {
           float *src_ptr{data_ptrs[i] + src_idx * emb_vec_size_};
-          float *dst_ptr{cache_datas_[blk_idx][i].data() + dst_idx * emb_vec_size_};
+          float *dst_ptr{block.data_ptrs[i] + dst_idx * emb_vec_size_};
           memcpy(dst_ptr, src_ptr, emb_vec_size_ * sizeof(float));
         }
       }
@@ -373,8 +519,8 @@ void HMemCache<TypeKey>::sync_to_ssd() {
   }
   for (auto cnt{0}; cnt < num_blk; cnt++) {
     auto blk_idx{(tail_id + cnt) % num_block_};
-    sparse_model_file_ptr_->dump_update(key_idx_maps_[blk_idx], slot_ids_[blk_idx],
-                                        cache_datas_[blk_idx]);
+    Block &block{*blocks_[blk_idx]};
+    sparse_model_file_ptr_->dump_update(block.key_idx_map, block.slot_ids, block.data_ptrs);
     if (resource_manager_->is_master_process()) {
       bar.progress(cnt + 1, num_blk);
     }
@@ -338,6 +338,7 @@ SparseModelFileTS<TypeKey>::SparseModelFileTS(std::string sparse_model_path,
         check_integrate_and_init(global_sparse_model);
         // initialize the key<-->ssd mapping
         auto keys{load_data_from_file<long long>(mmap_handler_.get_key_file())};
+        key_idx_map_.reserve(keys.size());
         for (size_t i{0}; i < keys.size(); i++) {
           key_idx_map_.insert({static_cast<TypeKey>(keys[i]), i});
         }
@@ -441,7 +442,7 @@ SparseModelFileTS<TypeKey>::SparseModelFileTS(std::string sparse_model_path,
     }
 
     // filter keys belongs to the current processor
-    std::unordered_map<TypeKey, size_t> global_key_idx_map_;
+    HashTableType global_key_idx_map_;
     slot_ids.resize(slot_id_vec.size());
     size_t counter{0};
     for (size_t i{0}; i < num_key; i++) {
@@ -520,7 +521,7 @@ void SparseModelFileTS<TypeKey>::load(std::vector<size_t> const& mem_src_idx, si
       HCTR_OWN_THROW(Error_t::WrongInput, "Num of data files and pointers doesn't equal");
     }
     size_t const len{mem_src_idx.size()};
-#pragma omp parallel for num_threads(24)
+#pragma omp parallel for
     for (size_t cnt = 0; cnt < len; cnt++) {
       auto src_idx{mem_src_idx[cnt]};
       if (use_slot_id_) slot_id_ptr[cnt] = slot_ids[src_idx];
@@ -543,12 +544,23 @@ template <typename TypeKey>
 void SparseModelFileTS<TypeKey>::dump_update(HashTableType& dump_key_idx_map,
                                              std::vector<size_t>& slot_id_vec,
                                              std::vector<std::vector<float>>& data_vecs) {
+  std::vector<float*> data_ptrs(data_vecs.size());
+  for (size_t i{0}; i < data_vecs.size(); i++) {
+    data_ptrs[i] = data_vecs[i].data();
+  }
+  dump_update(dump_key_idx_map, slot_id_vec.data(), data_ptrs);
+}
+
+template <typename TypeKey>
+void SparseModelFileTS<TypeKey>::dump_update(HashTableType& dump_key_idx_map,
+                                             size_t const* slot_id_ptr,
+                                             std::vector<float*>& data_ptrs) {
   try {
     if (dump_key_idx_map.size() == 0) return;
     if (!mmap_handler_.mapped_to_file_) {
       mmap_to_memory_();
     }
-    if (data_vecs.size() != mmap_handler_.mmaped_ptrs_.size()) {
+    if (data_ptrs.size() != mmap_handler_.mmaped_ptrs_.size()) {
       HCTR_OWN_THROW(Error_t::WrongInput, "Num of data files and pointers doesn't equal");
     }
     std::vector<TypeKey> keys_vec;
@@ -560,7 +572,7 @@ void SparseModelFileTS<TypeKey>::dump_update(HashTableType& dump_key_idx_map,
       mem_idx_vec.push_back(pair.second);
     });
 
-    size_t const num_thread(24);
+    size_t const num_thread(omp_get_max_threads());
     std::vector<std::vector<std::vector<size_t>>> sub_idx_vecs(num_thread,
                                                                std::vector<std::vector<size_t>>(2));
     size_t len{keys_vec.size()};
@@ -605,11 +617,7 @@ void SparseModelFileTS<TypeKey>::dump_update(HashTableType& dump_key_idx_map,
       }
     }
 
-    std::vector<float*> data_ptrs(data_vecs.size());
-    for (size_t i{0}; i < data_vecs.size(); i++) {
-      data_ptrs[i] = data_vecs[i].data();
-    }
-    dump_update(idx_vecs[1], idx_vecs[0], slot_id_vec.data(), data_ptrs);
+    dump_update(idx_vecs[1], idx_vecs[0], slot_id_ptr, data_ptrs);
   } catch (const internal_runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -635,7 +643,7 @@ void SparseModelFileTS<TypeKey>::dump_update(std::vector<size_t> const& ssd_idx_
       HCTR_OWN_THROW(Error_t::WrongInput, "ssd_idx_vec.size() != mem_idx_vec.size()");
     }
     size_t const len{ssd_idx_vec.size()};
-#pragma omp parallel for num_threads(24)
+#pragma omp parallel for
     for (size_t cnt = 0; cnt < len; cnt++) {
       auto mem_idx{mem_idx_vec[cnt]};
       auto ssd_idx{ssd_idx_vec[cnt]};
@@ -14,9 +14,14 @@
  * limitations under the License.
  */
 
+#include <omp.h>
+
+#include <HugeCTR/include/optimizer.hpp>
+#include <cstring>
 #include <embedding_training_cache/parameter_server.hpp>
 #include <filesystem>
 #include <fstream>
+#include <numeric>
 
 namespace HugeCTR {
 
@@ -31,8 +36,63 @@ void open_and_get_size(const std::string& file_name, std::ifstream& stream,
   file_size_in_byte = std::filesystem::file_size(file_name);
 }
 
+template <typename TypeKey>
+void read_keyset_file(const std::string& keyset_file, std::vector<TypeKey>& keyset) {
+  std::ifstream keyset_stream;
+  size_t file_size_in_byte = 0;
+  open_and_get_size(keyset_file, keyset_stream, file_size_in_byte);
+
+  if (file_size_in_byte == 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, keyset_file + " is empty");
+  }
+
+  size_t num_keys_in_file = file_size_in_byte / sizeof(TypeKey);
+  keyset.resize(num_keys_in_file);
+  keyset_stream.read((char*)keyset.data(), file_size_in_byte);
+}
+
+/**
+ * Exposes host memory owned by somebody else as a TensorBuffer2.
+ */
+class HostPtrBuffer : public TensorBuffer2 {
+ public:
+  HostPtrBuffer(void* ptr) : ptr_(ptr) {}
+  bool allocated() const override { return true; }
+  void* get_ptr() override { return ptr_; }
+
+ private:
+  void* ptr_;
+};
+
+template <typename T>
+Tensor2<T> wrap_host_ptr(T* ptr, const std::vector<size_t>& dimensions) {
+  return Tensor2<T>(dimensions, std::make_shared<HostPtrBuffer>(ptr));
+}
+
 }  // namespace
 
+template <typename TypeKey>
+void ParameterServer<TypeKey>::HostBuffer::resize(size_t capacity, size_t emb_vec_size) {
+  keys.resize(capacity);
+  slot_ids.resize(capacity);
+  for (auto& vec : data) {
+    vec.resize(capacity * emb_vec_size);
+  }
+}
+
+template <typename TypeKey>
+BufferBag ParameterServer<TypeKey>::HostBuffer::as_buffer_bag(size_t emb_vec_size) {
+  const size_t capacity = keys.size();
+  BufferBag buf_bag;
+  buf_bag.keys = wrap_host_ptr(keys.data(), {capacity}).shrink();
+  buf_bag.slot_id = wrap_host_ptr(slot_ids.data(), {capacity}).shrink();
+  buf_bag.embedding = wrap_host_ptr(data[0].data(), {capacity, emb_vec_size});
+  for (size_t i = 1; i < data.size(); i++) {
+    buf_bag.opt_states.push_back(wrap_host_ptr(data[i].data(), {capacity, emb_vec_size}));
+  }
+  return buf_bag;
+}
+
 template <typename TypeKey>
 ParameterServer<TypeKey>::ParameterServer(TrainPSType_t ps_type,
                                           const std::string& sparse_model_file,
@@ -42,7 +102,11 @@ ParameterServer<TypeKey>::ParameterServer(TrainPSType_t ps_type,
                                           std::string local_path, HMemCacheConfig hmem_cache_config)
     : ps_type_(ps_type),
       use_slot_id_(embedding_type == Embedding_t::LocalizedSlotSparseEmbeddingHash ||
-                   embedding_type == Embedding_t::LocalizedSlotSparseEmbeddingOneHot) {
+                   embedding_type == Embedding_t::LocalizedSlotSparseEmbeddingOneHot),
+      emb_vec_size_(emb_vec_size),
+      num_data_per_key_(ps_type == TrainPSType_t::Cached
+                            ? 1 + OptParams::num_parameters_per_weight(opt_type)
+                            : 1) {
   if (ps_type_ != TrainPSType_t::Cached) {
     sparse_model_entity_.reset(new SparseModelEntity<TypeKey>(sparse_model_file, embedding_type,
                                                               emb_vec_size, resource_manager));
@@ -53,22 +117,28 @@ ParameterServer<TypeKey>::ParameterServer(TrainPSType_t ps_type,
         hmem_cache_config.max_num_evict, hmem_cache_config.block_capacity, sparse_model_file,
         local_path, use_slot_id_, opt_type, emb_vec_size, resource_manager));
   }
+  prefetch_buf_.data.resize(num_data_per_key_);
+  write_back_buf_.data.resize(num_data_per_key_);
 }
 
 template <typename TypeKey>
-void ParameterServer<TypeKey>::load_keyset_from_file(std::string keyset_file) {
+ParameterServer<TypeKey>::~ParameterServer() {
   try {
-    std::ifstream keyset_stream;
-    size_t file_size_in_byte = 0;
-    open_and_get_size(keyset_file, keyset_stream, file_size_in_byte);
+    sync();
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+}
 
-    if (file_size_in_byte == 0) {
-      HCTR_OWN_THROW(Error_t::WrongInput, keyset_file + " is empty");
+template <typename TypeKey>
+void ParameterServer<TypeKey>::load_keyset_from_file(std::string keyset_file) {
+  try {
+    use_prefetched_ = !prefetch_keyset_file_.empty() && keyset_file == prefetch_keyset_file_;
+    if (use_prefetched_) {
+      keyset_.clear();
+    } else {
+      read_keyset_file(keyset_file, keyset_);
     }
-
-    size_t num_keys_in_file = file_size_in_byte / sizeof(TypeKey);
-    keyset_.resize(num_keys_in_file);
-    keyset_stream.read((char*)keyset_.data(), file_size_in_byte);
 #ifdef ENABLE_MPI
     HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
 #endif
@@ -82,12 +152,51 @@ void ParameterServer<TypeKey>::load_keyset_from_file(std::string keyset_file) {
 }
 
 template <typename TypeKey>
-void ParameterServer<TypeKey>::pull(BufferBag& buf_bag, size_t& hit_size) {
-  if (keyset_.empty()) {
-    HCTR_OWN_THROW(Error_t::WrongInput, "keyset is empty");
+void ParameterServer<TypeKey>::prefetch(const std::string& keyset_file) {
+  // The staging buffer can only hold one pass at a time.
+  if (prefetch_task_.valid()) {
+    prefetch_task_.get();
+  }
+  prefetch_keyset_file_ = keyset_file;
+  use_prefetched_ = false;
+
+  // Queued behind pending write-backs. Hence, we never read outdated vectors from the PS.
+  prefetch_task_ = background_worker_.submit([this, keyset_file]() {
+    std::vector<TypeKey> keys;
+    read_keyset_file(keyset_file, keys);
+
+    prefetch_buf_.resize(keys.size(), emb_vec_size_);
+    BufferBag buf_bag{prefetch_buf_.as_buffer_bag(emb_vec_size_)};
+    size_t hit_size = 0;
+    pull_(keys, buf_bag, hit_size);
+    prefetch_buf_.size = hit_size;
+
+    // Keys that are not in the model yet may be created by the current pass. Hence, they are
+    // tracked as well, and appended to the staging buffer once they are pushed.
+    std::vector<size_t> rows(keys.size());
+    std::iota(rows.begin(), rows.begin() + hit_size, 0);
+    std::fill(rows.begin() + hit_size, rows.end(), missing_row);
+    prefetch_key_idx_map_.clear();
+    prefetch_key_idx_map_.bulk_insert(hit_size, prefetch_buf_.keys.data(), rows.data());
+    prefetch_key_idx_map_.bulk_insert(keys.size(), keys.data(), rows.data() + hit_size);
+  });
+}
+
+template <typename TypeKey>
+void ParameterServer<TypeKey>::sync() {
+  if (prefetch_task_.valid()) {
+    prefetch_task_.get();
+  }
+  if (write_back_task_.valid()) {
+    write_back_task_.get();
   }
+}
+
+template <typename TypeKey>
+void ParameterServer<TypeKey>::pull_(std::vector<TypeKey>& keys, BufferBag& buf_bag,
+                                     size_t& hit_size) {
   if (ps_type_ != TrainPSType_t::Cached) {
-    sparse_model_entity_->load_vec_by_key(keyset_, buf_bag, hit_size);
+    sparse_model_entity_->load_vec_by_key(keys, buf_bag, hit_size);
   } else {
     TypeKey* key_ptr{Tensor2<TypeKey>::stretch_from(buf_bag.keys).get_ptr()};
     size_t* slot_id_ptr{use_slot_id_ ? Tensor2<size_t>::stretch_from(buf_bag.slot_id).get_ptr()
@@ -97,18 +206,52 @@ void ParameterServer<TypeKey>::pull(BufferBag& buf_bag, size_t& hit_size) {
     for (auto& opt_state : buf_bag.opt_states) {
       data_ptrs.push_back(opt_state.get_ptr());
     }
-    memcpy(key_ptr, keyset_.data(), keyset_.size() * sizeof(TypeKey));
-    hit_size = keyset_.size();
+    memcpy(key_ptr, keys.data(), keys.size() * sizeof(TypeKey));
+    hit_size = keys.size();
     hmem_cache_->read(key_ptr, hit_size, slot_id_ptr, data_ptrs);
   }
 }
 
+template <typename TypeKey>
+void ParameterServer<TypeKey>::pull(BufferBag& buf_bag, size_t& hit_size) {
+  if (use_prefetched_) {
+    if (prefetch_task_.valid()) {
+      prefetch_task_.get();
+    }
+    hit_size = prefetch_buf_.size;
+
+    TypeKey* key_ptr{Tensor2<TypeKey>::stretch_from(buf_bag.keys).get_ptr()};
+    memcpy(key_ptr, prefetch_buf_.keys.data(), hit_size * sizeof(TypeKey));
+    if (use_slot_id_) {
+      size_t* slot_id_ptr{Tensor2<size_t>::stretch_from(buf_bag.slot_id).get_ptr()};
+      memcpy(slot_id_ptr, prefetch_buf_.slot_ids.data(), hit_size * sizeof(size_t));
+    }
+    for (size_t i = 0; i < num_data_per_key_; i++) {
+      float* dst_ptr{(i == 0) ? buf_bag.embedding.get_ptr() : buf_bag.opt_states[i - 1].get_ptr()};
+      memcpy(dst_ptr, prefetch_buf_.data[i].data(), hit_size * emb_vec_size_ * sizeof(float));
+    }
+
+    use_prefetched_ = false;
+    prefetch_keyset_file_.clear();
+    return;
+  }
+
+  if (keyset_.empty()) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "keyset is empty");
+  }
+  // Discard outdated prefetches.
+  sync();
+  prefetch_keyset_file_.clear();
+  pull_(keyset_, buf_bag, hit_size);
+}
+
 template <typename TypeKey>
 std::pair<std::vector<long long>, std::vector<float>> ParameterServer<TypeKey>::pull(
     const std::vector<long long>& keys_to_load) {
   if (keys_to_load.empty()) {
     HCTR_OWN_THROW(Error_t::WrongInput, "\nkeyset is empty");
   }
+  sync();
   if (ps_type_ != TrainPSType_t::Cached) {
     return sparse_model_entity_->load_vec_by_key(keys_to_load);
   } else {
@@ -117,8 +260,7 @@ std::pair<std::vector<long long>, std::vector<float>> ParameterServer<TypeKey>::
 }
 
 template <typename TypeKey>
-void ParameterServer<TypeKey>::push(BufferBag& buf_bag, size_t dump_size) {
-  if (dump_size == 0) return;
+void ParameterServer<TypeKey>::push_(BufferBag& buf_bag, size_t dump_size) {
   if (ps_type_ != TrainPSType_t::Cached) {
     sparse_model_entity_->dump_vec_by_key(buf_bag, dump_size);
   } else {
@@ -134,8 +276,83 @@ void ParameterServer<TypeKey>::push(BufferBag& buf_bag, size_t dump_size) {
   }
 }
 
+template <typename TypeKey>
+void ParameterServer<TypeKey>::push(BufferBag& buf_bag, size_t dump_size) {
+  if (dump_size == 0) return;
+
+  const TypeKey* key_ptr{Tensor2<TypeKey>::stretch_from(buf_bag.keys).get_ptr()};
+  const size_t* slot_id_ptr{
+      use_slot_id_ ? Tensor2<size_t>::stretch_from(buf_bag.slot_id).get_ptr() : nullptr};
+  std::vector<const float*> data_ptrs;
+  for (size_t i = 0; i < num_data_per_key_; i++) {
+    data_ptrs.push_back((i == 0) ? buf_bag.embedding.get_ptr()
+                                 : buf_bag.opt_states[i - 1].get_ptr());
+  }
+  const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
+
+  // The prefetched pass may contain keys that were trained in the current pass. Patch them.
+  if (!prefetch_keyset_file_.empty()) {
+    if (prefetch_task_.valid()) {
+      prefetch_task_.get();
+    }
+
+    auto copy_row = [&](const size_t src_idx, const size_t dst_idx) {
+      if (use_slot_id_) prefetch_buf_.slot_ids[dst_idx] = slot_id_ptr[src_idx];
+      for (size_t j = 0; j < num_data_per_key_; j++) {
+        memcpy(&prefetch_buf_.data[j][dst_idx * emb_vec_size_],
+               data_ptrs[j] + src_idx * emb_vec_size_, emb_vec_size_in_byte);
+      }
+    };
+
+    std::vector<std::vector<size_t>> chunk_new_idx(omp_get_max_threads());
+#pragma omp parallel
+    {
+      const size_t tid = omp_get_thread_num();
+#pragma omp for
+      for (size_t i = 0; i < dump_size; i++) {
+        const auto it{prefetch_key_idx_map_.find(key_ptr[i])};
+        if (it == prefetch_key_idx_map_.end()) continue;
+        if (it->second == missing_row) {
+          chunk_new_idx[tid].push_back(i);
+        } else {
+          copy_row(i, it->second);
+        }
+      }
+    }
+
+    for (const auto& new_idx : chunk_new_idx) {
+      for (const size_t i : new_idx) {
+        const size_t dst_idx{prefetch_buf_.size++};
+        prefetch_key_idx_map_.at(key_ptr[i]) = dst_idx;
+        prefetch_buf_.keys[dst_idx] = key_ptr[i];
+        copy_row(i, dst_idx);
+      }
+    }
+  }
+
+  // Copy to the write-back buffer, and release the buffer bag for loading the next pass.
+  if (write_back_task_.valid()) {
+    write_back_task_.get();
+  }
+  write_back_buf_.resize(dump_size, emb_vec_size_);
+  memcpy(write_back_buf_.keys.data(), key_ptr, dump_size * sizeof(TypeKey));
+  if (use_slot_id_) {
+    memcpy(write_back_buf_.slot_ids.data(), slot_id_ptr, dump_size * sizeof(size_t));
+  }
+  for (size_t i = 0; i < num_data_per_key_; i++) {
+    memcpy(write_back_buf_.data[i].data(), data_ptrs[i], dump_size * emb_vec_size_in_byte);
+  }
+  write_back_buf_.size = dump_size;
+
+  write_back_task_ = background_worker_.submit([this]() {
+    BufferBag buf_bag{write_back_buf_.as_buffer_bag(emb_vec_size_)};
+    push_(buf_bag, write_back_buf_.size);
+  });
+}
+
 template <typename TypeKey>
 void ParameterServer<TypeKey>::flush_emb_tbl_to_ssd() {
+  sync();
   if (ps_type_ != TrainPSType_t::Cached) {
     sparse_model_entity_->flush_emb_tbl_to_ssd();
   } else {
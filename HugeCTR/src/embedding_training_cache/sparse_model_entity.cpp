@@ -41,12 +41,12 @@ void type_convert(std::vector<TypeDst> &dst_vec, const std::vector<TypeSrc> &src
 }
 
 template <typename TypeKey>
-void parallel_table_lookup(
-    const std::vector<TypeKey> &keys,
-    const std::unordered_map<TypeKey, std::pair<size_t, size_t>> &exist_key_idx_mapping,
-    const std::unordered_map<TypeKey, std::pair<size_t, size_t>> &new_key_idx_mapping,
-    BufferBag &buf_bag, std::vector<TypeKey> &exist_keys, std::vector<size_t> &exist_idx,
-    bool is_distributed, bool save_to_buf_bag) {
+void parallel_table_lookup(const std::vector<TypeKey> &keys,
+                           const KeyIndexMap<TypeKey, SlotIndex> &exist_key_idx_mapping,
+                           const KeyIndexMap<TypeKey, SlotIndex> &new_key_idx_mapping,
+                           BufferBag &buf_bag, std::vector<TypeKey> &exist_keys,
+                           std::vector<size_t> &exist_idx, bool is_distributed,
+                           bool save_to_buf_bag) {
   TypeKey *key_ptr{nullptr};
   size_t *slot_id_ptr{nullptr};
 
@@ -140,6 +140,8 @@ SparseModelEntity<TypeKey>::SparseModelEntity(const std::string &sparse_model_fi
       sparse_model_file_(SparseModelFile<TypeKey>(sparse_model_file, embedding_type, emb_vec_size,
                                                   resource_manager)) {
   sparse_model_file_.load_emb_tbl_to_mem(exist_key_idx_mapping_, host_emb_tabel_);
+  const size_t num_rows = host_emb_tabel_.size() / emb_vec_size_;
+  dirty_groups_.resize((num_rows + rows_per_dirty_group - 1) / rows_per_dirty_group, 0);
 }
 
 template <typename TypeKey>
@@ -285,7 +287,7 @@ void SparseModelEntity<TypeKey>::dump_vec_by_key(BufferBag &buf_bag, const size_
         if (iter == new_key_idx_mapping_.end()) {
           size_t slot_id_temp = is_distributed_ ? 0 : slot_id_ptr[idx + i];
           size_t vec_idx_temp = num_exist_vecs + chunk_cnt_new_keys[tid]++;
-          chunk_new_key_idx_mapping[tid].emplace(key, std::make_pair(slot_id_temp, vec_idx_temp));
+          chunk_new_key_idx_mapping[tid].emplace(key, SlotIndex{slot_id_temp, vec_idx_temp});
           chunk_idx_dst[tid].push_back(-1 * vec_idx_temp - 1);
         } else {
           chunk_idx_dst[tid].push_back(iter->second.second);
@@ -315,9 +317,9 @@ void SparseModelEntity<TypeKey>::dump_vec_by_key(BufferBag &buf_bag, const size_
       memcpy(idx_dst.data() + offset, tmp_idx_dst[tid].data(),
              tmp_idx_dst[tid].size() * sizeof(size_t));
 
-      for_each(std::execution::par, chunk_new_key_idx_mapping[tid].begin(),
-               chunk_new_key_idx_mapping[tid].end(),
-               [val = new_key_offset[tid]](auto &pair) { pair.second.second += val; });
+      std::for_each(std::execution::par, chunk_new_key_idx_mapping[tid].begin(),
+                    chunk_new_key_idx_mapping[tid].end(),
+                    [val = new_key_offset[tid]](auto &pair) { pair.second.second += val; });
     }
 
     cnt_new_keys = 0;
@@ -330,6 +332,8 @@ void SparseModelEntity<TypeKey>::dump_vec_by_key(BufferBag &buf_bag, const size_
 
     size_t extended_table_size = host_emb_tabel_.size() + cnt_new_keys * emb_vec_size_;
     host_emb_tabel_.resize(extended_table_size);
+    const size_t num_rows = extended_table_size / emb_vec_size_;
+    dirty_groups_.resize((num_rows + rows_per_dirty_group - 1) / rows_per_dirty_group, 0);
 
 #pragma omp parallel num_threads(chunk_num)
     {
@@ -345,6 +349,8 @@ void SparseModelEntity<TypeKey>::dump_vec_by_key(BufferBag &buf_bag, const size_
         size_t src_idx = (idx + i) * emb_vec_size_;
         size_t dst_idx = idx_dst[idx + i] * emb_vec_size_;
         memcpy(&host_emb_tabel_[dst_idx], &vec_ptr[src_idx], emb_vec_size_ * sizeof(float));
+        __atomic_store_n(&dirty_groups_[idx_dst[idx + i] / rows_per_dirty_group], uint8_t{1},
+                         __ATOMIC_RELAXED);
       }
     }
 
@@ -366,20 +372,18 @@ void SparseModelEntity<TypeKey>::dump_vec_by_key(BufferBag &buf_bag, const size_
 template <typename TypeKey>
 void SparseModelEntity<TypeKey>::flush_emb_tbl_to_ssd() {
   try {
-    HCTR_LOG(INFO, ROOT, "Updating sparse model in SSD\n");
-
     std::vector<TypeKey> exist_keys, new_keys;
     std::vector<size_t> exist_vec_idx, new_vec_idx, new_slots;
 
-    exist_keys.reserve(exist_key_idx_mapping_.size());
-    exist_vec_idx.reserve(exist_key_idx_mapping_.size());
     new_keys.reserve(new_key_idx_mapping_.size());
     new_slots.reserve(new_key_idx_mapping_.size());
     new_vec_idx.reserve(new_key_idx_mapping_.size());
 
     for (const auto &exist_pair : exist_key_idx_mapping_) {
-      exist_keys.push_back(exist_pair.first);
-      exist_vec_idx.push_back(exist_pair.second.second);
+      if (dirty_groups_[exist_pair.second.second / rows_per_dirty_group]) {
+        exist_keys.push_back(exist_pair.first);
+        exist_vec_idx.push_back(exist_pair.second.second);
+      }
     }
     for (const auto &new_pair : new_key_idx_mapping_) {
       new_keys.push_back(new_pair.first);
@@ -387,6 +391,10 @@ void SparseModelEntity<TypeKey>::flush_emb_tbl_to_ssd() {
       new_vec_idx.push_back(new_pair.second.second);
     }
 
+    HCTR_LOG_S(INFO, ROOT) << "Updating sparse model in SSD: " << exist_keys.size()
+                           << " modified and " << new_keys.size() << " new embedding vectors"
+                           << std::endl;
+
     exist_key_idx_mapping_.insert(new_key_idx_mapping_.begin(), new_key_idx_mapping_.end());
     new_key_idx_mapping_.clear();
 
@@ -400,11 +408,15 @@ void SparseModelEntity<TypeKey>::flush_emb_tbl_to_ssd() {
         sparse_model_file_.dump_exist_vec_by_key(exist_keys, exist_vec_idx, host_emb_tabel_.data());
         sparse_model_file_.append_new_vec_and_key(new_keys, new_slots.data(), new_vec_idx,
                                                   host_emb_tabel_.data());
+        // The embedding loaders, the HPS and other tools read the key, slot_id and emb_vector
+        // files directly, so leave no delta log behind. Compacting only appends the new rows.
+        sparse_model_file_.compact();
 #ifdef ENABLE_MPI
       }
       HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
     }
 #endif
+    std::fill(dirty_groups_.begin(), dirty_groups_.end(), 0);
     HCTR_LOG(INFO, ROOT, "Done!\n");
   } catch (const internal_runtime_error &rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
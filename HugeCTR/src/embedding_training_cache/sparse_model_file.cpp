@@ -19,14 +19,23 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <embedding_training_cache/sparse_model_file.hpp>
 #include <filesystem>
 #include <fstream>
 #include <map>
+#include <numeric>
+#include <optional>
+#include <thread>
 
 namespace HugeCTR {
 
@@ -42,6 +51,89 @@ void open_and_get_size(const std::string& file_name, std::ifstream& stream,
   file_size_in_byte = std::filesystem::file_size(file_name);
 }
 
+// The delta log consists of a header followed by fixed-size records
+// <long long key, size_t slot_id, float emb_vector[emb_vec_size]>.
+struct DeltaLogHeader {
+  uint64_t magic;
+  // Number of rows in the base files when the first record was appended.
+  uint64_t num_base_rows;
+};
+constexpr uint64_t delta_log_magic{0x474f4c44'52544348};  // "HCTRDLOG"
+constexpr size_t delta_vec_offset{sizeof(long long) + sizeof(size_t)};
+
+struct ScopedFd {
+  int fd{-1};
+
+  ScopedFd(const std::string& file_name, int flags)
+      : fd(open(file_name.c_str(), flags, S_IRUSR | S_IWUSR)) {
+    if (fd == -1) {
+      HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open the file: " + file_name);
+    }
+  }
+  ScopedFd(const ScopedFd&) = delete;
+  ScopedFd& operator=(const ScopedFd&) = delete;
+  ~ScopedFd() { close(fd); }
+};
+
+bool pread_all(int fd, void* buf, size_t count, size_t offset) {
+  char* ptr = reinterpret_cast<char*>(buf);
+  while (count > 0) {
+    const ssize_t ret = pread(fd, ptr, count, offset);
+    if (ret <= 0) {
+      if (ret == -1 && errno == EINTR) continue;
+      return false;
+    }
+    ptr += ret;
+    count -= ret;
+    offset += ret;
+  }
+  return true;
+}
+
+bool pwrite_all(int fd, const void* buf, size_t count, size_t offset) {
+  const char* ptr = reinterpret_cast<const char*>(buf);
+  while (count > 0) {
+    const ssize_t ret = pwrite(fd, ptr, count, offset);
+    if (ret <= 0) {
+      if (ret == -1 && errno == EINTR) continue;
+      return false;
+    }
+    ptr += ret;
+    count -= ret;
+    offset += ret;
+  }
+  return true;
+}
+
+bool pwritev_all(int fd, iovec* iov, int iovcnt, size_t offset) {
+  while (iovcnt > 0) {
+    const ssize_t ret = pwritev(fd, iov, iovcnt, offset);
+    if (ret <= 0) {
+      if (ret == -1 && errno == EINTR) continue;
+      return false;
+    }
+    offset += ret;
+    // Skip the buffers that were written completely, and resume within the partial one.
+    size_t written = ret;
+    while (iovcnt > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = reinterpret_cast<char*>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return true;
+}
+
+void check_io(bool success, const std::string& what, const std::string& file_name) {
+  if (!success) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, what + " " + file_name + " failed: " + strerror(errno));
+  }
+}
+
 }  // namespace
 
 template <typename TypeKey>
@@ -50,11 +142,13 @@ struct SparseModelFile<TypeKey>::EmbeddingTableFile {
   std::string key_file;
   std::string slot_file;
   std::string vec_file;
+  std::string delta_file;
 
   EmbeddingTableFile(std::string sparse_model) : folder_name(sparse_model) {
     key_file = sparse_model + "/key";
     slot_file = sparse_model + "/slot_id";
     vec_file = sparse_model + "/emb_vector";
+    delta_file = sparse_model + "/delta";
   }
 };
 
@@ -94,27 +188,6 @@ void SparseModelFile<TypeKey>::map_embedding_to_memory_() {
   }
 }
 
-template <typename TypeKey>
-void SparseModelFile<TypeKey>::sync_mmaped_embedding_with_disk_() {
-  try {
-    const std::string emb_vec_file = mmap_handler_.get_vec_file();
-    if (!mmap_handler_.maped_to_memory_) {
-      HCTR_OWN_THROW(Error_t::IllegalCall, emb_vec_file + " not mapped to HMEM");
-    }
-    const size_t vec_file_size_in_byte = std::filesystem::file_size(emb_vec_file);
-    int ret = msync(mmap_handler_.mmaped_table_, vec_file_size_in_byte, MS_SYNC);
-    if (ret != 0) {
-      HCTR_OWN_THROW(Error_t::WrongInput, "Mmap sync error");
-    }
-  } catch (const internal_runtime_error& rt_err) {
-    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
-    throw;
-  } catch (const std::exception& err) {
-    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
-    throw;
-  }
-}
-
 template <typename TypeKey>
 void SparseModelFile<TypeKey>::unmap_embedding_from_memory_() {
   try {
@@ -136,12 +209,132 @@ void SparseModelFile<TypeKey>::unmap_embedding_from_memory_() {
   }
 }
 
+template <typename TypeKey>
+size_t SparseModelFile<TypeKey>::delta_record_size_() const {
+  return delta_vec_offset + emb_vec_size_ * sizeof(float);
+}
+
+template <typename TypeKey>
+std::pair<size_t, size_t> SparseModelFile<TypeKey>::get_num_rows_() {
+  const std::string delta_file = mmap_handler_.get_delta_file();
+  size_t num_delta_rows = 0;
+  if (std::filesystem::exists(delta_file)) {
+    const size_t delta_file_size_in_byte = std::filesystem::file_size(delta_file);
+    if (delta_file_size_in_byte > sizeof(DeltaLogHeader)) {
+      // A partially written record at the end is ignored, and overwritten by the next append.
+      num_delta_rows = (delta_file_size_in_byte - sizeof(DeltaLogHeader)) / delta_record_size_();
+    }
+  }
+  if (num_delta_rows == 0) {
+    return {std::filesystem::file_size(mmap_handler_.get_key_file()) / sizeof(long long), 0};
+  }
+
+  // The base files may contain the leftovers of an interrupted compaction. Hence, the number of
+  // base rows is taken from the header.
+  DeltaLogHeader header;
+  {
+    ScopedFd delta_fd(delta_file, O_RDONLY);
+    check_io(pread_all(delta_fd.fd, &header, sizeof(header), 0), "Reading", delta_file);
+  }
+  if (header.magic != delta_log_magic) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Invalid delta log: " + delta_file);
+  }
+  return {header.num_base_rows, num_delta_rows};
+}
+
+template <typename TypeKey>
+void SparseModelFile<TypeKey>::write_rows_(const std::vector<size_t>& dst_rows,
+                                           const std::vector<size_t>& vec_indices,
+                                           const float* vecs) {
+  const size_t num_rows = dst_rows.size();
+  const size_t num_base_rows = get_num_rows_().first;
+  const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
+  const size_t record_size = delta_record_size_();
+
+  std::vector<size_t> order(num_rows);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&dst_rows](size_t lhs, size_t rhs) { return dst_rows[lhs] < dst_rows[rhs]; });
+
+  const std::string vec_file = mmap_handler_.get_vec_file();
+  const std::string delta_file = mmap_handler_.get_delta_file();
+  ScopedFd vec_fd(vec_file, O_WRONLY);
+  std::optional<ScopedFd> delta_fd;
+  if (dst_rows[order.back()] >= num_base_rows) {
+    delta_fd.emplace(delta_file, O_WRONLY);
+  }
+
+  std::atomic<bool> vec_success{true}, delta_success{true};
+#pragma omp parallel num_threads(std::thread::hardware_concurrency())
+  {
+    const size_t tid = omp_get_thread_num();
+    const size_t thread_num = omp_get_num_threads();
+    size_t sub_chunk_size = num_rows / thread_num;
+    size_t res_chunk_size = num_rows % thread_num;
+    const size_t idx = tid * sub_chunk_size;
+
+    if (tid == thread_num - 1) sub_chunk_size += res_chunk_size;
+
+    // Rows that are adjacent in the file are written with a single system call.
+    std::vector<iovec> iov;
+    iov.reserve(IOV_MAX);
+    int fd = -1;
+    size_t begin = 0, end = 0;
+    size_t range_begin[2] = {SIZE_MAX, SIZE_MAX}, range_end[2] = {0, 0};
+    auto write_iov = [&]() {
+      if (!iov.empty() && !pwritev_all(fd, iov.data(), iov.size(), begin)) {
+        (fd == vec_fd.fd ? vec_success : delta_success) = false;
+      }
+      iov.clear();
+    };
+
+    for (size_t i = 0; i < sub_chunk_size; i++) {
+      const size_t src = order[idx + i];
+      const size_t row = dst_rows[src];
+      const bool in_delta = row >= num_base_rows;
+      const int row_fd = in_delta ? delta_fd->fd : vec_fd.fd;
+      const size_t offset =
+          in_delta
+              ? sizeof(DeltaLogHeader) + (row - num_base_rows) * record_size + delta_vec_offset
+              : row * emb_vec_size_in_byte;
+      if (row_fd != fd || offset != end || iov.size() == IOV_MAX) {
+        write_iov();
+        fd = row_fd;
+        begin = offset;
+      }
+      iov.push_back({const_cast<float*>(&vecs[vec_indices[src] * emb_vec_size_]),
+                     emb_vec_size_in_byte});
+      end = offset + emb_vec_size_in_byte;
+      range_begin[in_delta] = std::min(range_begin[in_delta], offset);
+      range_end[in_delta] = end;
+    }
+    write_iov();
+
+    // Start the writeback of this range, so that it overlaps with the writes of other threads.
+    for (int in_delta = 0; in_delta < 2; in_delta++) {
+      if (range_begin[in_delta] < range_end[in_delta]) {
+        sync_file_range(in_delta ? delta_fd->fd : vec_fd.fd, range_begin[in_delta],
+                        range_end[in_delta] - range_begin[in_delta], SYNC_FILE_RANGE_WRITE);
+      }
+    }
+  }
+  check_io(vec_success, "Writing", vec_file);
+  check_io(delta_success, "Writing", delta_file);
+
+  check_io(fdatasync(vec_fd.fd) == 0, "Syncing", vec_file);
+  if (delta_fd) {
+    check_io(fdatasync(delta_fd->fd) == 0, "Syncing", delta_file);
+  }
+}
+
 template <typename TypeKey>
 SparseModelFile<TypeKey>::SparseModelFile(const std::string& sparse_model_file,
                                           Embedding_t embedding_type, size_t emb_vec_size,
-                                          std::shared_ptr<ResourceManager> resource_manager)
+                                          std::shared_ptr<ResourceManager> resource_manager,
+                                          double max_delta_ratio)
     : is_distributed_(embedding_type == Embedding_t::DistributedSlotSparseEmbeddingHash),
       emb_vec_size_(emb_vec_size),
+      max_delta_ratio_(max_delta_ratio),
       resource_manager_(resource_manager) {
   try {
     mmap_handler_.emb_tbl_.reset(new EmbeddingTableFile(sparse_model_file));
@@ -170,40 +363,73 @@ SparseModelFile<TypeKey>::SparseModelFile(const std::string& sparse_model_file,
     size_t key_file_size_in_byte;
     open_and_get_size(mmap_handler_.get_key_file(), key_stream, key_file_size_in_byte);
 
+    const auto [num_base_rows, num_delta_rows] = get_num_rows_();
     size_t num_key = key_file_size_in_byte / sizeof(long long);
     size_t num_vec =
         std::filesystem::file_size(mmap_handler_.get_vec_file()) / (sizeof(float) * emb_vec_size_);
-    if (num_key != num_vec) {
+    if (num_delta_rows == 0 && num_key != num_vec) {
       HCTR_OWN_THROW(Error_t::BrokenFile, "num of vec and num of key do not equal");
     }
+    if (num_key < num_base_rows || num_vec < num_base_rows) {
+      HCTR_OWN_THROW(Error_t::BrokenFile, "num of key or vec is less than recorded in delta log");
+    }
 
     std::ifstream slot_stream;
     size_t slot_file_size_in_byte;
     if (!is_distributed_) {
       open_and_get_size(mmap_handler_.get_slot_file(), slot_stream, slot_file_size_in_byte);
       size_t num_slot = slot_file_size_in_byte / sizeof(size_t);
-      if (num_key != num_slot) {
+      if (num_delta_rows == 0 && num_key != num_slot) {
         HCTR_OWN_THROW(Error_t::BrokenFile, "num of key and num of slot_id do not equal");
       }
+      if (num_slot < num_base_rows) {
+        HCTR_OWN_THROW(Error_t::BrokenFile, "num of slot_id is less than recorded in delta log");
+      }
     }
 
-    std::vector<TypeKey> key_vec(num_key);
-    std::vector<size_t> slot_id_vec(num_key);
+    const size_t num_rows = num_base_rows + num_delta_rows;
+    std::vector<TypeKey> key_vec(num_rows);
+    std::vector<size_t> slot_id_vec(num_rows);
     if (std::is_same<TypeKey, long long>::value) {
-      key_stream.read(reinterpret_cast<char*>(key_vec.data()), key_file_size_in_byte);
+      key_stream.read(reinterpret_cast<char*>(key_vec.data()), num_base_rows * sizeof(long long));
     } else {
-      std::vector<long long> i64_key_vec(num_key, 0);
-      key_stream.read(reinterpret_cast<char*>(i64_key_vec.data()), key_file_size_in_byte);
+      std::vector<long long> i64_key_vec(num_base_rows, 0);
+      key_stream.read(reinterpret_cast<char*>(i64_key_vec.data()),
+                      num_base_rows * sizeof(long long));
       std::transform(i64_key_vec.begin(), i64_key_vec.end(), key_vec.begin(),
                      [](long long key) { return static_cast<unsigned>(key); });
     }
     if (!is_distributed_) {
-      slot_stream.read(reinterpret_cast<char*>(slot_id_vec.data()), slot_file_size_in_byte);
+      slot_stream.read(reinterpret_cast<char*>(slot_id_vec.data()),
+                       num_base_rows * sizeof(size_t));
+    }
+
+    // replay the delta log
+    if (num_delta_rows > 0) {
+      const std::string delta_file = mmap_handler_.get_delta_file();
+      const size_t record_size = delta_record_size_();
+      std::vector<char> records(num_delta_rows * record_size);
+      {
+        ScopedFd delta_fd(delta_file, O_RDONLY);
+        check_io(pread_all(delta_fd.fd, records.data(), records.size(), sizeof(DeltaLogHeader)),
+                 "Reading", delta_file);
+      }
+      for (size_t i = 0; i < num_delta_rows; i++) {
+        const char* record = &records[i * record_size];
+        long long key;
+        memcpy(&key, record, sizeof(long long));
+        key_vec[num_base_rows + i] = static_cast<TypeKey>(key);
+        memcpy(&slot_id_vec[num_base_rows + i], record + sizeof(long long), sizeof(size_t));
+      }
+      HCTR_LOG_S(INFO, ROOT) << "Replayed " << num_delta_rows << " embedding vectors from "
+                             << delta_file << std::endl;
     }
 
     // each rank stores a subset of embedding table
     int my_rank = resource_manager_->get_process_id();
-    for (size_t i = 0; i < num_key; i++) {
+    std::vector<SlotIndex> slot_idx_vec(num_rows);
+    size_t num_local_key = 0;
+    for (size_t i = 0; i < num_rows; i++) {
       int dst_rank;
       if (is_distributed_) {
         TypeKey key = key_vec[i];
@@ -216,9 +442,15 @@ SparseModelFile<TypeKey>::SparseModelFile(const std::string& sparse_model_file,
       }
       if (my_rank == dst_rank) {
         size_t slot_id = is_distributed_ ? 0 : slot_id_vec[i];
-        key_idx_map_.insert({key_vec[i], {slot_id, i}});
+        if (slot_id > SlotIndex::max_slot) {
+          HCTR_OWN_THROW(Error_t::WrongInput, "slot_id exceeds the range of SlotIndex");
+        }
+        key_vec[num_local_key] = key_vec[i];
+        slot_idx_vec[num_local_key] = {slot_id, i};
+        num_local_key++;
       }
     }
+    key_idx_map_.bulk_insert(num_local_key, key_vec.data(), slot_idx_vec.data());
   } catch (const internal_runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -240,8 +472,20 @@ void SparseModelFile<TypeKey>::load_exist_vec_by_key(const std::vector<TypeKey>&
     }
     vecs.resize(keys.size() * emb_vec_size_);
     const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
+    const size_t record_size = delta_record_size_();
+
+    const auto [num_base_rows, num_delta_rows] = get_num_rows_();
+    const std::string delta_file = mmap_handler_.get_delta_file();
+    std::optional<ScopedFd> delta_fd;
+    if (num_delta_rows > 0) {
+      delta_fd.emplace(delta_file, O_RDONLY);
+    }
+    const bool has_base_rows = std::filesystem::file_size(mmap_handler_.get_vec_file()) > 0;
+    if (has_base_rows) {
+      map_embedding_to_memory_();
+    }
 
-    map_embedding_to_memory_();
+    std::atomic<bool> success{true};
 #pragma omp parallel num_threads(8)
     {
       const size_t tid = omp_get_thread_num();
@@ -255,14 +499,24 @@ void SparseModelFile<TypeKey>::load_exist_vec_by_key(const std::vector<TypeKey>&
       for (size_t i = 0; i < sub_chunk_size; i++) {
         const auto& pair = key_idx_map_.at(keys[idx + i]);
         if (!is_distributed_) slots[idx + i] = pair.first;
-        size_t src_vec_idx = pair.second * emb_vec_size_;
         size_t dst_vec_idx = (idx + i) * emb_vec_size_;
-        memcpy(&vecs[dst_vec_idx], &(mmap_handler_.mmaped_table_[src_vec_idx]),
-               emb_vec_size_in_byte);
+        if (pair.second < num_base_rows) {
+          size_t src_vec_idx = pair.second * emb_vec_size_;
+          memcpy(&vecs[dst_vec_idx], &(mmap_handler_.mmaped_table_[src_vec_idx]),
+                 emb_vec_size_in_byte);
+        } else {
+          size_t offset = sizeof(DeltaLogHeader) + (pair.second - num_base_rows) * record_size +
+                          delta_vec_offset;
+          if (!pread_all(delta_fd->fd, &vecs[dst_vec_idx], emb_vec_size_in_byte, offset)) {
+            success = false;
+          }
+        }
       }
     }
-    sync_mmaped_embedding_with_disk_();
-    unmap_embedding_from_memory_();
+    if (has_base_rows) {
+      unmap_embedding_from_memory_();
+    }
+    check_io(success, "Reading", delta_file);
   } catch (const internal_runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -282,29 +536,12 @@ void SparseModelFile<TypeKey>::dump_exist_vec_by_key(const std::vector<TypeKey>&
     }
     if (keys.size() == 0) return;
 
-    const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
-
-    map_embedding_to_memory_();
-#pragma omp parallel num_threads(8)
-    {
-      const size_t tid = omp_get_thread_num();
-      const size_t thread_num = omp_get_num_threads();
-      size_t sub_chunk_size = keys.size() / thread_num;
-      size_t res_chunk_size = keys.size() % thread_num;
-      const size_t idx = tid * sub_chunk_size;
-
-      if (tid == thread_num - 1) sub_chunk_size += res_chunk_size;
-
-      for (size_t i = 0; i < sub_chunk_size; i++) {
-        size_t src_vec_idx = vec_indices[idx + i] * emb_vec_size_;
-        const auto& pair = key_idx_map_.at(keys[idx + i]);
-        size_t dst_vec_idx = pair.second * emb_vec_size_;
-        memcpy(&(mmap_handler_.mmaped_table_[dst_vec_idx]), &vecs[src_vec_idx],
-               emb_vec_size_in_byte);
-      }
+    std::vector<size_t> dst_rows(keys.size());
+#pragma omp parallel for num_threads(8)
+    for (size_t i = 0; i < keys.size(); i++) {
+      dst_rows[i] = key_idx_map_.at(keys[i]).second;
     }
-    sync_mmaped_embedding_with_disk_();
-    unmap_embedding_from_memory_();
+    write_rows_(dst_rows, vec_indices, vecs);
   } catch (const internal_runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -331,49 +568,117 @@ void SparseModelFile<TypeKey>::append_new_vec_and_key(const std::vector<TypeKey>
       }
     };
     std::for_each(keys.begin(), keys.end(), check_key_exists_op);
-
-    long long* key_ptr = nullptr;
-    std::vector<long long> i64_keys;
-    if (std::is_same<TypeKey, long long>::value) {
-      key_ptr = const_cast<long long*>(reinterpret_cast<const long long*>(keys.data()));
-    } else {
-      i64_keys.resize(keys.size());
-      std::transform(keys.begin(), keys.end(), i64_keys.begin(),
-                     [](unsigned key) { return static_cast<long long>(key); });
-      key_ptr = i64_keys.data();
+    if (!is_distributed_ && std::any_of(slots, slots + keys.size(), [](size_t slot_id) {
+          return slot_id > SlotIndex::max_slot;
+        })) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "slot_id exceeds the range of SlotIndex");
     }
+    if (keys.size() == 0) return;
 
     const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
-    const size_t num_vec_in_file =
-        std::filesystem::file_size(mmap_handler_.get_vec_file()) / emb_vec_size_in_byte;
-    // write keys, slots, vectors to file
-    std::ofstream key_ofs(mmap_handler_.get_key_file(), std::ofstream::out | std::ofstream::app);
-    if (!key_ofs.is_open()) {
-      HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open key file");
+    const size_t record_size = delta_record_size_();
+    std::vector<char> records(keys.size() * record_size);
+#pragma omp parallel for num_threads(std::thread::hardware_concurrency())
+    for (size_t i = 0; i < keys.size(); i++) {
+      char* record = &records[i * record_size];
+      const long long key = static_cast<long long>(keys[i]);
+      const size_t slot_id = is_distributed_ ? 0 : slots[i];
+      memcpy(record, &key, sizeof(long long));
+      memcpy(record + sizeof(long long), &slot_id, sizeof(size_t));
+      memcpy(record + delta_vec_offset, &vecs[vec_indices[i] * emb_vec_size_],
+             emb_vec_size_in_byte);
     }
-    key_ofs.write(reinterpret_cast<const char*>(key_ptr), keys.size() * sizeof(long long));
 
-    if (!is_distributed_) {
-      std::ofstream slot_ofs(mmap_handler_.get_slot_file(),
-                             std::ofstream::out | std::ofstream::app);
-      if (!slot_ofs.is_open()) {
-        HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open slot file");
+    // write the records ahead to the delta log, base files are updated by compaction
+    const auto [num_base_rows, num_delta_rows] = get_num_rows_();
+    const std::string delta_file = mmap_handler_.get_delta_file();
+    {
+      ScopedFd delta_fd(delta_file, O_WRONLY | O_CREAT);
+      if (num_delta_rows == 0) {
+        const DeltaLogHeader header{delta_log_magic, num_base_rows};
+        check_io(pwrite_all(delta_fd.fd, &header, sizeof(header), 0), "Writing", delta_file);
       }
-      slot_ofs.write(reinterpret_cast<const char*>(slots), keys.size() * sizeof(size_t));
+      const size_t offset = sizeof(DeltaLogHeader) + num_delta_rows * record_size;
+      check_io(pwrite_all(delta_fd.fd, records.data(), records.size(), offset), "Writing",
+               delta_file);
+      check_io(ftruncate(delta_fd.fd, offset + records.size()) == 0, "Truncating", delta_file);
+      check_io(fdatasync(delta_fd.fd) == 0, "Syncing", delta_file);
     }
 
-    size_t extended_vec_file_size = std::filesystem::file_size(mmap_handler_.get_vec_file()) +
-                                    keys.size() * emb_vec_size_in_byte;
-    std::filesystem::resize_file(mmap_handler_.get_vec_file(), extended_vec_file_size);
-
     // update key_idx_map_
+    key_idx_map_.reserve(key_idx_map_.size() + keys.size());
     for (size_t i = 0; i < keys.size(); i++) {
       size_t slot_id = is_distributed_ ? 0 : slots[i];
-      key_idx_map_.insert({keys[i], {slot_id, num_vec_in_file + i}});
+      key_idx_map_.emplace(keys[i], SlotIndex{slot_id, num_base_rows + num_delta_rows + i});
+    }
+
+    if (num_delta_rows + keys.size() > max_delta_ratio_ * num_base_rows) {
+      compact();
+    }
+  } catch (const internal_runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    throw;
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+    throw;
+  }
+}
+
+template <typename TypeKey>
+void SparseModelFile<TypeKey>::compact() {
+  try {
+    const auto [num_base_rows, num_delta_rows] = get_num_rows_();
+    if (num_delta_rows == 0) return;
+
+    const std::string delta_file = mmap_handler_.get_delta_file();
+    const size_t record_size = delta_record_size_();
+    const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
+    std::vector<char> records(num_delta_rows * record_size);
+    {
+      ScopedFd delta_fd(delta_file, O_RDONLY);
+      check_io(pread_all(delta_fd.fd, records.data(), records.size(), sizeof(DeltaLogHeader)),
+               "Reading", delta_file);
+    }
+
+    std::vector<long long> keys(num_delta_rows);
+    std::vector<size_t> slots(num_delta_rows);
+    std::vector<float> vecs(num_delta_rows * emb_vec_size_);
+#pragma omp parallel for num_threads(std::thread::hardware_concurrency())
+    for (size_t i = 0; i < num_delta_rows; i++) {
+      const char* record = &records[i * record_size];
+      memcpy(&keys[i], record, sizeof(long long));
+      memcpy(&slots[i], record + sizeof(long long), sizeof(size_t));
+      memcpy(&vecs[i * emb_vec_size_], record + delta_vec_offset, emb_vec_size_in_byte);
+    }
+
+    // Rows are written to their final offset instead of being appended. Thus, the leftovers of
+    // an interrupted compaction are simply overwritten.
+    auto write_base_file = [num_base_rows = num_base_rows, num_delta_rows = num_delta_rows](
+                               const std::string& file_name, const void* data,
+                               size_t row_size_in_byte) {
+      ScopedFd fd(file_name, O_WRONLY);
+      check_io(pwrite_all(fd.fd, data, num_delta_rows * row_size_in_byte,
+                          num_base_rows * row_size_in_byte),
+               "Writing", file_name);
+      check_io(ftruncate(fd.fd, (num_base_rows + num_delta_rows) * row_size_in_byte) == 0,
+               "Truncating", file_name);
+      check_io(fdatasync(fd.fd) == 0, "Syncing", file_name);
+    };
+    write_base_file(mmap_handler_.get_vec_file(), vecs.data(), emb_vec_size_in_byte);
+    if (!is_distributed_) {
+      write_base_file(mmap_handler_.get_slot_file(), slots.data(), sizeof(size_t));
     }
+    // The key file determines the number of base rows once the delta log is empty.
+    write_base_file(mmap_handler_.get_key_file(), keys.data(), sizeof(long long));
 
-    // write embedding vector to disk
-    dump_exist_vec_by_key(keys, vec_indices, vecs);
+    // the base files are durable, drop the delta log
+    {
+      ScopedFd delta_fd(delta_file, O_WRONLY);
+      check_io(ftruncate(delta_fd.fd, 0) == 0, "Truncating", delta_file);
+      check_io(fdatasync(delta_fd.fd) == 0, "Syncing", delta_file);
+    }
+    HCTR_LOG_S(INFO, ROOT) << "Compacted " << num_delta_rows << " embedding vectors from "
+                           << delta_file << std::endl;
   } catch (const internal_runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -388,17 +693,18 @@ void SparseModelFile<TypeKey>::load_emb_tbl_to_mem(HashTableType& mem_key_index_
                                                    std::vector<float>& vecs) {
   try {
     const size_t num_vecs = key_idx_map_.size();
-    mem_key_index_map.clear();
-    mem_key_index_map.reserve(num_vecs);
     vecs.resize(num_vecs * emb_vec_size_);
 
+    // Copying the flat index retains its layout, so that no rehashing is required. Only the
+    // indices need to be renumbered to the position in host memory.
+    mem_key_index_map = key_idx_map_;
+
     std::vector<TypeKey> exist_key;
     exist_key.reserve(num_vecs);
     size_t counter = 0;
-    for (auto key_idx_pair : key_idx_map_) {
+    for (auto& key_idx_pair : mem_key_index_map) {
       exist_key.push_back(key_idx_pair.first);
       key_idx_pair.second.second = counter++;
-      mem_key_index_map.emplace(std::move(key_idx_pair));
     }
 
     std::vector<size_t> temp_slots;
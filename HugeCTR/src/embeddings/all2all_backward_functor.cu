@@ -102,7 +102,7 @@ void SparseEmbeddingFunctors::all2all_backward(size_t batch_size_per_gpu, size_t
 
 #ifndef NDEBUG
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all backward src_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < total_gpu_count; j++) {
@@ -112,7 +112,7 @@ void SparseEmbeddingFunctors::all2all_backward(size_t batch_size_per_gpu, size_t
     }
   }
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all backward dst_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < total_gpu_count; j++) {
@@ -194,7 +194,7 @@ void SparseEmbeddingFunctors::all2all_backward(size_t batch_size_per_gpu,
 
 #ifndef NDEBUG
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all backward table:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < local_gpu_count; j++) {
@@ -233,7 +233,7 @@ void SparseEmbeddingFunctors::all2all_backward(size_t batch_size_per_gpu,
 
 #ifndef NDEBUG
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all backward src_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < local_gpu_count; j++) {
@@ -243,7 +243,7 @@ void SparseEmbeddingFunctors::all2all_backward(size_t batch_size_per_gpu,
     }
   }
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all backward dst_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < local_gpu_count; j++) {
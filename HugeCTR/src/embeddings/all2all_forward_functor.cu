@@ -92,7 +92,7 @@ void SparseEmbeddingFunctors::all2all_forward(size_t batch_size_per_gpu, size_t
 
 #ifndef NDEBUG
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all forward src_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < total_gpu_count; j++) {
@@ -102,7 +102,7 @@ void SparseEmbeddingFunctors::all2all_forward(size_t batch_size_per_gpu, size_t
     }
   }
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all forward dst_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < total_gpu_count; j++) {
@@ -174,7 +174,7 @@ void SparseEmbeddingFunctors::all2all_forward(size_t batch_size_per_gpu,
 
 #ifndef NDEBUG
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all forward table:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < local_gpu_count; j++) {
@@ -213,7 +213,7 @@ void SparseEmbeddingFunctors::all2all_forward(size_t batch_size_per_gpu,
 
 #ifndef NDEBUG
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all forward src_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < local_gpu_count; j++) {
@@ -223,7 +223,7 @@ void SparseEmbeddingFunctors::all2all_forward(size_t batch_size_per_gpu,
     }
   }
   {
-    auto log = HCTR_LOG_S(DEBUG, ROOT);
+    auto log = HCTR_LOG_ENTRY(DEBUG, ROOT);
     log << "nccl all2all forward dst_pos:" << std::endl;
     for (size_t i = 0; i < local_gpu_count; i++) {
       for (size_t j = 0; j < local_gpu_count; j++) {
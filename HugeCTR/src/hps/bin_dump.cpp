@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <cerrno>
+#include <cstring>
+#include <hps/bin_dump.hpp>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+namespace {
+
+size_t align_up(const size_t offset) {
+  return (offset + bin_dump_alignment - 1) / bin_dump_alignment * bin_dump_alignment;
+}
+
+void pwrite_all(const int fd, const void* const buf, const size_t n, const size_t offset) {
+  const char* p = static_cast<const char*>(buf);
+  for (size_t done = 0; done < n;) {
+    const ssize_t res = ::pwrite(fd, &p[done], n - done, static_cast<off_t>(offset + done));
+    HCTR_CHECK_HINT(res > 0 || (res < 0 && errno == EINTR), "Dump write failed: %s",
+                    std::strerror(errno));
+    if (res > 0) {
+      done += static_cast<size_t>(res);
+    }
+  }
+}
+
+void pread_all(const int fd, void* const buf, const size_t n, const size_t offset) {
+  char* p = static_cast<char*>(buf);
+  for (size_t done = 0; done < n;) {
+    const ssize_t res = ::pread(fd, &p[done], n - done, static_cast<off_t>(offset + done));
+    HCTR_CHECK_HINT(res > 0 || (res < 0 && errno == EINTR), "Dump read failed: %s",
+                    std::strerror(errno));
+    if (res > 0) {
+      done += static_cast<size_t>(res);
+    }
+  }
+}
+
+void init_header(BinDumpHeader& header, const uint32_t key_size) {
+  std::memset(&header, 0, sizeof(BinDumpHeader));
+  std::memcpy(header.magic, "bin", 4);
+  header.version = bin_dump_version;
+  header.key_size = key_size;
+  header.index_offset = sizeof(BinDumpHeader);
+}
+
+}  // namespace
+
+BinDumpWriter::BinDumpWriter(const std::string& path, const uint32_t key_size,
+                             const uint32_t value_size, const std::vector<size_t>& partition_sizes,
+                             const BinDumpPartitioner_t partitioner)
+    : path_{path} {
+  fd_ = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+  HCTR_CHECK_HINT(fd_ >= 0, "Unable to create dump file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+
+  // Assign pairs to partitions.
+  index_.reserve(partition_sizes.size());
+  size_t num_pairs = 0;
+  for (const size_t partition_size : partition_sizes) {
+    index_.push_back({num_pairs, partition_size});
+    num_pairs += partition_size;
+  }
+
+  // Fix the layout.
+  init_header(header_, key_size);
+  header_.value_size = value_size;
+  header_.num_pairs = num_pairs;
+  header_.num_partitions = static_cast<uint32_t>(index_.size());
+  header_.partitioner = static_cast<uint32_t>(partitioner);
+  header_.keys_offset =
+      align_up(header_.index_offset + index_.size() * sizeof(BinDumpPartition));
+  header_.values_offset = align_up(header_.keys_offset + num_pairs * key_size);
+
+  const size_t file_size = header_.values_offset + num_pairs * value_size;
+  HCTR_CHECK_HINT(::ftruncate(fd_, static_cast<off_t>(file_size)) == 0,
+                  "Unable to allocate dump file '%s': %s", path.c_str(), std::strerror(errno));
+}
+
+BinDumpWriter::BinDumpWriter(const std::string& path, const uint32_t key_size) : path_{path} {
+  fd_ = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+  HCTR_CHECK_HINT(fd_ >= 0, "Unable to create dump file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+
+  // Values are written in place. Keys are spilled to an anonymous file and appended by finish().
+  const std::string keys_path = path + ".keys";
+  keys_fd_ = ::open(keys_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+  HCTR_CHECK_HINT(keys_fd_ >= 0, "Unable to create spill file '%s': %s", keys_path.c_str(),
+                  std::strerror(errno));
+  ::unlink(keys_path.c_str());
+
+  index_.push_back({0, 0});
+
+  init_header(header_, key_size);
+  header_.num_partitions = 1;
+  header_.partitioner = static_cast<uint32_t>(BinDumpPartitioner_t::None);
+  header_.values_offset = align_up(header_.index_offset + sizeof(BinDumpPartition));
+}
+
+BinDumpWriter::~BinDumpWriter() {
+  if (keys_fd_ >= 0) {
+    ::close(keys_fd_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void BinDumpWriter::write(const size_t partition, const size_t first_pair, const size_t num_pairs,
+                          const void* const keys, const char* const values) {
+  HCTR_CHECK(keys_fd_ < 0 && partition < index_.size());
+  const BinDumpPartition& part = index_[partition];
+  HCTR_CHECK(first_pair + num_pairs <= part.num_pairs);
+
+  const size_t pair = part.first_pair + first_pair;
+  pwrite_all(fd_, keys, num_pairs * header_.key_size,
+             header_.keys_offset + pair * header_.key_size);
+  pwrite_all(fd_, values, num_pairs * header_.value_size,
+             header_.values_offset + pair * header_.value_size);
+}
+
+void BinDumpWriter::append(const size_t num_pairs, const void* const keys,
+                           const char* const values, const uint32_t value_size) {
+  HCTR_CHECK(keys_fd_ >= 0);
+  if (!num_pairs) {
+    return;
+  }
+  if (header_.value_size == 0) {
+    header_.value_size = value_size;
+  } else {
+    HCTR_CHECK_HINT(value_size == header_.value_size, "Value size mismatch! (%u <> %u)!",
+                    value_size, header_.value_size);
+  }
+
+  pwrite_all(keys_fd_, keys, num_pairs * header_.key_size, header_.num_pairs * header_.key_size);
+  pwrite_all(fd_, values, num_pairs * value_size,
+             header_.values_offset + header_.num_pairs * value_size);
+  header_.num_pairs += num_pairs;
+  index_.front().num_pairs += num_pairs;
+}
+
+void BinDumpWriter::finish() {
+  HCTR_CHECK(fd_ >= 0);
+
+  // Move spilled keys behind the values.
+  if (keys_fd_ >= 0) {
+    header_.keys_offset =
+        align_up(header_.values_offset + header_.num_pairs * header_.value_size);
+
+    std::vector<char> buffer(4 * 1024 * 1024);
+    const size_t keys_size = header_.num_pairs * header_.key_size;
+    for (size_t offset = 0; offset < keys_size;) {
+      const size_t n = std::min(buffer.size(), keys_size - offset);
+      pread_all(keys_fd_, buffer.data(), n, offset);
+      pwrite_all(fd_, buffer.data(), n, header_.keys_offset + offset);
+      offset += n;
+    }
+
+    ::close(keys_fd_);
+    keys_fd_ = -1;
+  }
+
+  // Data must be persisted before the header, which marks the dump as complete.
+  pwrite_all(fd_, index_.data(), index_.size() * sizeof(BinDumpPartition), header_.index_offset);
+  HCTR_CHECK_HINT(::fdatasync(fd_) == 0, "Dump sync failed: %s", std::strerror(errno));
+  pwrite_all(fd_, &header_, sizeof(BinDumpHeader), 0);
+  HCTR_CHECK_HINT(::fdatasync(fd_) == 0, "Dump sync failed: %s", std::strerror(errno));
+
+  ::close(fd_);
+  fd_ = -1;
+}
+
+BinDumpReader::BinDumpReader(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  HCTR_CHECK_HINT(fd >= 0, "Unable to open dump file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+
+  struct stat st;
+  HCTR_CHECK(::fstat(fd, &st) == 0);
+  size_ = static_cast<size_t>(st.st_size);
+  HCTR_CHECK_HINT(size_ >= sizeof(BinDumpHeader), "Dump file '%s' is truncated!", path.c_str());
+
+  void* const data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  HCTR_CHECK_HINT(data != MAP_FAILED, "Unable to map dump file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+  data_ = static_cast<char*>(data);
+  // Each partition is consumed front to back.
+  ::madvise(data_, size_, MADV_SEQUENTIAL);
+
+  // Validate header.
+  header_ = reinterpret_cast<const BinDumpHeader*>(data_);
+  HCTR_CHECK_HINT(std::memcmp(header_->magic, "bin", 4) == 0 &&
+                      header_->version == bin_dump_version,
+                  "'%s' is not a version %u dump file!", path.c_str(), bin_dump_version);
+
+  const size_t num_pairs = header_->num_pairs;
+  const size_t index_size = header_->num_partitions * sizeof(BinDumpPartition);
+  HCTR_CHECK_HINT(header_->index_offset + index_size <= size_ &&
+                      header_->keys_offset + num_pairs * header_->key_size <= size_ &&
+                      header_->values_offset + num_pairs * header_->value_size <= size_,
+                  "Dump file '%s' is truncated!", path.c_str());
+
+  index_ = reinterpret_cast<const BinDumpPartition*>(&data_[header_->index_offset]);
+  for (size_t i = 0; i < header_->num_partitions; i++) {
+    HCTR_CHECK_HINT(index_[i].first_pair + index_[i].num_pairs <= num_pairs,
+                    "Dump file '%s', partition %zu: Index is corrupted!", path.c_str(), i);
+  }
+}
+
+BinDumpReader::~BinDumpReader() {
+  if (data_) {
+    ::munmap(data_, size_);
+  }
+}
+
+uint32_t BinDumpReader::peek_version(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  HCTR_CHECK_HINT(fd >= 0, "Unable to open dump file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+
+  char buffer[2 * sizeof(uint32_t)];
+  const ssize_t res = ::pread(fd, buffer, sizeof(buffer), 0);
+  ::close(fd);
+  if (res != static_cast<ssize_t>(sizeof(buffer)) || std::memcmp(buffer, "bin", 4) != 0) {
+    return 0;
+  }
+
+  uint32_t version;
+  std::memcpy(&version, &buffer[4], sizeof(uint32_t));
+  return version;
+}
+
+}  // namespace HugeCTR
@@ -16,9 +16,12 @@
 
 #include <rocksdb/sst_file_reader.h>
 
+#include <algorithm>
 #include <base/debug/logger.hpp>
 #include <fstream>
+#include <hps/bin_dump.hpp>
 #include <hps/database_backend.hpp>
+#include <hps/database_backend_detail.hpp>
 #include <sstream>
 
 // TODO: Remove me!
@@ -61,6 +64,42 @@ size_t DatabaseBackend<Key>::fetch(const std::string& table_name, const size_t n
   return 0;
 }
 
+template <typename Key>
+size_t DatabaseBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                   const Key* const keys, char* const values,
+                                   const size_t value_size, const size_t value_stride,
+                                   std::vector<size_t>& missing,
+                                   const std::chrono::nanoseconds& time_budget) {
+  // Generic implementation for backends that do not provide a dedicated bulk variant.
+  BulkFetchTarget target(values, value_size, value_stride, num_keys, missing);
+  const size_t hit_count = fetch(
+      table_name, num_keys, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
+template <typename Key>
+size_t DatabaseBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                   const size_t* const indices, const Key* const keys,
+                                   char* const values, const size_t value_size,
+                                   const size_t value_stride, std::vector<size_t>& missing,
+                                   const std::chrono::nanoseconds& time_budget) {
+  // Generic implementation for backends that do not provide a dedicated bulk variant.
+  BulkFetchTarget target(values, value_size, value_stride, num_indices, missing);
+  const size_t hit_count = fetch(
+      table_name, num_indices, indices, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
 template <typename Key>
 size_t DatabaseBackend<Key>::evict(const std::vector<std::string>& table_names) {
   size_t n = 0;
@@ -87,20 +126,7 @@ void DatabaseBackend<Key>::dump(const std::string& table_name, const std::string
 
   switch (format) {
     case DBTableDumpFormat_t::Raw: {
-      std::ofstream file{path, std::ios::binary};
-
-      // Write header.
-      const char magic[] = "bin";
-      file.write(magic, sizeof(magic));
-
-      const uint32_t version = 1;
-      file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
-
-      const uint32_t key_size = sizeof(Key);
-      file.write(reinterpret_cast<const char*>(&key_size), sizeof(uint32_t));
-
-      // Write data.
-      dump_bin(table_name, file);
+      dump_bin(table_name, path);
     } break;
     case DBTableDumpFormat_t::SST: {
       rocksdb::Options options;
@@ -133,6 +159,25 @@ void DatabaseBackend<Key>::load_dump(const std::string& table_name, const std::s
 
 template <typename Key>
 void DatabaseBackend<Key>::load_dump_bin(const std::string& table_name, const std::string& path) {
+  const uint32_t format_version = BinDumpReader::peek_version(path);
+  HCTR_CHECK_HINT(format_version == 1 || format_version == bin_dump_version,
+                  "'%s' is not a supported dump file!", path.c_str());
+
+  if (format_version == bin_dump_version) {
+    const BinDumpReader file{path};
+    const BinDumpHeader& header = file.header();
+    HCTR_CHECK(header.key_size == sizeof(Key));
+
+    // Insert straight from the mapped file. Backends parallelize each batch internally.
+    for (size_t i = 0; i < header.num_pairs; i += max_set_batch_size_) {
+      const size_t batch_size = std::min(max_set_batch_size_, header.num_pairs - i);
+      insert(table_name, batch_size, reinterpret_cast<const Key*>(file.keys(i)), file.values(i),
+             header.value_size);
+    }
+    return;
+  }
+
+  // Legacy format: Interleaved keys and values.
   std::ifstream file{path, std::ios::binary};
   HCTR_CHECK(file.is_open());
 
@@ -268,10 +313,15 @@ VolatileBackend<Key>::VolatileBackend(const size_t max_get_batch_size,
 template <typename Key>
 std::future<void> VolatileBackend<Key>::insert_async(
     const std::string& table_name, const std::shared_ptr<std::vector<Key>>& keys,
-    const std::shared_ptr<std::vector<char>>& values, size_t value_size) {
+    const std::shared_ptr<std::vector<char>>& values, size_t value_size,
+    const std::function<void(bool)>& on_complete) {
   HCTR_CHECK(keys->size() * value_size == values->size());
-  return background_worker_.submit([this, table_name, keys, values, value_size]() {
-    this->insert(table_name, keys->size(), keys->data(), values->data(), value_size);
+  return background_worker_.submit([this, table_name, keys, values, value_size, on_complete]() {
+    const bool success =
+        this->insert(table_name, keys->size(), keys->data(), values->data(), value_size);
+    if (on_complete) {
+      on_complete(success);
+    }
   });
 }
 
@@ -137,6 +137,23 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
     }
   }
 
+  // Register the metrics of each table
+  MetricsRegistry& registry = MetricsRegistry::get();
+  table_metrics_.reserve(cache_config_.num_emb_table_);
+  for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+    const MetricLabels labels{{"model", cache_config_.model_name_},
+                              {"table", cache_config_.embedding_table_name_[i]},
+                              {"device", std::to_string(cache_config_.cuda_dev_id_)}};
+    table_metrics_.push_back({
+        registry.counter("hps_embedding_cache_queries_total",
+                         "Unique keys queried from the GPU embedding cache.", labels),
+        registry.counter("hps_embedding_cache_hits_total",
+                         "Unique keys found in the GPU embedding cache.", labels),
+        registry.gauge("hps_embedding_cache_hit_rate",
+                       "Hit rate of the most recent GPU embedding cache lookup.", labels),
+    });
+  }
+
   // Query the size of all embedding tables and calculate the size of each embedding cache
   if (cache_config_.use_gpu_embedding_cache_) {
     cache_config_.num_set_in_cache_.reserve(cache_config_.num_emb_table_);
@@ -305,6 +322,11 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
           1.0 - (static_cast<double>(workspace_handler.h_missing_length_[table_id]) /
                  static_cast<double>(workspace_handler.h_unique_length_[table_id]));
     }
+    TableMetrics& metrics = table_metrics_[table_id];
+    metrics.queries.add(workspace_handler.h_unique_length_[table_id]);
+    metrics.hits.add(workspace_handler.h_unique_length_[table_id] -
+                     workspace_handler.h_missing_length_[table_id]);
+    metrics.hit_rate.set(workspace_handler.h_hit_rate_[table_id]);
 
     bool async_insert_flag{workspace_handler.h_hit_rate_[table_id] >= hit_rate_threshold};
 
@@ -19,9 +19,11 @@
 #include <base/debug/logger.hpp>
 #include <cstring>
 #include <execution>
+#include <hps/bin_dump.hpp>
 #include <hps/database_backend_detail.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server_base.hpp>
+#include <hps/metrics_registry.hpp>
 #include <random>
 
 // TODO: Remove me!
@@ -120,7 +122,8 @@ HashMapBackend<Key>::HashMapBackend(const size_t num_partitions, const size_t al
     : Base(max_get_batch_size, max_set_batch_size, overflow_margin, overflow_policy,
            overflow_resolution_target),
       num_partitions_{num_partitions},
-      allocation_rate_{allocation_rate} {
+      allocation_rate_{allocation_rate},
+      metrics_{DatabaseBackendMetrics::get(get_name())} {
   HCTR_LOG_S(DEBUG, WORLD) << "Created blank database backend in local memory!" << std::endl;
 }
 
@@ -391,17 +394,20 @@ bool HashMapBackend<Key>::insert(const std::string& table_name, const size_t num
 }
 
 template <typename Key>
-size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
-                                  const Key* const keys, const DatabaseHitCallback& on_hit,
-                                  const DatabaseMissCallback& on_miss,
-                                  const std::chrono::nanoseconds& time_budget) {
+template <typename HitFn, typename MissFn>
+size_t HashMapBackend<Key>::fetch_(const std::string& table_name, const size_t num_keys,
+                                   const Key* const keys, HitFn&& on_hit, MissFn&& on_miss,
+                                   const std::chrono::nanoseconds& time_budget) {
   const auto begin = std::chrono::high_resolution_clock::now();
   const std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions.
   const auto& tables_it = tables_.find(table_name);
   if (tables_it == tables_.end()) {
-    return Base::fetch(table_name, num_keys, keys, on_hit, on_miss, time_budget);
+    for (size_t i = 0; i < num_keys; i++) {
+      on_miss(i);
+    }
+    return 0;
   }
   const std::vector<Partition>& parts = tables_it->second;
 
@@ -539,18 +545,21 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
 }
 
 template <typename Key>
-size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
-                                  const size_t* const indices, const Key* const keys,
-                                  const DatabaseHitCallback& on_hit,
-                                  const DatabaseMissCallback& on_miss,
-                                  const std::chrono::nanoseconds& time_budget) {
+template <typename HitFn, typename MissFn>
+size_t HashMapBackend<Key>::fetch_(const std::string& table_name, const size_t num_indices,
+                                   const size_t* const indices, const Key* const keys,
+                                   HitFn&& on_hit, MissFn&& on_miss,
+                                   const std::chrono::nanoseconds& time_budget) {
   const auto begin = std::chrono::high_resolution_clock::now();
   const std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions.
   const auto& tables_it = tables_.find(table_name);
   if (tables_it == tables_.end()) {
-    return Base::fetch(table_name, num_indices, indices, keys, on_hit, on_miss, time_budget);
+    for (const size_t* i = indices; i != &indices[num_indices]; i++) {
+      on_miss(*i);
+    }
+    return 0;
   }
   const std::vector<Partition>& parts = tables_it->second;
 
@@ -672,9 +681,9 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
                   << ", batch " << num_batches << ": " << (hit_count - prev_hit_count) << " / "
                   << batch_size << " hits. Time: " << elapsed.count() << " / "
                   << time_budget.count() << " ns." << std::endl;
-
-              joint_hit_count += hit_count;
             }
+
+            joint_hit_count += hit_count;
           }));
         }
         ThreadPool::await(tasks.begin(), tasks.end());
@@ -690,6 +699,59 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
   return hit_count;
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                  const Key* const keys, const DatabaseHitCallback& on_hit,
+                                  const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) {
+  return fetch_(table_name, num_keys, keys, on_hit, on_miss, time_budget);
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                  const size_t* const indices, const Key* const keys,
+                                  const DatabaseHitCallback& on_hit,
+                                  const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) {
+  return fetch_(table_name, num_indices, indices, keys, on_hit, on_miss, time_budget);
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                  const Key* const keys, char* const values,
+                                  const size_t value_size, const size_t value_stride,
+                                  std::vector<size_t>& missing,
+                                  const std::chrono::nanoseconds& time_budget) {
+  // Handlers are inlined into the lookup loop.
+  BulkFetchTarget target(values, value_size, value_stride, num_keys, missing);
+  const size_t hit_count = fetch_(
+      table_name, num_keys, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                  const size_t* const indices, const Key* const keys,
+                                  char* const values, const size_t value_size,
+                                  const size_t value_stride, std::vector<size_t>& missing,
+                                  const std::chrono::nanoseconds& time_budget) {
+  // Handlers are inlined into the lookup loop.
+  BulkFetchTarget target(values, value_size, value_stride, num_indices, missing);
+  const size_t hit_count = fetch_(
+      table_name, num_indices, indices, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::evict(const std::string& table_name) {
   const std::unique_lock lock(read_write_guard_);
@@ -821,27 +883,78 @@ std::vector<std::string> HashMapBackend<Key>::find_tables(const std::string& mod
 }
 
 template <typename Key>
-void HashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstream& file) {
+std::vector<Key> HashMapBackend<Key>::keys(const std::string& table_name) const {
   const std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions.
   const auto& tables_it = tables_.find(table_name);
   if (tables_it == tables_.end()) {
+    return {};
+  }
+  const std::vector<Partition>& parts = tables_it->second;
+
+  std::vector<Key> keys;
+  keys.reserve(
+      std::accumulate(parts.begin(), parts.end(), size_t{0},
+                      [](const size_t a, const Partition& b) { return a + b.entries.size(); }));
+  for (const Partition& part : parts) {
+    for (const Entry& entry : part.entries) {
+      keys.emplace_back(entry.first);
+    }
+  }
+  return keys;
+}
+
+template <typename Key>
+void HashMapBackend<Key>::dump_bin(const std::string& table_name, const std::string& path) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it = tables_.find(table_name);
+  if (tables_it == tables_.end()) {
+    BinDumpWriter(path, key_size, 0, {}, BinDumpPartitioner_t::None).finish();
     return;
   }
   const std::vector<Partition>& parts = tables_it->second;
 
-  // Store value size.
+  // Each partition becomes a section of the file.
   const uint32_t value_size = parts.empty() ? 0 : parts[0].value_size;
-  file.write(reinterpret_cast<const char*>(&value_size), sizeof(uint32_t));
+  std::vector<size_t> part_sizes;
+  part_sizes.reserve(parts.size());
+  for (const Partition& part : parts) {
+    part_sizes.emplace_back(part.entries.size());
+  }
+  BinDumpWriter file(path, key_size, value_size, part_sizes, BinDumpPartitioner_t::Hash);
+
+  // Gather and write partitions in parallel.
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(parts.size());
 
-  // Store values.
   for (const Partition& part : parts) {
-    for (const Entry& entry : part.entries) {
-      file.write(reinterpret_cast<const char*>(&entry.first), sizeof(Key));
-      file.write(entry.second->value, value_size);
-    }
+    tasks.emplace_back(ThreadPool::get().submit([&]() {
+      std::vector<Key> keys;
+      keys.reserve(this->max_set_batch_size_);
+      std::vector<char> values;
+      values.reserve(this->max_set_batch_size_ * value_size);
+
+      size_t num_written = 0;
+      for (const Entry& entry : part.entries) {
+        keys.emplace_back(entry.first);
+        values.insert(values.end(), entry.second->value, &entry.second->value[value_size]);
+
+        if (keys.size() >= this->max_set_batch_size_) {
+          file.write(part.index, num_written, keys.size(), keys.data(), values.data());
+          num_written += keys.size();
+          keys.clear();
+          values.clear();
+        }
+      }
+      file.write(part.index, num_written, keys.size(), keys.data(), values.data());
+    }));
   }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  file.finish();
 }
 
 template <typename Key>
@@ -879,6 +992,86 @@ void HashMapBackend<Key>::dump_sst(const std::string& table_name, rocksdb::SstFi
   }
 }
 
+template <typename Key>
+void HashMapBackend<Key>::load_dump_bin(const std::string& table_name, const std::string& path) {
+  if (BinDumpReader::peek_version(path) != bin_dump_version) {
+    Base::load_dump_bin(table_name, path);
+    return;
+  }
+
+  const BinDumpReader file{path};
+  const BinDumpHeader& header = file.header();
+  HCTR_CHECK(header.key_size == key_size);
+
+  // Unless the dump was partitioned like this table, we have to redistribute the keys.
+  if (header.partitioner != static_cast<uint32_t>(BinDumpPartitioner_t::Hash) ||
+      header.num_partitions != num_partitions_ || header.num_pairs == 0) {
+    Base::load_dump_bin(table_name, path);
+    return;
+  }
+  const size_t value_size = header.value_size;
+
+  const std::unique_lock lock(read_write_guard_);
+
+  // Locate the partitions, or create them, if they do not exist yet.
+  const auto& tables_it = tables_.try_emplace(table_name).first;
+  std::vector<Partition>& parts = tables_it->second;
+  if (parts.empty()) {
+    HCTR_CHECK(value_size > 0 && value_size <= allocation_rate_);
+
+    parts.reserve(num_partitions_);
+    for (size_t i = 0; i < num_partitions_; i++) {
+      parts.emplace_back(i, header.value_size);
+    }
+  } else {
+    HCTR_CHECK(parts.size() == num_partitions_);
+  }
+
+  std::atomic<size_t> joint_num_inserts{0};
+
+  // Each section of the file maps to exactly one partition. Hence, no filtering is required.
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(num_partitions_);
+
+  for (Partition& part : parts) {
+    tasks.emplace_back(ThreadPool::get().submit([&]() {
+      HCTR_CHECK(part.value_size == value_size);
+
+      const BinDumpPartition& section = file.partition(part.index);
+      const Key* const keys = reinterpret_cast<const Key*>(file.keys(section.first_pair));
+      const char* const values = file.values(section.first_pair);
+      part.entries.reserve(
+          std::min(part.entries.size() + section.num_pairs, this->overflow_margin_));
+
+      size_t num_inserts = 0;
+
+      // Step through batch-by-batch.
+      for (size_t i = 0; i < section.num_pairs;) {
+        // Check overflow condition.
+        if (part.entries.size() >= this->overflow_margin_) {
+          resolve_overflow_(table_name, part);
+        }
+
+        // Perform insertion.
+        const time_t now = std::time(nullptr);
+
+        const size_t batch_end = std::min(i + this->max_set_batch_size_, section.num_pairs);
+        for (; i != batch_end; i++) {
+          HCTR_CHECK(HCTR_KEY_TO_DB_PART_INDEX(keys[i]) == part.index);
+          HCTR_HASH_MAP_BACKEND_INSERT_(keys[i], &values[i * value_size]);
+        }
+      }
+
+      joint_num_inserts += num_inserts;
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  HCTR_LOG_S(DEBUG, WORLD) << get_name() << " backend; Table " << table_name << ": Loaded "
+                           << joint_num_inserts << " / " << header.num_pairs << " entries from '"
+                           << path << "'." << std::endl;
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name, Partition& part) {
   // Return if no overflow.
@@ -886,6 +1079,7 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name, Par
     return 0;
   }
 
+  const MetricTimer timer(metrics_.overflow_resolution_duration);
   size_t hit_count = 0;
 
   switch (this->overflow_policy_) {
@@ -959,6 +1153,7 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name, Par
     } break;
   }
 
+  metrics_.overflow_evicted_keys.add(hit_count);
   return hit_count;
 }
 
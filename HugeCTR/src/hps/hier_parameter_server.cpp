@@ -14,19 +14,64 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <base/debug/tracer.hpp>
 #include <cmath>
 #include <filesystem>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server.hpp>
+#include <hps/immutable_store_backend.hpp>
 #include <hps/kafka_message.hpp>
+#include <hps/metrics_registry.hpp>
 #include <hps/modelloader.hpp>
 #include <hps/mp_hash_map_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <hps/sharded_hash_map_backend.hpp>
+#include <hps/value_codec.hpp>
+#include <iterator>
+#include <mutex>
 #include <regex>
+#include <thread_pool.hpp>
 
 namespace HugeCTR {
 
+namespace {
+
+struct LookupMetrics final {
+  MetricCounter& keys;
+  MetricCounter& volatile_db_hits;
+  MetricCounter& persistent_db_hits;
+  MetricCounter& misses;
+  MetricHistogram& duration;
+  MetricHistogram& volatile_db_duration;
+  MetricHistogram& persistent_db_duration;
+
+  static LookupMetrics& get() {
+    static LookupMetrics metrics = []() {
+      MetricsRegistry& registry = MetricsRegistry::get();
+      const char keys_help[] = "Keys looked up in the parameter server.";
+      const char hits_help[] = "Keys found in each tier of the parameter server.";
+      const char misses_help[] = "Keys not found in any tier (set to the default value).";
+      const char duration_help[] = "Duration of parameter server lookups per tier.";
+      return LookupMetrics{
+          registry.counter("hps_lookup_keys_total", keys_help),
+          registry.counter("hps_lookup_hits_total", hits_help, {{"tier", "volatile_db"}}),
+          registry.counter("hps_lookup_hits_total", hits_help, {{"tier", "persistent_db"}}),
+          registry.counter("hps_lookup_misses_total", misses_help),
+          registry.histogram("hps_lookup_duration_seconds", duration_help, {{"tier", "total"}}),
+          registry.histogram("hps_lookup_duration_seconds", duration_help,
+                             {{"tier", "volatile_db"}}),
+          registry.histogram("hps_lookup_duration_seconds", duration_help,
+                             {{"tier", "persistent_db"}}),
+      };
+    }();
+    return metrics;
+  }
+};
+
+}  // namespace
+
 std::string HierParameterServerBase::make_tag_name(const std::string& model_name,
                                                    const std::string& embedding_table_name,
                                                    const bool check_arguments) {
@@ -118,13 +163,21 @@ HierParameterServer<TypeHashKey>::HierParameterServer(
             conf.overflow_policy, conf.overflow_resolution_target);
         break;
 
+      case DatabaseType_t::ShardedHashMap:
+        HCTR_LOG_S(INFO, WORLD) << "Creating Sharded HashMap CPU database backend..." << std::endl;
+        volatile_db_ = std::make_unique<ShardedHashMapBackend<TypeHashKey>>(
+            conf.num_partitions, conf.numa_aware, conf.allocation_rate, conf.max_get_batch_size,
+            conf.max_set_batch_size, conf.overflow_margin, conf.overflow_policy,
+            conf.overflow_resolution_target);
+        break;
+
       case DatabaseType_t::RedisCluster:
         HCTR_LOG_S(INFO, WORLD) << "Creating RedisCluster backend..." << std::endl;
         volatile_db_ = std::make_unique<RedisClusterBackend<TypeHashKey>>(
             conf.address, conf.user_name, conf.password, conf.num_partitions,
             conf.num_node_connections, conf.max_get_batch_size, conf.max_set_batch_size,
-            conf.refresh_time_after_fetch, conf.overflow_margin, conf.overflow_policy,
-            conf.overflow_resolution_target);
+            conf.async_fetch, conf.max_pipeline_depth, conf.refresh_time_after_fetch,
+            conf.overflow_margin, conf.overflow_policy, conf.overflow_resolution_target);
         break;
 
       default:
@@ -150,13 +203,32 @@ HierParameterServer<TypeHashKey>::HierParameterServer(
         HCTR_LOG(INFO, WORLD, "Creating RocksDB backend...\n");
         persistent_db_ = std::make_unique<RocksDBBackend<TypeHashKey>>(
             conf.path, conf.num_threads, conf.read_only, conf.max_get_batch_size,
-            conf.max_set_batch_size);
+            conf.max_set_batch_size, conf.block_cache_size, conf.bloom_filter_bits,
+            conf.partitioned_index, conf.compression);
+        break;
+      case DatabaseType_t::ImmutableStore:
+        HCTR_LOG(INFO, WORLD, "Creating ImmutableStore backend...\n");
+        persistent_db_ = std::make_unique<ImmutableStoreBackend<TypeHashKey>>(
+            conf.path, conf.read_only, conf.max_get_batch_size, conf.max_set_batch_size);
         break;
       default:
         HCTR_DIE("Selected backend (persistent_db.type = %d) is not supported!", conf.type);
         break;
     }
     persistent_db_initialize_after_startup_ = conf.initialize_after_startup;
+    persistent_db_negative_cache_bits_ = conf.negative_cache_bits;
+  }
+
+  // Metrics.
+  if (volatile_db_) {
+    volatile_db_metrics_ = &DatabaseBackendMetrics::get(volatile_db_->get_name());
+  }
+  if (persistent_db_) {
+    persistent_db_metrics_ = &DatabaseBackendMetrics::get(persistent_db_->get_name());
+  }
+  if (ps_config_.metrics_port) {
+    metrics_server_ =
+        std::make_unique<MetricsHttpServer>(static_cast<uint16_t>(ps_config_.metrics_port));
   }
 
   // Load embeddings for each embedding table from each model
@@ -214,6 +286,23 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
         inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j]);
     size_t num_key = rawreader->getkeycount();
     const size_t embedding_size = ps_config_.embedding_vec_size_[inference_params.model_name][j];
+    {
+      const DatabaseValueCodec_t codec = j < inference_params.value_codec_per_table.size()
+                                             ? inference_params.value_codec_per_table[j]
+                                             : DatabaseValueCodec_t::Float32;
+      std::unique_lock lock(value_codecs_guard_);
+      value_codecs_[tag_name] = codec;
+    }
+
+    // Encode the table once, if required. Both databases store the same representation.
+    std::vector<char> encoded_values;
+    size_t value_size = embedding_size * sizeof(float);
+    const char* values = reinterpret_cast<const char*>(rawreader->getvectors());
+    if ((volatile_db_ && volatile_db_initialize_after_startup_) ||
+        (persistent_db_ && persistent_db_initialize_after_startup_)) {
+      values = encode_values_(tag_name, num_key, values, value_size, encoded_values);
+    }
+
     // Populate volatile database(s).
     if (volatile_db_ && volatile_db_initialize_after_startup_) {
       const size_t volatile_capacity = volatile_db_->capacity(tag_name);
@@ -223,11 +312,14 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
               : static_cast<size_t>(
                     volatile_db_cache_rate_ * static_cast<double>(volatile_capacity) + 0.5);
 
-      HCTR_CHECK(volatile_db_->insert(tag_name, volatile_cache_amount,
-                                      reinterpret_cast<const TypeHashKey*>(rawreader->getkeys()),
-                                      reinterpret_cast<const char*>(rawreader->getvectors()),
-                                      embedding_size * sizeof(float)));
-      volatile_db_->synchronize();
+      {
+        const MetricTimer timer(volatile_db_metrics_->insert_duration);
+        HCTR_CHECK(volatile_db_->insert(tag_name, volatile_cache_amount,
+                                        reinterpret_cast<const TypeHashKey*>(rawreader->getkeys()),
+                                        values, value_size));
+        volatile_db_->synchronize();
+      }
+      volatile_db_metrics_->insert_pairs.add(volatile_cache_amount);
       HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << volatile_cache_amount
                               << " / " << num_key << " embeddings in volatile database ("
                               << volatile_db_->get_name()
@@ -240,9 +332,46 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
 
     // Persistent database - by definition - always gets all keys.
     if (persistent_db_ && persistent_db_initialize_after_startup_) {
-      HCTR_CHECK(persistent_db_->insert(
-          tag_name, num_key, reinterpret_cast<const TypeHashKey*>(rawreader->getkeys()),
-          reinterpret_cast<const char*>(rawreader->getvectors()), embedding_size * sizeof(float)));
+      // Only we know all keys of an unshared database, and only if it did not hold keys from
+      // earlier sessions or online updates. Keys enter the filter first, so that it cannot reject
+      // keys that are present.
+      bool use_negative_cache =
+          persistent_db_negative_cache_bits_ > 0 && !persistent_db_->is_shared();
+      if (use_negative_cache) {
+        std::unique_lock lock(negative_caches_guard_);
+        if (negative_caches_.find(tag_name) == negative_caches_.end()) {
+          if (persistent_db_->empty(tag_name)) {
+            negative_caches_.emplace(tag_name, std::make_unique<NegativeCache>(
+                                                   num_key, persistent_db_negative_cache_bits_));
+          } else {
+            HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; persistent database ("
+                                    << persistent_db_->get_name()
+                                    << ") already holds keys from earlier sessions. Negative cache "
+                                       "disabled."
+                                    << std::endl;
+            use_negative_cache = false;
+          }
+        }
+      }
+      if (use_negative_cache) {
+        insert_into_negative_cache_(tag_name, num_key,
+                                    reinterpret_cast<const TypeHashKey*>(rawreader->getkeys()));
+
+        std::shared_lock lock(negative_caches_guard_);
+        const KeyFilter& filter = negative_caches_.at(tag_name)->filter;
+        HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; negative cache holds "
+                                << filter.num_inserted() << " keys (" << filter.size_in_bytes()
+                                << " bytes), expected false positive rate: "
+                                << filter.expected_false_positive_rate() << '.' << std::endl;
+      }
+
+      {
+        const MetricTimer timer(persistent_db_metrics_->insert_duration);
+        HCTR_CHECK(persistent_db_->insert(
+            tag_name, num_key, reinterpret_cast<const TypeHashKey*>(rawreader->getkeys()), values,
+            value_size));
+      }
+      persistent_db_metrics_->insert_pairs.add(num_key);
       HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << num_key
                               << " embeddings in persistent database ("
                               << persistent_db_->get_name() << ")." << std::endl;
@@ -321,33 +450,70 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
 
   HCTR_LOG(DEBUG, WORLD, "Real-time subscribers created!\n");
 
-  auto insert_fn = [&](DatabaseBackend<TypeHashKey>* const db, const std::string& tag,
-                       const size_t num_pairs, const TypeHashKey* keys, const char* values,
-                       const size_t value_size) -> bool {
+  auto insert_fn = [](DatabaseBackend<TypeHashKey>* const db, DatabaseBackendMetrics& metrics,
+                      const std::string& tag, const size_t num_pairs, const TypeHashKey* keys,
+                      const char* values, const size_t value_size) -> bool {
     HCTR_LOG(DEBUG, WORLD,
              "Database \"%s\" update for tag: \"%s\", num_pairs: %d, value_size: %d bytes\n",
              db->get_name(), tag.c_str(), num_pairs, value_size);
-    return db->insert(tag, num_pairs, keys, values, value_size);
+    const MetricTimer timer(metrics.insert_duration);
+    const bool success = db->insert(tag, num_pairs, keys, values, value_size);
+    if (success) {
+      metrics.insert_pairs.add(num_pairs);
+    }
+    return success;
   };
 
+  // Optionally, decouple applying updates from consuming them.
+  const UpdateSourceParams& update_source = inference_params.update_source;
+  if (update_source.apply_max_batch_size) {
+    const std::chrono::milliseconds apply_max_delay{update_source.apply_max_delay_ms};
+    const size_t apply_max_pending = update_source.apply_max_batch_size * 16;
+
+    if (volatile_db_source_ && !volatile_db_applier_) {
+      volatile_db_applier_ = std::make_unique<UpdateApplier<TypeHashKey>>(
+          volatile_db_.get(), update_source.apply_max_batch_size, apply_max_delay,
+          apply_max_pending);
+    }
+    if (persistent_db_source_ && !persistent_db_applier_) {
+      persistent_db_applier_ = std::make_unique<UpdateApplier<TypeHashKey>>(
+          persistent_db_.get(), update_source.apply_max_batch_size, apply_max_delay,
+          apply_max_pending);
+    }
+  }
+
   // TODO: Update embedding cache!
 
   // Turn on background updates.
   if (volatile_db_source_) {
-    volatile_db_source_->engage([&](const std::string& tag, const size_t num_pairs,
-                                    const TypeHashKey* keys, const char* values,
-                                    const size_t value_size) -> bool {
+    volatile_db_source_->engage([this, insert_fn](const std::string& tag, const size_t num_pairs,
+                                                  const TypeHashKey* keys, const char* values,
+                                                  size_t value_size) -> bool {
+      std::vector<char> buffer;
+      values = encode_values_(tag, num_pairs, values, value_size, buffer);
+      if (volatile_db_applier_) {
+        return volatile_db_applier_->post(tag, num_pairs, keys, values, value_size);
+      }
       // Try a search. If we can find the value, override it. If not, do nothing.
-      return insert_fn(volatile_db_.get(), tag, num_pairs, keys, values, value_size);
+      return insert_fn(volatile_db_.get(), *volatile_db_metrics_, tag, num_pairs, keys, values,
+                       value_size);
     });
   }
 
   if (persistent_db_source_) {
-    persistent_db_source_->engage([&](const std::string& tag, const size_t num_pairs,
-                                      const TypeHashKey* keys, const char* values,
-                                      const size_t value_size) -> bool {
+    persistent_db_source_->engage([this, insert_fn](const std::string& tag,
+                                                    const size_t num_pairs,
+                                                    const TypeHashKey* keys, const char* values,
+                                                    size_t value_size) -> bool {
+      insert_into_negative_cache_(tag, num_pairs, keys);
+      std::vector<char> buffer;
+      values = encode_values_(tag, num_pairs, values, value_size, buffer);
+      if (persistent_db_applier_) {
+        return persistent_db_applier_->post(tag, num_pairs, keys, values, value_size);
+      }
       // For persistent, we always insert.
-      return insert_fn(persistent_db_.get(), tag, num_pairs, keys, values, value_size);
+      return insert_fn(persistent_db_.get(), *persistent_db_metrics_, tag, num_pairs, keys, values,
+                       value_size);
     });
   }
 }
@@ -474,11 +640,33 @@ template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::erase_model_from_hps(const std::string& model_name) {
   if (volatile_db_) {
     const std::vector<std::string>& table_names = volatile_db_->find_tables(model_name);
-    volatile_db_->evict(table_names);
+    const MetricTimer timer(volatile_db_metrics_->evict_duration);
+    volatile_db_metrics_->evict_keys.add(volatile_db_->evict(table_names));
   }
   if (persistent_db_) {
     const std::vector<std::string>& table_names = persistent_db_->find_tables(model_name);
-    persistent_db_->evict(table_names);
+    {
+      const MetricTimer timer(persistent_db_metrics_->evict_duration);
+      persistent_db_metrics_->evict_keys.add(persistent_db_->evict(table_names));
+    }
+
+    std::unique_lock lock(negative_caches_guard_);
+    for (const std::string& table_name : table_names) {
+      const auto it = negative_caches_.find(table_name);
+      if (it == negative_caches_.end()) {
+        continue;
+      }
+      const NegativeCache& cache = *it->second;
+      const size_t num_absent = cache.num_skipped + cache.num_false_positives;
+      HCTR_LOG_S(INFO, WORLD) << "Table: " << table_name << "; negative cache saved "
+                              << cache.num_skipped << " / " << cache.num_queries
+                              << " persistent database fetches, false positive rate: "
+                              << (num_absent ? static_cast<double>(cache.num_false_positives) /
+                                                   static_cast<double>(num_absent)
+                                             : 0.0)
+                              << '.' << std::endl;
+      negative_caches_.erase(it);
+    }
   }
 }
 
@@ -532,8 +720,12 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
   if (!length) {
     return;
   }
+  HCTR_TRACE_SCOPE("hps", "HierParameterServer::lookup");
   const auto start_time = std::chrono::high_resolution_clock::now();
   const auto time_budget = std::chrono::nanoseconds::max();
+  LookupMetrics& metrics = LookupMetrics::get();
+  const MetricTimer timer(metrics.duration);
+  metrics.keys.add(length);
 
   const auto& model_id = ps_config_.find_model_id(model_name);
   HCTR_CHECK_HINT(
@@ -542,9 +734,10 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
       "using Triton LOAD/UNLOAD APIs which haven't been supported in HPS backend.\n");
 
   const size_t embedding_size = ps_config_.embedding_vec_size_[model_name][table_id];
-  const size_t expected_value_size = embedding_size * sizeof(float);
   const std::string& embedding_table_name = ps_config_.emb_table_name_[model_name][table_id];
   const std::string& tag_name = make_tag_name(model_name, embedding_table_name);
+  const DatabaseValueCodec_t codec = get_value_codec_(tag_name);
+  const size_t expected_value_size = value_codec_size(codec, embedding_size);
   const float default_vec_value = ps_config_.default_emb_vec_value_[*model_id][table_id];
 #ifdef ENABLE_INFERENCE
   HCTR_LOG_S(TRACE, WORLD) << "Looking up " << length << " embeddings (each with " << embedding_size
@@ -552,69 +745,81 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
 #endif
   size_t hit_count = 0;
 
-  DatabaseHitCallback check_and_copy = [&](const size_t index, const char* const value,
-                                           const uint32_t value_size) {
-    HCTR_CHECK_HINT(value_size == expected_value_size,
-                    "Table: %s; Batch[%d]: Value size mismatch! (%d <> %d)!", tag_name.c_str(),
-                    index, value_size, expected_value_size);
-    memcpy(&h_vectors[index * embedding_size], value, value_size);
-  };
-
-  DatabaseMissCallback fill_default = [&](const size_t index) {
-    std::fill_n(&h_vectors[index * embedding_size], embedding_size, default_vec_value);
+  const TypeHashKey* const keys = reinterpret_cast<const TypeHashKey*>(h_keys);
+  // Encoded values are fetched into a staging buffer, and decoded once all databases were queried.
+  std::vector<char> encoded_values;
+  if (codec != DatabaseValueCodec_t::Float32) {
+    encoded_values.resize(length * expected_value_size);
+  }
+  char* const values =
+      encoded_values.empty() ? reinterpret_cast<char*>(h_vectors) : encoded_values.data();
+  auto finalize_values = [&](const std::vector<size_t>& missing) {
+    if (!encoded_values.empty()) {
+      decode_values(codec, length, embedding_size, values, h_vectors);
+    }
+    for (const size_t index : missing) {
+      std::fill_n(&h_vectors[index * embedding_size], embedding_size, default_vec_value);
+    }
   };
 
   // If have volatile and persistant database.
   if (volatile_db_ && persistent_db_) {
-    std::mutex resource_guard;
-
     // Do a sequential lookup in the volatile DB, and remember the missing keys.
     std::vector<size_t> missing;
-    DatabaseMissCallback record_missing = [&](const size_t index) {
-      std::lock_guard<std::mutex> lock(resource_guard);
-      missing.push_back(index);
-    };
-
-    hit_count += volatile_db_->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                                     check_and_copy, record_missing, time_budget);
+    {
+      const MetricTimer timer(metrics.volatile_db_duration);
+      hit_count += fetch_from_volatile_db_(tag_name, length, keys, values, expected_value_size,
+                                           missing, time_budget);
+    }
+    metrics.volatile_db_hits.add(hit_count);
 
     HCTR_LOG_S(TRACE, WORLD) << volatile_db_->get_name() << ": " << hit_count << " hits, "
                              << missing.size() << " missing!" << std::endl;
 
-    // If the layer 0 cache should be optimized as we go, elevate missed keys.
-    std::shared_ptr<std::vector<TypeHashKey>> keys_to_elevate;
-    std::shared_ptr<std::vector<char>> values_to_elevate;
-
-    if (volatile_db_cache_missed_embeddings_) {
-      keys_to_elevate = std::make_shared<std::vector<TypeHashKey>>();
-      values_to_elevate = std::make_shared<std::vector<char>>();
-
-      check_and_copy = [&](const size_t index, const char* const value, const uint32_t value_size) {
-        HCTR_CHECK_HINT(value_size == expected_value_size,
-                        "Table: %s; Batch[%d]: Value size mismatch! (%d <> %d)!", tag_name.c_str(),
-                        index, value_size, expected_value_size);
-        memcpy(&h_vectors[index * embedding_size], value, value_size);
-
-        std::lock_guard<std::mutex> lock(resource_guard);
-        keys_to_elevate->emplace_back(reinterpret_cast<const TypeHashKey*>(h_keys)[index]);
-        values_to_elevate->insert(values_to_elevate->end(), value, &value[value_size]);
-      };
-    }
-
     // Do a sparse lookup in the persisent DB, to fill gaps and set others to default.
-    hit_count += persistent_db_->fetch(tag_name, missing.size(), missing.data(),
-                                       reinterpret_cast<const TypeHashKey*>(h_keys), check_and_copy,
-                                       fill_default, time_budget);
+    std::vector<size_t> still_missing;
+    {
+      const MetricTimer timer(metrics.persistent_db_duration);
+      const size_t persistent_hit_count =
+          fetch_from_persistent_db_(tag_name, missing.size(), missing.data(), keys, values,
+                                    expected_value_size, still_missing, time_budget);
+      hit_count += persistent_hit_count;
+      metrics.persistent_db_hits.add(persistent_hit_count);
+    }
+    metrics.misses.add(still_missing.size());
+    finalize_values(still_missing);
 
     HCTR_LOG_S(TRACE, WORLD) << persistent_db_->get_name() << ": " << hit_count << " hits, "
                              << (length - hit_count) << " missing!" << std::endl;
 
-    // Elevate keys if desired and possible.
-    if (keys_to_elevate && !keys_to_elevate->empty()) {
+    // If the layer 0 cache should be optimized as we go, elevate missed keys.
+    if (volatile_db_cache_missed_embeddings_ && missing.size() > still_missing.size()) {
+      // Both lists are sorted. Hence, the keys found in the persistent DB are their difference.
+      std::vector<size_t> found;
+      found.reserve(missing.size() - still_missing.size());
+      std::set_difference(missing.begin(), missing.end(), still_missing.begin(),
+                          still_missing.end(), std::back_inserter(found));
+
+      auto keys_to_elevate = std::make_shared<std::vector<TypeHashKey>>(found.size());
+      auto values_to_elevate =
+          std::make_shared<std::vector<char>>(found.size() * expected_value_size);
+      for (size_t i = 0; i < found.size(); i++) {
+        (*keys_to_elevate)[i] = keys[found[i]];
+        memcpy(&(*values_to_elevate)[i * expected_value_size],
+               &values[found[i] * expected_value_size], expected_value_size);
+      }
+
       HCTR_LOG_S(DEBUG, WORLD) << "Attempting to migrate " << keys_to_elevate->size()
                                << " embeddings from " << persistent_db_->get_name() << " to "
                                << volatile_db_->get_name() << '.' << std::endl;
-      volatile_db_->insert_async(tag_name, keys_to_elevate, values_to_elevate, expected_value_size);
+      DatabaseBackendMetrics* const metrics = volatile_db_metrics_;
+      const size_t num_pairs = keys_to_elevate->size();
+      volatile_db_->insert_async(tag_name, keys_to_elevate, values_to_elevate, expected_value_size,
+                                 [metrics, num_pairs](const bool success) {
+                                   if (success) {
+                                     metrics->insert_pairs.add(num_pairs);
+                                   }
+                                 });
     }
   } else {
     // If any database.
@@ -623,14 +828,27 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
                      : static_cast<DatabaseBackend<TypeHashKey>*>(persistent_db_.get());
     if (db) {
       // Do a sequential lookup in the volatile DB, but fill gaps with a default value.
-      hit_count += db->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                             check_and_copy, fill_default, time_budget);
+      std::vector<size_t> missing;
+      if (volatile_db_) {
+        const MetricTimer timer(metrics.volatile_db_duration);
+        hit_count += fetch_from_volatile_db_(tag_name, length, keys, values, expected_value_size,
+                                             missing, time_budget);
+        metrics.volatile_db_hits.add(hit_count);
+      } else {
+        const MetricTimer timer(metrics.persistent_db_duration);
+        hit_count += fetch_from_persistent_db_(tag_name, length, nullptr, keys, values,
+                                               expected_value_size, missing, time_budget);
+        metrics.persistent_db_hits.add(hit_count);
+      }
+      metrics.misses.add(missing.size());
+      finalize_values(missing);
 
       HCTR_LOG_S(TRACE, WORLD) << db->get_name() << ": " << hit_count << " hits, "
                                << (length - hit_count) << " missing!" << std::endl;
     } else {
       // Without a database, set everything to default.
       std::fill_n(h_vectors, length * embedding_size, default_vec_value);
+      metrics.misses.add(length);
       HCTR_LOG_S(WARNING, WORLD) << "No database. All embeddings set to default." << std::endl;
     }
   }
@@ -644,6 +862,163 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
 #endif
 }
 
+template <typename TypeHashKey>
+DatabaseValueCodec_t HierParameterServer<TypeHashKey>::get_value_codec_(
+    const std::string& tag_name) const {
+  std::shared_lock lock(value_codecs_guard_);
+  const auto it = value_codecs_.find(tag_name);
+  return it != value_codecs_.end() ? it->second : DatabaseValueCodec_t::Float32;
+}
+
+template <typename TypeHashKey>
+const char* HierParameterServer<TypeHashKey>::encode_values_(const std::string& tag_name,
+                                                             const size_t num_pairs,
+                                                             const char* const values,
+                                                             size_t& value_size,
+                                                             std::vector<char>& buffer) const {
+  const DatabaseValueCodec_t codec = get_value_codec_(tag_name);
+  if (codec == DatabaseValueCodec_t::Float32) {
+    return values;
+  }
+  HCTR_CHECK_HINT(value_size % sizeof(float) == 0,
+                  "Table %s: Value size (%zu) is not a multiple of sizeof(float)!",
+                  tag_name.c_str(), value_size);
+  const size_t dim = value_size / sizeof(float);
+  const size_t encoded_size = value_codec_size(codec, dim);
+  buffer.resize(num_pairs * encoded_size);
+
+  // Large batches (e.g., initial table loads) are encoded in parallel.
+  const float* const src = reinterpret_cast<const float*>(values);
+  constexpr size_t chunk_size = 64 * 1024;
+  if (num_pairs <= chunk_size) {
+    encode_values(codec, num_pairs, dim, src, buffer.data());
+  } else {
+    std::vector<std::future<void>> tasks;
+    tasks.reserve((num_pairs + chunk_size - 1) / chunk_size);
+    for (size_t i = 0; i < num_pairs; i += chunk_size) {
+      tasks.emplace_back(ThreadPool::get().submit([&, i]() {
+        encode_values(codec, std::min(chunk_size, num_pairs - i), dim, &src[i * dim],
+                      &buffer[i * encoded_size]);
+      }));
+    }
+    ThreadPool::await(tasks.begin(), tasks.end());
+  }
+
+  value_size = encoded_size;
+  return buffer.data();
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::insert_into_negative_cache_(const std::string& tag_name,
+                                                                   const size_t num_keys,
+                                                                   const TypeHashKey* const keys) {
+  std::shared_lock lock(negative_caches_guard_);
+  const auto it = negative_caches_.find(tag_name);
+  if (it == negative_caches_.end()) {
+    return;
+  }
+  KeyFilter& filter = it->second->filter;
+
+  // Filter updates are lock-free. Hence, large batches can be split.
+  constexpr size_t chunk_size = 1024 * 1024;
+  if (num_keys <= chunk_size) {
+    filter.insert(num_keys, keys);
+  } else {
+    std::vector<std::future<void>> tasks;
+    tasks.reserve((num_keys + chunk_size - 1) / chunk_size);
+    for (size_t i = 0; i < num_keys; i += chunk_size) {
+      tasks.emplace_back(ThreadPool::get().submit(
+          [&, i]() { filter.insert(std::min(chunk_size, num_keys - i), &keys[i]); }));
+    }
+    ThreadPool::await(tasks.begin(), tasks.end());
+  }
+}
+
+template <typename TypeHashKey>
+size_t HierParameterServer<TypeHashKey>::fetch_from_volatile_db_(
+    const std::string& tag_name, const size_t num_keys, const TypeHashKey* const keys,
+    char* const values, const size_t value_size, std::vector<size_t>& missing,
+    const std::chrono::nanoseconds& time_budget) {
+  HCTR_TRACE_SCOPE("hps", "HierParameterServer::fetch_from_volatile_db");
+  DatabaseBackendMetrics& metrics = *volatile_db_metrics_;
+  size_t hit_count;
+  {
+    const MetricTimer timer(metrics.fetch_duration);
+    hit_count = volatile_db_->fetch(tag_name, num_keys, keys, values, value_size, value_size,
+                                    missing, time_budget);
+  }
+  metrics.fetch_keys.add(num_keys);
+  metrics.fetch_hits.add(hit_count);
+  return hit_count;
+}
+
+template <typename TypeHashKey>
+size_t HierParameterServer<TypeHashKey>::fetch_from_persistent_db_(
+    const std::string& tag_name, const size_t num_indices, const size_t* const indices,
+    const TypeHashKey* const keys, char* const values, const size_t value_size,
+    std::vector<size_t>& missing, const std::chrono::nanoseconds& time_budget) {
+  auto fetch = [&](const size_t num_keys, const size_t* const fetch_indices) {
+    HCTR_TRACE_SCOPE("hps", "HierParameterServer::fetch_from_persistent_db");
+    DatabaseBackendMetrics& metrics = *persistent_db_metrics_;
+    size_t hit_count;
+    {
+      const MetricTimer timer(metrics.fetch_duration);
+      if (fetch_indices) {
+        hit_count = persistent_db_->fetch(tag_name, num_keys, fetch_indices, keys, values,
+                                          value_size, value_size, missing, time_budget);
+      } else {
+        hit_count = persistent_db_->fetch(tag_name, num_keys, keys, values, value_size,
+                                          value_size, missing, time_budget);
+      }
+    }
+    metrics.fetch_keys.add(num_keys);
+    metrics.fetch_hits.add(hit_count);
+    return hit_count;
+  };
+
+  std::shared_lock lock(negative_caches_guard_);
+  const auto it = negative_caches_.find(tag_name);
+  if (it == negative_caches_.end()) {
+    lock.unlock();
+    return fetch(num_indices, indices);
+  }
+  NegativeCache& cache = *it->second;
+
+  // Only query keys that may exist.
+  std::vector<size_t> candidates;
+  std::vector<size_t> absent;
+  candidates.reserve(num_indices);
+  for (size_t i = 0; i < num_indices; i++) {
+    const size_t index = indices ? indices[i] : i;
+    if (cache.filter.may_contain(keys[index])) {
+      candidates.emplace_back(index);
+    } else {
+      absent.emplace_back(index);
+    }
+  }
+
+  size_t hit_count = 0;
+  if (candidates.empty()) {
+    missing.clear();
+  } else {
+    hit_count = fetch(candidates.size(), candidates.data());
+  }
+  const size_t num_false_positives = missing.size();
+
+  cache.num_queries += num_indices;
+  cache.num_skipped += absent.size();
+  cache.num_false_positives += num_false_positives;
+  HCTR_LOG_S(TRACE, WORLD) << "Table: " << tag_name << "; negative cache skipped " << absent.size()
+                           << " / " << num_indices << " persistent database fetches ("
+                           << num_false_positives << " false positives)." << std::endl;
+
+  // Both lists are sorted.
+  missing.insert(missing.end(), absent.begin(), absent.end());
+  const auto mid = missing.begin() + static_cast<std::ptrdiff_t>(num_false_positives);
+  std::inplace_merge(missing.begin(), mid, missing.end());
+  return hit_count;
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string& model_name,
                                                                const int device_id) {
@@ -0,0 +1,585 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <base/debug/logger.hpp>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <hps/bin_dump.hpp>
+#include <hps/database_backend_detail.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/immutable_store_backend.hpp>
+#include <numeric>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr size_t immutable_store_alignment = 4096;
+
+size_t align_up(const size_t offset) {
+  return (offset + immutable_store_alignment - 1) / immutable_store_alignment *
+         immutable_store_alignment;
+}
+
+void pwrite_all(const int fd, const void* const buf, const size_t n, const size_t offset) {
+  const char* p = static_cast<const char*>(buf);
+  for (size_t done = 0; done < n;) {
+    const ssize_t res = ::pwrite(fd, &p[done], n - done, static_cast<off_t>(offset + done));
+    HCTR_CHECK_HINT(res > 0 || (res < 0 && errno == EINTR), "Store write failed: %s",
+                    std::strerror(errno));
+    if (res > 0) {
+      done += static_cast<size_t>(res);
+    }
+  }
+}
+
+// Distance between two keys. Keys are compared by value, but their bit patterns are subtracted.
+// That way, signed keys are handled correctly as long as a <= b.
+template <typename Key>
+inline double key_distance(const Key a, const Key b) {
+  return static_cast<double>(static_cast<uint64_t>(b) - static_cast<uint64_t>(a));
+}
+
+}  // namespace
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::Table::find(const Key key) const {
+  const ImmutableStoreSegment* const segments_end = &segments[header->num_segments];
+  if (segments == segments_end || key < static_cast<Key>(segments->first_key)) {
+    return npos;
+  }
+
+  // Find the segment that covers the key.
+  const ImmutableStoreSegment* const seg =
+      std::upper_bound(segments, segments_end, key,
+                       [](const Key k, const ImmutableStoreSegment& s) {
+                         return k < static_cast<Key>(s.first_key);
+                       }) -
+      1;
+  const size_t seg_begin = seg->first_pos;
+  const size_t seg_end = seg + 1 != segments_end ? seg[1].first_pos : header->num_keys;
+
+  // Predict position, and search the surrounding window (+1 slot to absorb rounding errors).
+  const double pred =
+      static_cast<double>(seg_begin) +
+      seg->slope * key_distance(static_cast<Key>(seg->first_key), key);
+  const double err = static_cast<double>(header->max_error + 1);
+  size_t hi = pred + err + 1 >= static_cast<double>(seg_end) ? seg_end
+                                                              : static_cast<size_t>(pred + err + 1);
+  size_t lo = pred - err <= static_cast<double>(seg_begin) ? seg_begin
+                                                           : static_cast<size_t>(pred - err);
+  lo = std::min(lo, hi);
+
+  const Key* const it = std::lower_bound(&keys[lo], &keys[hi], key);
+  return it != &keys[hi] && *it == key ? static_cast<size_t>(it - keys) : npos;
+}
+
+template <typename Key>
+ImmutableStoreBackend<Key>::ImmutableStoreBackend(const std::string& path, const bool read_only,
+                                                  const size_t max_get_batch_size,
+                                                  const size_t max_set_batch_size,
+                                                  const size_t max_error)
+    : Base(max_get_batch_size, max_set_batch_size),
+      path_{path},
+      read_only_{read_only},
+      max_error_{max_error} {
+  HCTR_CHECK(max_get_batch_size > 0);
+
+  if (!std::filesystem::exists(path)) {
+    HCTR_CHECK_HINT(!read_only, "Immutable store '%s' does not exist!", path.c_str());
+    std::filesystem::create_directories(path);
+  }
+
+  // Map all tables.
+  for (const auto& entry : std::filesystem::directory_iterator(path)) {
+    if (entry.is_regular_file() && entry.path().extension() == immutable_store_extension) {
+      open_table_(entry.path().stem(), entry.path());
+    }
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Mapped " << tables_.size() << " immutable table(s) from '" << path
+                          << "'." << std::endl;
+}
+
+template <typename Key>
+ImmutableStoreBackend<Key>::~ImmutableStoreBackend() {
+  for (const auto& pair : tables_) {
+    ::munmap(pair.second.data, pair.second.size);
+  }
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::size(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  const auto& tables_it = tables_.find(table_name);
+  return tables_it != tables_.end() ? tables_it->second.header->num_keys : 0;
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
+                                            const Key* const keys,
+                                            const std::chrono::nanoseconds& time_budget) const {
+  const auto begin = std::chrono::high_resolution_clock::now();
+  const std::shared_lock lock(read_write_guard_);
+
+  const auto& tables_it = tables_.find(table_name);
+  if (tables_it == tables_.end()) {
+    return Base::contains(table_name, num_keys, keys, time_budget);
+  }
+  const Table& table = tables_it->second;
+
+  size_t hit_count = 0;
+  size_t ign_count = 0;
+
+  const Key* const keys_end = &keys[num_keys];
+  for (const Key* k = keys; k != keys_end;) {
+    // Check time budget.
+    const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
+    if (elapsed >= time_budget) {
+      HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name << ": Timeout!"
+                                 << std::endl;
+      ign_count += keys_end - k;
+      break;
+    }
+
+    // Query next batch.
+    const Key* const batch_end = std::min(&k[this->max_get_batch_size_], keys_end);
+    for (; k != batch_end; k++) {
+      hit_count += table.find(*k) != Table::npos;
+    }
+  }
+
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": " << hit_count
+                           << " / " << (num_keys - ign_count) << " hits, " << ign_count
+                           << " ignored." << std::endl;
+  return hit_count;
+}
+
+template <typename Key>
+bool ImmutableStoreBackend<Key>::insert(const std::string& table_name, const size_t num_pairs,
+                                        const Key* const keys, const char* const values,
+                                        const size_t value_size) {
+  const std::unique_lock lock(read_write_guard_);
+
+  if (tables_.find(table_name) != tables_.end()) {
+    HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name
+                               << " is immutable. Ignored " << num_pairs << " pairs." << std::endl;
+    return true;
+  }
+  if (read_only_) {
+    HCTR_LOG_S(ERROR, WORLD) << get_name() << " backend; Table " << table_name
+                             << " does not exist, and cannot be built in read-only mode."
+                             << std::endl;
+    return false;
+  }
+
+  // Build the table from the provided pairs, and map it.
+  const std::string path = (std::filesystem::path(path_) / table_name).string() +
+                           immutable_store_extension;
+  build(path, num_pairs, keys, values, value_size, max_error_);
+  open_table_(table_name, path);
+
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": Built from "
+                           << num_pairs << " pairs." << std::endl;
+  return true;
+}
+
+template <typename Key>
+template <typename HitFn, typename MissFn>
+size_t ImmutableStoreBackend<Key>::fetch_(const std::string& table_name, const size_t num_keys,
+                                          const size_t* const indices, const Key* const keys,
+                                          HitFn&& on_hit, MissFn&& on_miss,
+                                          const std::chrono::nanoseconds& time_budget) {
+  const auto begin = std::chrono::high_resolution_clock::now();
+  const std::shared_lock lock(read_write_guard_);
+
+  const auto& tables_it = tables_.find(table_name);
+  if (tables_it == tables_.end()) {
+    for (size_t i = 0; i < num_keys; i++) {
+      on_miss(indices ? indices[i] : i);
+    }
+    return 0;
+  }
+  const Table& table = tables_it->second;
+  const uint32_t value_size = table.header->value_size;
+
+  // Looks up a range of keys. Returns the number of hits, or npos upon timeout.
+  const auto process_batch = [&](const size_t first, const size_t last) {
+    const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
+    if (elapsed >= time_budget) {
+      for (size_t i = first; i != last; i++) {
+        on_miss(indices ? indices[i] : i);
+      }
+      return Table::npos;
+    }
+
+    size_t hit_count = 0;
+    for (size_t i = first; i != last; i++) {
+      const size_t index = indices ? indices[i] : i;
+      const size_t pos = table.find(keys[index]);
+      if (pos != Table::npos) {
+        on_hit(index, &table.values[pos * value_size], value_size);
+        hit_count++;
+      } else {
+        on_miss(index);
+      }
+    }
+    return hit_count;
+  };
+
+  size_t hit_count = 0;
+  size_t ign_count = 0;
+
+  const size_t batch_size = this->max_get_batch_size_;
+  if (num_keys <= batch_size) {
+    const size_t n = process_batch(0, num_keys);
+    if (n == Table::npos) {
+      ign_count += num_keys;
+    } else {
+      hit_count += n;
+    }
+  } else {
+    std::atomic<size_t> joint_hit_count{0};
+    std::atomic<size_t> joint_ign_count{0};
+
+    // Lookups are independent. Hence, batches can be processed in parallel.
+    std::vector<std::future<void>> tasks;
+    tasks.reserve((num_keys + batch_size - 1) / batch_size);
+
+    for (size_t first = 0; first < num_keys; first += batch_size) {
+      tasks.emplace_back(ThreadPool::get().submit([&, first]() {
+        const size_t last = std::min(first + batch_size, num_keys);
+        const size_t n = process_batch(first, last);
+        if (n == Table::npos) {
+          joint_ign_count += last - first;
+        } else {
+          joint_hit_count += n;
+        }
+      }));
+    }
+    ThreadPool::await(tasks.begin(), tasks.end());
+    hit_count += static_cast<size_t>(joint_hit_count);
+    ign_count += static_cast<size_t>(joint_ign_count);
+  }
+
+  if (ign_count) {
+    HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name << ": Timeout!"
+                               << std::endl;
+  }
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": " << hit_count
+                           << " / " << (num_keys - ign_count) << " hits, " << ign_count
+                           << " ignored." << std::endl;
+  return hit_count;
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys, const DatabaseHitCallback& on_hit,
+                                         const DatabaseMissCallback& on_miss,
+                                         const std::chrono::nanoseconds& time_budget) {
+  return fetch_(table_name, num_keys, nullptr, keys, on_hit, on_miss, time_budget);
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                         const size_t* const indices, const Key* const keys,
+                                         const DatabaseHitCallback& on_hit,
+                                         const DatabaseMissCallback& on_miss,
+                                         const std::chrono::nanoseconds& time_budget) {
+  return fetch_(table_name, num_indices, indices, keys, on_hit, on_miss, time_budget);
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys, char* const values,
+                                         const size_t value_size, const size_t value_stride,
+                                         std::vector<size_t>& missing,
+                                         const std::chrono::nanoseconds& time_budget) {
+  // Handlers are inlined into the lookup loop.
+  BulkFetchTarget target(values, value_size, value_stride, num_keys, missing);
+  const size_t hit_count = fetch_(
+      table_name, num_keys, nullptr, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                         const size_t* const indices, const Key* const keys,
+                                         char* const values, const size_t value_size,
+                                         const size_t value_stride, std::vector<size_t>& missing,
+                                         const std::chrono::nanoseconds& time_budget) {
+  // Handlers are inlined into the lookup loop.
+  BulkFetchTarget target(values, value_size, value_stride, num_indices, missing);
+  const size_t hit_count = fetch_(
+      table_name, num_indices, indices, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::evict(const std::string& table_name) {
+  HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name
+                             << " is immutable. Eviction ignored." << std::endl;
+  return 0;
+}
+
+template <typename Key>
+size_t ImmutableStoreBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys) {
+  HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name
+                             << " is immutable. Eviction of " << num_keys << " keys ignored."
+                             << std::endl;
+  return 0;
+}
+
+template <typename Key>
+std::vector<std::string> ImmutableStoreBackend<Key>::find_tables(const std::string& model_name) {
+  const std::string& tag_prefix = HierParameterServerBase::make_tag_name(model_name, "", false);
+
+  const std::shared_lock lock(read_write_guard_);
+
+  std::vector<std::string> matches;
+  for (const auto& pair : tables_) {
+    if (pair.first.find(tag_prefix) == 0) {
+      matches.push_back(pair.first);
+    }
+  }
+  return matches;
+}
+
+template <typename Key>
+void ImmutableStoreBackend<Key>::dump_bin(const std::string& table_name, const std::string& path) {
+  const std::shared_lock lock(read_write_guard_);
+
+  const auto& tables_it = tables_.find(table_name);
+  if (tables_it == tables_.end()) {
+    BinDumpWriter(path, sizeof(Key), 0, {}, BinDumpPartitioner_t::None).finish();
+    return;
+  }
+  const Table& table = tables_it->second;
+
+  // The key and value sections can be copied as-is.
+  const size_t num_keys = table.header->num_keys;
+  BinDumpWriter file(path, sizeof(Key), table.header->value_size, {num_keys},
+                     BinDumpPartitioner_t::None);
+  file.write(0, 0, num_keys, table.keys, table.values);
+  file.finish();
+}
+
+template <typename Key>
+void ImmutableStoreBackend<Key>::dump_sst(const std::string& table_name,
+                                          rocksdb::SstFileWriter& file) {
+  const std::shared_lock lock(read_write_guard_);
+
+  const auto& tables_it = tables_.find(table_name);
+  if (tables_it == tables_.end()) {
+    return;
+  }
+  const Table& table = tables_it->second;
+
+  // Keys are already sorted.
+  rocksdb::Slice k_view{nullptr, sizeof(Key)};
+  rocksdb::Slice v_view{nullptr, table.header->value_size};
+
+  for (size_t i = 0; i < table.header->num_keys; i++) {
+    k_view.data_ = reinterpret_cast<const char*>(&table.keys[i]);
+    v_view.data_ = &table.values[i * table.header->value_size];
+    HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
+  }
+}
+
+template <typename Key>
+void ImmutableStoreBackend<Key>::build(const std::string& path, const size_t num_pairs,
+                                       const Key* const keys, const char* const values,
+                                       const size_t value_size, const size_t max_error) {
+  HCTR_CHECK(value_size > 0 && value_size <= std::numeric_limits<uint32_t>::max());
+
+  // Sort pairs by key. Among duplicates, only the last occurrence is retained.
+  std::vector<size_t> order(num_pairs);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [keys](const size_t a, const size_t b) { return keys[a] < keys[b]; });
+  {
+    auto dst = order.begin();
+    for (auto it = order.begin(); it != order.end(); ++it) {
+      if (it + 1 != order.end() && keys[*it] == keys[it[1]]) {
+        continue;
+      }
+      *dst++ = *it;
+    }
+    order.erase(dst, order.end());
+  }
+  const size_t num_keys = order.size();
+
+  std::vector<Key> sorted_keys;
+  sorted_keys.reserve(num_keys);
+  for (const size_t i : order) {
+    sorted_keys.emplace_back(keys[i]);
+  }
+
+  // Fit segments (shrinking cone). Each segment starts at a key, and extends as long as a single
+  // slope can predict the position of all covered keys within max_error.
+  std::vector<ImmutableStoreSegment> segments;
+  const double eps = static_cast<double>(max_error);
+  for (size_t first = 0; first < num_keys;) {
+    double min_slope = 0;
+    double max_slope = std::numeric_limits<double>::infinity();
+
+    size_t last = first + 1;
+    for (; last < num_keys; last++) {
+      const double dx = key_distance(sorted_keys[first], sorted_keys[last]);
+      const double dy = static_cast<double>(last - first);
+      const double lo = std::max(min_slope, (dy - eps) / dx);
+      const double hi = std::min(max_slope, (dy + eps) / dx);
+      if (lo > hi) {
+        break;
+      }
+      min_slope = lo;
+      max_slope = hi;
+    }
+
+    const double slope = last == first + 1 ? 0 : (min_slope + max_slope) / 2;
+    segments.push_back({static_cast<uint64_t>(sorted_keys[first]), first, slope});
+    first = last;
+  }
+
+  // Fix layout.
+  ImmutableStoreHeader header;
+  std::memset(&header, 0, sizeof(ImmutableStoreHeader));
+  std::memcpy(header.magic, "hims", 4);
+  header.version = immutable_store_version;
+  header.key_size = sizeof(Key);
+  header.value_size = static_cast<uint32_t>(value_size);
+  header.num_keys = num_keys;
+  header.num_segments = segments.size();
+  header.max_error = max_error;
+  header.segments_offset = sizeof(ImmutableStoreHeader);
+  header.keys_offset =
+      align_up(header.segments_offset + segments.size() * sizeof(ImmutableStoreSegment));
+  header.values_offset = align_up(header.keys_offset + num_keys * sizeof(Key));
+
+  // Write to a temporary file first, so that readers never observe a partial store.
+  const std::string tmp_path = path + ".tmp";
+  const int fd = ::open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  HCTR_CHECK_HINT(fd >= 0, "Unable to create store file '%s': %s", tmp_path.c_str(),
+                  std::strerror(errno));
+
+  pwrite_all(fd, &header, sizeof(ImmutableStoreHeader), 0);
+  pwrite_all(fd, segments.data(), segments.size() * sizeof(ImmutableStoreSegment),
+             header.segments_offset);
+  pwrite_all(fd, sorted_keys.data(), num_keys * sizeof(Key), header.keys_offset);
+
+  std::vector<char> buffer(4 * 1024 * 1024 / value_size * value_size + value_size);
+  const size_t buffer_pairs = buffer.size() / value_size;
+  for (size_t i = 0; i < num_keys;) {
+    const size_t n = std::min(buffer_pairs, num_keys - i);
+    for (size_t j = 0; j < n; j++) {
+      std::copy_n(&values[order[i + j] * value_size], value_size, &buffer[j * value_size]);
+    }
+    pwrite_all(fd, buffer.data(), n * value_size, header.values_offset + i * value_size);
+    i += n;
+  }
+
+  // Make sure the file is padded to the full size, even if there are no values.
+  HCTR_CHECK(::ftruncate(fd, static_cast<off_t>(header.values_offset + num_keys * value_size)) ==
+             0);
+  HCTR_CHECK_HINT(::fdatasync(fd) == 0, "Store sync failed: %s", std::strerror(errno));
+  ::close(fd);
+
+  HCTR_CHECK_HINT(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+                  "Unable to rename '%s' to '%s': %s", tmp_path.c_str(), path.c_str(),
+                  std::strerror(errno));
+
+  HCTR_LOG_S(DEBUG, WORLD) << "Built immutable store '" << path << "': " << num_keys << " keys, "
+                           << segments.size() << " segments." << std::endl;
+}
+
+template <typename Key>
+void ImmutableStoreBackend<Key>::open_table_(const std::string& table_name,
+                                             const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  HCTR_CHECK_HINT(fd >= 0, "Unable to open store file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+
+  struct stat st;
+  HCTR_CHECK(::fstat(fd, &st) == 0);
+  const size_t size = static_cast<size_t>(st.st_size);
+  HCTR_CHECK_HINT(size >= sizeof(ImmutableStoreHeader), "Store file '%s' is truncated!",
+                  path.c_str());
+
+  void* const data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  HCTR_CHECK_HINT(data != MAP_FAILED, "Unable to map store file '%s': %s", path.c_str(),
+                  std::strerror(errno));
+  // Lookups are random. Read-ahead would only pollute the page cache.
+  ::madvise(data, size, MADV_RANDOM);
+
+  Table table;
+  table.data = static_cast<char*>(data);
+  table.size = size;
+  table.header = reinterpret_cast<const ImmutableStoreHeader*>(table.data);
+
+  // Validate header.
+  const ImmutableStoreHeader& header = *table.header;
+  HCTR_CHECK_HINT(std::memcmp(header.magic, "hims", 4) == 0 &&
+                      header.version == immutable_store_version,
+                  "'%s' is not a version %u immutable store file!", path.c_str(),
+                  immutable_store_version);
+  HCTR_CHECK_HINT(header.key_size == sizeof(Key),
+                  "Store file '%s': Key size mismatch! (%u <> %zu)", path.c_str(), header.key_size,
+                  sizeof(Key));
+  HCTR_CHECK_HINT(
+      header.segments_offset + header.num_segments * sizeof(ImmutableStoreSegment) <= size &&
+          header.keys_offset + header.num_keys * sizeof(Key) <= size &&
+          header.values_offset + header.num_keys * header.value_size <= size,
+      "Store file '%s' is truncated!", path.c_str());
+
+  table.segments =
+      reinterpret_cast<const ImmutableStoreSegment*>(&table.data[header.segments_offset]);
+  table.keys = reinterpret_cast<const Key*>(&table.data[header.keys_offset]);
+  table.values = &table.data[header.values_offset];
+
+  // Keep the index resident. It is touched by every lookup.
+  ::madvise(table.data, header.keys_offset, MADV_WILLNEED);
+
+  HCTR_CHECK(tables_.emplace(table_name, table).second);
+}
+
+template class ImmutableStoreBackend<unsigned int>;
+template class ImmutableStoreBackend<long long>;
+
+}  // namespace HugeCTR
@@ -39,6 +39,8 @@ bool VolatileDatabaseParams::operator==(const VolatileDatabaseParams& p) const {
          shared_memory_size == p.shared_memory_size && shared_memory_name == p.shared_memory_name &&
          num_node_connections == p.num_node_connections &&
          max_get_batch_size == p.max_get_batch_size && max_set_batch_size == p.max_set_batch_size &&
+         async_fetch == p.async_fetch && max_pipeline_depth == p.max_pipeline_depth &&
+         numa_aware == p.numa_aware &&
          // Overflow handling related.
          refresh_time_after_fetch == p.refresh_time_after_fetch &&
          overflow_margin == p.overflow_margin && overflow_policy == p.overflow_policy &&
@@ -59,8 +61,11 @@ bool PersistentDatabaseParams::operator==(const PersistentDatabaseParams& p) con
          // Backend specific.
          path == p.path && num_threads == p.num_threads && read_only == p.read_only &&
          max_get_batch_size == p.max_get_batch_size && max_set_batch_size == p.max_set_batch_size &&
+         block_cache_size == p.block_cache_size && bloom_filter_bits == p.bloom_filter_bits &&
+         partitioned_index == p.partitioned_index && compression == p.compression &&
          // Caching behavior related.
          initialize_after_startup == p.initialize_after_startup &&
+         negative_cache_bits == p.negative_cache_bits &&
          // Real-time update mechanism related.
          update_filters == p.update_filters;
 }
@@ -74,7 +79,10 @@ bool UpdateSourceParams::operator==(const UpdateSourceParams& p) const {
          brokers == p.brokers && metadata_refresh_interval_ms == p.metadata_refresh_interval_ms &&
          receive_buffer_size == p.receive_buffer_size && poll_timeout_ms == p.poll_timeout_ms &&
          max_batch_size == p.max_batch_size && failure_backoff_ms == p.failure_backoff_ms &&
-         max_commit_interval == p.max_commit_interval;
+         max_commit_interval == p.max_commit_interval &&
+         // Update application related.
+         apply_max_batch_size == p.apply_max_batch_size &&
+         apply_max_delay_ms == p.apply_max_delay_ms;
 }
 bool UpdateSourceParams::operator!=(const UpdateSourceParams& p) const { return !operator==(p); }
 
@@ -84,7 +92,8 @@ VolatileDatabaseParams::VolatileDatabaseParams(
     const std::string& address, const std::string& user_name, const std::string& password,
     const size_t num_partitions, const size_t allocation_rate, const size_t shared_memory_size,
     const std::string& shared_memory_name, const size_t num_node_connections,
-    const size_t max_get_batch_size, const size_t max_set_batch_size,
+    const size_t max_get_batch_size, const size_t max_set_batch_size, const bool async_fetch,
+    const size_t max_pipeline_depth, const bool numa_aware,
     // Overflow handling related.
     const bool refresh_time_after_fetch, const size_t overflow_margin,
     const DatabaseOverflowPolicy_t overflow_policy, const double overflow_resolution_target,
@@ -105,6 +114,9 @@ VolatileDatabaseParams::VolatileDatabaseParams(
       num_node_connections(num_node_connections),
       max_get_batch_size(max_get_batch_size),
       max_set_batch_size(max_set_batch_size),
+      async_fetch{async_fetch},
+      max_pipeline_depth{max_pipeline_depth},
+      numa_aware{numa_aware},
       // Overflow handling related.
       refresh_time_after_fetch(refresh_time_after_fetch),
       overflow_margin(overflow_margin),
@@ -123,8 +135,13 @@ PersistentDatabaseParams::PersistentDatabaseParams(const DatabaseType_t type,
                                                    const size_t num_threads, const bool read_only,
                                                    const size_t max_get_batch_size,
                                                    const size_t max_set_batch_size,
+                                                   const size_t block_cache_size,
+                                                   const double bloom_filter_bits,
+                                                   const bool partitioned_index,
+                                                   const DatabaseCompression_t compression,
                                                    // Caching behavior related.
                                                    const bool initialize_after_startup,
+                                                   const double negative_cache_bits,
                                                    // Real-time update mechanism related.
                                                    const std::vector<std::string>& update_filters)
     : type(type),
@@ -134,8 +151,13 @@ PersistentDatabaseParams::PersistentDatabaseParams(const DatabaseType_t type,
       read_only(read_only),
       max_get_batch_size(max_get_batch_size),
       max_set_batch_size(max_set_batch_size),
+      block_cache_size(block_cache_size),
+      bloom_filter_bits(bloom_filter_bits),
+      partitioned_index(partitioned_index),
+      compression(compression),
       // Caching behavior related.
       initialize_after_startup{initialize_after_startup},
+      negative_cache_bits{negative_cache_bits},
       // Real-time update mechanism related.
       update_filters(update_filters) {}
 
@@ -146,7 +168,10 @@ UpdateSourceParams::UpdateSourceParams(const UpdateSourceType_t type,
                                        const size_t receive_buffer_size,
                                        const size_t poll_timeout_ms, const size_t max_batch_size,
                                        const size_t failure_backoff_ms,
-                                       const size_t max_commit_interval)
+                                       const size_t max_commit_interval,
+                                       // Update application related.
+                                       const size_t apply_max_batch_size,
+                                       const size_t apply_max_delay_ms)
     : type(type),
       // Backend specific.
       brokers(brokers),
@@ -155,7 +180,10 @@ UpdateSourceParams::UpdateSourceParams(const UpdateSourceType_t type,
       poll_timeout_ms(poll_timeout_ms),
       max_batch_size(max_batch_size),
       failure_backoff_ms(failure_backoff_ms),
-      max_commit_interval(max_commit_interval) {}
+      max_commit_interval(max_commit_interval),
+      // Update application related.
+      apply_max_batch_size(apply_max_batch_size),
+      apply_max_delay_ms(apply_max_delay_ms) {}
 
 InferenceParams::InferenceParams(
     const std::string& model_name, const size_t max_batchsize, const float hit_rate_threshold,
@@ -177,7 +205,8 @@ InferenceParams::InferenceParams(
     const std::vector<size_t>& embedding_vecsize_per_table,
     const std::vector<std::string>& embedding_table_names, const std::string& network_file,
     const size_t label_dim, const size_t slot_num, const std::string& non_trainable_params_file,
-    bool use_static_table)
+    bool use_static_table, const std::vector<DatabaseValueCodec_t>& value_codec_per_table,
+    bool use_int8_dense)
     : model_name(model_name),
       max_batchsize(max_batchsize),
       hit_rate_threshold(hit_rate_threshold),
@@ -212,7 +241,9 @@ InferenceParams::InferenceParams(
       label_dim(label_dim),
       slot_num(slot_num),
       non_trainable_params_file(non_trainable_params_file),
-      use_static_table(use_static_table) {
+      use_static_table(use_static_table),
+      value_codec_per_table(value_codec_per_table),
+      use_int8_dense(use_int8_dense) {
   if (this->default_value_for_each_table.size() != this->sparse_model_files.size()) {
     HCTR_LOG(
         WARNING, ROOT,
@@ -274,6 +305,13 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
 
     params.max_commit_interval =
         get_value_from_json_soft<size_t>(update_source, "max_commit_interval", 32);
+
+    // Update application related.
+    params.apply_max_batch_size =
+        get_value_from_json_soft<size_t>(update_source, "apply_max_batch_size", 0);
+
+    params.apply_max_delay_ms =
+        get_value_from_json_soft<size_t>(update_source, "apply_max_delay_ms", 100);
   }
   // Persistent database parameters.
   PersistentDatabaseParams persistent_db_params;
@@ -296,6 +334,20 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.max_set_batch_size =
         get_value_from_json_soft<size_t>(persistent_db, "max_set_batch_size", 64L * 1024L);
 
+    params.block_cache_size = get_value_from_json_soft<size_t>(persistent_db, "block_cache_size",
+                                                               256L * 1024L * 1024L);
+
+    params.bloom_filter_bits =
+        get_value_from_json_soft<double>(persistent_db, "bloom_filter_bits", 10.0);
+
+    params.partitioned_index =
+        get_value_from_json_soft<bool>(persistent_db, "partitioned_index", false);
+
+    params.compression = get_hps_database_compression(persistent_db, "compression");
+
+    params.negative_cache_bits =
+        get_value_from_json_soft<double>(persistent_db, "negative_cache_bits", 0.0);
+
     if (persistent_db.find("update_filters") != persistent_db.end()) {
       params.update_filters.clear();
       auto update_filters = get_json(persistent_db, "update_filters");
@@ -346,6 +398,13 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.max_set_batch_size =
         get_value_from_json_soft<size_t>(volatile_db, "max_set_batch_size", 64L * 1024L);
 
+    params.async_fetch = get_value_from_json_soft<bool>(volatile_db, "async_fetch", false);
+
+    params.max_pipeline_depth =
+        get_value_from_json_soft<size_t>(volatile_db, "max_pipeline_depth", 16);
+
+    params.numa_aware = get_value_from_json_soft<bool>(volatile_db, "numa_aware", true);
+
     // Overflow handling related.
     params.refresh_time_after_fetch =
         get_value_from_json_soft<bool>(volatile_db, "refresh_time_after_fetch", false);
@@ -377,6 +436,7 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
   this->volatile_db = volatile_db_params;
   this->persistent_db = persistent_db_params;
   this->update_source = update_source_params;
+  this->metrics_port = get_value_from_json_soft<size_t>(hps_config, "metrics_port", 0);
   // Search for all model configuration
   const nlohmann::json& models = get_json(hps_config, "models");
   HCTR_CHECK_HINT(models.size() > 0,
@@ -499,6 +559,21 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     // [19] use_static_table -> bool
     params.use_static_table = get_value_from_json_soft<bool>(model, "use_static_table", false);
 
+    // [20] value_codec_per_table -> std::vector<DatabaseValueCodec_t>
+    params.value_codec_per_table.clear();
+    if (model.find("value_codec_per_table") != model.end()) {
+      auto value_codec_per_table = get_json(model, "value_codec_per_table");
+      if (value_codec_per_table.is_array()) {
+        for (size_t codec_index = 0; codec_index < value_codec_per_table.size(); ++codec_index) {
+          params.value_codec_per_table.emplace_back(get_hps_database_value_codec(
+              value_codec_per_table[codec_index].get<std::string>()));
+        }
+      }
+    }
+
+    // [21] use_int8_dense -> bool
+    params.use_int8_dense = get_value_from_json_soft<bool>(model, "use_int8_dense", false);
+
     params.volatile_db = volatile_db_params;
     params.persistent_db = persistent_db_params;
     params.update_source = update_source_params;
@@ -696,6 +771,13 @@ HugeCTR::DatabaseType_t get_hps_database_type(const nlohmann::json& json, const
       return enum_value;
     }
 
+  enum_value = HugeCTR::DatabaseType_t::ShardedHashMap;
+  names = {hctr_enum_to_c_str(enum_value), "sharded_hashmap", "sharded_hash", "sharded_map"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
   enum_value = HugeCTR::DatabaseType_t::RedisCluster;
   names = {hctr_enum_to_c_str(enum_value), "redis"};
   for (const char* name : names)
@@ -710,6 +792,13 @@ HugeCTR::DatabaseType_t get_hps_database_type(const nlohmann::json& json, const
       return enum_value;
     }
 
+  enum_value = HugeCTR::DatabaseType_t::ImmutableStore;
+  names = {hctr_enum_to_c_str(enum_value), "immutable", "mmap"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
   return HugeCTR::DatabaseType_t::Disabled;
 }
 
@@ -764,4 +853,81 @@ DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json,
   return HugeCTR::DatabaseOverflowPolicy_t::EvictOldest;
 }
 
+DatabaseCompression_t get_hps_database_compression(const nlohmann::json& json,
+                                                   const std::string key) {
+  if (json.find(key) == json.end()) {
+    return HugeCTR::DatabaseCompression_t::Snappy;
+  }
+  std::string tmp = get_value_from_json<std::string>(json, key);
+  HugeCTR::DatabaseCompression_t enum_value;
+  std::unordered_set<const char*> names;
+
+  enum_value = HugeCTR::DatabaseCompression_t::None;
+  names = {hctr_enum_to_c_str(enum_value), "no", "disabled"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = HugeCTR::DatabaseCompression_t::Snappy;
+  names = {hctr_enum_to_c_str(enum_value)};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = HugeCTR::DatabaseCompression_t::LZ4;
+  names = {hctr_enum_to_c_str(enum_value)};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = HugeCTR::DatabaseCompression_t::ZSTD;
+  names = {hctr_enum_to_c_str(enum_value), "zstandard"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  return HugeCTR::DatabaseCompression_t::Snappy;
+}
+
+DatabaseValueCodec_t get_hps_database_value_codec(const std::string& name) {
+  HugeCTR::DatabaseValueCodec_t enum_value;
+  std::unordered_set<const char*> names;
+
+  enum_value = HugeCTR::DatabaseValueCodec_t::Float32;
+  names = {hctr_enum_to_c_str(enum_value), "float32", "none"};
+  for (const char* n : names)
+    if (name == n) {
+      return enum_value;
+    }
+
+  enum_value = HugeCTR::DatabaseValueCodec_t::Float16;
+  names = {hctr_enum_to_c_str(enum_value), "float16", "half"};
+  for (const char* n : names)
+    if (name == n) {
+      return enum_value;
+    }
+
+  enum_value = HugeCTR::DatabaseValueCodec_t::BFloat16;
+  names = {hctr_enum_to_c_str(enum_value), "bfloat16"};
+  for (const char* n : names)
+    if (name == n) {
+      return enum_value;
+    }
+
+  enum_value = HugeCTR::DatabaseValueCodec_t::Int8;
+  names = {hctr_enum_to_c_str(enum_value), "uint8"};
+  for (const char* n : names)
+    if (name == n) {
+      return enum_value;
+    }
+
+  HCTR_LOG_S(WARNING, WORLD) << "Unknown value codec '" << name << "'. Falling back to "
+                             << HugeCTR::DatabaseValueCodec_t::Float32 << '.' << std::endl;
+  return HugeCTR::DatabaseValueCodec_t::Float32;
+}
+
 }  // namespace HugeCTR
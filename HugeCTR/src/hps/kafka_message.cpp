@@ -540,7 +540,7 @@ void KafkaMessageSource<Key>::resubscribe() {
       rd_kafka_topic_partition_list_new(static_cast<int>(tag_filters_.size())));
 
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "Attempting to (re-)subscribe to Kafka topics { ";
 
     for (const std::string& tag_filter : tag_filters_) {
@@ -614,7 +614,7 @@ void KafkaMessageSource<Key>::run(std::function<HCTR_MESSAGE_SOURCE_CALLBACK> ca
 
     // Do the commit.
     {
-      auto log = HCTR_LOG_S(TRACE, WORLD);
+      auto log = HCTR_LOG_ENTRY(TRACE, WORLD);
       log << "Committing Kafka topic: " << topic;
       for (int i = 0; i < buf.next_offsets->cnt; i++) {
         if (i) {
@@ -683,7 +683,7 @@ void KafkaMessageSource<Key>::run(std::function<HCTR_MESSAGE_SOURCE_CALLBACK> ca
 
     // Messages emitted by a sink shouldn't have a key and need to be at least 8 bytes long.
     if (msg->key_len != 0 || msg->len < sizeof(uint32_t) * 2) {
-      auto log = HCTR_LOG_S(WARNING, WORLD);
+      auto log = HCTR_LOG_ENTRY(WARNING, WORLD);
       log << "Unexpected message. Data corruption? Discarding!" << std::endl
           << "Topic = " << rd_kafka_topic_name(msg->rkt) << std::endl
           << "Offset = " << msg->offset << std::endl
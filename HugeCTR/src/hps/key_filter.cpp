@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <cmath>
+#include <hps/key_filter.hpp>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+KeyFilter::KeyFilter(const size_t capacity, const double bits_per_key)
+    : capacity_{capacity},
+      blocks_(std::max(static_cast<size_t>(std::ceil(static_cast<double>(capacity) * bits_per_key /
+                                                     static_cast<double>(sizeof(Block) * 8))),
+                       size_t{1})) {
+  HCTR_CHECK_HINT(bits_per_key > 0, "Bits per key must be positive!");
+}
+
+double KeyFilter::expected_false_positive_rate() const {
+  // Block loads follow a Poisson distribution. A query for an absent key fails, if the tested bit
+  // is set in each of the words of its block.
+  const double load = static_cast<double>(num_inserted()) / static_cast<double>(blocks_.size());
+  const double max_load = load + 10 * std::sqrt(load) + 20;
+
+  double fpr = 0;
+  double p = std::exp(-load);
+  for (double l = 0; l <= max_load; l++) {
+    const double word_fpr = 1 - std::pow(1 - 1.0 / 64, l);
+    fpr += p * std::pow(word_fpr, static_cast<double>(words_per_block));
+    p *= load / (l + 1);
+  }
+  return fpr;
+}
+
+}  // namespace HugeCTR
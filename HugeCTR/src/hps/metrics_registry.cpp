@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <cmath>
+#include <cstring>
+#include <hps/metrics_registry.hpp>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace HugeCTR {
+
+std::atomic<size_t> MetricCounter::next_shard_{0};
+
+uint64_t MetricCounter::value() const {
+  uint64_t sum = 0;
+  for (const Shard& shard : shards_) {
+    sum += shard.value.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+void MetricGauge::add(const double value) {
+  double expected = value_.load(std::memory_order_relaxed);
+  while (!value_.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed)) {
+  }
+}
+
+size_t MetricHistogram::bucket_index(const uint64_t value) {
+  if (value < num_sub_buckets) {
+    return value;
+  }
+  const size_t msb = 63 - __builtin_clzll(value);
+  const size_t shift = msb - sub_bucket_bits;
+  return (shift + 1) * num_sub_buckets + ((value >> shift) & (num_sub_buckets - 1));
+}
+
+uint64_t MetricHistogram::bucket_lower_bound(const size_t index) {
+  if (index < 2 * num_sub_buckets) {
+    return index;
+  }
+  const size_t shift = index / num_sub_buckets - 1;
+  return (num_sub_buckets + index % num_sub_buckets) << shift;
+}
+
+uint64_t MetricHistogram::count() const {
+  uint64_t count = 0;
+  for (const auto& bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t MetricHistogram::quantile(const double q) const {
+  std::array<uint64_t, num_buckets> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < num_buckets; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (!total) {
+    return 0;
+  }
+
+  const uint64_t rank = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(std::clamp(q, 0., 1.) * static_cast<double>(total))), 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      // Largest value that falls into this bucket.
+      return i + 1 < num_buckets ? bucket_lower_bound(i + 1) - 1
+                                 : std::numeric_limits<uint64_t>::max();
+    }
+  }
+  return std::numeric_limits<uint64_t>::max();
+}
+
+std::vector<uint64_t> MetricHistogram::cumulative_counts(
+    const std::vector<uint64_t>& values) const {
+  std::vector<uint64_t> counts(values.size());
+  for (size_t i = 0; i < num_buckets; i++) {
+    const uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+    if (!n) {
+      continue;
+    }
+    const uint64_t upper_bound =
+        i + 1 < num_buckets ? bucket_lower_bound(i + 1) : std::numeric_limits<uint64_t>::max();
+    for (size_t j = 0; j < values.size(); j++) {
+      if (upper_bound <= values[j]) {
+        counts[j] += n;
+      }
+    }
+  }
+  return counts;
+}
+
+MetricsRegistry& MetricsRegistry::get() {
+  // Never destroyed, because metrics may still be updated by threads that outlive main().
+  static MetricsRegistry* const instance = new MetricsRegistry();
+  return *instance;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family_(const std::string& name,
+                                                  const std::string& help, const Type type) {
+  const auto it = families_.try_emplace(name, Family{type, help, {}, {}, {}}).first;
+  if (it->second.type != type) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Metric '" + name + "' was already registered with a different type.");
+  }
+  return it->second;
+}
+
+namespace {
+
+void write_escaped(std::ostream& os, const std::string& s) {
+  for (const char c : s) {
+    switch (c) {
+      case '\\':
+        os << "\\\\";
+        break;
+      case '"':
+        os << "\\\"";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        os << c;
+    }
+  }
+}
+
+// Formats the labels as `k1="v1",k2="v2"` (without braces, so that "le" can be appended).
+std::string format_labels(const MetricLabels& labels) {
+  std::ostringstream os;
+  for (size_t i = 0; i < labels.size(); i++) {
+    if (i) {
+      os << ',';
+    }
+    os << labels[i].first << "=\"";
+    write_escaped(os, labels[i].second);
+    os << '"';
+  }
+  return os.str();
+}
+
+void write_series(std::ostream& os, const std::string& name, const std::string& labels) {
+  os << name;
+  if (!labels.empty()) {
+    os << '{' << labels << '}';
+  }
+  os << ' ';
+}
+
+// Histogram buckets exported to Prometheus: Powers of 2 from ~1 us to ~69 s.
+const std::vector<uint64_t>& prometheus_bucket_bounds() {
+  static const std::vector<uint64_t> bounds = []() {
+    std::vector<uint64_t> bounds;
+    for (size_t i = 10; i <= 36; i++) {
+      bounds.emplace_back(uint64_t{1} << i);
+    }
+    return bounds;
+  }();
+  return bounds;
+}
+
+}  // namespace
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                        const MetricLabels& labels) {
+  const std::lock_guard lock(mutex_);
+  auto& metric = family_(name, help, Type::Counter).counters[format_labels(labels)];
+  if (!metric) {
+    metric = std::make_unique<MetricCounter>();
+  }
+  return *metric;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                                    const MetricLabels& labels) {
+  const std::lock_guard lock(mutex_);
+  auto& metric = family_(name, help, Type::Gauge).gauges[format_labels(labels)];
+  if (!metric) {
+    metric = std::make_unique<MetricGauge>();
+  }
+  return *metric;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                            const MetricLabels& labels) {
+  const std::lock_guard lock(mutex_);
+  auto& metric = family_(name, help, Type::Histogram).histograms[format_labels(labels)];
+  if (!metric) {
+    metric = std::make_unique<MetricHistogram>();
+  }
+  return *metric;
+}
+
+void MetricsRegistry::write_prometheus(std::ostream& os) const {
+  const std::lock_guard lock(mutex_);
+  const std::vector<uint64_t>& bounds = prometheus_bucket_bounds();
+
+  os << std::setprecision(10);
+  for (const auto& family_entry : families_) {
+    const std::string& name = family_entry.first;
+    const Family& family = family_entry.second;
+
+    os << "# HELP " << name << ' ' << family.help << '\n';
+    switch (family.type) {
+      case Type::Counter:
+        os << "# TYPE " << name << " counter\n";
+        for (const auto& metric : family.counters) {
+          write_series(os, name, metric.first);
+          os << metric.second->value() << '\n';
+        }
+        break;
+
+      case Type::Gauge:
+        os << "# TYPE " << name << " gauge\n";
+        for (const auto& metric : family.gauges) {
+          write_series(os, name, metric.first);
+          os << metric.second->value() << '\n';
+        }
+        break;
+
+      case Type::Histogram:
+        os << "# TYPE " << name << " histogram\n";
+        for (const auto& metric : family.histograms) {
+          const std::string& labels = metric.first;
+          const std::string separator = labels.empty() ? "" : ",";
+          const MetricHistogram& histogram = *metric.second;
+
+          // Values are recorded in nanoseconds, but exported in seconds.
+          const uint64_t count = histogram.count();
+          const std::vector<uint64_t> counts = histogram.cumulative_counts(bounds);
+          for (size_t i = 0; i < bounds.size(); i++) {
+            os << name << "_bucket{" << labels << separator << "le=\""
+               << static_cast<double>(bounds[i]) * 1e-9 << "\"} " << counts[i] << '\n';
+          }
+          os << name << "_bucket{" << labels << separator << "le=\"+Inf\"} " << count << '\n';
+          write_series(os, name + "_sum", labels);
+          os << static_cast<double>(histogram.sum()) * 1e-9 << '\n';
+          write_series(os, name + "_count", labels);
+          os << count << '\n';
+        }
+        break;
+    }
+  }
+}
+
+std::string MetricsRegistry::to_prometheus() const {
+  std::ostringstream os;
+  write_prometheus(os);
+  return os.str();
+}
+
+MetricsHttpServer::MetricsHttpServer(const uint16_t port, const std::string& address)
+    : port_{port} {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Invalid metrics server address '" + address + "'.");
+  }
+
+  socket_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socket_ < 0) {
+    HCTR_OWN_THROW(Error_t::UnspecificError, std::string("socket: ") + std::strerror(errno));
+  }
+  const int reuse = 1;
+  setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (::bind(socket_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(socket_, 16) != 0) {
+    const std::string error = std::strerror(errno);
+    ::close(socket_);
+    HCTR_OWN_THROW(Error_t::UnspecificError, "Unable to serve metrics on " + address + ':' +
+                                                 std::to_string(port) + ": " + error);
+  }
+
+  // Port 0 = any free port.
+  socklen_t addr_len = sizeof(addr);
+  getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+  port_ = ntohs(addr.sin_port);
+
+  HCTR_LOG_S(INFO, WORLD) << "Serving HPS metrics on http://" << address << ':' << port_
+                          << "/metrics" << std::endl;
+  thread_ = std::thread(&MetricsHttpServer::run_, this);
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+  terminate_ = true;
+  thread_.join();
+  ::close(socket_);
+}
+
+void MetricsHttpServer::run_() {
+  hctr_set_thread_name("hps metrics");
+
+  while (!terminate_) {
+    pollfd pfd{socket_, POLLIN, 0};
+    if (poll(&pfd, 1, 100) <= 0) {
+      continue;
+    }
+    const int client = ::accept4(socket_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      continue;
+    }
+
+    // Read the request header. We only look at the request line.
+    const timeval timeout{1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 16 * 1024) {
+      const ssize_t n = ::recv(client, buffer, sizeof(buffer), 0);
+      if (n <= 0) {
+        break;
+      }
+      request.append(buffer, n);
+    }
+
+    std::string status = "200 OK";
+    std::string body;
+    if (request.compare(0, 4, "GET ") != 0) {
+      status = "405 Method Not Allowed";
+    } else {
+      const std::string path = request.substr(4, request.find(' ', 4) - 4);
+      if (path == "/metrics" || path == "/") {
+        body = MetricsRegistry::get().to_prometheus();
+      } else {
+        status = "404 Not Found";
+      }
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    const std::string& data = response.str();
+    for (size_t sent = 0; sent < data.size();) {
+      const ssize_t n = ::send(client, &data[sent], data.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) {
+        break;
+      }
+      sent += n;
+    }
+    ::close(client);
+  }
+}
+
+DatabaseBackendMetrics& DatabaseBackendMetrics::get(const std::string& backend) {
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<DatabaseBackendMetrics>> metrics;
+
+  const std::lock_guard lock(mutex);
+  auto& m = metrics[backend];
+  if (!m) {
+    MetricsRegistry& registry = MetricsRegistry::get();
+    const MetricLabels labels{{"backend", backend}};
+    m.reset(new DatabaseBackendMetrics{
+        registry.histogram("hps_backend_fetch_duration_seconds",
+                           "Time spent in database backend fetch calls.", labels),
+        registry.counter("hps_backend_fetch_keys_total", "Keys queried from the database backend.",
+                         labels),
+        registry.counter("hps_backend_fetch_hits_total", "Keys found in the database backend.",
+                         labels),
+        registry.histogram("hps_backend_insert_duration_seconds",
+                           "Time spent in database backend insert calls.", labels),
+        registry.counter("hps_backend_insert_pairs_total",
+                         "Key/value pairs inserted into the database backend.", labels),
+        registry.histogram("hps_backend_evict_duration_seconds",
+                           "Time spent in database backend evict calls.", labels),
+        registry.counter("hps_backend_evict_keys_total", "Keys evicted from the database backend.",
+                         labels),
+        registry.histogram("hps_backend_overflow_resolution_duration_seconds",
+                           "Time spent resolving partition overflows.", labels),
+        registry.counter("hps_backend_overflow_evicted_keys_total",
+                         "Keys evicted to resolve partition overflows.", labels),
+    });
+  }
+  return *m;
+}
+
+}  // namespace HugeCTR
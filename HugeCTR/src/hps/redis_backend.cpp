@@ -14,16 +14,20 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <base/debug/logger.hpp>
 #include <boost/algorithm/string.hpp>
+#include <hps/bin_dump.hpp>
 #include <hps/database_backend_detail.hpp>
 #include <hps/hier_parameter_server_base.hpp>
+#include <hps/metrics_registry.hpp>
 #include <hps/redis_backend.hpp>
 #include <iostream>
 #include <optional>
 #include <random>
 #include <string_view>
 #include <thread_pool.hpp>
+#include <unordered_map>
 #include <unordered_set>
 
 // TODO: Remove me!
@@ -38,6 +42,96 @@ inline std::string make_hkey(const std::string& table_name, const size_t partiti
   return os.str();
 }
 
+constexpr size_t redis_num_hash_slots = 16384;
+
+/**
+ * Hash slot of a Redis key (CRC16/XMODEM of the hash tag, see Redis cluster specification).
+ */
+inline size_t redis_hash_slot(const std::string& key) {
+  std::string_view tag = key;
+  const size_t tag_begin = key.find('{');
+  if (tag_begin != std::string::npos) {
+    const size_t tag_end = key.find('}', tag_begin + 1);
+    if (tag_end != std::string::npos && tag_end != tag_begin + 1) {
+      tag = tag.substr(tag_begin + 1, tag_end - tag_begin - 1);
+    }
+  }
+
+  uint32_t crc = 0;
+  for (const char c : tag) {
+    crc ^= static_cast<uint32_t>(static_cast<uint8_t>(c)) << 8;
+    for (size_t i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return (crc & 0xffff) % redis_num_hash_slots;
+}
+
+/**
+ * Lua scripts for overflow resolution. KEYS[1] = value hash, KEYS[2] = time sorted set,
+ * ARGV[1] = number of pairs to evict. Both keys share a hash tag, i.e., live in the same slot.
+ * Hence, the victims never leave the server.
+ */
+constexpr const char* redis_evict_oldest_script = R"(
+local victims = redis.call('ZPOPMIN', KEYS[2], ARGV[1])
+local batch = {}
+for i = 1, #victims, 2 do
+  batch[#batch + 1] = victims[i]
+  if #batch == 1024 then
+    redis.call('HDEL', KEYS[1], unpack(batch))
+    batch = {}
+  end
+end
+if #batch > 0 then
+  redis.call('HDEL', KEYS[1], unpack(batch))
+end
+return #victims / 2
+)";
+
+constexpr const char* redis_evict_random_script = R"(
+local victims = redis.call('ZRANDMEMBER', KEYS[2], ARGV[1])
+for i = 1, #victims, 1024 do
+  local batch = {unpack(victims, i, math.min(i + 1023, #victims))}
+  redis.call('ZREM', KEYS[2], unpack(batch))
+  redis.call('HDEL', KEYS[1], unpack(batch))
+end
+return #victims
+)";
+
+/**
+ * Lua script that migrates a partition from the previous layout, where access times were stored
+ * as binary `time_t` values in a hash (suffix 't'). KEYS[1] = value hash, KEYS[2] = time sorted
+ * set, KEYS[3] = legacy time hash. Legacy timestamps are carried over and the legacy hash is
+ * dropped. Values that still lack an access time get score 0, so that they are evicted first.
+ * Returns the number of migrated access times.
+ */
+constexpr const char* redis_migrate_legacy_script = R"(
+local n = 0
+local times = redis.call('HGETALL', KEYS[3])
+for i = 1, #times, 2 do
+  if redis.call('HEXISTS', KEYS[1], times[i]) == 1 then
+    n = n + redis.call('ZADD', KEYS[2], 'NX', struct.unpack('<i8', times[i + 1]), times[i])
+  end
+end
+redis.call('DEL', KEYS[3])
+if redis.call('ZCARD', KEYS[2]) < redis.call('HLEN', KEYS[1]) then
+  local keys = redis.call('HKEYS', KEYS[1])
+  for i = 1, #keys do
+    n = n + redis.call('ZADD', KEYS[2], 'NX', 0, keys[i])
+  end
+end
+return n
+)";
+
+/**
+ * A run of keys from the same partition that is queried with a single HMGET.
+ */
+struct RedisFetchBatch final {
+  size_t part;
+  const size_t* indices;
+  size_t num_indices;
+};
+
 #ifdef HCTR_REDIS_VALUE_HKEY
 #error HCTR_REDIS_VALUE_HKEY should not be defined!
 #else
@@ -46,23 +140,33 @@ inline std::string make_hkey(const std::string& table_name, const size_t partiti
 #ifdef HCTR_REDIS_TIME_HKEY
 #error HCTR_REDIS_TIME_HKEY should not be defined!
 #else
-#define HCTR_REDIS_TIME_HKEY() const std::string& hkey_t = make_hkey(table_name, part, 't')
+#define HCTR_REDIS_TIME_HKEY() const std::string& hkey_t = make_hkey(table_name, part, 'z')
+#endif
+#ifdef HCTR_REDIS_LEGACY_TIME_HKEY
+#error HCTR_REDIS_LEGACY_TIME_HKEY should not be defined!
+#else
+#define HCTR_REDIS_LEGACY_TIME_HKEY() const std::string& hkey_l = make_hkey(table_name, part, 't')
 #endif
 
 template <typename Key>
 RedisClusterBackend<Key>::RedisClusterBackend(
     const std::string& address, const std::string& user_name, const std::string& password,
     const size_t num_partitions, const size_t num_node_connections, const size_t max_get_batch_size,
-    const size_t max_set_batch_size, const bool refresh_time_after_fetch,
-    const size_t overflow_margin, const DatabaseOverflowPolicy_t overflow_policy,
-    const double overflow_resolution_target)
+    const size_t max_set_batch_size, const bool async_fetch, const size_t max_pipeline_depth,
+    const bool refresh_time_after_fetch, const size_t overflow_margin,
+    const DatabaseOverflowPolicy_t overflow_policy, const double overflow_resolution_target)
     : Base(max_get_batch_size, max_set_batch_size, overflow_margin, overflow_policy,
            overflow_resolution_target),
+      num_node_connections_{num_node_connections},
+      async_fetch_{async_fetch},
+      max_pipeline_depth_{max_pipeline_depth},
       refresh_time_after_fetch_{refresh_time_after_fetch},
       // Can switch to std::range in C++20.
-      num_partitions_{num_partitions} {
+      num_partitions_{num_partitions},
+      metrics_{DatabaseBackendMetrics::get(get_name())} {
   HCTR_CHECK(num_node_connections > 0);
   HCTR_CHECK(num_partitions_ >= num_node_connections);
+  HCTR_CHECK(max_pipeline_depth > 0);
 
   // Put together cluster configuration.
   sw::redis::ConnectionOptions options;
@@ -334,7 +438,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
 
         sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
         pipe.hset(hkey_v, k_view, {values, value_size});
-        pipe.hset(hkey_t, k_view, {reinterpret_cast<const char*>(&now), sizeof(time_t)});
+        pipe.zadd(hkey_t, k_view, static_cast<double>(now));
         pipe.exec();
 
         num_inserts++;
@@ -357,7 +461,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
 
         try {
           std::vector<std::pair<std::string_view, std::string_view>> v_views;
-          std::vector<std::pair<std::string_view, std::string_view>> t_views;
+          std::vector<std::pair<std::string_view, double>> t_views;
 
           size_t num_batches = 0;
           for (const Key* k = keys; k != keys_end; num_batches++) {
@@ -371,10 +475,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
                   std::piecewise_construct,
                   std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),
                   std::forward_as_tuple(&values[(k - keys) * value_size], value_size));
-              t_views.emplace_back(
-                  std::piecewise_construct,
-                  std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),
-                  std::forward_as_tuple(reinterpret_cast<const char*>(&now), sizeof(time_t)));
+              t_views.emplace_back(v_views.back().first, static_cast<double>(now));
               if (t_views.size() >= this->max_set_batch_size_) {
                 ++k;
                 break;
@@ -386,7 +487,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
 
             sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
             pipe.hmset(hkey_v, v_views.begin(), v_views.end());
-            pipe.hmset(hkey_t, t_views.begin(), t_views.end());
+            pipe.zadd(hkey_t, t_views.begin(), t_views.end());
             pipe.exec();
 
             HCTR_LOG_S(TRACE, WORLD)
@@ -418,7 +519,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
 
             try {
               std::vector<std::pair<std::string_view, std::string_view>> v_views;
-              std::vector<std::pair<std::string_view, std::string_view>> t_views;
+              std::vector<std::pair<std::string_view, double>> t_views;
 
               size_t num_batches = 0;
               for (const Key* k = keys; k != keys_end; num_batches++) {
@@ -433,10 +534,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
                         std::piecewise_construct,
                         std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),
                         std::forward_as_tuple(&values[(k - keys) * value_size], value_size));
-                    t_views.emplace_back(
-                        std::piecewise_construct,
-                        std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),
-                        std::forward_as_tuple(reinterpret_cast<const char*>(&now), sizeof(time_t)));
+                    t_views.emplace_back(v_views.back().first, static_cast<double>(now));
                     if (t_views.size() >= this->max_set_batch_size_) {
                       ++k;
                       break;
@@ -449,7 +547,7 @@ bool RedisClusterBackend<Key>::insert(const std::string& table_name, const size_
 
                 sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
                 pipe.hmset(hkey_v, v_views.begin(), v_views.end());
-                pipe.hmset(hkey_t, t_views.begin(), t_views.end());
+                pipe.zadd(hkey_t, t_views.begin(), t_views.end());
                 pipe.exec();
 
                 HCTR_LOG_S(TRACE, WORLD)
@@ -485,6 +583,10 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
                                        const Key* const keys, const DatabaseHitCallback& on_hit,
                                        const DatabaseMissCallback& on_miss,
                                        const std::chrono::nanoseconds& time_budget) {
+  if (async_fetch_) {
+    return fetch_async_(table_name, num_keys, nullptr, keys, on_hit, on_miss, time_budget);
+  }
+
   const auto begin = std::chrono::high_resolution_clock::now();
 
   size_t hit_count = 0;
@@ -740,6 +842,10 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
                                        const DatabaseHitCallback& on_hit,
                                        const DatabaseMissCallback& on_miss,
                                        const std::chrono::nanoseconds& time_budget) {
+  if (async_fetch_) {
+    return fetch_async_(table_name, num_indices, indices, keys, on_hit, on_miss, time_budget);
+  }
+
   const auto begin = std::chrono::high_resolution_clock::now();
 
   size_t hit_count = 0;
@@ -999,6 +1105,52 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
   return hit_count;
 }
 
+template <typename Key>
+size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                       const Key* const keys, char* const values,
+                                       const size_t value_size, const size_t value_stride,
+                                       std::vector<size_t>& missing,
+                                       const std::chrono::nanoseconds& time_budget) {
+  if (!async_fetch_) {
+    return Base::fetch(table_name, num_keys, keys, values, value_size, value_stride, missing,
+                       time_budget);
+  }
+
+  // Values are copied straight from the reply buffers into the output buffer.
+  BulkFetchTarget target(values, value_size, value_stride, num_keys, missing);
+  const size_t hit_count = fetch_async_(
+      table_name, num_keys, nullptr, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
+template <typename Key>
+size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                       const size_t* const indices, const Key* const keys,
+                                       char* const values, const size_t value_size,
+                                       const size_t value_stride, std::vector<size_t>& missing,
+                                       const std::chrono::nanoseconds& time_budget) {
+  if (!async_fetch_) {
+    return Base::fetch(table_name, num_indices, indices, keys, values, value_size, value_stride,
+                       missing, time_budget);
+  }
+
+  // Values are copied straight from the reply buffers into the output buffer.
+  BulkFetchTarget target(values, value_size, value_stride, num_indices, missing);
+  const size_t hit_count = fetch_async_(
+      table_name, num_indices, indices, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
+
 template <typename Key>
 size_t RedisClusterBackend<Key>::evict(const std::string& table_name) {
   size_t approx_num_keys;
@@ -1009,14 +1161,16 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name) {
     // Precalc constants.
     HCTR_REDIS_VALUE_HKEY();
     HCTR_REDIS_TIME_HKEY();
+    HCTR_REDIS_LEGACY_TIME_HKEY();
 
     try {
       approx_num_keys = redis_->hlen(hkey_v);
 
-      // Delete the keys.
+      // Delete the keys (including access times left behind by the previous layout).
       sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
       pipe.del(hkey_v);
       pipe.del(hkey_t);
+      pipe.del(hkey_l);
       pipe.exec();
     } catch (sw::redis::Error& e) {
       throw DatabaseBackendError(get_name(), part, e.what());
@@ -1033,14 +1187,16 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name) {
         // Precalc constants.
         HCTR_REDIS_VALUE_HKEY();
         HCTR_REDIS_TIME_HKEY();
+        HCTR_REDIS_LEGACY_TIME_HKEY();
 
         try {
           const size_t approx_num_keys = redis_->hlen(hkey_v);
 
-          // Delete the keys.
+          // Delete the keys (including access times left behind by the previous layout).
           sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
           pipe.del(hkey_v);
           pipe.del(hkey_t);
+          pipe.del(hkey_l);
           pipe.exec();
 
           HCTR_LOG_S(TRACE, WORLD)
@@ -1085,7 +1241,7 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name, const size
         // Erase.
         sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
         pipe.hdel(hkey_v, k_view);
-        pipe.hdel(hkey_t, k_view);
+        pipe.zrem(hkey_t, k_view);
         sw::redis::QueuedReplies replies = pipe.exec();
         HCTR_CHECK(replies.size() == 2);
 
@@ -1120,7 +1276,7 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name, const size
             // Erase.
             sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
             pipe.hdel(hkey_v, k_views.begin(), k_views.end());
-            pipe.hdel(hkey_t, k_views.begin(), k_views.end());
+            pipe.zrem(hkey_t, k_views.begin(), k_views.end());
             sw::redis::QueuedReplies replies = pipe.exec();
             HCTR_CHECK(replies.size() == 2);
 
@@ -1174,7 +1330,7 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name, const size
                 // Erase.
                 sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
                 pipe.hdel(hkey_v, k_views.begin(), k_views.end());
-                pipe.hdel(hkey_t, k_views.begin(), k_views.end());
+                pipe.zrem(hkey_t, k_views.begin(), k_views.end());
                 sw::redis::QueuedReplies replies = pipe.exec();
                 HCTR_CHECK(replies.size() == 2);
 
@@ -1246,12 +1402,13 @@ std::vector<Key> RedisClusterBackend<Key>::keys(const std::string& table_name) {
 
   if (num_partitions_ == 1) {
     static constexpr size_t part = 0;
-    HCTR_REDIS_TIME_HKEY();
+    HCTR_REDIS_VALUE_HKEY();
 
-    // Fetch keys.
+    // Fetch keys. The value hash also holds the keys of partitions not yet migrated from the
+    // previous access time layout.
     std::vector<std::string> k_views;
     try {
-      redis_->hkeys(hkey_t, std::back_inserter(k_views));
+      redis_->hkeys(hkey_v, std::back_inserter(k_views));
     } catch (sw::redis::Error& e) {
       throw DatabaseBackendError(get_name(), part, e.what());
     }
@@ -1270,12 +1427,12 @@ std::vector<Key> RedisClusterBackend<Key>::keys(const std::string& table_name) {
 
     for (size_t part = 0; part < num_partitions_; ++part) {
       tasks.emplace_back(ThreadPool::get().submit([&, part]() {
-        HCTR_REDIS_TIME_HKEY();
+        HCTR_REDIS_VALUE_HKEY();
 
         // Fetch keys.
         std::vector<std::string> k_views;
         try {
-          redis_->hkeys(hkey_t, std::back_inserter(k_views));
+          redis_->hkeys(hkey_v, std::back_inserter(k_views));
         } catch (sw::redis::Error& e) {
           throw DatabaseBackendError(get_name(), part, e.what());
         }
@@ -1296,7 +1453,7 @@ std::vector<Key> RedisClusterBackend<Key>::keys(const std::string& table_name) {
 }
 
 template <typename Key>
-void RedisClusterBackend<Key>::dump_bin(const std::string& table_name, std::ofstream& file) {
+void RedisClusterBackend<Key>::dump_bin(const std::string& table_name, const std::string& path) {
   std::vector<Key> k = keys(table_name);
 
   // TODO: Maybe not ideal to shuffle to undo partition sorting. Use a different data structure?
@@ -1306,9 +1463,13 @@ void RedisClusterBackend<Key>::dump_bin(const std::string& table_name, std::ofst
     std::shuffle(k.begin(), k.end(), gen);
   }
 
+  BinDumpWriter file(path, sizeof(Key));
+
   // We just implement this as repeating queries.
   std::vector<std::string> v_views(this->max_get_batch_size_);
   std::atomic<uint32_t> first_value_size{0};
+  std::vector<Key> batch_keys;
+  std::vector<char> batch_values;
 
   for (auto k_it = k.begin(); k_it != k.end();) {
     // Read batch values.
@@ -1326,20 +1487,20 @@ void RedisClusterBackend<Key>::dump_bin(const std::string& table_name, std::ofst
         },
         [&](const size_t index) { v_views[index].clear(); }, std::chrono::nanoseconds::max());
 
-    // Write the value size if this is the first batch.
-    if (k_it == k.begin() && first_value_size) {
-      file.write(reinterpret_cast<const char*>(&first_value_size), sizeof(uint32_t));
-    }
-
     // Write the batch.
+    batch_keys.clear();
+    batch_values.clear();
     for (auto v_views_it = v_views.begin(); k_it != batch_end; ++k_it, ++v_views_it) {
       const std::string& value = *v_views_it;
       if (!value.empty()) {
-        file.write(reinterpret_cast<const char*>(&*k_it), sizeof(Key));
-        file.write(value.data(), value.size());
+        batch_keys.emplace_back(*k_it);
+        batch_values.insert(batch_values.end(), value.begin(), value.end());
       }
     }
+    file.append(batch_keys.size(), batch_keys.data(), batch_values.data(), first_value_size);
   }
+
+  file.finish();
 }
 
 template <typename Key>
@@ -1378,116 +1539,46 @@ template <typename Key>
 void RedisClusterBackend<Key>::check_and_resolve_overflow_(const size_t part,
                                                            const std::string& hkey_v,
                                                            const std::string& hkey_t) {
+  // Partitions written with the previous layout lack access times in the sorted set. Migrate them
+  // once, so that all values are visible to the overflow check.
+  bool migrated;
+  {
+    const std::lock_guard<std::mutex> lock(migrated_parts_guard_);
+    migrated = migrated_parts_.find(hkey_v) != migrated_parts_.end();
+  }
+  if (!migrated) {
+    std::string hkey_l = hkey_v;
+    hkey_l.back() = 't';
+    const long long num_migrated =
+        redis_->eval<long long>(redis_migrate_legacy_script, {hkey_v, hkey_t, hkey_l}, {});
+    if (num_migrated > 0) {
+      HCTR_LOG_S(INFO, WORLD) << get_name() << " partition " << hkey_v << ": Migrated "
+                              << num_migrated << " access times from the previous layout."
+                              << std::endl;
+    }
+
+    const std::lock_guard<std::mutex> lock(migrated_parts_guard_);
+    migrated_parts_.emplace(hkey_v);
+  }
+
   // Check overflow condition.
-  size_t part_size = redis_->hlen(hkey_t);
+  size_t part_size = static_cast<size_t>(redis_->zcard(hkey_t));
   if (part_size <= this->overflow_margin_) {
     return;
   }
   HCTR_LOG_S(TRACE, WORLD) << get_name() << " partition " << hkey_v
                            << " is overflowing (size = " << part_size << " > "
                            << this->overflow_margin_ << "). Attempting to resolve..." << std::endl;
+  const MetricTimer timer(metrics_.overflow_resolution_duration);
 
   // Select overflow resolution policy.
+  const char* script;
   switch (this->overflow_policy_) {
     case DatabaseOverflowPolicy_t::EvictOldest: {
-      // Fetch keys and insert times.
-      std::vector<std::pair<Key, time_t>> kt;
-      {
-        // Fetch from Redis.
-        std::vector<std::pair<std::string, std::string>> kt_views;
-        kt_views.reserve(part_size);
-        redis_->hgetall(hkey_t, std::back_inserter(kt_views));
-
-        // Sanity check.
-        part_size = kt_views.size();
-        if (part_size <= this->overflow_resolution_target_) {
-          return;
-        }
-
-        // Convert to native format.
-        kt.reserve(part_size);
-        for (const std::pair<std::string, std::string>& kt_view : kt_views) {
-          kt.emplace_back(*reinterpret_cast<const Key*>(kt_view.first.data()),
-                          *reinterpret_cast<const time_t*>(kt_view.second.data()));
-        }
-      }
-
-      // Sort by ascending by time.
-      std::sort(kt.begin(), kt.end(),
-                [](const auto& a, const auto& b) { return a.second < b.second; });
-
-      // Delete pairs in batches until overflow condition is no longer fulfilled.
-      std::vector<std::string_view> k_views;
-      k_views.reserve(this->max_set_batch_size_);
-
-      for (auto kt_it = kt.begin(); kt_it != kt.end();) {
-        // Collect a batch.
-        const auto batch_end = std::min(kt_it + this->max_set_batch_size_, kt.end());
-        k_views.clear();
-        for (; kt_it != batch_end; ++kt_it) {
-          k_views.emplace_back(reinterpret_cast<const char*>(&kt_it->first), sizeof(Key));
-        }
-
-        // Perform deletion.
-        HCTR_LOG_S(TRACE, WORLD) << get_name() << " partition " << hkey_v
-                                 << " (size = " << part_size << "). Attempting to evict "
-                                 << k_views.size() << " OLD key/value pairs." << std::endl;
-
-        sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
-        pipe.hdel(hkey_v, k_views.begin(), k_views.end());
-        pipe.hdel(hkey_t, k_views.begin(), k_views.end());
-        pipe.exec();
-
-        // Overflow resolved?
-        part_size = redis_->hlen(hkey_t);
-        if (part_size <= this->overflow_resolution_target_) {
-          break;
-        }
-      }
+      script = redis_evict_oldest_script;
     } break;
     case DatabaseOverflowPolicy_t::EvictRandom: {
-      // Fetch all keys in partition.
-      std::vector<std::string> k_views;
-      k_views.reserve(part_size);
-      redis_->hkeys(hkey_t, std::back_inserter(k_views));
-
-      // Sanity check.
-      part_size = k_views.size();
-      if (part_size <= this->overflow_resolution_target_) {
-        return;
-      }
-
-      // Shuffle the keys.
-      {
-        std::random_device rd;
-        std::default_random_engine gen(rd());
-        std::shuffle(k_views.begin(), k_views.end(), gen);
-      }
-
-      // Delete pairs in batches until overflow condition is no longer fulfilled.
-      // Delete keys.
-      const auto k_end = k_views.end();
-      for (auto k_it = k_views.begin(); k_it != k_end;) {
-        const auto batch_end = std::min(k_it + this->max_set_batch_size_, k_end);
-
-        // Perform deletion.
-        HCTR_LOG_S(TRACE, WORLD) << get_name() << " partition " << hkey_v
-                                 << " (size = " << part_size << "). Attempting to evict "
-                                 << k_views.size() << " RANDOM key/value pairs." << std::endl;
-
-        sw::redis::Pipeline pipe = redis_->pipeline(hkey_v, false);
-        pipe.hdel(hkey_v, k_it, batch_end);
-        pipe.hdel(hkey_t, k_it, batch_end);
-        pipe.exec();
-
-        // Overflow resolved?
-        part_size = redis_->hlen(hkey_t);
-        if (part_size <= this->overflow_resolution_target_) {
-          break;
-        }
-
-        k_it = batch_end;
-      }
+      script = redis_evict_random_script;
     } break;
     default: {
       HCTR_LOG_S(WARNING, WORLD) << "Redis partition " << hkey_v << " (size = " << part_size
@@ -1499,6 +1590,29 @@ void RedisClusterBackend<Key>::check_and_resolve_overflow_(const size_t part,
     } break;
   }
 
+  // Delete pairs in batches until overflow condition is no longer fulfilled. Victims are selected
+  // and deleted by the server.
+  size_t hit_count = 0;
+  while (part_size > this->overflow_resolution_target_) {
+    const size_t batch_size =
+        std::min(part_size - this->overflow_resolution_target_, this->max_set_batch_size_);
+
+    HCTR_LOG_S(TRACE, WORLD) << get_name() << " partition " << hkey_v << " (size = " << part_size
+                             << "). Attempting to evict " << batch_size << ' '
+                             << this->overflow_policy_ << " key/value pairs." << std::endl;
+
+    const long long num_evicted =
+        redis_->eval<long long>(script, {hkey_v, hkey_t}, {std::to_string(batch_size)});
+    if (num_evicted <= 0) {
+      break;
+    }
+    hit_count += static_cast<size_t>(num_evicted);
+
+    // Overflow resolved?
+    part_size = static_cast<size_t>(redis_->zcard(hkey_t));
+  }
+  metrics_.overflow_evicted_keys.add(hit_count);
+
   HCTR_LOG_S(DEBUG, WORLD) << get_name() << " partition " << hkey_v
                            << " overflow resolution concluded!" << std::endl;
 }
@@ -1509,10 +1623,10 @@ void RedisClusterBackend<Key>::touch_(const std::string& hkey_t, const Key& key,
   HCTR_LOG_S(TRACE, WORLD) << get_name() << ": Touching key " << key << " of " << hkey_t << '.'
                            << std::endl;
 
-  // Launch query.
+  // Launch query. Only update keys that were not evicted in the meantime.
   try {
-    redis_->hset(hkey_t, {reinterpret_cast<const char*>(&key), sizeof(Key)},
-                 {reinterpret_cast<const char*>(&time), sizeof(time_t)});
+    redis_->zadd(hkey_t, {reinterpret_cast<const char*>(&key), sizeof(Key)},
+                 static_cast<double>(time), sw::redis::UpdateType::EXIST);
   } catch (sw::redis::Error& e) {
     HCTR_LOG_S(ERROR, WORLD) << get_name() << " partition " << hkey_t
                              << "; error during refresh: " << e.what() << '.' << std::endl;
@@ -1527,24 +1641,231 @@ void RedisClusterBackend<Key>::touch_(const std::string& hkey_t,
                            << '.' << std::endl;
 
   // Prepare query.
-  std::vector<std::pair<std::string_view, std::string_view>> kt_views;
+  std::vector<std::pair<std::string_view, double>> kt_views;
   kt_views.reserve(keys->size());
   for (const Key& k : *keys) {
-    kt_views.emplace_back(
-        std::piecewise_construct,
-        std::forward_as_tuple(reinterpret_cast<const char*>(&k), sizeof(Key)),
-        std::forward_as_tuple(reinterpret_cast<const char*>(&time), sizeof(time_t)));
+    kt_views.emplace_back(std::piecewise_construct,
+                          std::forward_as_tuple(reinterpret_cast<const char*>(&k), sizeof(Key)),
+                          std::forward_as_tuple(static_cast<double>(time)));
   }
 
-  // Launch query.
+  // Launch query. Large refreshes are split into several ZADDs, but sent in a single round trip.
+  // Only update keys that were not evicted in the meantime.
   try {
-    redis_->hmset(hkey_t, kt_views.begin(), kt_views.end());
+    sw::redis::Pipeline pipe = redis_->pipeline(hkey_t, false);
+    for (auto kt_it = kt_views.begin(); kt_it != kt_views.end();) {
+      const auto batch_end = std::min(kt_it + this->max_set_batch_size_, kt_views.end());
+      pipe.zadd(hkey_t, kt_it, batch_end, sw::redis::UpdateType::EXIST);
+      kt_it = batch_end;
+    }
+    pipe.exec();
   } catch (sw::redis::Error& e) {
     HCTR_LOG_S(ERROR, WORLD) << get_name() << " partition " << hkey_t
                              << "; error touching refresh: " << e.what() << '.' << std::endl;
   }
 }
 
+template <typename Key>
+std::shared_ptr<const typename RedisClusterBackend<Key>::ClusterTopology>
+RedisClusterBackend<Key>::topology_() {
+  const std::lock_guard<std::mutex> lock(topology_guard_);
+  if (topology_cache_) {
+    return topology_cache_;
+  }
+
+  // Unassigned slots are attributed to the first node. Queries to them fail either way.
+  auto topology = std::make_shared<ClusterTopology>();
+  topology->slot_nodes.resize(redis_num_hash_slots, 0);
+
+  std::unordered_map<std::string, uint32_t> node_ids;
+  try {
+    // Reply: [[first_slot, last_slot, [master_ip, master_port, ...], replicas...], ...]
+    sw::redis::Redis node = redis_->redis("hps_et", false);
+    const sw::redis::ReplyUPtr reply = node.command("CLUSTER", "SLOTS");
+    HCTR_CHECK(reply && reply->type == REDIS_REPLY_ARRAY);
+
+    for (size_t i = 0; i < reply->elements; i++) {
+      const redisReply& range = *reply->element[i];
+      HCTR_CHECK(range.type == REDIS_REPLY_ARRAY && range.elements >= 3);
+      const redisReply& master = *range.element[2];
+      HCTR_CHECK(master.type == REDIS_REPLY_ARRAY && master.elements >= 2);
+
+      std::ostringstream os;
+      os << std::string_view(master.element[0]->str, master.element[0]->len) << ':'
+         << master.element[1]->integer;
+      const uint32_t node_id =
+          node_ids.try_emplace(os.str(), static_cast<uint32_t>(node_ids.size())).first->second;
+
+      const size_t first_slot = static_cast<size_t>(range.element[0]->integer);
+      const size_t last_slot = static_cast<size_t>(range.element[1]->integer);
+      HCTR_CHECK(first_slot <= last_slot && last_slot < redis_num_hash_slots);
+      std::fill(&topology->slot_nodes[first_slot], &topology->slot_nodes[last_slot + 1], node_id);
+    }
+  } catch (sw::redis::Error& e) {
+    throw DatabaseBackendError(get_name(), 0, e.what());
+  }
+  topology->num_nodes = std::max(node_ids.size(), size_t{1});
+
+  HCTR_LOG_S(DEBUG, WORLD) << get_name() << ": Cluster has " << topology->num_nodes
+                           << " master nodes." << std::endl;
+  topology_cache_ = topology;
+  return topology_cache_;
+}
+
+template <typename Key>
+template <typename HitFn, typename MissFn>
+size_t RedisClusterBackend<Key>::fetch_async_(const std::string& table_name, const size_t num_keys,
+                                              const size_t* const indices, const Key* const keys,
+                                              HitFn&& on_hit, MissFn&& on_miss,
+                                              const std::chrono::nanoseconds& time_budget) {
+  const auto begin = std::chrono::high_resolution_clock::now();
+  if (!num_keys) {
+    return 0;
+  }
+
+  // Bucket keys by partition (single pass).
+  std::vector<std::vector<size_t>> part_indices(num_partitions_);
+  for (size_t i = 0; i < num_keys; i++) {
+    const size_t idx = indices ? indices[i] : i;
+    part_indices[HCTR_KEY_TO_DB_PART_INDEX(keys[idx])].emplace_back(idx);
+  }
+
+  // Partitions that are served by the same node share its connections.
+  const std::shared_ptr<const ClusterTopology> topology = topology_();
+  std::vector<std::string> hkeys_v(num_partitions_);
+  std::vector<std::vector<RedisFetchBatch>> node_batches(topology->num_nodes);
+  for (size_t part = 0; part < num_partitions_; part++) {
+    const std::vector<size_t>& idx = part_indices[part];
+    if (idx.empty()) {
+      continue;
+    }
+    hkeys_v[part] = make_hkey(table_name, part, 'v');
+
+    std::vector<RedisFetchBatch>& batches =
+        node_batches[topology->slot_nodes[redis_hash_slot(hkeys_v[part])]];
+    for (size_t i = 0; i < idx.size(); i += this->max_get_batch_size_) {
+      batches.push_back({part, &idx[i], std::min(this->max_get_batch_size_, idx.size() - i)});
+    }
+  }
+
+  std::atomic<size_t> joint_hit_count{0};
+  std::atomic<size_t> joint_ign_count{0};
+
+  // Each lane owns a connection to a node, and keeps up to max_pipeline_depth_ batches in flight.
+  std::vector<std::future<void>> tasks;
+  for (const std::vector<RedisFetchBatch>& batches : node_batches) {
+    const size_t num_lanes = std::min(num_node_connections_, batches.size());
+
+    for (size_t lane = 0; lane < num_lanes; lane++) {
+      tasks.emplace_back(ThreadPool::get().submit([&, lane, num_lanes]() {
+        size_t hit_count = 0;
+        size_t part = batches[lane].part;
+
+        try {
+          sw::redis::Pipeline pipe = redis_->pipeline(hkeys_v[part], false);
+          std::vector<std::string_view> k_views;
+
+          for (size_t b = lane; b < batches.size();) {
+            // Check time budget.
+            const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
+            if (elapsed >= time_budget) {
+              HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name
+                                         << ", lane " << lane << ": Timeout!" << std::endl;
+
+              size_t ign_count = 0;
+              for (; b < batches.size(); b += num_lanes) {
+                const RedisFetchBatch& batch = batches[b];
+                std::for_each_n(batch.indices, batch.num_indices,
+                                [&](const size_t idx) { on_miss(idx); });
+                ign_count += batch.num_indices;
+              }
+              joint_ign_count += ign_count;
+              break;
+            }
+
+            // Queue batches.
+            const size_t round_begin = b;
+            for (size_t depth = 0; depth < max_pipeline_depth_ && b < batches.size();
+                 depth++, b += num_lanes) {
+              const RedisFetchBatch& batch = batches[b];
+              k_views.clear();
+              k_views.reserve(batch.num_indices);
+              std::for_each_n(batch.indices, batch.num_indices, [&](const size_t idx) {
+                k_views.emplace_back(reinterpret_cast<const char*>(&keys[idx]), sizeof(Key));
+              });
+              pipe.hmget(hkeys_v[batch.part], k_views.begin(), k_views.end());
+            }
+            sw::redis::QueuedReplies replies = pipe.exec();
+
+            // Process results without copying the reply buffers.
+            size_t reply_idx = 0;
+            for (size_t r = round_begin; r < b; r += num_lanes) {
+              const RedisFetchBatch& batch = batches[r];
+              part = batch.part;
+
+              const redisReply& reply = replies.get(reply_idx++);
+              HCTR_CHECK(reply.type == REDIS_REPLY_ARRAY && reply.elements == batch.num_indices);
+
+              std::shared_ptr<std::vector<Key>> touched_keys;
+              for (size_t i = 0; i < batch.num_indices; i++) {
+                const redisReply& v = *reply.element[i];
+                const size_t idx = batch.indices[i];
+
+                if (v.type == REDIS_REPLY_STRING) {
+                  on_hit(idx, v.str, static_cast<uint32_t>(v.len));
+                  hit_count++;
+
+                  if (this->refresh_time_after_fetch_) {
+                    if (!touched_keys) {
+                      touched_keys = std::make_shared<std::vector<Key>>();
+                    }
+                    touched_keys->emplace_back(keys[idx]);
+                  }
+                } else {
+                  on_miss(idx);
+                }
+              }
+
+              // Refresh timestamps if desired.
+              if (touched_keys) {
+                const time_t now = std::time(nullptr);
+
+                this->background_worker_.submit([this, table_name, part, touched_keys, now]() {
+                  HCTR_REDIS_TIME_HKEY();
+                  touch_(hkey_t, touched_keys, now);
+                });
+              }
+            }
+
+            HCTR_LOG_S(TRACE, WORLD)
+                << get_name() << " backend; Table " << table_name << ", lane " << lane
+                << ": Fetched " << reply_idx << " batches. Hits " << hit_count << '.' << std::endl;
+          }
+        } catch (sw::redis::RedirectionError& e) {
+          // Slots were migrated. Query the topology again next time.
+          {
+            const std::lock_guard<std::mutex> lock(topology_guard_);
+            topology_cache_.reset();
+          }
+          throw DatabaseBackendError(get_name(), part, e.what());
+        } catch (sw::redis::Error& e) {
+          throw DatabaseBackendError(get_name(), part, e.what());
+        }
+
+        joint_hit_count += hit_count;
+      }));
+    }
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  const size_t hit_count = joint_hit_count;
+  const size_t ign_count = joint_ign_count;
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": " << hit_count
+                           << " / " << (num_keys - ign_count) << " hits, " << ign_count
+                           << " ignored." << std::endl;
+  return hit_count;
+}
+
 template class RedisClusterBackend<unsigned int>;
 template class RedisClusterBackend<long long>;
 
@@ -14,37 +14,128 @@
  * limitations under the License.
  */
 
+#include <rocksdb/cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
+
+#include <algorithm>
 #include <base/debug/logger.hpp>
+#include <execution>
+#include <filesystem>
+#include <hps/bin_dump.hpp>
+#include <hps/database_backend_detail.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <sstream>
 
 // TODO: Remove me!
 #pragma GCC diagnostic error "-Wconversion"
 
 namespace HugeCTR {
 
+namespace {
+
+// Buffers for batched MultiGet queries. Kept per thread, so that lookups do not allocate.
+struct MultiGetBuffers final {
+  std::vector<rocksdb::Slice> k_views;
+  std::vector<rocksdb::PinnableSlice> v_views;
+  std::vector<rocksdb::Status> statuses;
+
+  void reserve(const size_t batch_size) {
+    if (k_views.size() < batch_size) {
+      k_views.resize(batch_size);
+      v_views.resize(batch_size);
+      statuses.resize(batch_size);
+    }
+  }
+
+  static MultiGetBuffers& get() {
+    static thread_local MultiGetBuffers buffers;
+    return buffers;
+  }
+};
+
+// Target size of the SST files that are created for bulk insertion.
+constexpr size_t bulk_insert_file_size = 256L * 1024L * 1024L;
+
+// Position of a key in the order of RocksDB's default (bytewise) comparator. Keys are stored in
+// native (little-endian) byte order. Hence, the bytewise order equals that of the byte-swapped key.
+template <typename Key>
+inline uint64_t bytewise_order(const Key key) {
+  if constexpr (sizeof(Key) == sizeof(uint64_t)) {
+    return __builtin_bswap64(static_cast<uint64_t>(key));
+  } else {
+    static_assert(sizeof(Key) == sizeof(uint32_t));
+    return __builtin_bswap32(static_cast<uint32_t>(key));
+  }
+}
+
+}  // namespace
+
 template <typename Key>
 RocksDBBackend<Key>::RocksDBBackend(const std::string& path, const size_t num_threads,
                                     const bool read_only, const size_t max_get_batch_size,
-                                    const size_t max_set_batch_size)
+                                    const size_t max_set_batch_size, const size_t block_cache_size,
+                                    const double bloom_filter_bits, const bool partitioned_index,
+                                    const DatabaseCompression_t compression)
     : Base(max_get_batch_size, max_set_batch_size), db_{nullptr} {
   HCTR_LOG(INFO, WORLD, "Connecting to RocksDB database...\n");
 
-  // Basic behavior.
-  rocksdb::Options options;
+  // Table format. Point lookups only. Hence, the block cache is all that matters. Index and filter
+  // blocks are charged to the cache, so that its capacity is a true bound for the memory usage.
+  rocksdb::BlockBasedTableOptions table_options;
+  table_options.block_cache = rocksdb::NewLRUCache(block_cache_size);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.cache_index_and_filter_blocks_with_high_priority = true;
+  table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+  if (bloom_filter_bits > 0) {
+    table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bloom_filter_bits));
+  }
+  if (partitioned_index) {
+    table_options.index_type = rocksdb::BlockBasedTableOptions::kTwoLevelIndexSearch;
+    table_options.partition_filters = bloom_filter_bits > 0;
+    table_options.pin_top_level_index_and_filter = true;
+  } else {
+    table_options.index_type = rocksdb::BlockBasedTableOptions::kBinarySearch;
+    table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  }
+
+  // Configure various behaviors and options used in later operations.
+  column_family_options_.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+  column_family_options_.memtable_prefix_bloom_size_ratio = 0.02;
+  column_family_options_.memtable_whole_key_filtering = true;
+  switch (compression) {
+    case DatabaseCompression_t::None:
+      column_family_options_.compression = rocksdb::kNoCompression;
+      break;
+    case DatabaseCompression_t::Snappy:
+      column_family_options_.compression = rocksdb::kSnappyCompression;
+      break;
+    case DatabaseCompression_t::LZ4:
+      column_family_options_.compression = rocksdb::kLZ4Compression;
+      break;
+    case DatabaseCompression_t::ZSTD:
+      column_family_options_.compression = rocksdb::kZSTD;
+      break;
+    default:
+      HCTR_DIE("Unsupported compression (%d)!", compression);
+  }
+  column_family_options_.OptimizeLevelStyleCompaction();
+  // Point lookups do not use readahead. Checksums are only verified when a block is read from
+  // disk, not for cache hits. Hence, the read options are left at their defaults.
+  write_options_.sync = false;
+
+  // Basic behavior. The default column family is configured like all other tables.
+  rocksdb::Options options{rocksdb::DBOptions(), column_family_options_};
   options.create_if_missing = true;
   options.manual_wal_flush = true;
-  options.OptimizeForPointLookup(8);
-  options.OptimizeLevelStyleCompaction();
   HCTR_CHECK(num_threads <= std::numeric_limits<int>::max());
   options.IncreaseParallelism(static_cast<int>(num_threads));
 
-  // Configure various behaviors and options used in later operations.
-  column_family_options_.OptimizeForPointLookup(8);
-  column_family_options_.OptimizeLevelStyleCompaction();
-  // Need to tune: read_options_.readahead_size
-  // Need to tune: read_options_.verify_checksums
-  write_options_.sync = false;
+  HCTR_LOG_S(INFO, WORLD) << "RocksDB " << path << ": block cache = " << block_cache_size
+                          << " bytes, bloom filter = " << bloom_filter_bits
+                          << " bits/key, partitioned index = " << partitioned_index
+                          << ", compression = " << compression << "." << std::endl;
 
   // Enumerate column families.
   std::vector<rocksdb::ColumnFamilyDescriptor> column_descriptors;
@@ -125,104 +216,23 @@ size_t RocksDBBackend<Key>::size(const std::string& table_name) const {
   return approx_num_keys;
 }
 
+template <typename Key>
+bool RocksDBBackend<Key>::empty(const std::string& table_name) {
+  const auto& col_handles_it = column_handles_.find(table_name);
+  return col_handles_it == column_handles_.end() || is_empty_(table_name, col_handles_it->second);
+}
+
 template <typename Key>
 size_t RocksDBBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
-                                     const Key* keys,
+                                     const Key* const keys,
                                      const std::chrono::nanoseconds& time_budget) const {
-  const auto begin = std::chrono::high_resolution_clock::now();
-
   // Empty result, if database does not contain this column handle.
-  const auto& col_handles_it = column_handles_.find(table_name);
-  if (col_handles_it == column_handles_.end()) {
+  if (column_handles_.find(table_name) == column_handles_.end()) {
     return Base::contains(table_name, num_keys, keys, time_budget);
   }
-  rocksdb::ColumnFamilyHandle* const col_handle = col_handles_it->second;
-
-  size_t hit_count = 0;
-  size_t ign_count = 0;
-
-  switch (num_keys) {
-    case 0: {
-      // Do nothing ;-).
-    } break;
-    case 1: {
-      // Check time budget.
-      const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
-      if (elapsed >= time_budget) {
-        HCTR_LOG_S(WARNING, WORLD)
-            << get_name() << " backend; Table " << table_name << ": Timeout!" << std::endl;
-        ign_count++;
-        break;
-      }
-
-      // Create and launch query.
-      const rocksdb::Slice k_view{reinterpret_cast<const char*>(keys), sizeof(Key)};
-      rocksdb::PinnableSlice v_view;
-      const auto& status = db_->Get(read_options_, col_handle, k_view, &v_view);
-
-      // Process results.
-      if (status.ok()) {
-        hit_count++;
-      } else if (!status.IsNotFound()) {
-        HCTR_ROCKSDB_CHECK(status);
-      }
-    } break;
-    default: {
-      std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-      std::vector<rocksdb::Slice> k_views;
-      std::vector<std::string> v_views;
-
-      const Key* const keys_end = &keys[num_keys];
-      for (size_t num_queries = 0; keys != keys_end; num_queries++) {
-        // Check time budget.
-        const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
-        if (elapsed >= time_budget) {
-          HCTR_LOG_S(WARNING, WORLD)
-              << get_name() << " backend; Table " << table_name << ": Timeout!" << std::endl;
-          for (; keys != keys_end; keys++) {
-            ign_count++;
-          }
-          break;
-        }
-
-        // Create and launch query.
-        k_views.clear();
-        const Key* const batch_end = std::min(&keys[this->max_get_batch_size_], keys_end);
-        k_views.reserve(batch_end - keys);
-
-        for (; keys != batch_end; keys++) {
-          k_views.emplace_back(reinterpret_cast<const char*>(keys), sizeof(Key));
-        }
-        col_handles.resize(k_views.size(), col_handle);
-
-        v_views.clear();
-        v_views.reserve(col_handles.size());
-        const std::vector<rocksdb::Status>& statuses =
-            db_->MultiGet(read_options_, col_handles, k_views, &v_views);
-
-        // Process results.
-        size_t batch_hits = 0;
-        for (const auto& status : statuses) {
-          if (status.ok()) {
-            batch_hits++;
-          } else if (!status.IsNotFound()) {
-            HCTR_ROCKSDB_CHECK(status);
-          }
-        }
-
-        HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ", query "
-                                 << num_queries << ": " << batch_hits << " / " << statuses.size()
-                                 << " hits. Time: " << elapsed.count() << " / "
-                                 << time_budget.count() << " us." << std::endl;
-        hit_count += batch_hits;
-      }
-    } break;
-  }
-
-  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": " << hit_count
-                           << " / " << (num_keys - ign_count) << " hits, " << ign_count
-                           << " ignored." << std::endl;
-  return hit_count;
+  return fetch_(
+      table_name, num_keys, nullptr, keys, [](size_t, const char*, uint32_t) {}, [](size_t) {},
+      time_budget);
 }
 
 template <typename Key>
@@ -230,16 +240,27 @@ bool RocksDBBackend<Key>::insert(const std::string& table_name, const size_t num
                                  const Key* keys, const char* values, const size_t value_size) {
   // Locate or create column family.
   rocksdb::ColumnFamilyHandle* col_handle;
+  bool is_empty;
   {
     const auto& handles_it = column_handles_.find(table_name);
     if (handles_it != column_handles_.end()) {
       col_handle = handles_it->second;
+      is_empty = is_empty_(table_name, col_handle);
     } else {
       HCTR_ROCKSDB_CHECK(db_->CreateColumnFamily(column_family_options_, table_name, &col_handle));
       column_handles_.emplace(table_name, col_handle);
+      is_empty = true;
     }
   }
 
+  // Populating an empty table in many small batches causes heavy compaction. Build and ingest SST
+  // files instead.
+  if (is_empty && num_pairs > this->max_set_batch_size_) {
+    bulk_insert_(table_name, col_handle, num_pairs, keys, values, value_size);
+    set_populated_(table_name, true);
+    return true;
+  }
+
   size_t num_inserts = 0;
 
   switch (num_pairs) {
@@ -278,6 +299,9 @@ bool RocksDBBackend<Key>::insert(const std::string& table_name, const size_t num
     } break;
   }
   HCTR_ROCKSDB_CHECK(db_->FlushWAL(true));
+  if (is_empty && num_inserts) {
+    set_populated_(table_name, true);
+  }
 
   HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": Inserted "
                            << num_inserts << " / " << num_pairs << " pairs." << std::endl;
@@ -285,226 +309,142 @@ bool RocksDBBackend<Key>::insert(const std::string& table_name, const size_t num
 }
 
 template <typename Key>
-size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
-                                  const Key* keys, const DatabaseHitCallback& on_hit,
-                                  const DatabaseMissCallback& on_miss,
-                                  const std::chrono::nanoseconds& time_budget) {
+template <typename HitFn, typename MissFn>
+size_t RocksDBBackend<Key>::fetch_(const std::string& table_name, const size_t num_keys,
+                                   const size_t* const indices, const Key* const keys,
+                                   HitFn&& on_hit, MissFn&& on_miss,
+                                   const std::chrono::nanoseconds& time_budget) const {
   const auto begin = std::chrono::high_resolution_clock::now();
 
   // Empty result, if database does not contain this column handle.
   const auto& col_handles_it = column_handles_.find(table_name);
   if (col_handles_it == column_handles_.end()) {
-    return Base::fetch(table_name, num_keys, keys, on_hit, on_miss, time_budget);
+    for (size_t i = 0; i != num_keys; i++) {
+      on_miss(indices ? indices[i] : i);
+    }
+    return 0;
   }
   rocksdb::ColumnFamilyHandle* const col_handle = col_handles_it->second;
 
+  // Buffers are reused by all queries from this thread.
+  MultiGetBuffers& buffers = MultiGetBuffers::get();
+  buffers.reserve(std::min(num_keys, this->max_get_batch_size_));
+
   size_t hit_count = 0;
   size_t ign_count = 0;
 
-  switch (num_keys) {
-    case 0: {
-      // Do nothing ;-).
-    } break;
-    case 1: {
-      // Check time budget.
-      const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
-      if (elapsed >= time_budget) {
-        HCTR_LOG_S(WARNING, WORLD)
-            << get_name() << " backend; Table " << table_name << ": Timeout!" << std::endl;
-        on_miss(0);
-        ign_count++;
-        break;
+  size_t num_batches = 0;
+  for (size_t first = 0; first != num_keys; num_batches++) {
+    // Check time budget.
+    const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
+    if (elapsed >= time_budget) {
+      HCTR_LOG_S(WARNING, WORLD) << get_name() << " backend; Table " << table_name << ": Timeout!"
+                                 << std::endl;
+      for (size_t i = first; i != num_keys; i++) {
+        on_miss(indices ? indices[i] : i);
       }
+      ign_count += num_keys - first;
+      break;
+    }
 
-      // Create and launch query.
-      const rocksdb::Slice k_view{reinterpret_cast<const char*>(keys), sizeof(Key)};
-      rocksdb::PinnableSlice v_view;
-      const auto& status = db_->Get(read_options_, col_handle, k_view, &v_view);
-
-      // Process results.
+    // Create and launch query.
+    const size_t batch_size = std::min(num_keys - first, this->max_get_batch_size_);
+    for (size_t i = 0; i != batch_size; i++) {
+      const size_t index = indices ? indices[first + i] : first + i;
+      buffers.k_views[i] = {reinterpret_cast<const char*>(&keys[index]), sizeof(Key)};
+    }
+    db_->MultiGet(read_options_, col_handle, batch_size, buffers.k_views.data(),
+                  buffers.v_views.data(), buffers.statuses.data());
+
+    // Process results, and release the pinned blocks.
+    size_t batch_hits = 0;
+    for (size_t i = 0; i != batch_size; i++) {
+      const size_t index = indices ? indices[first + i] : first + i;
+      const rocksdb::Status& status = buffers.statuses[i];
+      rocksdb::PinnableSlice& v_view = buffers.v_views[i];
       if (status.ok()) {
-        on_hit(0, v_view.data(), static_cast<uint32_t>(v_view.size()));
-        hit_count++;
+        on_hit(index, v_view.data(), static_cast<uint32_t>(v_view.size()));
+        batch_hits++;
       } else if (status.IsNotFound()) {
-        on_miss(0);
+        on_miss(index);
       } else {
         HCTR_ROCKSDB_CHECK(status);
       }
-    } break;
-    default: {
-      std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-      std::vector<rocksdb::Slice> k_views;
-      std::vector<std::string> v_views;
-
-      const Key* const keys_end = &keys[num_keys];
-      for (size_t num_batches = 0, idx = 0; keys != keys_end; num_batches++) {
-        // Check time budget.
-        const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
-        if (elapsed >= time_budget) {
-          HCTR_LOG_S(WARNING, WORLD)
-              << get_name() << " backend; Table " << table_name << ": Timeout!" << std::endl;
-          for (; idx < num_keys; idx++) {
-            on_miss(idx);
-            ign_count++;
-          }
-          break;
-        }
-
-        // Create and launch query.
-        k_views.clear();
-        const Key* const batch_end = std::min(&keys[this->max_get_batch_size_], keys_end);
-        k_views.reserve(batch_end - keys);
-
-        for (; keys != batch_end; keys++) {
-          k_views.emplace_back(reinterpret_cast<const char*>(keys), sizeof(Key));
-        }
-        col_handles.resize(k_views.size(), col_handle);
-
-        v_views.clear();
-        v_views.reserve(col_handles.size());
-        const std::vector<rocksdb::Status>& statuses =
-            db_->MultiGet(read_options_, col_handles, k_views, &v_views);
-
-        // Process results.
-        size_t batch_hits = 0;
-        auto v_it = v_views.begin();
-        auto s_it = statuses.begin();
-        for (; s_it != statuses.end(); idx++, v_it++, s_it++) {
-          if (s_it->ok()) {
-            on_hit(idx, v_it->data(), static_cast<uint32_t>(v_it->size()));
-            batch_hits++;
-          } else if (s_it->IsNotFound()) {
-            on_miss(idx);
-          } else {
-            HCTR_ROCKSDB_CHECK(*s_it);
-          }
-        }
+      v_view.Reset();
+    }
 
-        HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ", query "
-                                 << num_batches << ": " << batch_hits << " / " << statuses.size()
-                                 << " hits. Time: " << elapsed.count() << " / "
-                                 << time_budget.count() << " us." << std::endl;
-        hit_count += batch_hits;
-      }
-    } break;
+    HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ", batch "
+                             << num_batches << ": " << batch_hits << " / " << batch_size
+                             << " hits. Time: " << elapsed.count() << " / "
+                             << time_budget.count() << " ns." << std::endl;
+    hit_count += batch_hits;
+    first += batch_size;
   }
 
-  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table: " << table_name << ": " << hit_count
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": " << hit_count
                            << " / " << (num_keys - ign_count) << " hits, " << ign_count
                            << " ignored." << std::endl;
   return hit_count;
 }
 
+template <typename Key>
+size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                  const Key* const keys, const DatabaseHitCallback& on_hit,
+                                  const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) {
+  // Empty result, if database does not contain this column handle.
+  if (column_handles_.find(table_name) == column_handles_.end()) {
+    return Base::fetch(table_name, num_keys, keys, on_hit, on_miss, time_budget);
+  }
+  return fetch_(table_name, num_keys, nullptr, keys, on_hit, on_miss, time_budget);
+}
+
 template <typename Key>
 size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
-                                  const size_t* indices, const Key* const keys,
+                                  const size_t* const indices, const Key* const keys,
                                   const DatabaseHitCallback& on_hit,
                                   const DatabaseMissCallback& on_miss,
                                   const std::chrono::nanoseconds& time_budget) {
-  const auto begin = std::chrono::high_resolution_clock::now();
-
   // Empty result, if database does not contain this column handle.
-  const auto& col_handles_it = column_handles_.find(table_name);
-  if (col_handles_it == column_handles_.end()) {
+  if (column_handles_.find(table_name) == column_handles_.end()) {
     return Base::fetch(table_name, num_indices, indices, keys, on_hit, on_miss, time_budget);
   }
-  rocksdb::ColumnFamilyHandle* const col_handle = col_handles_it->second;
-
-  size_t hit_count = 0;
-  size_t ign_count = 0;
-
-  switch (num_indices) {
-    case 0: {
-      // Do nothing ;-).
-    } break;
-    case 1: {
-      // Check time budget.
-      const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
-      if (elapsed >= time_budget) {
-        HCTR_LOG_S(WARNING, WORLD)
-            << get_name() << " backend; Table " << table_name << ": Timeout!" << std::endl;
-        on_miss(*indices);
-        ign_count++;
-        break;
-      }
-
-      // Create and launch query.
-      const rocksdb::Slice k_view{reinterpret_cast<const char*>(&keys[*indices]), sizeof(Key)};
-      rocksdb::PinnableSlice v_view;
-      const auto& status = db_->Get(read_options_, col_handle, k_view, &v_view);
-
-      // Process results.
-      if (status.ok()) {
-        on_hit(*indices, v_view.data(), static_cast<uint32_t>(v_view.size()));
-        hit_count++;
-      } else if (status.IsNotFound()) {
-        on_miss(*indices);
-      } else {
-        HCTR_ROCKSDB_CHECK(status);
-      }
-    } break;
-    default: {
-      std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-      std::vector<rocksdb::Slice> k_views;
-      std::vector<std::string> v_views;
-
-      const size_t* const indices_end = &indices[num_indices];
-      for (size_t num_batches = 0; indices != indices_end; num_batches++) {
-        // Check time budget.
-        const auto elapsed = std::chrono::high_resolution_clock::now() - begin;
-        if (elapsed >= time_budget) {
-          HCTR_LOG_S(WARNING, WORLD)
-              << get_name() << " backend; Table " << table_name << ": Timeout!" << std::endl;
-          for (; indices != indices_end; indices++) {
-            on_miss(*indices);
-            ign_count++;
-          }
-          break;
-        }
-
-        // Create and launch query.
-        k_views.clear();
-        const size_t* const batch_end = std::min(&indices[this->max_get_batch_size_], indices_end);
-        k_views.reserve(batch_end - indices);
-
-        for (const size_t* i = indices; i != batch_end; i++) {
-          k_views.emplace_back(reinterpret_cast<const char*>(&keys[*i]), sizeof(Key));
-        }
-        col_handles.resize(k_views.size(), col_handle);
-
-        v_views.clear();
-        v_views.reserve(col_handles.size());
-        const std::vector<rocksdb::Status>& statuses =
-            db_->MultiGet(read_options_, col_handles, k_views, &v_views);
-
-        // Process results.
-        size_t batch_hits = 0;
-        auto v_it = v_views.begin();
-        auto s_it = statuses.begin();
-        for (; indices != batch_end; v_it++, s_it++, indices++) {
-          if (s_it->ok()) {
-            on_hit(*indices, v_it->data(), static_cast<uint32_t>(v_it->size()));
-            batch_hits++;
-          } else if (s_it->IsNotFound()) {
-            on_miss(*indices);
-          } else {
-            HCTR_ROCKSDB_CHECK(*s_it);
-          }
-        }
-        HCTR_CHECK(v_it == v_views.end() && s_it == statuses.end());
+  return fetch_(table_name, num_indices, indices, keys, on_hit, on_miss, time_budget);
+}
 
-        HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ", batch "
-                                 << num_batches << ": " << batch_hits << " / " << statuses.size()
-                                 << " hits. Time: " << elapsed.count() << " / "
-                                 << time_budget.count() << " us." << std::endl;
-        hit_count += batch_hits;
-      }
-    } break;
-  }
+template <typename Key>
+size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                  const Key* const keys, char* const values,
+                                  const size_t value_size, const size_t value_stride,
+                                  std::vector<size_t>& missing,
+                                  const std::chrono::nanoseconds& time_budget) {
+  // Values are copied straight from the pinned blocks into the output buffer.
+  BulkFetchTarget target(values, value_size, value_stride, num_keys, missing);
+  const size_t hit_count = fetch_(
+      table_name, num_keys, nullptr, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
+  return hit_count;
+}
 
-  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": " << hit_count
-                           << " / " << (num_indices - ign_count) << " hits, " << ign_count
-                           << " ignored." << std::endl;
+template <typename Key>
+size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                  const size_t* const indices, const Key* const keys,
+                                  char* const values, const size_t value_size,
+                                  const size_t value_stride, std::vector<size_t>& missing,
+                                  const std::chrono::nanoseconds& time_budget) {
+  // Values are copied straight from the pinned blocks into the output buffer.
+  BulkFetchTarget target(values, value_size, value_stride, num_indices, missing);
+  const size_t hit_count = fetch_(
+      table_name, num_indices, indices, keys,
+      [&target](const size_t index, const char* const value, const uint32_t size) {
+        target.on_hit(index, value, size);
+      },
+      [&target](const size_t index) { target.on_miss(index); }, time_budget);
+  target.finalize();
   return hit_count;
 }
 
@@ -528,6 +468,7 @@ size_t RocksDBBackend<Key>::evict(const std::string& table_name) {
   HCTR_ROCKSDB_CHECK(db_->DropColumnFamily(col_handle));
   HCTR_ROCKSDB_CHECK(db_->DestroyColumnFamilyHandle(col_handle));
   column_handles_.erase(table_name);
+  set_populated_(table_name, false);
 
   HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name
                            << " erased (approximately " << approx_num_keys << " pairs)."
@@ -597,10 +538,13 @@ std::vector<std::string> RocksDBBackend<Key>::find_tables(const std::string& mod
 }
 
 template <typename Key>
-void RocksDBBackend<Key>::dump_bin(const std::string& table_name, std::ofstream& file) {
+void RocksDBBackend<Key>::dump_bin(const std::string& table_name, const std::string& path) {
+  BinDumpWriter file(path, sizeof(Key));
+
   // Locate the column handle.
   const auto& col_handles_it = column_handles_.find(table_name);
   if (col_handles_it == column_handles_.end()) {
+    file.finish();
     return;
   }
   rocksdb::ColumnFamilyHandle* const col_handle = col_handles_it->second;
@@ -609,25 +553,36 @@ void RocksDBBackend<Key>::dump_bin(const std::string& table_name, std::ofstream&
   std::unique_ptr<rocksdb::Iterator> it{db_->NewIterator(read_options_, col_handle)};
   it->SeekToFirst();
 
-  // Write value size to file.
   const uint32_t value_size = it->Valid() ? static_cast<uint32_t>(it->value().size()) : 0;
-  file.write(reinterpret_cast<const char*>(&value_size), sizeof(uint32_t));
+  std::vector<Key> keys;
+  keys.reserve(this->max_set_batch_size_);
+  std::vector<char> values;
+  values.reserve(this->max_set_batch_size_ * value_size);
 
-  // Append the key/value pairs one by one.
+  // Append the key/value pairs batch by batch.
   for (; it->Valid(); it->Next()) {
     // Key
     {
       const rocksdb::Slice& k_view = it->key();
       HCTR_CHECK(k_view.size() == sizeof(Key));
-      file.write(k_view.data(), sizeof(Key));
+      keys.emplace_back(*reinterpret_cast<const Key*>(k_view.data()));
     }
     // Value
     {
       const rocksdb::Slice& v_view = it->value();
       HCTR_CHECK(v_view.size() == value_size);
-      file.write(v_view.data(), value_size);
+      values.insert(values.end(), v_view.data(), &v_view.data()[value_size]);
+    }
+
+    if (keys.size() >= this->max_set_batch_size_) {
+      file.append(keys.size(), keys.data(), values.data(), value_size);
+      keys.clear();
+      values.clear();
     }
   }
+  file.append(keys.size(), keys.data(), values.data(), value_size);
+
+  file.finish();
 }
 
 template <typename Key>
@@ -670,6 +625,119 @@ void RocksDBBackend<Key>::load_dump_sst(const std::string& table_name, const std
   HCTR_ROCKSDB_CHECK(db_->IngestExternalFile(col_handle, {path}, options));
 }
 
+template <typename Key>
+void RocksDBBackend<Key>::bulk_insert_(const std::string& table_name,
+                                       rocksdb::ColumnFamilyHandle* const col_handle,
+                                       const size_t num_pairs, const Key* const keys,
+                                       const char* const values, const size_t value_size) {
+  const auto begin = std::chrono::high_resolution_clock::now();
+
+  // Sort pairs in comparator order. Among duplicates, only the last occurrence is retained.
+  std::vector<std::pair<uint64_t, size_t>> order;
+  order.reserve(num_pairs);
+  for (size_t i = 0; i != num_pairs; i++) {
+    order.emplace_back(bytewise_order(keys[i]), i);
+  }
+  std::sort(std::execution::par, order.begin(), order.end());
+  {
+    auto dst = order.begin();
+    for (auto it = order.begin(); it != order.end(); ++it) {
+      if (it + 1 != order.end() && it[1].first == it->first) {
+        continue;
+      }
+      *dst++ = *it;
+    }
+    order.erase(dst, order.end());
+  }
+
+  // Write non-overlapping SST files in parallel. Each call uses its own directory, because other
+  // tables may be bulk loaded at the same time.
+  const std::filesystem::path ingest_dir = std::filesystem::path(db_->GetName()) / "ingest";
+  std::ostringstream dir_name;
+  dir_name << table_name << '.' << num_bulk_inserts_++;
+  const std::filesystem::path dir = ingest_dir / dir_name.str();
+  std::filesystem::create_directories(dir);
+
+  const size_t pairs_per_file = std::max(bulk_insert_file_size / (sizeof(Key) + value_size),
+                                         this->max_set_batch_size_);
+  const size_t num_files = (order.size() + pairs_per_file - 1) / pairs_per_file;
+  std::vector<std::string> paths;
+  paths.reserve(num_files);
+  for (size_t i = 0; i != num_files; i++) {
+    std::ostringstream name;
+    name << table_name << '.' << i << ".sst";
+    paths.emplace_back((dir / name.str()).string());
+  }
+
+  const rocksdb::Options options{rocksdb::DBOptions(), column_family_options_};
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(num_files);
+  for (size_t i = 0; i != num_files; i++) {
+    tasks.emplace_back(ThreadPool::get().submit([&, i]() {
+      rocksdb::SstFileWriter file{rocksdb::EnvOptions(), options};
+      HCTR_ROCKSDB_CHECK(file.Open(paths[i]));
+
+      rocksdb::Slice k_view{nullptr, sizeof(Key)};
+      rocksdb::Slice v_view{nullptr, value_size};
+
+      const auto first = order.begin() + static_cast<ptrdiff_t>(i * pairs_per_file);
+      const auto last = order.begin() +
+                        static_cast<ptrdiff_t>(std::min((i + 1) * pairs_per_file, order.size()));
+      for (auto it = first; it != last; ++it) {
+        k_view.data_ = reinterpret_cast<const char*>(&keys[it->second]);
+        v_view.data_ = &values[it->second * value_size];
+        HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
+      }
+      HCTR_ROCKSDB_CHECK(file.Finish());
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  // The table is empty, and the files do not overlap. Hence, they are placed directly in the
+  // bottommost level, and no compaction is required.
+  rocksdb::IngestExternalFileOptions ingest_options;
+  ingest_options.move_files = true;
+  HCTR_ROCKSDB_CHECK(db_->IngestExternalFile(col_handle, paths, ingest_options));
+  std::filesystem::remove_all(dir);
+  // Only succeeds once no other bulk insert is running.
+  std::error_code error;
+  std::filesystem::remove(ingest_dir, error);
+
+  const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - begin;
+  HCTR_LOG_S(INFO, WORLD) << get_name() << " backend; Table " << table_name << ": Bulk loaded "
+                          << order.size() << " / " << num_pairs << " pairs from " << num_files
+                          << " SST files in " << elapsed.count() << " s." << std::endl;
+}
+
+template <typename Key>
+bool RocksDBBackend<Key>::is_empty_(const std::string& table_name,
+                                    rocksdb::ColumnFamilyHandle* const col_handle) {
+  {
+    const std::lock_guard<std::mutex> lock(populated_tables_mutex_);
+    if (populated_tables_.find(table_name) != populated_tables_.end()) {
+      return false;
+    }
+  }
+
+  std::unique_ptr<rocksdb::Iterator> it{db_->NewIterator(read_options_, col_handle)};
+  it->SeekToFirst();
+  const bool is_empty = !it->Valid();
+  if (!is_empty) {
+    set_populated_(table_name, true);
+  }
+  return is_empty;
+}
+
+template <typename Key>
+void RocksDBBackend<Key>::set_populated_(const std::string& table_name, const bool populated) {
+  const std::lock_guard<std::mutex> lock(populated_tables_mutex_);
+  if (populated) {
+    populated_tables_.emplace(table_name);
+  } else {
+    populated_tables_.erase(table_name);
+  }
+}
+
 template class RocksDBBackend<unsigned int>;
 template class RocksDBBackend<long long>;
 
@@ -0,0 +1,674 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <numa.h>
+
+#include <algorithm>
+#include <atomic>
+#include <base/debug/logger.hpp>
+#include <cstring>
+#include <hps/bin_dump.hpp>
+#include <hps/database_backend_detail.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/sharded_hash_map_backend.hpp>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+namespace {
+
+/**
+ * Binds the calling thread to a NUMA node (CPUs and memory). Worker pools are node specific.
+ * Hence, this needs to happen only once per thread.
+ */
+void bind_to_numa_node(const int node) {
+  thread_local int bound_node = -1;
+  if (bound_node != node) {
+    HCTR_CHECK_HINT(numa_run_on_node(node) == 0, "Unable to bind thread to NUMA node %d!", node);
+    numa_set_preferred(node);
+    bound_node = node;
+  }
+}
+
+inline uint64_t ring_hash(const uint64_t x) { return rrxmrrxmsx_0(x); }
+
+constexpr uint64_t ring_seed = UINT64_C(0x5851F42D4C957F2D);
+constexpr int ring_lut_bits = 16;
+
+}  // namespace
+
+template <typename Key>
+ShardedHashMapBackend<Key>::ShardedHashMapBackend(
+    const size_t num_shards, const bool numa_aware, const size_t allocation_rate,
+    const size_t max_get_batch_size, const size_t max_set_batch_size, const size_t overflow_margin,
+    const DatabaseOverflowPolicy_t overflow_policy, const double overflow_resolution_target)
+    : Base(max_get_batch_size, max_set_batch_size, overflow_margin, overflow_policy,
+           overflow_resolution_target),
+      numa_aware_{numa_aware},
+      allocation_rate_{allocation_rate},
+      shard_overflow_resolution_target_{overflow_resolution_target} {
+  HCTR_CHECK_HINT(num_shards > 0, "At least one shard is required!");
+
+  // Discover NUMA nodes that have CPUs. Binding only makes sense if there is more than one.
+  if (numa_aware_ && numa_available() >= 0) {
+    bitmask* const cpus = numa_allocate_cpumask();
+    for (int node = 0; node <= numa_max_node(); node++) {
+      if (numa_bitmask_isbitset(numa_all_nodes_ptr, static_cast<unsigned int>(node)) &&
+          numa_node_to_cpus(node, cpus) == 0 && numa_bitmask_weight(cpus) > 0) {
+        numa_nodes_.emplace_back(node);
+        node_workers_.emplace_back(std::make_unique<ThreadPool>(
+            "shard n" + std::to_string(node), numa_bitmask_weight(cpus)));
+      }
+    }
+    numa_free_cpumask(cpus);
+
+    if (numa_nodes_.size() < 2) {
+      numa_nodes_.clear();
+      node_workers_.clear();
+    }
+  }
+
+  for (size_t i = 0; i < num_shards; i++) {
+    add_shard_();
+  }
+  rebuild_ring_(num_shards);
+
+  HCTR_LOG_S(INFO, WORLD) << get_name() << ": Created " << num_shards << " shards across "
+                          << std::max(numa_nodes_.size(), size_t{1}) << " NUMA node(s)."
+                          << std::endl;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::capacity(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  size_t total_cap = 0;
+  for (const Shard& shard : shards_) {
+    const size_t cap = shard.db->capacity(table_name);
+    if (cap > std::numeric_limits<size_t>::max() - total_cap) {
+      return std::numeric_limits<size_t>::max();
+    }
+    total_cap += cap;
+  }
+  return total_cap;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::size(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  size_t num_keys = 0;
+  for (const Shard& shard : shards_) {
+    num_keys += shard.db->size(table_name);
+  }
+  return num_keys;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
+                                            const Key* const keys,
+                                            const std::chrono::nanoseconds& time_budget) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  const std::vector<std::vector<size_t>> buckets = split_(num_keys, nullptr, keys);
+  std::atomic<size_t> hit_count{0};
+
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    if (buckets[s].empty()) {
+      continue;
+    }
+    tasks.emplace_back(submit_(s, [&, s]() {
+      const std::vector<size_t>& bucket = buckets[s];
+      std::vector<Key> shard_keys(bucket.size());
+      for (size_t i = 0; i < bucket.size(); i++) {
+        shard_keys[i] = keys[bucket[i]];
+      }
+      hit_count += shards_[s].db->contains(table_name, shard_keys.size(), shard_keys.data(),
+                                           time_budget);
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  return hit_count;
+}
+
+template <typename Key>
+bool ShardedHashMapBackend<Key>::insert(const std::string& table_name, const size_t num_pairs,
+                                        const Key* const keys, const char* const values,
+                                        const size_t value_size) {
+  {
+    const std::lock_guard lock(value_sizes_guard_);
+    const auto& it = value_sizes_.try_emplace(table_name, value_size).first;
+    HCTR_CHECK_HINT(it->second == value_size, "Table %s: Value size mismatch! (%zu <> %zu)!",
+                    table_name.c_str(), value_size, it->second);
+  }
+
+  const std::shared_lock lock(read_write_guard_);
+
+  const std::vector<std::vector<size_t>> buckets = split_(num_pairs, nullptr, keys);
+  std::atomic<bool> success{true};
+
+  // Gather on the worker of the shard, so that the copies are node-local.
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    if (buckets[s].empty()) {
+      continue;
+    }
+    tasks.emplace_back(submit_(s, [&, s]() {
+      const std::vector<size_t>& bucket = buckets[s];
+      std::vector<Key> shard_keys(bucket.size());
+      std::vector<char> shard_values(bucket.size() * value_size);
+      for (size_t i = 0; i < bucket.size(); i++) {
+        shard_keys[i] = keys[bucket[i]];
+        std::memcpy(&shard_values[i * value_size], &values[bucket[i] * value_size], value_size);
+      }
+      if (!shards_[s].db->insert(table_name, shard_keys.size(), shard_keys.data(),
+                                 shard_values.data(), value_size)) {
+        success = false;
+      }
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": Inserted "
+                           << num_pairs << " entries into " << tasks.size() << " shards."
+                           << std::endl;
+  return success;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys, const DatabaseHitCallback& on_hit,
+                                         const DatabaseMissCallback& on_miss,
+                                         const std::chrono::nanoseconds& time_budget) {
+  return fetch(table_name, num_keys, nullptr, keys, on_hit, on_miss, time_budget);
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                         const size_t* const indices, const Key* const keys,
+                                         const DatabaseHitCallback& on_hit,
+                                         const DatabaseMissCallback& on_miss,
+                                         const std::chrono::nanoseconds& time_budget) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Shards are queried with the original indices. Hence, the handlers see the same indices.
+  const std::vector<std::vector<size_t>> buckets = split_(num_indices, indices, keys);
+  std::atomic<size_t> hit_count{0};
+
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    if (buckets[s].empty()) {
+      continue;
+    }
+    tasks.emplace_back(submit_(s, [&, s]() {
+      hit_count += shards_[s].db->fetch(table_name, buckets[s].size(), buckets[s].data(), keys,
+                                        on_hit, on_miss, time_budget);
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  return hit_count;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys, char* const values,
+                                         const size_t value_size, const size_t value_stride,
+                                         std::vector<size_t>& missing,
+                                         const std::chrono::nanoseconds& time_budget) {
+  const std::shared_lock lock(read_write_guard_);
+  return fetch_(table_name, num_keys, nullptr, keys, values, value_size, value_stride, missing,
+                time_budget);
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                         const size_t* const indices, const Key* const keys,
+                                         char* const values, const size_t value_size,
+                                         const size_t value_stride, std::vector<size_t>& missing,
+                                         const std::chrono::nanoseconds& time_budget) {
+  const std::shared_lock lock(read_write_guard_);
+  return fetch_(table_name, num_indices, indices, keys, values, value_size, value_stride, missing,
+                time_budget);
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::fetch_(const std::string& table_name, const size_t num_indices,
+                                          const size_t* const indices, const Key* const keys,
+                                          char* const values, const size_t value_size,
+                                          const size_t value_stride, std::vector<size_t>& missing,
+                                          const std::chrono::nanoseconds& time_budget) {
+  // Each shard writes its values straight to their final position.
+  const std::vector<std::vector<size_t>> buckets = split_(num_indices, indices, keys);
+  std::vector<std::vector<size_t>> shard_missing(shards_.size());
+  std::atomic<size_t> hit_count{0};
+
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    if (buckets[s].empty()) {
+      continue;
+    }
+    tasks.emplace_back(submit_(s, [&, s]() {
+      hit_count +=
+          shards_[s].db->fetch(table_name, buckets[s].size(), buckets[s].data(), keys, values,
+                               value_size, value_stride, shard_missing[s], time_budget);
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  // Merge missing indices.
+  missing.clear();
+  for (const std::vector<size_t>& m : shard_missing) {
+    missing.insert(missing.end(), m.begin(), m.end());
+  }
+  std::sort(missing.begin(), missing.end());
+
+  HCTR_LOG_S(TRACE, WORLD) << get_name() << " backend; Table " << table_name << ": Fetched "
+                           << hit_count << " / " << num_indices << " entries from "
+                           << tasks.size() << " shards." << std::endl;
+  return hit_count;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::evict(const std::string& table_name) {
+  const std::shared_lock lock(read_write_guard_);
+
+  size_t num_deletions = 0;
+  for (const Shard& shard : shards_) {
+    num_deletions += shard.db->evict(table_name);
+  }
+  {
+    const std::lock_guard value_sizes_lock(value_sizes_guard_);
+    value_sizes_.erase(table_name);
+  }
+
+  HCTR_LOG_S(DEBUG, WORLD) << get_name() << " backend. Table " << table_name << " erased ("
+                           << num_deletions << " pairs)." << std::endl;
+  return num_deletions;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys) {
+  const std::shared_lock lock(read_write_guard_);
+
+  const std::vector<std::vector<size_t>> buckets = split_(num_keys, nullptr, keys);
+  std::atomic<size_t> num_deletions{0};
+
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    if (buckets[s].empty()) {
+      continue;
+    }
+    tasks.emplace_back(submit_(s, [&, s]() {
+      const std::vector<size_t>& bucket = buckets[s];
+      std::vector<Key> shard_keys(bucket.size());
+      for (size_t i = 0; i < bucket.size(); i++) {
+        shard_keys[i] = keys[bucket[i]];
+      }
+      num_deletions += shards_[s].db->evict(table_name, shard_keys.size(), shard_keys.data());
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  return num_deletions;
+}
+
+template <typename Key>
+std::vector<std::string> ShardedHashMapBackend<Key>::find_tables(const std::string& model_name) {
+  const std::string& tag_prefix = HierParameterServerBase::make_tag_name(model_name, "", false);
+
+  std::vector<std::string> matches;
+  for (const std::string& table_name : tables_()) {
+    if (table_name.find(tag_prefix) == 0) {
+      matches.push_back(table_name);
+    }
+  }
+  return matches;
+}
+
+template <typename Key>
+void ShardedHashMapBackend<Key>::dump_bin(const std::string& table_name, const std::string& path) {
+  const std::shared_lock lock(read_write_guard_);
+
+  size_t value_size;
+  {
+    const std::lock_guard value_sizes_lock(value_sizes_guard_);
+    const auto& it = value_sizes_.find(table_name);
+    if (it == value_sizes_.end()) {
+      BinDumpWriter(path, sizeof(Key), 0, {}, BinDumpPartitioner_t::None).finish();
+      return;
+    }
+    value_size = it->second;
+  }
+
+  // Each shard becomes a section of the file.
+  std::vector<std::vector<Key>> shard_keys(shards_.size());
+  std::vector<size_t> part_sizes(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    shard_keys[s] = shards_[s].db->keys(table_name);
+    part_sizes[s] = shard_keys[s].size();
+  }
+  BinDumpWriter file(path, sizeof(Key), static_cast<uint32_t>(value_size), part_sizes,
+                     BinDumpPartitioner_t::None);
+
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(shards_.size());
+  for (size_t s = 0; s < shards_.size(); s++) {
+    tasks.emplace_back(submit_(s, [&, s]() {
+      const std::vector<Key>& keys = shard_keys[s];
+      std::vector<char> values(std::min(keys.size(), this->max_set_batch_size_) * value_size);
+      std::vector<size_t> missing;
+
+      for (size_t i = 0; i < keys.size(); i += this->max_set_batch_size_) {
+        const size_t batch_size = std::min(keys.size() - i, this->max_set_batch_size_);
+        shards_[s].db->fetch(table_name, batch_size, &keys[i], values.data(), value_size,
+                             value_size, missing, std::chrono::nanoseconds::max());
+        HCTR_CHECK_HINT(missing.empty(), "Table %s was modified during dump!",
+                        table_name.c_str());
+        file.write(s, i, batch_size, &keys[i], values.data());
+      }
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  file.finish();
+}
+
+template <typename Key>
+void ShardedHashMapBackend<Key>::dump_sst(const std::string& table_name,
+                                          rocksdb::SstFileWriter& file) {
+  const std::shared_lock lock(read_write_guard_);
+
+  size_t value_size;
+  {
+    const std::lock_guard value_sizes_lock(value_sizes_guard_);
+    const auto& it = value_sizes_.find(table_name);
+    if (it == value_sizes_.end()) {
+      return;
+    }
+    value_size = it->second;
+  }
+
+  // Sort keys by value.
+  std::vector<Key> keys;
+  for (const Shard& shard : shards_) {
+    const std::vector<Key>& shard_keys = shard.db->keys(table_name);
+    keys.insert(keys.end(), shard_keys.begin(), shard_keys.end());
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // Fetch and insert batch-by-batch.
+  std::vector<char> values(std::min(keys.size(), this->max_get_batch_size_) * value_size);
+  std::vector<size_t> missing;
+  rocksdb::Slice k_view{nullptr, sizeof(Key)};
+  rocksdb::Slice v_view{nullptr, value_size};
+
+  for (size_t i = 0; i < keys.size(); i += this->max_get_batch_size_) {
+    const size_t batch_size = std::min(keys.size() - i, this->max_get_batch_size_);
+    fetch_(table_name, batch_size, nullptr, &keys[i], values.data(), value_size, value_size,
+           missing, std::chrono::nanoseconds::max());
+    HCTR_CHECK_HINT(missing.empty(), "Table %s was modified during dump!", table_name.c_str());
+
+    for (size_t j = 0; j < batch_size; j++) {
+      k_view.data_ = reinterpret_cast<const char*>(&keys[i + j]);
+      v_view.data_ = &values[j * value_size];
+      HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
+    }
+  }
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::num_shards() const {
+  const std::shared_lock lock(read_write_guard_);
+  return shards_.size();
+}
+
+template <typename Key>
+std::vector<int> ShardedHashMapBackend<Key>::shard_nodes() const {
+  const std::shared_lock lock(read_write_guard_);
+
+  std::vector<int> nodes;
+  nodes.reserve(shards_.size());
+  for (const Shard& shard : shards_) {
+    nodes.emplace_back(shard.numa_node);
+  }
+  return nodes;
+}
+
+template <typename Key>
+void ShardedHashMapBackend<Key>::resize(const size_t num_shards) {
+  HCTR_CHECK_HINT(num_shards > 0, "At least one shard is required!");
+
+  const std::unique_lock lock(read_write_guard_);
+  const size_t prev_num_shards = shards_.size();
+  if (num_shards == prev_num_shards) {
+    return;
+  }
+
+  // Add shards (if growing), and redistribute keys according to the new ring. Removed shards
+  // remain accessible until all of their keys have been moved.
+  while (shards_.size() < num_shards) {
+    add_shard_();
+  }
+  rebuild_ring_(num_shards);
+
+  struct Batch final {
+    std::vector<Key> keys;
+    std::vector<char> values;
+  };
+
+  size_t num_moved = 0;
+  for (const std::string& table_name : tables_()) {
+    size_t value_size;
+    {
+      const std::lock_guard value_sizes_lock(value_sizes_guard_);
+      value_size = value_sizes_.at(table_name);
+    }
+
+    // Phase 1: Extract pairs that have a new owner (on the workers of the source shard).
+    std::vector<std::vector<Batch>> moves(shards_.size(), std::vector<Batch>(num_shards));
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(shards_.size());
+    for (size_t src = 0; src < shards_.size(); src++) {
+      tasks.emplace_back(submit_(src, [&, src]() {
+        const std::vector<Key>& keys = shards_[src].db->keys(table_name);
+        for (const Key& k : keys) {
+          const size_t dst = shard_of_(k);
+          if (dst != src) {
+            moves[src][dst].keys.emplace_back(k);
+          }
+        }
+
+        std::vector<size_t> missing;
+        for (size_t dst = 0; dst < num_shards; dst++) {
+          Batch& batch = moves[src][dst];
+          if (batch.keys.empty()) {
+            continue;
+          }
+          batch.values.resize(batch.keys.size() * value_size);
+          shards_[src].db->fetch(table_name, batch.keys.size(), batch.keys.data(),
+                                 batch.values.data(), value_size, value_size, missing,
+                                 std::chrono::nanoseconds::max());
+          HCTR_CHECK(missing.empty());
+          shards_[src].db->evict(table_name, batch.keys.size(), batch.keys.data());
+        }
+      }));
+    }
+    ThreadPool::await(tasks.begin(), tasks.end());
+
+    // Phase 2: Insert them (on the workers of the destination shard).
+    tasks.clear();
+    for (size_t dst = 0; dst < num_shards; dst++) {
+      tasks.emplace_back(submit_(dst, [&, dst]() {
+        for (size_t src = 0; src < shards_.size(); src++) {
+          const Batch& batch = moves[src][dst];
+          if (!batch.keys.empty()) {
+            HCTR_CHECK(shards_[dst].db->insert(table_name, batch.keys.size(), batch.keys.data(),
+                                               batch.values.data(), value_size));
+          }
+        }
+      }));
+    }
+    ThreadPool::await(tasks.begin(), tasks.end());
+
+    for (const std::vector<Batch>& src_moves : moves) {
+      for (const Batch& batch : src_moves) {
+        num_moved += batch.keys.size();
+      }
+    }
+  }
+
+  // Drop shards that are no longer part of the ring (they are empty now).
+  shards_.resize(num_shards);
+
+  HCTR_LOG_S(INFO, WORLD) << get_name() << ": Resized from " << prev_num_shards << " to "
+                          << num_shards << " shards. Moved " << num_moved << " pairs."
+                          << std::endl;
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::shard_of(const Key key) const {
+  const std::shared_lock lock(read_write_guard_);
+  return shard_of_(key);
+}
+
+template <typename Key>
+void ShardedHashMapBackend<Key>::add_shard_() {
+  const size_t index = shards_.size();
+
+  Shard shard;
+  // Each shard is a single partition. Parallelism stems from the shards.
+  shard.db = std::make_unique<HashMapBackend<Key>>(
+      1, allocation_rate_, this->max_get_batch_size_, this->max_set_batch_size_,
+      this->overflow_margin_, this->overflow_policy_, shard_overflow_resolution_target_);
+  if (numa_nodes_.empty()) {
+    shard.numa_node = -1;
+    shard.workers = nullptr;
+  } else {
+    const size_t node_index = index % numa_nodes_.size();
+    shard.numa_node = numa_nodes_[node_index];
+    shard.workers = node_workers_[node_index].get();
+  }
+  shards_.emplace_back(std::move(shard));
+}
+
+template <typename Key>
+void ShardedHashMapBackend<Key>::rebuild_ring_(const size_t num_shards) {
+  HCTR_CHECK(num_shards <= shards_.size());
+
+  ring_.clear();
+  ring_.reserve(num_shards * num_virtual_nodes);
+  for (size_t s = 0; s < num_shards; s++) {
+    for (size_t v = 0; v < num_virtual_nodes; v++) {
+      const uint64_t point = ring_hash((static_cast<uint64_t>(s) << 32 | v) ^ ring_seed);
+      ring_.emplace_back(point, static_cast<uint32_t>(s));
+    }
+  }
+  std::sort(ring_.begin(), ring_.end());
+
+  // Most hash ranges do not contain a point of the ring. Their owner can be looked up directly.
+  ring_lut_.resize(size_t{1} << ring_lut_bits);
+  auto it = ring_.begin();
+  for (size_t b = 0; b < ring_lut_.size(); b++) {
+    const uint64_t range_begin = static_cast<uint64_t>(b) << (64 - ring_lut_bits);
+    while (it != ring_.end() && it->first < range_begin) {
+      ++it;
+    }
+    if (it != ring_.end() && (it->first >> (64 - ring_lut_bits)) == b) {
+      ring_lut_[b] = ring_ambiguous;
+    } else {
+      ring_lut_[b] = (it != ring_.end() ? it : ring_.begin())->second;
+    }
+  }
+}
+
+template <typename Key>
+size_t ShardedHashMapBackend<Key>::shard_of_(const Key key) const {
+  const uint64_t h = ring_hash(static_cast<uint64_t>(key));
+
+  const uint32_t owner = ring_lut_[h >> (64 - ring_lut_bits)];
+  if (owner != ring_ambiguous) {
+    return owner;
+  }
+
+  // First point at or after the hash (wrapping around).
+  const auto it = std::lower_bound(
+      ring_.begin(), ring_.end(), h,
+      [](const std::pair<uint64_t, uint32_t>& point, const uint64_t x) { return point.first < x; });
+  return (it != ring_.end() ? it : ring_.begin())->second;
+}
+
+template <typename Key>
+std::vector<std::vector<size_t>> ShardedHashMapBackend<Key>::split_(const size_t num_keys,
+                                                                    const size_t* const indices,
+                                                                    const Key* const keys) const {
+  std::vector<std::vector<size_t>> buckets(shards_.size());
+  const size_t expected_size = num_keys / shards_.size() + num_keys / (4 * shards_.size()) + 1;
+  for (std::vector<size_t>& bucket : buckets) {
+    bucket.reserve(expected_size);
+  }
+
+  if (indices) {
+    for (const size_t* i = indices; i != &indices[num_keys]; i++) {
+      buckets[shard_of_(keys[*i])].emplace_back(*i);
+    }
+  } else {
+    for (size_t i = 0; i < num_keys; i++) {
+      buckets[shard_of_(keys[i])].emplace_back(i);
+    }
+  }
+  return buckets;
+}
+
+template <typename Key>
+std::future<void> ShardedHashMapBackend<Key>::submit_(const size_t shard,
+                                                      std::function<void()> task) const {
+  const Shard& s = shards_[shard];
+  if (!s.workers) {
+    return ThreadPool::get().submit(std::move(task));
+  }
+  return s.workers->submit([node = s.numa_node, task = std::move(task)]() {
+    bind_to_numa_node(node);
+    task();
+  });
+}
+
+template <typename Key>
+std::vector<std::string> ShardedHashMapBackend<Key>::tables_() const {
+  const std::lock_guard lock(value_sizes_guard_);
+
+  std::vector<std::string> table_names;
+  table_names.reserve(value_sizes_.size());
+  for (const auto& pair : value_sizes_) {
+    table_names.emplace_back(pair.first);
+  }
+  return table_names;
+}
+
+template class ShardedHashMapBackend<unsigned int>;
+template class ShardedHashMapBackend<long long>;
+
+}  // namespace HugeCTR
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <parallel_hashmap/phmap.h>
+
+#include <base/debug/logger.hpp>
+#include <cstring>
+#include <hps/update_applier.hpp>
+
+namespace HugeCTR {
+
+template <typename Key>
+UpdateApplier<Key>::UpdateApplier(DatabaseBackend<Key>* const db, const size_t max_batch_size,
+                                  const std::chrono::milliseconds max_delay,
+                                  const size_t max_pending_pairs, const size_t num_workers)
+    : db_{db},
+      max_batch_size_{max_batch_size},
+      max_delay_{max_delay},
+      max_pending_pairs_{max_pending_pairs},
+      workers_{"hps update", num_workers} {
+  HCTR_CHECK(db_);
+  HCTR_CHECK(max_batch_size_ > 0);
+  HCTR_CHECK(max_pending_pairs_ >= max_batch_size_);
+  HCTR_CHECK(num_workers > 0);
+
+  MetricsRegistry& registry = MetricsRegistry::get();
+  const MetricLabels labels{{"backend", db_->get_name()}};
+  lag_metric_ = &registry.histogram("hps_update_lag_seconds",
+                                    "Time between receiving and applying an update.", labels);
+  pairs_received_metric_ = &registry.counter("hps_update_pairs_received_total",
+                                             "Updates received from the update source.", labels);
+  pairs_applied_metric_ = &registry.counter(
+      "hps_update_pairs_applied_total", "Updates applied after deduplication.", labels);
+  pairs_pending_metric_ = &registry.gauge("hps_update_pairs_pending",
+                                          "Updates that are waiting to be applied.", labels);
+
+  applier_ = std::thread(&UpdateApplier<Key>::run_, this);
+}
+
+template <typename Key>
+UpdateApplier<Key>::~UpdateApplier() {
+  // Request termination. The background thread will apply all pending updates before exiting.
+  {
+    const std::lock_guard lock(barrier_);
+    terminate_ = true;
+  }
+  post_semaphore_.notify_one();
+  swap_semaphore_.notify_all();
+
+  if (applier_.joinable()) {
+    applier_.join();
+  }
+}
+
+template <typename Key>
+bool UpdateApplier<Key>::post(const std::string& tag, const size_t num_pairs,
+                              const Key* const keys, const char* const values,
+                              const size_t value_size) {
+  if (!num_pairs) {
+    return true;
+  }
+
+  std::unique_lock lock(barrier_);
+
+  // Backpressure. Only kicks in if the database cannot keep up with the update stream.
+  while (front_size_ >= max_pending_pairs_ && !terminate_) {
+    swap_requested_ = true;
+    post_semaphore_.notify_one();
+    swap_semaphore_.wait(lock);
+  }
+  if (terminate_) {
+    return false;
+  }
+
+  TableBuffer& buf = front_.try_emplace(tag).first->second;
+  if (buf.keys.empty()) {
+    buf.value_size = value_size;
+    buf.first_post = Clock::now();
+  } else if (buf.value_size != value_size) {
+    // Value size changed. Have the pending updates applied first, and let caller retry.
+    HCTR_LOG_S(WARNING, WORLD) << "Table " << tag << ": Value size changed (" << buf.value_size
+                               << " <> " << value_size << "). Deferring update." << std::endl;
+    swap_requested_ = true;
+    post_semaphore_.notify_one();
+    return false;
+  }
+
+  buf.keys.insert(buf.keys.end(), keys, &keys[num_pairs]);
+  buf.values.insert(buf.values.end(), values, &values[num_pairs * value_size]);
+  front_size_ += num_pairs;
+  num_pairs_received_ += num_pairs;
+  num_pairs_pending_ += num_pairs;
+  pairs_received_metric_->add(num_pairs);
+  pairs_pending_metric_->add(static_cast<double>(num_pairs));
+
+  if (buf.keys.size() >= max_batch_size_) {
+    swap_requested_ = true;
+    post_semaphore_.notify_one();
+  }
+  return true;
+}
+
+template <typename Key>
+void UpdateApplier<Key>::flush() {
+  std::unique_lock lock(barrier_);
+
+  // If there is data in the front buffer, we need to wait for the next swap to complete.
+  // Otherwise, it suffices to wait until any in-flight apply completed.
+  size_t target = num_swaps_;
+  if (front_size_) {
+    target++;
+    swap_requested_ = true;
+    post_semaphore_.notify_one();
+  }
+  while (num_rounds_completed_ < target) {
+    swap_semaphore_.wait(lock);
+  }
+}
+
+template <typename Key>
+void UpdateApplier<Key>::run_() {
+  hctr_set_thread_name("hps update");
+
+  std::unique_lock lock(barrier_);
+  while (true) {
+    // Wait until there is work to do.
+    while (!swap_requested_ && !terminate_) {
+      if (!front_size_) {
+        post_semaphore_.wait(lock);
+        continue;
+      }
+
+      // Find deadline of the oldest pending update.
+      Clock::time_point deadline = Clock::time_point::max();
+      for (const auto& front_entry : front_) {
+        const TableBuffer& buf = front_entry.second;
+        if (!buf.keys.empty()) {
+          deadline = std::min(deadline, buf.first_post + max_delay_);
+        }
+      }
+      if (Clock::now() >= deadline) {
+        break;
+      }
+      post_semaphore_.wait_until(lock, deadline);
+    }
+    swap_requested_ = false;
+
+    if (!front_size_) {
+      if (terminate_) {
+        break;
+      }
+      continue;
+    }
+
+    // Swap buffers, and release consumers.
+    std::swap(front_, back_);
+    const size_t batch_size = front_size_;
+    front_size_ = 0;
+    num_swaps_++;
+    lock.unlock();
+    swap_semaphore_.notify_all();
+
+    // Apply tables in parallel. The backends further parallelize across their partitions.
+    const auto begin = Clock::now();
+    std::atomic<size_t> joint_num_applied{0};
+    {
+      std::vector<std::future<void>> tasks;
+      tasks.reserve(back_.size());
+
+      for (auto back_it = back_.begin(); back_it != back_.end(); back_it++) {
+        if (back_it->second.keys.empty()) {
+          continue;
+        }
+        tasks.emplace_back(workers_.submit([&, back_it]() {
+          joint_num_applied += apply_(back_it->first, back_it->second);
+        }));
+      }
+      ThreadPool::await(tasks.begin(), tasks.end());
+    }
+    num_pairs_pending_ -= batch_size;
+    pairs_pending_metric_->add(-static_cast<double>(batch_size));
+    num_applies_++;
+
+    HCTR_LOG_S(DEBUG, WORLD) << "Applied " << joint_num_applied << " / " << batch_size
+                             << " updates to " << db_->get_name() << " in "
+                             << std::chrono::duration_cast<std::chrono::microseconds>(
+                                    Clock::now() - begin)
+                                    .count()
+                             << " us. Lag: " << last_lag().count() << " ns (max "
+                             << max_lag().count() << " ns)." << std::endl;
+
+    lock.lock();
+    num_rounds_completed_++;
+    swap_semaphore_.notify_all();
+  }
+}
+
+template <typename Key>
+size_t UpdateApplier<Key>::apply_(const std::string& tag, TableBuffer& buf) {
+  const size_t value_size = buf.value_size;
+  size_t num_pairs = buf.keys.size();
+
+  // Deduplicate keys. If a key was posted multiple times, the last value wins.
+  {
+    phmap::flat_hash_map<Key, size_t> latest;
+    latest.reserve(num_pairs);
+    for (size_t i = 0; i < num_pairs; i++) {
+      latest.insert_or_assign(buf.keys[i], i);
+    }
+
+    if (latest.size() != num_pairs) {
+      size_t j = 0;
+      for (size_t i = 0; i < num_pairs; i++) {
+        if (latest.find(buf.keys[i])->second != i) {
+          continue;
+        }
+        if (i != j) {
+          buf.keys[j] = buf.keys[i];
+          std::memcpy(&buf.values[j * value_size], &buf.values[i * value_size], value_size);
+        }
+        j++;
+      }
+      num_pairs_deduplicated_ += num_pairs - j;
+      num_pairs = j;
+    }
+  }
+
+  // Retry until the database accepted the update. On termination, the update is dropped.
+  while (!db_->insert(tag, num_pairs, buf.keys.data(), buf.values.data(), value_size)) {
+    if (terminate_) {
+      HCTR_LOG_S(WARNING, WORLD) << "Dropped " << num_pairs << " updates to table " << tag
+                                 << " in " << db_->get_name() << " during shutdown." << std::endl;
+      buf.keys.clear();
+      buf.values.clear();
+      return 0;
+    }
+    HCTR_LOG_S(WARNING, WORLD) << "Unable to apply " << num_pairs << " updates to table " << tag
+                               << " in " << db_->get_name() << '.' << std::endl;
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  }
+  num_pairs_applied_ += num_pairs;
+  pairs_applied_metric_->add(num_pairs);
+
+  // Update lag metrics.
+  const int64_t lag = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                           buf.first_post)
+                          .count();
+  last_lag_ns_ = lag;
+  lag_metric_->record(std::chrono::nanoseconds{lag});
+  for (int64_t max_lag = max_lag_ns_; lag > max_lag;) {
+    if (max_lag_ns_.compare_exchange_weak(max_lag, lag)) {
+      break;
+    }
+  }
+
+  // Keep allocated memory for the next round.
+  buf.keys.clear();
+  buf.values.clear();
+  return num_pairs;
+}
+
+template class UpdateApplier<unsigned int>;
+template class UpdateApplier<long long>;
+
+}  // namespace HugeCTR
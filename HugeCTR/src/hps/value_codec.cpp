@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <cstdint>
+#include <cstring>
+#include <hps/value_codec.hpp>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+namespace {
+
+inline uint32_t float_bits(const float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(float));
+  return bits;
+}
+
+inline float bits_float(const uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(float));
+  return value;
+}
+
+// IEEE 754 float -> half conversion with round-to-nearest-even (same result as F16C).
+inline uint16_t float_to_half(const float value) {
+  uint32_t x = float_bits(value);
+  const uint32_t sign = (x >> 16) & 0x8000u;
+  x &= 0x7fffffffu;
+
+  uint32_t h;
+  if (x >= 0x7f800000u) {
+    // Inf / NaN (quiet NaN, keep the upper payload bits).
+    h = 0x7c00u | (x > 0x7f800000u ? 0x200u | ((x >> 13) & 0x3ffu) : 0u);
+  } else if (x >= 0x477ff000u) {
+    // Rounds to a value >= 65536.
+    h = 0x7c00u;
+  } else if (x < 0x38800000u) {
+    // Subnormal half. Adding 0.5 aligns the mantissa, such that the FPU does the rounding.
+    h = float_bits(bits_float(x) + 0.5f) - 0x3f000000u;
+  } else {
+    // Normal half. Rebias exponent and round mantissa.
+    h = (x + 0xc8000fffu + ((x >> 13) & 1u)) >> 13;
+  }
+  return static_cast<uint16_t>(sign | h);
+}
+
+inline float half_to_float(const uint16_t value) {
+  const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+  const uint32_t em = value & 0x7fffu;
+  if (em >= 0x7c00u) {
+    return bits_float(sign | 0x7f800000u | ((em & 0x3ffu) << 13));
+  } else if (em >= 0x400u) {
+    return bits_float(sign | ((em << 13) + 0x38000000u));
+  } else {
+    return bits_float(sign | float_bits(static_cast<float>(em) * 5.9604644775390625e-8f));
+  }
+}
+
+void encode_fp16_generic(const size_t n, const float* const src, char* const dst) {
+#pragma omp simd
+  for (size_t i = 0; i < n; i++) {
+    const uint16_t h = float_to_half(src[i]);
+    std::memcpy(&dst[i * sizeof(uint16_t)], &h, sizeof(uint16_t));
+  }
+}
+
+void decode_fp16_generic(const size_t n, const char* const src, float* const dst) {
+#pragma omp simd
+  for (size_t i = 0; i < n; i++) {
+    uint16_t h;
+    std::memcpy(&h, &src[i * sizeof(uint16_t)], sizeof(uint16_t));
+    dst[i] = half_to_float(h);
+  }
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx,f16c"))) void encode_fp16_f16c(const size_t n, const float* const src,
+                                                          char* const dst) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(&src[i]), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * sizeof(uint16_t)]), h);
+  }
+  encode_fp16_generic(n - i, &src[i], &dst[i * sizeof(uint16_t)]);
+}
+
+__attribute__((target("avx,f16c"))) void decode_fp16_f16c(const size_t n, const char* const src,
+                                                          float* const dst) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i * sizeof(uint16_t)]));
+    _mm256_storeu_ps(&dst[i], _mm256_cvtph_ps(h));
+  }
+  decode_fp16_generic(n - i, &src[i * sizeof(uint16_t)], &dst[i]);
+}
+
+const bool has_f16c = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+
+void encode_fp16(const size_t n, const float* const src, char* const dst) {
+#if defined(__x86_64__)
+  if (has_f16c) {
+    encode_fp16_f16c(n, src, dst);
+    return;
+  }
+#endif
+  encode_fp16_generic(n, src, dst);
+}
+
+void decode_fp16(const size_t n, const char* const src, float* const dst) {
+#if defined(__x86_64__)
+  if (has_f16c) {
+    decode_fp16_f16c(n, src, dst);
+    return;
+  }
+#endif
+  decode_fp16_generic(n, src, dst);
+}
+
+void encode_bf16(const size_t n, const float* const src, char* const dst) {
+#pragma omp simd
+  for (size_t i = 0; i < n; i++) {
+    const uint32_t x = float_bits(src[i]);
+    // Round to nearest even, but do not let NaNs collapse into infinity.
+    const uint32_t y = ((x & 0x7fffffffu) > 0x7f800000u) ? (x | 0x00400000u)
+                                                         : (x + 0x7fffu + ((x >> 16) & 1u));
+    const uint16_t h = static_cast<uint16_t>(y >> 16);
+    std::memcpy(&dst[i * sizeof(uint16_t)], &h, sizeof(uint16_t));
+  }
+}
+
+void decode_bf16(const size_t n, const char* const src, float* const dst) {
+#pragma omp simd
+  for (size_t i = 0; i < n; i++) {
+    uint16_t h;
+    std::memcpy(&h, &src[i * sizeof(uint16_t)], sizeof(uint16_t));
+    dst[i] = bits_float(static_cast<uint32_t>(h) << 16);
+  }
+}
+
+constexpr size_t int8_header_size = 2 * sizeof(float);
+
+void encode_int8(const size_t num_values, const size_t dim, const float* src, char* dst) {
+  for (size_t r = 0; r < num_values; r++, src += dim, dst += int8_header_size + dim) {
+    float lo = dim ? src[0] : 0.f;
+    float hi = lo;
+#pragma omp simd reduction(min : lo) reduction(max : hi)
+    for (size_t i = 0; i < dim; i++) {
+      lo = std::min(lo, src[i]);
+      hi = std::max(hi, src[i]);
+    }
+    const float scale = (hi - lo) / 255.f;
+    const float inv_scale = scale > 0.f ? 1.f / scale : 0.f;
+    std::memcpy(&dst[0], &scale, sizeof(float));
+    std::memcpy(&dst[sizeof(float)], &lo, sizeof(float));
+
+    uint8_t* const q = reinterpret_cast<uint8_t*>(&dst[int8_header_size]);
+#pragma omp simd
+    for (size_t i = 0; i < dim; i++) {
+      const float v = std::min((src[i] - lo) * inv_scale + 0.5f, 255.f);
+      q[i] = static_cast<uint8_t>(static_cast<int32_t>(v));
+    }
+  }
+}
+
+void decode_int8(const size_t num_values, const size_t dim, const char* src, float* dst) {
+  for (size_t r = 0; r < num_values; r++, src += int8_header_size + dim, dst += dim) {
+    float scale, offset;
+    std::memcpy(&scale, &src[0], sizeof(float));
+    std::memcpy(&offset, &src[sizeof(float)], sizeof(float));
+
+    const uint8_t* const q = reinterpret_cast<const uint8_t*>(&src[int8_header_size]);
+#pragma omp simd
+    for (size_t i = 0; i < dim; i++) {
+      dst[i] = offset + scale * static_cast<float>(q[i]);
+    }
+  }
+}
+
+}  // namespace
+
+size_t value_codec_size(const DatabaseValueCodec_t codec, const size_t dim) {
+  switch (codec) {
+    case DatabaseValueCodec_t::Float32:
+      return dim * sizeof(float);
+    case DatabaseValueCodec_t::Float16:
+    case DatabaseValueCodec_t::BFloat16:
+      return dim * sizeof(uint16_t);
+    case DatabaseValueCodec_t::Int8:
+      return int8_header_size + dim * sizeof(uint8_t);
+    default:
+      HCTR_DIE("Unsupported value codec!");
+      return 0;
+  }
+}
+
+void encode_values(const DatabaseValueCodec_t codec, const size_t num_values, const size_t dim,
+                   const float* const src, char* const dst) {
+  switch (codec) {
+    case DatabaseValueCodec_t::Float32:
+      std::copy_n(reinterpret_cast<const char*>(src), num_values * dim * sizeof(float), dst);
+      break;
+    case DatabaseValueCodec_t::Float16:
+      encode_fp16(num_values * dim, src, dst);
+      break;
+    case DatabaseValueCodec_t::BFloat16:
+      encode_bf16(num_values * dim, src, dst);
+      break;
+    case DatabaseValueCodec_t::Int8:
+      encode_int8(num_values, dim, src, dst);
+      break;
+    default:
+      HCTR_DIE("Unsupported value codec!");
+  }
+}
+
+void decode_values(const DatabaseValueCodec_t codec, const size_t num_values, const size_t dim,
+                   const char* const src, float* const dst) {
+  switch (codec) {
+    case DatabaseValueCodec_t::Float32:
+      std::copy_n(src, num_values * dim * sizeof(float), reinterpret_cast<char*>(dst));
+      break;
+    case DatabaseValueCodec_t::Float16:
+      decode_fp16(num_values * dim, src, dst);
+      break;
+    case DatabaseValueCodec_t::BFloat16:
+      decode_bf16(num_values * dim, src, dst);
+      break;
+    case DatabaseValueCodec_t::Int8:
+      decode_int8(num_values, dim, src, dst);
+      break;
+    default:
+      HCTR_DIE("Unsupported value codec!");
+  }
+}
+
+}  // namespace HugeCTR
@@ -1631,7 +1631,7 @@ void Model::summary() {
              "=======Model "
              "Summary====================================="
              "==============\n");
-  auto log = HCTR_LOG_S(INFO, ROOT);
+  auto log = HCTR_LOG_ENTRY(INFO, ROOT);
   log << "Model structure on each GPU" << std::endl;
   log << std::left << std::setw(40) << std::setfill(' ') << "Label" << std::left << std::setw(30)
       << std::setfill(' ') << "Dense" << std::left << std::setw(30) << std::setfill(' ') << "Sparse"
@@ -1922,6 +1922,12 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         data_reader_train->set_source(reader_params_.source[f]);
         data_reader_train_status_ = true;
         embedding_training_cache->update(reader_params_.keyset[f]);
+        // Load the embeddings of the next pass while training the current one.
+        if (f + 1 < reader_params_.source.size()) {
+          embedding_training_cache->prefetch(reader_params_.keyset[f + 1]);
+        } else if (e + 1 < etc_epochs) {
+          embedding_training_cache->prefetch(reader_params_.keyset[0]);
+        }
         do {
           float lr = 0;
           if (!this->use_gpu_learning_rate_scheduling()) {
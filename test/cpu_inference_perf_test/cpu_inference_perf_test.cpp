@@ -0,0 +1,613 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * End-to-end CPU inference benchmark.
+ *
+ * Generates a synthetic model (dense MLP + embedding tables with power-law key popularity), loads
+ * it into the HPS with each database backend, and measures raw HPS lookups as well as
+ * InferenceSessionCPU::predict from concurrent client threads. For each scenario, the throughput,
+ * latency percentiles and the memory used by the loaded model are written as JSON, and the
+ * throughput is compared against 'expected_throughput.json'. A second benchmark merges small
+ * requests with BatchingInferenceSessionCPU, and logs throughput and latency for different
+ * batching deadlines.
+ *
+ * Configuration (env variables):
+ *   HUGECTR_PERF_NUM_THREADS   Client threads (default: min(8, #cores)).
+ *   HUGECTR_PERF_DURATION      Seconds per scenario (default: 3).
+ *   HUGECTR_PERF_NUM_KEYS      Keys per embedding table (default: 1048576).
+ *   HUGECTR_PERF_ZIPF_ALPHA    Exponent of the key popularity distribution (default: 1.05).
+ *   HUGECTR_PERF_BACKENDS      Comma-separated backends (default: all local backends).
+ *   HUGECTR_PERF_REDIS         Redis cluster address. Adds the RedisCluster backend, if set.
+ *   HUGECTR_PERF_BASELINE      Expected throughput (default: /workdir/test/cpu_inference_perf_test/
+ *                              expected_throughput.json). Ignored, if the file does not exist.
+ *   HUGECTR_PERF_RESULT        Result file (default: cpu_inference_perf.json).
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <cmath>
+#include <cpu/batching_inference_session_cpu.hpp>
+#include <cpu/inference_session_cpu.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <hps/hier_parameter_server.hpp>
+#include <hps/inference_utils.hpp>
+#include <hps/metrics_registry.hpp>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using TypeHashKey = long long;
+using Clock = std::chrono::steady_clock;
+
+const std::string model_name = "perf";
+constexpr size_t num_tables = 2;
+constexpr size_t slot_num = 13;  // Slots per table, one key per slot.
+constexpr size_t dense_dim = 13;
+constexpr size_t embedding_vec_size = 16;
+const std::vector<size_t> mlp_dims = {200, 200, 200, 1};
+
+constexpr size_t lookup_batch_size = 1024;  // Keys per raw lookup.
+constexpr size_t predict_batch_size = 64;   // Samples per predict.
+constexpr size_t num_batches_per_thread = 64;
+constexpr size_t max_request_size = 16;      // Samples per request to the batching session.
+constexpr size_t batching_batch_size = 256;  // Samples per merged batch.
+constexpr size_t num_warmup_iterations = 16;
+
+std::string get_env(const char* const name, const std::string& default_value) {
+  const char* const value = std::getenv(name);
+  return value ? value : default_value;
+}
+
+struct BenchmarkOptions final {
+  size_t num_threads;
+  double duration;
+  size_t num_keys;
+  double zipf_alpha;
+  std::vector<std::string> backends;
+  std::string redis_address;
+  std::string baseline_path;
+  std::string result_path;
+
+  BenchmarkOptions() {
+    num_threads = std::stoull(
+        get_env("HUGECTR_PERF_NUM_THREADS",
+                std::to_string(std::clamp(std::thread::hardware_concurrency(), 1u, 8u))));
+    duration = std::stod(get_env("HUGECTR_PERF_DURATION", "3"));
+    num_keys = std::stoull(get_env("HUGECTR_PERF_NUM_KEYS", "1048576"));
+    zipf_alpha = std::stod(get_env("HUGECTR_PERF_ZIPF_ALPHA", "1.05"));
+
+    std::istringstream backend_list(get_env(
+        "HUGECTR_PERF_BACKENDS",
+        "HashMap,ParallelHashMap,ShardedHashMap,MultiProcessHashMap,RocksDB,ImmutableStore"));
+    for (std::string backend; std::getline(backend_list, backend, ',');) {
+      backends.emplace_back(backend);
+    }
+    redis_address = get_env("HUGECTR_PERF_REDIS", "");
+    if (!redis_address.empty()) {
+      backends.emplace_back("RedisCluster");
+    }
+
+    baseline_path = get_env("HUGECTR_PERF_BASELINE",
+                            "/workdir/test/cpu_inference_perf_test/expected_throughput.json");
+    result_path = get_env("HUGECTR_PERF_RESULT", "cpu_inference_perf.json");
+  }
+};
+
+// Zipf distribution over ranks [0, n). Rank 0 is the most popular.
+class ZipfDistribution final {
+ public:
+  ZipfDistribution(const size_t n, const double alpha) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += 1. / std::pow(static_cast<double>(i + 1), alpha);
+      cdf_[i] = sum;
+    }
+    for (double& p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  template <typename Generator>
+  size_t operator()(Generator& gen) const {
+    const double u = std::uniform_real_distribution<double>(0, 1)(gen);
+    const auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+    return std::min(static_cast<size_t>(it - cdf_.begin()), cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+// Scatters popular keys across the key space, so that they do not end up in the same partitions.
+inline TypeHashKey key_of_rank(const size_t rank) {
+  return static_cast<TypeHashKey>((rank * 0x9E3779B97F4A7C15ULL) & 0x7FFFFFFFFFFFFFFFULL);
+}
+
+// Model files in a temporary directory, which is removed on destruction.
+struct SyntheticModel final {
+  std::filesystem::path dir;
+  std::string network_file;
+  std::string dense_model_file;
+  std::vector<std::string> sparse_model_files;
+  std::vector<std::string> embedding_table_names;
+
+  explicit SyntheticModel(const size_t num_keys) {
+    dir = std::filesystem::temp_directory_path() /
+          ("hctr_cpu_inference_perf_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    write_network_();
+    write_dense_model_();
+    for (size_t t = 0; t < num_tables; t++) {
+      write_sparse_model_(t, num_keys);
+    }
+  }
+
+  ~SyntheticModel() { std::filesystem::remove_all(dir); }
+
+ private:
+  void write_network_() {
+    nlohmann::json data = {{"name", "data"},
+                           {"type", "Data"},
+                           {"check", "Sum"},
+                           {"label", {{"top", "label"}, {"label_dim", 1}}},
+                           {"dense", {{"top", "dense"}, {"dense_dim", dense_dim}}},
+                           {"sparse", nlohmann::json::array()}};
+    nlohmann::json layers = nlohmann::json::array({data});
+    nlohmann::json concat_bottoms = nlohmann::json::array();
+    for (size_t t = 0; t < num_tables; t++) {
+      const std::string id = std::to_string(t + 1);
+      layers[0]["sparse"].push_back({{"top", "data" + id},
+                                     {"slot_num", slot_num},
+                                     {"is_fixed_length", false},
+                                     {"nnz_per_slot", 1}});
+      embedding_table_names.emplace_back("sparse_embedding" + id);
+    }
+    for (size_t t = 0; t < num_tables; t++) {
+      const std::string id = std::to_string(t + 1);
+      layers.push_back({{"name", "sparse_embedding" + id},
+                        {"type", "DistributedSlotSparseEmbeddingHash"},
+                        {"bottom", "data" + id},
+                        {"top", "sparse_embedding" + id},
+                        {"sparse_embedding_hparam",
+                         {{"embedding_vec_size", embedding_vec_size},
+                          {"combiner", "sum"},
+                          {"workspace_size_per_gpu_in_mb", 1}}}});
+    }
+    for (size_t t = 0; t < num_tables; t++) {
+      const std::string id = std::to_string(t + 1);
+      layers.push_back({{"name", "reshape" + id},
+                        {"type", "Reshape"},
+                        {"bottom", "sparse_embedding" + id},
+                        {"top", "reshape" + id},
+                        {"leading_dim", slot_num * embedding_vec_size}});
+      concat_bottoms.push_back("reshape" + id);
+    }
+    concat_bottoms.push_back("dense");
+    layers.push_back({{"name", "concat"}, {"type", "Concat"}, {"bottom", concat_bottoms},
+                      {"top", "concat"}});
+
+    std::string bottom = "concat";
+    for (size_t i = 0; i < mlp_dims.size(); i++) {
+      const std::string id = std::to_string(i + 1);
+      layers.push_back({{"name", "fc" + id},
+                        {"type", "InnerProduct"},
+                        {"bottom", bottom},
+                        {"top", "fc" + id},
+                        {"fc_param", {{"num_output", mlp_dims[i]}}}});
+      bottom = "fc" + id;
+      if (i + 1 < mlp_dims.size()) {
+        layers.push_back(
+            {{"name", "relu" + id}, {"type", "ReLU"}, {"bottom", bottom}, {"top", "relu" + id}});
+        bottom = "relu" + id;
+      }
+    }
+    layers.push_back(
+        {{"name", "sigmoid"}, {"type", "Sigmoid"}, {"bottom", bottom}, {"top", "sigmoid"}});
+
+    network_file = dir / "network.json";
+    std::ofstream(network_file) << nlohmann::json{{"layers", layers}}.dump(2);
+  }
+
+  // Weights and biases of all InnerProduct layers, in layer order.
+  void write_dense_model_() {
+    size_t num_params = 0;
+    size_t num_inputs = num_tables * slot_num * embedding_vec_size + dense_dim;
+    for (const size_t num_outputs : mlp_dims) {
+      num_params += (num_inputs + 1) * num_outputs;
+      num_inputs = num_outputs;
+    }
+
+    std::mt19937 gen(42);
+    std::normal_distribution<float> dist(0, 0.05f);
+    std::vector<float> params(num_params);
+    std::generate(params.begin(), params.end(), [&]() { return dist(gen); });
+
+    dense_model_file = dir / "_dense.model";
+    std::ofstream(dense_model_file, std::ofstream::binary)
+        .write(reinterpret_cast<const char*>(params.data()), params.size() * sizeof(float));
+  }
+
+  // RawModelLoader format: A 'key' and an 'emb_vector' file per table.
+  void write_sparse_model_(const size_t table, const size_t num_keys) {
+    const std::filesystem::path table_dir = dir / (std::to_string(table) + "_sparse.model");
+    std::filesystem::create_directories(table_dir);
+
+    std::vector<TypeHashKey> keys(num_keys);
+    for (size_t i = 0; i < num_keys; i++) {
+      keys[i] = key_of_rank(i);
+    }
+    std::ofstream(table_dir / "key", std::ofstream::binary)
+        .write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(TypeHashKey));
+
+    std::mt19937 gen(table);
+    std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
+    std::ofstream vectors_file(table_dir / "emb_vector", std::ofstream::binary);
+    std::vector<float> vector(embedding_vec_size);
+    for (size_t i = 0; i < num_keys; i++) {
+      std::generate(vector.begin(), vector.end(), [&]() { return dist(gen); });
+      vectors_file.write(reinterpret_cast<const char*>(vector.data()),
+                         vector.size() * sizeof(float));
+    }
+
+    sparse_model_files.emplace_back(table_dir);
+  }
+};
+
+// Resident set size of this process in bytes, from '/proc/self/status' (field 'VmRSS' or 'VmHWM').
+size_t get_memory_usage(const std::string& field = "VmRSS") {
+  std::ifstream status("/proc/self/status");
+  for (std::string line; std::getline(status, line);) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stoull(line.substr(field.size() + 1)) * 1024;  // kB
+    }
+  }
+  return 0;
+}
+
+InferenceParams make_inference_params(const SyntheticModel& model, const BenchmarkOptions& options,
+                                      const std::string& backend) {
+  InferenceParams params(model_name, predict_batch_size, 0.5, model.dense_model_file,
+                         model.sparse_model_files, 0, false, 0.8, true);
+  params.maxnum_catfeature_query_per_table_per_sample.assign(num_tables, slot_num);
+  params.embedding_vecsize_per_table.assign(num_tables, embedding_vec_size);
+  params.embedding_table_names = model.embedding_table_names;
+  params.default_value_for_each_table.assign(num_tables, 0.f);
+
+  const std::filesystem::path db_dir = model.dir / ("db_" + backend);
+  VolatileDatabaseParams& volatile_db = params.volatile_db;
+  PersistentDatabaseParams& persistent_db = params.persistent_db;
+  volatile_db.type = DatabaseType_t::Disabled;
+  persistent_db.type = DatabaseType_t::Disabled;
+  if (backend == "HashMap") {
+    volatile_db.type = DatabaseType_t::HashMap;
+  } else if (backend == "ParallelHashMap") {
+    volatile_db.type = DatabaseType_t::ParallelHashMap;
+  } else if (backend == "ShardedHashMap") {
+    volatile_db.type = DatabaseType_t::ShardedHashMap;
+  } else if (backend == "MultiProcessHashMap") {
+    volatile_db.type = DatabaseType_t::MultiProcessHashMap;
+    volatile_db.shared_memory_name = "hctr_cpu_inference_perf_" + std::to_string(getpid());
+    // Values, keys and hash map overhead, with plenty of headroom.
+    volatile_db.shared_memory_size =
+        4 * num_tables * options.num_keys * (embedding_vec_size * sizeof(float) + 64) +
+        64L * 1024L * 1024L;
+  } else if (backend == "RedisCluster") {
+    volatile_db.type = DatabaseType_t::RedisCluster;
+    volatile_db.address = options.redis_address;
+  } else if (backend == "RocksDB") {
+    persistent_db.type = DatabaseType_t::RocksDB;
+    persistent_db.path = db_dir;
+  } else if (backend == "ImmutableStore") {
+    persistent_db.type = DatabaseType_t::ImmutableStore;
+    persistent_db.path = db_dir;
+  } else {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Unknown backend '" + backend + "'.");
+  }
+  return params;
+}
+
+struct ScenarioResult final {
+  std::string name;
+  double qps;  // Requests per second.
+  double items_per_second;
+  double p50_us;
+  double p99_us;
+  double p999_us;
+  size_t model_memory;  // Increase of the resident set size while loading the model.
+
+  nlohmann::json to_json() const {
+    return {{"qps", qps},         {"items_per_second", items_per_second},
+            {"p50_us", p50_us},   {"p99_us", p99_us},
+            {"p999_us", p999_us}, {"model_memory_mb", static_cast<double>(model_memory) / 1e6}};
+  }
+};
+
+/**
+ * Runs \p request in a closed loop on each client thread until the duration elapsed.
+ * \p request (thread_index, iteration) handles one request.
+ */
+template <typename Request>
+ScenarioResult run_clients(const std::string& name, const BenchmarkOptions& options,
+                           const size_t items_per_request, Request&& request) {
+  MetricHistogram latency;
+  std::atomic<bool> running{true};
+
+  std::vector<std::thread> clients;
+  for (size_t t = 0; t < options.num_threads; t++) {
+    clients.emplace_back([&, t]() {
+      hctr_set_thread_name("client #" + std::to_string(t));
+      size_t i = 0;
+      for (; i < num_warmup_iterations; i++) {
+        request(t, i);
+      }
+      for (; running.load(std::memory_order_relaxed); i++) {
+        const auto begin = Clock::now();
+        request(t, i);
+        latency.record(Clock::now() - begin);
+      }
+    });
+  }
+  const auto begin = Clock::now();
+  std::this_thread::sleep_for(std::chrono::duration<double>(options.duration));
+  running = false;
+  for (auto& client : clients) {
+    client.join();
+  }
+  const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+  ScenarioResult result;
+  result.name = name;
+  result.qps = static_cast<double>(latency.count()) / elapsed;
+  result.items_per_second = result.qps * static_cast<double>(items_per_request);
+  result.p50_us = static_cast<double>(latency.quantile(0.5)) * 1e-3;
+  result.p99_us = static_cast<double>(latency.quantile(0.99)) * 1e-3;
+  result.p999_us = static_cast<double>(latency.quantile(0.999)) * 1e-3;
+  result.model_memory = 0;
+  return result;
+}
+
+std::vector<ScenarioResult> benchmark_backend(const SyntheticModel& model,
+                                              const BenchmarkOptions& options,
+                                              const ZipfDistribution& zipf,
+                                              const std::string& backend) {
+  const size_t memory_before = get_memory_usage();
+  std::vector<InferenceParams> inference_params{make_inference_params(model, options, backend)};
+  parameter_server_config ps_config{{model.network_file}, inference_params};
+  const std::shared_ptr<HierParameterServerBase> parameter_server =
+      HierParameterServerBase::create(ps_config, inference_params);
+  const size_t memory_after = get_memory_usage();
+  const size_t model_memory = memory_after > memory_before ? memory_after - memory_before : 0;
+
+  std::vector<ScenarioResult> results;
+
+  // Raw HPS lookups. Each request queries one table.
+  {
+    std::vector<std::vector<TypeHashKey>> keys(options.num_threads);
+    for (size_t t = 0; t < options.num_threads; t++) {
+      std::mt19937_64 gen(t);
+      keys[t].resize(num_batches_per_thread * lookup_batch_size);
+      std::generate(keys[t].begin(), keys[t].end(), [&]() { return key_of_rank(zipf(gen)); });
+    }
+    std::vector<std::vector<float>> vectors(
+        options.num_threads, std::vector<float>(lookup_batch_size * embedding_vec_size));
+
+    results.emplace_back(run_clients(
+        "lookup/" + backend, options, lookup_batch_size, [&](const size_t t, const size_t i) {
+          const TypeHashKey* const batch =
+              &keys[t][(i % num_batches_per_thread) * lookup_batch_size];
+          parameter_server->lookup(batch, lookup_batch_size, vectors[t].data(), model_name,
+                                   i % num_tables);
+        }));
+  }
+
+  // Full predictions. Each client has its own session, which shares the parameter server.
+  {
+    struct ClientRequests final {
+      std::unique_ptr<InferenceSessionCPU<TypeHashKey>> session;
+      std::vector<float> dense;
+      std::vector<TypeHashKey> keys;
+      std::vector<int> row_ptrs;
+      std::vector<float> output;
+    };
+    const size_t num_keys_per_sample = num_tables * slot_num;
+    const size_t num_keys_per_batch = predict_batch_size * num_keys_per_sample;
+
+    std::vector<ClientRequests> clients(options.num_threads);
+    for (size_t t = 0; t < options.num_threads; t++) {
+      ClientRequests& client = clients[t];
+      client.session = std::make_unique<InferenceSessionCPU<TypeHashKey>>(
+          model.network_file, inference_params[0], parameter_server);
+
+      std::mt19937_64 gen(t);
+      std::uniform_real_distribution<float> dense_dist(0, 1);
+      client.dense.resize(num_batches_per_thread * predict_batch_size * dense_dim);
+      std::generate(client.dense.begin(), client.dense.end(), [&]() { return dense_dist(gen); });
+      client.keys.resize(num_batches_per_thread * num_keys_per_batch);
+      std::generate(client.keys.begin(), client.keys.end(),
+                    [&]() { return key_of_rank(zipf(gen)); });
+
+      // One key per slot. Row offsets of all tables, one after another.
+      for (size_t table = 0; table < num_tables; table++) {
+        for (size_t i = 0; i <= predict_batch_size * slot_num; i++) {
+          client.row_ptrs.emplace_back(static_cast<int>(i));
+        }
+      }
+      client.output.resize(predict_batch_size);
+    }
+
+    results.emplace_back(run_clients(
+        "predict/" + backend, options, predict_batch_size, [&](const size_t t, const size_t i) {
+          ClientRequests& client = clients[t];
+          const size_t batch = i % num_batches_per_thread;
+          client.session->predict(&client.dense[batch * predict_batch_size * dense_dim],
+                                  &client.keys[batch * num_keys_per_batch],
+                                  client.row_ptrs.data(), client.output.data(),
+                                  static_cast<int>(predict_batch_size));
+        }));
+  }
+
+  for (auto& result : results) {
+    result.model_memory = model_memory;
+  }
+  return results;
+}
+
+/**
+ * Closed-loop clients issue requests of 1..max_request_size samples, which the batching session
+ * merges. One scenario per batching deadline.
+ */
+std::vector<ScenarioResult> benchmark_batching(const SyntheticModel& model,
+                                               const BenchmarkOptions& options,
+                                               const ZipfDistribution& zipf,
+                                               const size_t num_replicas) {
+  std::vector<InferenceParams> inference_params{make_inference_params(model, options, "HashMap")};
+  inference_params[0].max_batchsize = batching_batch_size;
+  parameter_server_config ps_config{{model.network_file}, inference_params};
+  const std::shared_ptr<HierParameterServerBase> parameter_server =
+      HierParameterServerBase::create(ps_config, inference_params);
+
+  struct ClientRequest final {
+    int num_samples;
+    std::vector<float> dense;
+    std::vector<TypeHashKey> keys;
+    std::vector<int> row_ptrs;
+  };
+  const size_t num_keys_per_sample = num_tables * slot_num;
+
+  std::vector<std::vector<ClientRequest>> requests(options.num_threads);
+  std::vector<std::vector<float>> outputs(options.num_threads,
+                                          std::vector<float>(max_request_size));
+  size_t num_samples = 0;
+  for (size_t t = 0; t < options.num_threads; t++) {
+    std::mt19937_64 gen(t);
+    std::uniform_int_distribution<int> size_dist(1, max_request_size);
+    std::uniform_real_distribution<float> dense_dist(0, 1);
+    for (size_t i = 0; i < num_batches_per_thread; i++) {
+      ClientRequest request;
+      request.num_samples = size_dist(gen);
+      request.dense.resize(request.num_samples * dense_dim);
+      std::generate(request.dense.begin(), request.dense.end(), [&]() { return dense_dist(gen); });
+      request.keys.resize(request.num_samples * num_keys_per_sample);
+      std::generate(request.keys.begin(), request.keys.end(),
+                    [&]() { return key_of_rank(zipf(gen)); });
+
+      // One key per slot. Row offsets of all tables, one after another.
+      for (size_t table = 0; table < num_tables; table++) {
+        for (size_t j = 0; j <= request.num_samples * slot_num; j++) {
+          request.row_ptrs.emplace_back(static_cast<int>(j));
+        }
+      }
+      num_samples += request.num_samples;
+      requests[t].emplace_back(std::move(request));
+    }
+  }
+  const double mean_request_size =
+      static_cast<double>(num_samples) /
+      static_cast<double>(options.num_threads * num_batches_per_thread);
+
+  std::vector<ScenarioResult> results;
+  for (const int delay_us : {0, 100, 500, 1000, 5000}) {
+    BatchingInferenceSessionCPU<TypeHashKey> sess(model.network_file, inference_params[0],
+                                                  parameter_server, num_replicas,
+                                                  std::chrono::microseconds(delay_us));
+    results.emplace_back(run_clients(
+        "batching/" + std::to_string(delay_us) + "us", options, 1,
+        [&](const size_t t, const size_t i) {
+          const ClientRequest& request = requests[t][i % num_batches_per_thread];
+          sess.predict(request.dense.data(), request.keys.data(), request.row_ptrs.data(),
+                       outputs[t].data(), request.num_samples);
+        }));
+    results.back().items_per_second = results.back().qps * mean_request_size;
+    HCTR_LOG_S(INFO, WORLD) << results.back().name << ": "
+                            << static_cast<double>(sess.num_requests()) /
+                                   static_cast<double>(sess.num_batches())
+                            << " requests/batch" << std::endl;
+  }
+  return results;
+}
+
+}  // namespace
+
+TEST(cpu_inference_perf_test, hps_backends) {
+  const BenchmarkOptions options;
+  HCTR_LOG_S(INFO, WORLD) << "Generating synthetic model with " << num_tables << " x "
+                          << options.num_keys << " keys..." << std::endl;
+  const SyntheticModel model(options.num_keys);
+  const ZipfDistribution zipf(options.num_keys, options.zipf_alpha);
+
+  nlohmann::json results;
+  results["config"] = {{"num_threads", options.num_threads},
+                       {"duration_s", options.duration},
+                       {"num_tables", num_tables},
+                       {"num_keys_per_table", options.num_keys},
+                       {"embedding_vec_size", embedding_vec_size},
+                       {"zipf_alpha", options.zipf_alpha},
+                       {"lookup_batch_size", lookup_batch_size},
+                       {"predict_batch_size", predict_batch_size}};
+  for (const std::string& backend : options.backends) {
+    for (const ScenarioResult& result : benchmark_backend(model, options, zipf, backend)) {
+      HCTR_LOG_S(INFO, WORLD) << result.name << ": " << result.qps << " req/s, "
+                              << result.items_per_second << " items/s, p50: " << result.p50_us
+                              << " us, p99: " << result.p99_us << " us, p999: " << result.p999_us
+                              << " us, model memory: " << result.model_memory / (1024 * 1024)
+                              << " MiB" << std::endl;
+      results["scenarios"][result.name] = result.to_json();
+    }
+  }
+  results["peak_memory_mb"] = static_cast<double>(get_memory_usage("VmHWM")) / 1e6;
+
+  std::ofstream(options.result_path) << results.dump(2) << std::endl;
+  HCTR_LOG_S(INFO, WORLD) << "Wrote results to '" << options.result_path << "'." << std::endl;
+
+  // Lower bounds on the throughput (requests per second).
+  std::ifstream baseline_file(options.baseline_path);
+  if (!baseline_file.is_open()) {
+    HCTR_LOG_S(WARNING, WORLD) << "No baseline at '" << options.baseline_path << "'." << std::endl;
+    return;
+  }
+  const nlohmann::json baseline = nlohmann::json::parse(baseline_file);
+  for (const auto& [name, result] : results["scenarios"].items()) {
+    if (baseline.contains(name)) {
+      EXPECT_GE(result["qps"].get<double>(), baseline[name].get<double>()) << name;
+    }
+  }
+}
+TEST(cpu_inference_perf_test, batching) {
+  const BenchmarkOptions options;
+  const SyntheticModel model(options.num_keys);
+  const ZipfDistribution zipf(options.num_keys, options.zipf_alpha);
+  for (const ScenarioResult& result : benchmark_batching(model, options, zipf, 2)) {
+    HCTR_LOG_S(INFO, WORLD) << result.name << ": " << result.items_per_second
+                            << " samples/s, p50: " << result.p50_us << " us, p99: "
+                            << result.p99_us << " us" << std::endl;
+  }
+}
@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * CPU layer benchmarks.
+ *
+ * Measures the fprop time of INT8 quantized layers against their floating point version (and of
+ * the INT8 GEMM with each kernel this CPU supports), the fused embedding bag against separate
+ * lookup and combine, and the predict time of networks created with and without graph
+ * optimization. Results are logged. Correctness is covered by the unit tests.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <cmath>
+#include <cpu/embedding_feature_combiner_cpu.hpp>
+#include <cpu/layers/fully_connected_layer_cpu.hpp>
+#include <cpu/layers/fused_fully_connected_layer_cpu.hpp>
+#include <cpu/layers/multi_cross_layer_cpu.hpp>
+#include <cpu/network_cpu.hpp>
+#include <cpu/quantization_cpu.hpp>
+#include <general_buffer2.hpp>
+#include <hps/hash_map_backend.hpp>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Func>
+double time_ms(const int num_iterations, Func&& func) {
+  func();  // Warm up.
+  const auto begin = Clock::now();
+  for (int i = 0; i < num_iterations; i++) {
+    func();
+  }
+  return std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / num_iterations;
+}
+
+void log_speedup(const std::string& name, const double fp_ms, const double int8_ms) {
+  HCTR_LOG_S(INFO, WORLD) << name << ": fprop " << fp_ms << " ms -> " << int8_ms << " ms ("
+                          << fp_ms / int8_ms << "x, " << int8_gemm_cpu_kernel() << ')'
+                          << std::endl;
+}
+
+template <typename T>
+void fill_random(T* const values, const size_t num_values, std::mt19937& gen, const float scale) {
+  std::normal_distribution<float> dist(0.f, scale);
+  for (size_t i = 0; i < num_values; i++) {
+    values[i] = dist(gen);
+  }
+}
+
+const char* kernel_name(const Int8GemmKernel_t kernel) {
+  switch (kernel) {
+    case Int8GemmKernel_t::AVX2:
+      return "avx2";
+    case Int8GemmKernel_t::AVX512VNNI:
+      return "avx512_vnni";
+    default:
+      return "generic";
+  }
+}
+
+void int8_gemm_perf(const size_t m, const size_t k, const size_t n) {
+  std::mt19937 gen(4711);
+  std::vector<float> in(m * k), weights(k * n), out(m * n);
+  fill_random(in.data(), in.size(), gen, 1.f);
+  fill_random(weights.data(), weights.size(), gen, 1.f);
+
+  Int8WeightsCPU w;
+  w.quantize(weights.data(), k, n);
+  Int8ActivationsCPU a;
+  a.quantize(in.data(), m, k);
+  for (const Int8GemmKernel_t kernel : int8_gemm_cpu_kernels()) {
+    const double ms = time_ms(10, [&]() { int8_gemm_cpu(a, w, out.data(), kernel); });
+    HCTR_LOG_S(INFO, WORLD) << "INT8 GEMM " << m << 'x' << k << 'x' << n << ", kernel "
+                            << kernel_name(kernel) << ": " << ms << " ms ("
+                            << 2e-6 * static_cast<double>(m * k * n) / ms << " GOP/s)"
+                            << std::endl;
+  }
+}
+
+void fully_connected_int8_perf(const size_t m, const size_t k, const size_t n) {
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  std::shared_ptr<BufferBlock2<float>> weight_buff = buff->create_block<float>();
+  std::shared_ptr<BufferBlock2<float>> wgrad_buff = buff->create_block<float>();
+  Tensor2<float> in_tensor, out_tensor;
+  buff->reserve({m, k}, &in_tensor);
+  buff->reserve({m, n}, &out_tensor);
+  FullyConnectedLayerCPU<float> layer(weight_buff, wgrad_buff, in_tensor, out_tensor, false);
+  buff->allocate();
+  layer.initialize();
+
+  std::mt19937 gen(4711);
+  Tensor2<float> weights = weight_buff->as_tensor();
+  fill_random(in_tensor.get_ptr(), m * k, gen, 1.f);
+  fill_random(weights.get_ptr(), weights.get_num_elements(), gen, 1.f);
+
+  const double fp_ms = time_ms(3, [&]() { layer.fprop(false); });
+  layer.quantize();
+  const double int8_ms = time_ms(10, [&]() { layer.fprop(false); });
+  log_speedup("FullyConnectedLayerCPU<float> " + std::to_string(m) + 'x' + std::to_string(k) +
+                  'x' + std::to_string(n),
+              fp_ms, int8_ms);
+}
+
+void fused_fully_connected_int8_perf(const size_t m, const size_t k, const size_t n) {
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  std::shared_ptr<BufferBlock2<float>> master_weight_buff = buff->create_block<float>();
+  std::shared_ptr<BufferBlock2<__half>> weight_buff = buff->create_block<__half>();
+  std::shared_ptr<BufferBlock2<__half>> wgrad_buff = buff->create_block<__half>();
+  Tensor2<__half> bottom_tensor, top_tensor;
+  buff->reserve({m, k}, &bottom_tensor);
+  buff->reserve({m, n}, &top_tensor);
+  FusedFullyConnectedLayerCPU layer(master_weight_buff, weight_buff, wgrad_buff, buff,
+                                    bottom_tensor, top_tensor);
+  buff->allocate();
+  layer.initialize();
+
+  std::mt19937 gen(4711);
+  Tensor2<float> master_weights = master_weight_buff->as_tensor();
+  fill_random(master_weights.get_ptr(), master_weights.get_num_elements(), gen, 0.1f);
+  std::vector<float> h_bottom(m * k);
+  fill_random(h_bottom.data(), h_bottom.size(), gen, 1.f);
+  std::transform(h_bottom.begin(), h_bottom.end(), bottom_tensor.get_ptr(),
+                 [](const float x) { return __float2half(x); });
+  Tensor2<__half> weights = weight_buff->as_tensor();
+  std::transform(master_weights.get_ptr(),
+                 master_weights.get_ptr() + master_weights.get_num_elements(), weights.get_ptr(),
+                 [](const float x) { return __float2half(x); });
+
+  const double fp_ms = time_ms(3, [&]() { layer.fprop(false); });
+  layer.quantize();
+  const double int8_ms = time_ms(10, [&]() { layer.fprop(false); });
+  log_speedup("FusedFullyConnectedLayerCPU " + std::to_string(m) + 'x' + std::to_string(k) + 'x' +
+                  std::to_string(n),
+              fp_ms, int8_ms);
+}
+
+void multi_cross_int8_perf(const size_t batchsize, const size_t w, const int num_layers,
+                           const size_t projection_dim = 0) {
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  std::shared_ptr<BufferBlock2<float>> weight_buff = buff->create_block<float>();
+  std::shared_ptr<BufferBlock2<float>> wgrad_buff = buff->create_block<float>();
+  Tensor2<float> in_tensor, out_tensor;
+  buff->reserve({batchsize, w}, &in_tensor);
+  buff->reserve({batchsize, w}, &out_tensor);
+  MultiCrossLayerCPU layer(weight_buff, wgrad_buff, buff, in_tensor, out_tensor, num_layers,
+                           projection_dim);
+  buff->allocate();
+  layer.initialize();
+
+  std::mt19937 gen(4711);
+  Tensor2<float> weights = weight_buff->as_tensor();
+  fill_random(in_tensor.get_ptr(), batchsize * w, gen, 1.f);
+  fill_random(weights.get_ptr(), weights.get_num_elements(), gen, 1.f / static_cast<float>(w));
+
+  const double fp_ms = time_ms(10, [&]() { layer.fprop(false); });
+  layer.quantize();
+  const double int8_ms = time_ms(10, [&]() { layer.fprop(false); });
+  log_speedup("MultiCrossLayerCPU " + std::to_string(batchsize) + 'x' + std::to_string(w) + 'x' +
+                  std::to_string(num_layers) +
+                  (projection_dim ? " (projection_dim " + std::to_string(projection_dim) + ')'
+                                  : std::string()),
+              fp_ms, int8_ms);
+}
+
+// Embedding vectors are either fetched from a HashMap database (like the parameter server of the
+// CPU inference session does), or copied from a dense table (the cost of moving the vectors alone).
+void embedding_bag_perf(const int batch_size, const int slot_num, const int hotness,
+                        const int embedding_vec_size, const bool use_hash_map) {
+  const std::string tag = "hps_et.perf.bag";
+  const size_t num_table_keys = 1000000;
+
+  std::mt19937 gen(4711);
+  std::vector<float> table(num_table_keys * embedding_vec_size);
+  fill_random(table.data(), table.size(), gen, 1.f);
+  HashMapBackend<long long> db(16, 64 * 1024 * 1024);
+  if (use_hash_map) {
+    std::vector<long long> keys(num_table_keys);
+    std::iota(keys.begin(), keys.end(), 0LL);
+    db.insert(tag, num_table_keys, keys.data(), reinterpret_cast<const char*>(table.data()),
+              embedding_vec_size * sizeof(float));
+  }
+
+  // 1..hotness features per slot.
+  std::uniform_int_distribution<int> nnz_dist(1, hotness);
+  std::uniform_int_distribution<long long> key_dist(0, num_table_keys - 1);
+  std::vector<int> h_row_ptrs(batch_size * slot_num + 1);
+  h_row_ptrs[0] = 0;
+  for (size_t i = 1; i < h_row_ptrs.size(); i++) {
+    h_row_ptrs[i] = h_row_ptrs[i - 1] + nnz_dist(gen);
+  }
+  const size_t num_keys = h_row_ptrs.back();
+  std::vector<long long> h_keys(num_keys);
+  std::generate(h_keys.begin(), h_keys.end(), [&]() { return key_dist(gen); });
+
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  auto row_ptrs_tensor = std::make_shared<Tensor2<int>>();
+  buff->reserve({h_row_ptrs.size()}, row_ptrs_tensor.get());
+  auto in_tensor = std::make_shared<Tensor2<float>>();
+  buff->reserve({num_keys, static_cast<size_t>(embedding_vec_size)}, in_tensor.get());
+  Tensor2<float> out_tensor;
+  EmbeddingFeatureCombinerCPU<float> combiner(in_tensor, row_ptrs_tensor, out_tensor, batch_size,
+                                              slot_num, EmbeddingFeatureCombiner_t::Sum, buff);
+  buff->allocate();
+  std::copy(h_row_ptrs.begin(), h_row_ptrs.end(), row_ptrs_tensor->get_ptr());
+
+  std::vector<size_t> missing;
+  size_t next_key = 0;
+  auto lookup = [&](const size_t count, float* const vectors) {
+    if (use_hash_map) {
+      db.fetch(tag, count, &h_keys[next_key], reinterpret_cast<char*>(vectors),
+               embedding_vec_size * sizeof(float), embedding_vec_size * sizeof(float), missing,
+               std::chrono::nanoseconds::max());
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        std::copy_n(&table[h_keys[next_key + i] * embedding_vec_size], embedding_vec_size,
+                    &vectors[i * embedding_vec_size]);
+      }
+    }
+    next_key += count;
+  };
+
+  // Separate: Materialize all vectors in the input tensor, then combine.
+  const double separate_ms = time_ms(10, [&]() {
+    next_key = 0;
+    lookup(num_keys, in_tensor->get_ptr());
+    combiner.fprop(false);
+  });
+  const double fused_ms = time_ms(10, [&]() {
+    next_key = 0;
+    combiner.fprop_fused(lookup, batch_size);
+  });
+  HCTR_LOG_S(INFO, WORLD) << "Embedding bag (" << (use_hash_map ? "HashMap" : "dense table")
+                          << ") " << batch_size << 'x' << slot_num << " slots x " << hotness
+                          << "-hot x " << embedding_vec_size << ", " << num_keys
+                          << " keys: separate " << separate_ms << " ms -> fused " << fused_ms
+                          << " ms" << std::endl;
+}
+
+const size_t batchsize = 64;
+
+struct Input {
+  std::string name;
+  std::vector<size_t> dims;
+};
+
+void network_optimization_perf(const char* name, const std::string& layers,
+                               const std::vector<Input>& inputs) {
+  const nlohmann::json j_layers = nlohmann::json::parse(layers);
+  const auto cpu_resource = std::make_shared<CPUResource>(0, std::vector<unsigned long long>{});
+
+  std::mt19937 gen(4711);
+  const auto input_buff = GeneralBuffer2<HostAllocator>::create();
+  std::vector<TensorEntry> input_entries;
+  std::vector<Tensor2<float>> input_tensors;
+  for (const Input& input : inputs) {
+    Tensor2<float> tensor;
+    input_buff->reserve(input.dims, &tensor);
+    input_tensors.push_back(tensor);
+    input_entries.push_back({input.name, tensor.shrink()});
+  }
+  input_buff->allocate();
+  for (Tensor2<float>& tensor : input_tensors) {
+    fill_random(tensor.get_ptr(), tensor.get_num_elements(), gen, 1.f);
+  }
+
+  double predict_ms[2];
+  size_t buffer_size[2];
+  for (const bool use_optimization : {false, true}) {
+    std::vector<TensorEntry> tensor_entries = input_entries;
+    std::unique_ptr<NetworkCPU> network(NetworkCPU::create_network(
+        j_layers, tensor_entries, cpu_resource, false, false, use_optimization));
+    network->initialize();
+    predict_ms[use_optimization] = time_ms(3, [&]() { network->predict(); });
+    buffer_size[use_optimization] = network->get_buffer_size_in_bytes();
+  }
+  HCTR_LOG_S(INFO, WORLD) << name << ": buffers " << buffer_size[0] << " -> " << buffer_size[1]
+                          << " bytes, predict " << predict_ms[0] << " ms -> " << predict_ms[1]
+                          << " ms" << std::endl;
+}
+
+const char* const dcn_layers = R"([
+  {"name": "data", "type": "Data"},
+  {"name": "reshape1", "type": "Reshape", "bottom": "sparse_embedding1", "top": "reshape1",
+   "leading_dim": 416},
+  {"name": "concat1", "type": "Concat", "bottom": ["reshape1", "dense"], "top": "concat1"},
+  {"name": "slice1", "type": "Slice", "bottom": "concat1", "top": ["slice11", "slice12"],
+   "ranges": [[0, 429], [0, 429]]},
+  {"name": "multicross1", "type": "MultiCross", "bottom": "slice11", "top": "multicross1",
+   "mc_param": {"num_layers": 6}},
+  {"name": "fc1", "type": "InnerProduct", "bottom": "slice12", "top": "fc1",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+  {"name": "dropout1", "type": "Dropout", "bottom": "relu1", "top": "dropout1", "rate": 0.5},
+  {"name": "fc2", "type": "InnerProduct", "bottom": "dropout1", "top": "fc2",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu2", "type": "ReLU", "bottom": "fc2", "top": "relu2"},
+  {"name": "dropout2", "type": "Dropout", "bottom": "relu2", "top": "dropout2", "rate": 0.5},
+  {"name": "concat2", "type": "Concat", "bottom": ["dropout2", "multicross1"], "top": "concat2"},
+  {"name": "fc3", "type": "InnerProduct", "bottom": "concat2", "top": "fc3",
+   "fc_param": {"num_output": 1}},
+  {"name": "sigmoid", "type": "Sigmoid", "bottom": "fc3", "top": "sigmoid"}
+])";
+
+// Bottom MLP -> Interaction -> Top MLP
+const char* const dlrm_layers = R"([
+  {"name": "data", "type": "Data"},
+  {"name": "fc1", "type": "InnerProduct", "bottom": "dense", "top": "fc1",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+  {"name": "fc2", "type": "InnerProduct", "bottom": "relu1", "top": "fc2",
+   "fc_param": {"num_output": 128}},
+  {"name": "relu2", "type": "ReLU", "bottom": "fc2", "top": "relu2"},
+  {"name": "fc3", "type": "InnerProduct", "bottom": "relu2", "top": "fc3",
+   "fc_param": {"num_output": 64}},
+  {"name": "relu3", "type": "ReLU", "bottom": "fc3", "top": "relu3"},
+  {"name": "interaction1", "type": "Interaction", "bottom": ["relu3", "sparse_embedding1"],
+   "top": "interaction1"},
+  {"name": "fc4", "type": "InnerProduct", "bottom": "interaction1", "top": "fc4",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu4", "type": "ReLU", "bottom": "fc4", "top": "relu4"},
+  {"name": "fc5", "type": "InnerProduct", "bottom": "relu4", "top": "fc5",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu5", "type": "ReLU", "bottom": "fc5", "top": "relu5"},
+  {"name": "fc6", "type": "InnerProduct", "bottom": "relu5", "top": "fc6",
+   "fc_param": {"num_output": 128}},
+  {"name": "relu6", "type": "ReLU", "bottom": "fc6", "top": "relu6"},
+  {"name": "fc7", "type": "InnerProduct", "bottom": "relu6", "top": "fc7",
+   "fc_param": {"num_output": 1}},
+  {"name": "sigmoid", "type": "Sigmoid", "bottom": "fc7", "top": "sigmoid"}
+])";
+
+// Deep (Reshape -> Concat -> MLP) + wide (Reshape) -> Add
+const char* const wdl_layers = R"([
+  {"name": "data", "type": "Data"},
+  {"name": "reshape1", "type": "Reshape", "bottom": "sparse_embedding1", "top": "reshape1",
+   "leading_dim": 416},
+  {"name": "reshape2", "type": "Reshape", "bottom": "sparse_embedding2", "top": "reshape2",
+   "leading_dim": 1},
+  {"name": "concat1", "type": "Concat", "bottom": ["reshape1", "dense"], "top": "concat1"},
+  {"name": "fc1", "type": "InnerProduct", "bottom": "concat1", "top": "fc1",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+  {"name": "dropout1", "type": "Dropout", "bottom": "relu1", "top": "dropout1", "rate": 0.5},
+  {"name": "fc2", "type": "InnerProduct", "bottom": "dropout1", "top": "fc2",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu2", "type": "ReLU", "bottom": "fc2", "top": "relu2"},
+  {"name": "dropout2", "type": "Dropout", "bottom": "relu2", "top": "dropout2", "rate": 0.5},
+  {"name": "fc3", "type": "InnerProduct", "bottom": "dropout2", "top": "fc3",
+   "fc_param": {"num_output": 1}},
+  {"name": "add1", "type": "Add", "bottom": ["fc3", "reshape2"], "top": "add1"},
+  {"name": "sigmoid", "type": "Sigmoid", "bottom": "add1", "top": "sigmoid"}
+])";
+
+}  // namespace
+
+TEST(cpu_layer_perf_test, int8_gemm) {
+  int8_gemm_perf(256, 429, 1024);
+  int8_gemm_perf(256, 1024, 512);
+}
+TEST(cpu_layer_perf_test, int8_layers) {
+  fully_connected_int8_perf(256, 429, 1024);
+  fully_connected_int8_perf(256, 1024, 512);
+  fused_fully_connected_int8_perf(256, 512, 256);
+  multi_cross_int8_perf(256, 429, 6);
+  multi_cross_int8_perf(1024, 512, 3);
+  multi_cross_int8_perf(1024, 512, 3, 128);
+}
+TEST(cpu_layer_perf_test, embedding_bag) {
+  for (const bool use_hash_map : {false, true}) {
+    embedding_bag_perf(1024, 26, 1, 128, use_hash_map);
+    embedding_bag_perf(1024, 4, 100, 128, use_hash_map);
+    embedding_bag_perf(1024, 4, 100, 16, use_hash_map);
+  }
+}
+TEST(cpu_layer_perf_test, network_optimization) {
+  network_optimization_perf(
+      "DCN", dcn_layers, {{"dense", {batchsize, 13}}, {"sparse_embedding1", {batchsize, 26, 16}}});
+  network_optimization_perf(
+      "DLRM", dlrm_layers,
+      {{"dense", {batchsize, 13}}, {"sparse_embedding1", {batchsize, 26, 64}}});
+  network_optimization_perf("WDL", wdl_layers,
+                            {{"dense", {batchsize, 13}},
+                             {"sparse_embedding1", {batchsize, 26, 16}},
+                             {"sparse_embedding2", {batchsize, 1, 1}}});
+}
@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * HPS database backend benchmarks.
+ *
+ * Measures building blocks of the database backends in isolation, on workloads that are too large
+ * for the unit tests. Results are logged. Correctness is covered by
+ * test/utest/hps/db_backend_test.cpp, and mixed read/write workloads by tools/db_backend_benchmark.
+ *
+ * Cases: bulk fetch, raw dump and load, immutable store lookups, RocksDB lookups, RocksDB bulk
+ * insertion, Redis sync vs async fetch, value codecs, sharded hash map throughput, key filters.
+ * The Redis case expects a cluster at 127.0.0.1:7000-7002.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <hps/hash_map_backend.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/immutable_store_backend.hpp>
+#include <hps/key_filter.hpp>
+#include <hps/mp_hash_map_backend.hpp>
+#include <hps/redis_backend.hpp>
+#include <hps/rocksdb_backend.hpp>
+#include <hps/sharded_hash_map_backend.hpp>
+#include <hps/value_codec.hpp>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Func>
+double time_s(Func&& func) {
+  const auto begin = Clock::now();
+  func();
+  return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+template <typename Key>
+std::unique_ptr<DatabaseBackend<Key>> make_hash_map_backend(const DatabaseType_t database_type,
+                                                            const size_t num_partitions) {
+  // Small allocation rate, so that measurements are not dominated by zeroing empty pages.
+  const size_t allocation_rate = 16 * 1024 * 1024;
+  if (database_type == DatabaseType_t::MultiProcessHashMap) {
+    return std::make_unique<MultiProcessHashMapBackend<Key>>(num_partitions, allocation_rate);
+  }
+  return std::make_unique<HashMapBackend<Key>>(num_partitions, allocation_rate);
+}
+
+// Callback interface vs bulk fetch into a strided buffer. Every other key misses.
+template <typename Key>
+void bulk_fetch_perf(const DatabaseType_t database_type, const size_t num_keys) {
+  const auto db = make_hash_map_backend<Key>(database_type, 16);
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+  const size_t dim = 16;
+  const size_t value_size = dim * sizeof(float);
+  const size_t value_stride = value_size + 2 * sizeof(float);
+  {
+    std::vector<Key> keys;
+    std::vector<float> values;
+    for (size_t i = 0; i < num_keys; i += 2) {
+      keys.emplace_back(static_cast<Key>(i));
+      values.insert(values.end(), dim, static_cast<float>(i));
+    }
+    db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+               value_size);
+  }
+  std::vector<Key> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(i);
+  }
+
+  std::vector<float> cb_values(num_keys * dim);
+  std::vector<size_t> cb_missing;
+  std::mutex cb_missing_guard;
+  const double cb_s = time_s([&]() {
+    db->fetch(
+        tag, num_keys, keys.data(),
+        [&](const size_t index, const char* const value, const size_t size) {
+          memcpy(&cb_values[index * dim], value, size);
+        },
+        [&](const size_t index) {
+          std::lock_guard<std::mutex> lock(cb_missing_guard);
+          cb_missing.emplace_back(index);
+        },
+        std::chrono::nanoseconds::max());
+    std::sort(cb_missing.begin(), cb_missing.end());
+  });
+
+  std::vector<char> bulk_values(num_keys * value_stride);
+  std::vector<size_t> missing;
+  const double bulk_s = time_s([&]() {
+    db->fetch(tag, num_keys, keys.data(), bulk_values.data(), value_size, value_stride, missing,
+              std::chrono::nanoseconds::max());
+  });
+
+  HCTR_LOG_S(INFO, WORLD) << db->get_name() << ", fetch " << num_keys
+                          << " keys: callback " << cb_s * 1e9 / num_keys << " ns/key -> bulk "
+                          << bulk_s * 1e9 / num_keys << " ns/key" << std::endl;
+  db->evict(tag);
+}
+
+// Raw dump, and loading it with the same partitioning (per-partition path), a different one
+// (generic path), and from a version 1 dump.
+template <typename Key>
+void dump_load_perf(const DatabaseType_t database_type, const size_t num_keys) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+  const size_t dim = 32;
+  const size_t value_size = dim * sizeof(float);
+
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(i * 7 + 3);
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+  const double file_mb = static_cast<double>(num_keys * (sizeof(Key) + value_size)) / 1e6;
+  {
+    const auto db = make_hash_map_backend<Key>(database_type, 16);
+    db->insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+               value_size);
+    const double dump_s = time_s([&]() { db->dump(tag, "tbl_perf_v2.bin"); });
+    HCTR_LOG_S(INFO, WORLD) << db->get_name() << ", " << num_keys << " pairs, " << file_mb
+                            << " MB: dump " << file_mb / dump_s << " MB/s" << std::endl;
+    db->evict(tag);
+  }
+  {
+    std::ofstream file{"tbl_perf_v1.bin", std::ios::binary};
+    const char magic[] = "bin";
+    const uint32_t header[] = {1, sizeof(Key), static_cast<uint32_t>(value_size)};
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (size_t i = 0; i < num_keys; i++) {
+      file.write(reinterpret_cast<const char*>(&keys[i]), sizeof(Key));
+      file.write(reinterpret_cast<const char*>(&values[i * dim]), value_size);
+    }
+  }
+
+  const std::vector<std::pair<const char*, size_t>> runs{
+      {"tbl_perf_v2.bin", 16}, {"tbl_perf_v2.bin", 7}, {"tbl_perf_v1.bin", 16}};
+  for (const auto& [path, num_partitions] : runs) {
+    const auto db = make_hash_map_backend<Key>(database_type, num_partitions);
+    const double load_s = time_s([&]() { db->load_dump(tag, path); });
+    HCTR_LOG_S(INFO, WORLD) << db->get_name() << ", load " << path << " into " << num_partitions
+                            << " partitions: " << file_mb / load_s << " MB/s" << std::endl;
+    db->evict(tag);
+  }
+  std::filesystem::remove("tbl_perf_v2.bin");
+  std::filesystem::remove("tbl_perf_v1.bin");
+}
+
+// Random lookups of half known, half unknown keys, in the immutable store vs the backend it is
+// built from.
+template <typename Key>
+void immutable_store_perf(const DatabaseType_t baseline_type, const size_t num_keys) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+  const std::string path = "immutable_store_perf";
+  const size_t dim = 16;
+  const size_t value_size = dim * sizeof(float);
+  std::filesystem::remove_all(path);
+
+  // Half of the keys are dense, the other half is scattered across the entire key space.
+  std::mt19937_64 gen{42};
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = i % 2 ? static_cast<Key>(gen()) : static_cast<Key>(i / 2);
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+  std::vector<Key> query;
+  query.reserve(num_keys * 2);
+  for (size_t i = 0; i < num_keys; i++) {
+    query.emplace_back(keys[i]);
+    query.emplace_back(static_cast<Key>(num_keys + i * 3 + 1));
+  }
+  std::shuffle(query.begin(), query.end(), gen);
+
+  std::unique_ptr<DatabaseBackend<Key>> baseline;
+  if (baseline_type == DatabaseType_t::RocksDB) {
+    baseline = std::make_unique<RocksDBBackend<Key>>("/hugectr/Test_Data/rockdb");
+  } else {
+    baseline = make_hash_map_backend<Key>(baseline_type, 16);
+  }
+  auto db = std::make_unique<ImmutableStoreBackend<Key>>(path);
+  const std::vector<DatabaseBackend<Key>*> backends{baseline.get(), db.get()};
+  for (DatabaseBackend<Key>* const backend : backends) {
+    backend->insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                    value_size);
+  }
+
+  std::vector<float> fetched(query.size() * dim);
+  std::vector<size_t> missing;
+  for (DatabaseBackend<Key>* const backend : backends) {
+    missing.clear();
+    const double fetch_s = time_s([&]() {
+      backend->fetch(tag, query.size(), query.data(), reinterpret_cast<char*>(fetched.data()),
+                     value_size, value_size, missing, std::chrono::nanoseconds::max());
+    });
+    HCTR_LOG_S(INFO, WORLD) << backend->get_name() << ", " << query.size()
+                            << " lookups: " << query.size() / fetch_s / 1e6 << " M keys/s"
+                            << std::endl;
+  }
+
+  baseline->evict(tag);
+  db.reset();
+  std::filesystem::remove_all(path);
+}
+
+// Random lookups in a reopened RocksDB, half of which miss. The first pass starts with a cold block
+// cache, the second one finds it warm.
+template <typename Key>
+void rocksdb_fetch_perf(const size_t block_cache_size, const double bloom_filter_bits,
+                        const bool partitioned_index, const DatabaseCompression_t compression,
+                        const size_t num_keys) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "hctr_rocksdb_fetch_perf").string();
+  const size_t dim = 32;
+  const size_t value_size = dim * sizeof(float);
+  std::filesystem::remove_all(path);
+
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(i * 3);
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+  {
+    RocksDBBackend<Key> db(path, 16, false, 64L * 1024L, 64L * 1024L, block_cache_size,
+                           bloom_filter_bits, partitioned_index, compression);
+    db.insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+              value_size);
+  }
+  std::vector<Key> query;
+  query.reserve(num_keys * 2);
+  for (size_t i = 0; i < num_keys; i++) {
+    query.emplace_back(keys[i]);
+    query.emplace_back(keys[i] + 1);
+  }
+  std::shuffle(query.begin(), query.end(), std::mt19937_64{42});
+
+  RocksDBBackend<Key> db(path, 16, true, 64L * 1024L, 64L * 1024L, block_cache_size,
+                         bloom_filter_bits, partitioned_index, compression);
+  std::vector<float> fetched(query.size() * dim);
+  std::vector<size_t> missing;
+  double fetch_s[2];
+  for (double& s : fetch_s) {
+    missing.clear();
+    s = time_s([&]() {
+      db.fetch(tag, query.size(), query.data(), reinterpret_cast<char*>(fetched.data()),
+               value_size, value_size, missing, std::chrono::nanoseconds::max());
+    });
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << query.size() << " lookups, block cache: " << block_cache_size
+                          << " bytes, bloom filter: " << bloom_filter_bits
+                          << " bits/key, partitioned index: " << partitioned_index
+                          << ", compression: " << compression
+                          << "; cold: " << query.size() / fetch_s[0] / 1e6
+                          << " M keys/s, warm: " << query.size() / fetch_s[1] / 1e6 << " M keys/s"
+                          << std::endl;
+  std::filesystem::remove_all(path);
+}
+
+// Insertion of random keys with duplicates into an empty RocksDB table (bulk ingestion) vs a
+// non-empty one (batched writes).
+template <typename Key>
+void rocksdb_bulk_insert_perf(const size_t num_keys) {
+  const std::string tag0 = HierParameterServerBase::make_tag_name("mdl", "tbl0");
+  const std::string tag1 = HierParameterServerBase::make_tag_name("mdl", "tbl1");
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "hctr_rocksdb_bulk_insert_perf").string();
+  const size_t dim = 16;
+  const size_t value_size = dim * sizeof(float);
+  std::filesystem::remove_all(path);
+
+  std::mt19937_64 gen{42};
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(gen() % (num_keys * 2));
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+
+  {
+    RocksDBBackend<Key> db(path);
+    const double bulk_s = time_s([&]() {
+      db.insert(tag0, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                value_size);
+    });
+    db.insert(tag1, 1, keys.data(), reinterpret_cast<const char*>(values.data()), value_size);
+    const double batch_s = time_s([&]() {
+      db.insert(tag1, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                value_size);
+    });
+    HCTR_LOG_S(INFO, WORLD) << num_keys << " pairs, bulk insert: " << bulk_s
+                            << " s, batched insert: " << batch_s << " s" << std::endl;
+  }
+  std::filesystem::remove_all(path);
+}
+
+// Latency and throughput of a stream of random requests against a Redis cluster, fetched without
+// and with pipelining the partitions. Roughly every other key misses.
+template <typename Key>
+void redis_async_fetch_perf(const size_t num_partitions, const size_t batch_size,
+                            const size_t num_keys, const size_t num_requests) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "async_fetch_perf");
+  const std::string address = "127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002";
+  const size_t dim = 32;
+  const size_t value_size = dim * sizeof(float);
+
+  RedisClusterBackend<Key> sync_db(address, "default", "", num_partitions, 5, 64L * 1024L,
+                                   64L * 1024L, false);
+  RedisClusterBackend<Key> async_db(address, "default", "", num_partitions, 5, 64L * 1024L,
+                                    64L * 1024L, true);
+  sync_db.evict(tag);
+  {
+    std::vector<Key> keys(num_keys);
+    std::vector<float> values(num_keys * dim);
+    for (size_t i = 0; i < num_keys; i++) {
+      keys[i] = static_cast<Key>(i * 2);
+      std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+    }
+    sync_db.insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                   value_size);
+  }
+
+  std::mt19937_64 gen{42};
+  std::vector<std::vector<Key>> requests(num_requests, std::vector<Key>(batch_size));
+  for (std::vector<Key>& request : requests) {
+    for (Key& k : request) {
+      k = static_cast<Key>(gen() % (num_keys * 2));
+    }
+  }
+
+  std::vector<float> values(batch_size * dim);
+  std::vector<size_t> missing;
+  for (DatabaseBackend<Key>* const db : {&sync_db, &async_db}) {
+    std::vector<double> latencies_us;
+    latencies_us.reserve(num_requests);
+    const double total_s = time_s([&]() {
+      for (const std::vector<Key>& request : requests) {
+        missing.clear();
+        latencies_us.emplace_back(1e6 * time_s([&]() {
+          db->fetch(tag, batch_size, request.data(), reinterpret_cast<char*>(values.data()),
+                    value_size, value_size, missing, std::chrono::nanoseconds::max());
+        }));
+      }
+    });
+    std::sort(latencies_us.begin(), latencies_us.end());
+    HCTR_LOG_S(INFO, WORLD) << num_requests << " requests x " << batch_size << " keys, "
+                            << num_partitions << " partitions, "
+                            << (db == &async_db ? "async" : "sync")
+                            << ": p50: " << latencies_us[num_requests / 2]
+                            << " us, p99: " << latencies_us[num_requests * 99 / 100]
+                            << " us, throughput: " << num_requests * batch_size / total_s / 1e6
+                            << " M keys/s" << std::endl;
+  }
+  sync_db.evict(tag);
+}
+
+// Size, precision and encode / decode throughput of a value codec, on normally distributed
+// embeddings with a few outliers.
+void value_codec_perf(const DatabaseValueCodec_t codec, const size_t num_keys) {
+  const size_t dim = 128;
+  const size_t value_size = value_codec_size(codec, dim);
+
+  std::mt19937 gen(4711);
+  std::normal_distribution<float> dist(0.f, 0.05f);
+  std::vector<float> values(num_keys * dim);
+  std::generate(values.begin(), values.end(), [&]() { return dist(gen); });
+  for (size_t i = 0; i < num_keys; i += 97) {
+    values[i * dim + i % dim] = 4.f;
+  }
+
+  std::vector<char> encoded(num_keys * value_size);
+  const double encode_s =
+      time_s([&]() { encode_values(codec, num_keys, dim, values.data(), encoded.data()); });
+  std::vector<float> decoded(num_keys * dim);
+  const double decode_s =
+      time_s([&]() { decode_values(codec, num_keys, dim, encoded.data(), decoded.data()); });
+
+  double max_error = 0;
+  for (size_t i = 0; i < values.size(); i++) {
+    max_error = std::max(max_error, std::abs(static_cast<double>(values[i]) - decoded[i]));
+  }
+  const double mb = static_cast<double>(values.size() * sizeof(float)) / 1e6;
+  HCTR_LOG_S(INFO, WORLD) << codec << ": " << value_size << " bytes / vector ("
+                          << static_cast<double>(dim * sizeof(float)) / value_size
+                          << "x smaller), max error: " << max_error << ", encode: "
+                          << mb / encode_s << " MB/s, decode: " << mb / decode_s << " MB/s"
+                          << std::endl;
+}
+
+// Batched insertion of consecutive keys, then batched lookups in random order.
+void sharded_throughput_perf(const DatabaseType_t database_type, const bool numa_aware,
+                             const size_t num_keys) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "throughput");
+  const size_t batch_size = 16384;
+  const size_t dim = 64;
+  const size_t value_size = dim * sizeof(float);
+  const size_t allocation_rate = 16 * 1024 * 1024;
+
+  std::unique_ptr<DatabaseBackend<long long>> db;
+  if (database_type == DatabaseType_t::ShardedHashMap) {
+    db = std::make_unique<ShardedHashMapBackend<long long>>(16, numa_aware, allocation_rate);
+  } else {
+    db = make_hash_map_backend<long long>(database_type, 16);
+  }
+
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0LL);
+  std::vector<char> values(num_keys * value_size, 1);
+  const double insert_s = time_s([&]() {
+    for (size_t i = 0; i < num_keys; i += batch_size) {
+      const size_t n = std::min(batch_size, num_keys - i);
+      db->insert(tag, n, &keys[i], &values[i * value_size], value_size);
+    }
+  });
+
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64{4711});
+  std::vector<char> fetched(batch_size * value_size);
+  std::vector<size_t> missing;
+  const double fetch_s = time_s([&]() {
+    for (size_t i = 0; i < num_keys; i += batch_size) {
+      const size_t n = std::min(batch_size, num_keys - i);
+      db->fetch(tag, n, &keys[i], fetched.data(), value_size, value_size, missing,
+                std::chrono::nanoseconds::max());
+    }
+  });
+
+  const double mb = static_cast<double>(num_keys * value_size) / 1e6;
+  HCTR_LOG_S(INFO, WORLD) << db->get_name() << " (numa_aware = " << numa_aware << "): insert "
+                          << mb / insert_s << " MB/s, fetch " << mb / fetch_s << " MB/s"
+                          << std::endl;
+  db->evict(tag);
+}
+
+// Size, false positive rate and insert / query rates of a key filter. Queries only use keys that
+// were never inserted.
+void key_filter_perf(const double bits_per_key, const size_t num_keys) {
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0LL);
+  KeyFilter filter(num_keys, bits_per_key);
+  const double insert_s = time_s([&]() { filter.insert(keys.size(), keys.data()); });
+
+  size_t num_false_positives = 0;
+  const double query_s = time_s([&]() {
+    for (long long k = num_keys; k < static_cast<long long>(2 * num_keys); k++) {
+      num_false_positives += filter.may_contain(k);
+    }
+  });
+
+  HCTR_LOG_S(INFO, WORLD) << "Bits per key: " << bits_per_key << ", size: "
+                          << filter.size_in_bytes() << " bytes, false positive rate: "
+                          << static_cast<double>(num_false_positives) / num_keys
+                          << " (expected: " << filter.expected_false_positive_rate()
+                          << "), insert: " << num_keys / insert_s / 1e6
+                          << " M keys/s, query: " << num_keys / query_s / 1e6 << " M keys/s"
+                          << std::endl;
+}
+
+}  // namespace
+
+TEST(db_backend_perf_test, bulk_fetch) {
+  bulk_fetch_perf<long long>(DatabaseType_t::ParallelHashMap, 2000000);
+  bulk_fetch_perf<long long>(DatabaseType_t::MultiProcessHashMap, 2000000);
+}
+TEST(db_backend_perf_test, dump_load) {
+  dump_load_perf<long long>(DatabaseType_t::ParallelHashMap, 2000000);
+  dump_load_perf<long long>(DatabaseType_t::MultiProcessHashMap, 200000);
+}
+TEST(db_backend_perf_test, immutable_store) {
+  immutable_store_perf<long long>(DatabaseType_t::ParallelHashMap, 1000000);
+  immutable_store_perf<long long>(DatabaseType_t::RocksDB, 1000000);
+}
+TEST(db_backend_perf_test, rocksdb_fetch) {
+  const size_t num_keys = 1000000;
+  rocksdb_fetch_perf<long long>(256L * 1024L * 1024L, 10, false, DatabaseCompression_t::Snappy,
+                                num_keys);
+  rocksdb_fetch_perf<long long>(256L * 1024L * 1024L, 10, true, DatabaseCompression_t::Snappy,
+                                num_keys);
+  rocksdb_fetch_perf<long long>(256L * 1024L * 1024L, 0, false, DatabaseCompression_t::None,
+                                num_keys);
+  rocksdb_fetch_perf<long long>(8L * 1024L * 1024L, 10, false, DatabaseCompression_t::LZ4,
+                                num_keys);
+}
+TEST(db_backend_perf_test, rocksdb_bulk_insert) { rocksdb_bulk_insert_perf<long long>(4000000); }
+TEST(db_backend_perf_test, redis_async_fetch) {
+  redis_async_fetch_perf<long long>(8, 1024, 1000000, 500);
+  redis_async_fetch_perf<long long>(8, 32 * 1024, 1000000, 500);
+  redis_async_fetch_perf<long long>(64, 32 * 1024, 1000000, 500);
+}
+TEST(db_backend_perf_test, value_codec) {
+  for (const DatabaseValueCodec_t codec :
+       {DatabaseValueCodec_t::Float32, DatabaseValueCodec_t::Float16,
+        DatabaseValueCodec_t::BFloat16, DatabaseValueCodec_t::Int8}) {
+    value_codec_perf(codec, 200000);
+  }
+}
+TEST(db_backend_perf_test, sharded_throughput) {
+  sharded_throughput_perf(DatabaseType_t::ParallelHashMap, false, 1000000);
+  sharded_throughput_perf(DatabaseType_t::ShardedHashMap, false, 1000000);
+  sharded_throughput_perf(DatabaseType_t::ShardedHashMap, true, 1000000);
+}
+TEST(db_backend_perf_test, key_filter) {
+  for (const double bits_per_key : {8., 10., 16.}) {
+    key_filter_perf(bits_per_key, 1000000);
+  }
+}
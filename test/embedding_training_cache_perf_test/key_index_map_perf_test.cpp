@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <embedding_training_cache/key_index_map.hpp>
+#include <embedding_training_cache/sparse_model_file.hpp>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename TypeKey>
+std::vector<TypeKey> generate_unique_keys(const size_t num_keys) {
+  std::vector<TypeKey> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::mt19937 gen(42);
+  // Spread the keys so that they do not form a single dense range.
+  for (auto& key : keys) {
+    key = key * 64 + static_cast<TypeKey>(gen() % 64);
+  }
+  std::shuffle(keys.begin(), keys.end(), gen);
+  return keys;
+}
+
+template <typename TypeKey>
+void key_index_map_perf_test(const size_t num_keys) {
+  using Clock = std::chrono::steady_clock;
+  auto elapsed_ms = [](const Clock::time_point& begin) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+  };
+
+  const std::vector<TypeKey> keys = generate_unique_keys<TypeKey>(num_keys);
+  std::vector<TypeKey> query_keys(keys);
+  std::shuffle(query_keys.begin(), query_keys.end(), std::mt19937(1337));
+
+  // Baseline: node-based map, as previously used by SparseModelFile.
+  double std_build_ms, std_lookup_ms;
+  size_t std_checksum = 0;
+  {
+    auto begin = Clock::now();
+    std::unordered_map<TypeKey, std::pair<size_t, size_t>> map;
+    for (size_t i = 0; i < num_keys; i++) {
+      map.insert({keys[i], {0, i}});
+    }
+    std_build_ms = elapsed_ms(begin);
+
+    begin = Clock::now();
+#pragma omp parallel for reduction(+ : std_checksum)
+    for (size_t i = 0; i < num_keys; i++) {
+      std_checksum += map.find(query_keys[i])->second.second;
+    }
+    std_lookup_ms = elapsed_ms(begin);
+  }
+
+  double flat_build_ms, flat_lookup_ms;
+  size_t flat_checksum = 0;
+  size_t flat_memory;
+  {
+    std::vector<SlotIndex> values(num_keys);
+    for (size_t i = 0; i < num_keys; i++) {
+      values[i] = {0, i};
+    }
+
+    auto begin = Clock::now();
+    KeyIndexMap<TypeKey, SlotIndex> map;
+    map.bulk_insert(num_keys, keys.data(), values.data());
+    flat_build_ms = elapsed_ms(begin);
+    flat_memory = map.memory_usage();
+
+    begin = Clock::now();
+#pragma omp parallel for reduction(+ : flat_checksum)
+    for (size_t i = 0; i < num_keys; i++) {
+      flat_checksum += map.find(query_keys[i])->second.second;
+    }
+    flat_lookup_ms = elapsed_ms(begin);
+  }
+
+  ASSERT_EQ(std_checksum, flat_checksum);
+  HCTR_LOG_S(INFO, ROOT) << num_keys << " keys, build: std::unordered_map " << std_build_ms
+                         << " ms, KeyIndexMap " << flat_build_ms << " ms; lookup: "
+                         << "std::unordered_map " << std_lookup_ms << " ms, KeyIndexMap "
+                         << flat_lookup_ms << " ms; KeyIndexMap memory: "
+                         << static_cast<double>(flat_memory) / num_keys << " bytes/key"
+                         << std::endl;
+}
+
+}  // namespace
+
+TEST(key_index_map_perf_test, long_long_10M) { key_index_map_perf_test<long long>(10000000); }
+TEST(key_index_map_perf_test, unsigned_10M) { key_index_map_perf_test<unsigned>(10000000); }
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ETC parameter server benchmark.
+ *
+ * Emulates the pass switches of the embedding training cache on the CPU only: Push the previous
+ * pass, then load and pull the next one. Reports how long training waits for the parameter server
+ * at each pass switch, with and without prefetching the next pass. Correctness is covered by
+ * test/utest/embedding_training_cache/parameter_server_test.cu.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <embedding_training_cache/parameter_server.hpp>
+#include <filesystem>
+#include <fstream>
+#include <general_buffer2.hpp>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const sparse_model = "./etc_perf_sparse_model";
+const size_t emb_vec_size = 32;
+const size_t num_passes = 8;
+
+/**
+ * Single process without GPU or CPU resources. The parameter server only asks for the process
+ * layout.
+ */
+class HostResourceManager final : public ResourceManager {
+  const std::shared_ptr<CPUResource> cpu_;
+  const std::shared_ptr<GPUResource> gpu_;
+  const std::vector<int> device_ids_;
+  const std::vector<std::shared_ptr<GPUResource>> gpus_;
+  const std::shared_ptr<rmm::mr::device_memory_resource> memory_resource_;
+
+ public:
+  void set_local_gpu(std::shared_ptr<GPUResource>, size_t) override {}
+  const std::shared_ptr<GPUResource>& get_local_gpu(size_t) const override { return gpu_; }
+  const std::shared_ptr<GPUResource>& get_local_gpu_from_device_id(size_t) const override {
+    return gpu_;
+  }
+  size_t get_local_gpu_count() const override { return 1; }
+  size_t get_global_gpu_count() const override { return 1; }
+
+  int get_num_process() const override { return 1; }
+  int get_process_id() const override { return 0; }
+  int get_master_process_id() const override { return 0; }
+  bool is_master_process() const override { return true; }
+  const std::shared_ptr<CPUResource>& get_local_cpu() const override { return cpu_; }
+  const std::vector<int>& get_local_gpu_device_id_list() const override { return device_ids_; }
+  const std::vector<std::shared_ptr<GPUResource>>& get_local_gpus() const override {
+    return gpus_;
+  }
+  int get_process_id_from_gpu_global_id(size_t) const override { return 0; }
+  size_t get_gpu_local_id_from_global_id(size_t) const override { return 0; }
+  size_t get_gpu_global_id_from_local_id(size_t) const override { return 0; }
+  bool p2p_enabled(int, int) const override { return false; }
+  bool all_p2p_enabled() const override { return false; }
+  DeviceMap::Layout get_device_layout() const override { return DeviceMap::LOCAL_FIRST; }
+  const std::shared_ptr<rmm::mr::device_memory_resource>& get_device_rmm_device_memory_resource(
+      int) const override {
+    return memory_resource_;
+  }
+
+#ifdef ENABLE_MPI
+  void init_ib_comm() override {}
+  IbComm* get_ib_comm() const override { return nullptr; }
+  void set_ready_to_transfer() override {}
+#endif
+  void set_ar_comm(AllReduceAlgo, bool) override {}
+  AllReduceInPlaceComm* get_ar_comm() const override { return nullptr; }
+};
+
+void write_file(const std::string& path, const void* data, const size_t size) {
+  std::ofstream ofs(path, std::ofstream::binary | std::ofstream::trunc);
+  ofs.write(reinterpret_cast<const char*>(data), size);
+}
+
+/**
+ * Sparse model with keys [0, num_keys), and the Adam states of each key.
+ */
+void create_sparse_model(const size_t num_keys) {
+  std::filesystem::remove_all(sparse_model);
+  std::filesystem::create_directories(sparse_model);
+
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0LL);
+  write_file(std::string(sparse_model) + "/key", keys.data(), keys.size() * sizeof(long long));
+  const std::vector<size_t> slot_ids(num_keys, 0);
+  write_file(std::string(sparse_model) + "/slot_id", slot_ids.data(),
+             slot_ids.size() * sizeof(size_t));
+  const std::vector<float> vecs(num_keys * emb_vec_size, 0.f);
+  for (const char* const file : {"emb_vector", "Adam.m", "Adam.v"}) {
+    write_file(std::string(sparse_model) + "/" + file, vecs.data(), vecs.size() * sizeof(float));
+  }
+}
+
+BufferBag create_buffer_bag(const size_t capacity) {
+  BufferBag buf_bag;
+  const auto blobs_buff = GeneralBuffer2<HostAllocator>::create();
+  buf_bag.opt_states.resize(OptParams::num_parameters_per_weight(Optimizer_t::Adam));
+
+  Tensor2<long long> keys;
+  Tensor2<size_t> slot_ids;
+  blobs_buff->reserve({capacity}, &keys);
+  blobs_buff->reserve({capacity}, &slot_ids);
+  blobs_buff->reserve({capacity, emb_vec_size}, &buf_bag.embedding);
+  for (Tensor2<float>& opt_state : buf_bag.opt_states) {
+    blobs_buff->reserve({capacity, emb_vec_size}, &opt_state);
+  }
+  blobs_buff->allocate();
+
+  buf_bag.keys = keys.shrink();
+  buf_bag.slot_id = slot_ids.shrink();
+  return buf_bag;
+}
+
+/**
+ * Each pass covers 2 / num_passes of the model, overlapping half of the previous pass, plus keys
+ * that are new to the model. Training takes train_time per pass.
+ */
+void parameter_server_perf_test(const TrainPSType_t ps_type, const size_t num_keys,
+                                const size_t num_new_keys,
+                                const std::chrono::milliseconds train_time) {
+  const size_t pass_stride = num_keys / num_passes;
+  std::vector<std::string> keyset_files(num_passes);
+  size_t max_keyset_size = 0;
+  for (size_t pass = 0; pass < num_passes; pass++) {
+    const size_t begin = pass * pass_stride;
+    const size_t end = std::min(begin + 2 * pass_stride, num_keys);
+    std::vector<long long> keyset(end - begin);
+    std::iota(keyset.begin(), keyset.end(), static_cast<long long>(begin));
+    for (size_t i = 0; i < num_new_keys; i++) {
+      keyset.push_back(static_cast<long long>(num_keys + pass * num_new_keys + i));
+    }
+    max_keyset_size = std::max(max_keyset_size, keyset.size());
+    keyset_files[pass] = "etc_perf_keyset_" + std::to_string(pass) + ".bin";
+    write_file(keyset_files[pass], keyset.data(), keyset.size() * sizeof(long long));
+  }
+
+  const auto resource_manager = std::make_shared<HostResourceManager>();
+  BufferBag buf_bag = create_buffer_bag(max_keyset_size);
+  long long* const key_ptr = Tensor2<long long>::stretch_from(buf_bag.keys).get_ptr();
+  size_t* const slot_id_ptr = Tensor2<size_t>::stretch_from(buf_bag.slot_id).get_ptr();
+  HMemCacheConfig hc_config(1, 0.5, 0);
+  hc_config.block_capacity = max_keyset_size;
+
+  for (const bool use_prefetch : {false, true}) {
+    create_sparse_model(num_keys);
+    ParameterServer<long long> parameter_server(ps_type, sparse_model,
+                                                Embedding_t::LocalizedSlotSparseEmbeddingHash,
+                                                Optimizer_t::Adam, emb_vec_size, resource_manager,
+                                                "./", hc_config);
+
+    std::vector<double> stall_ms;
+    size_t num_pulled = 0;
+    for (size_t pass = 0; pass < num_passes; pass++) {
+      const auto begin = Clock::now();
+      if (pass > 0) {
+        parameter_server.push(buf_bag, num_pulled);
+      }
+      parameter_server.load_keyset_from_file(keyset_files[pass]);
+      parameter_server.pull(buf_bag, num_pulled);
+      stall_ms.emplace_back(
+          std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+
+      if (use_prefetch && pass + 1 < num_passes) {
+        parameter_server.prefetch(keyset_files[pass + 1]);
+      }
+
+      // Train: The embedding creates the keys that were not pulled, and updates all vectors.
+      std::unordered_set<long long> pulled_keys(key_ptr, key_ptr + num_pulled);
+      size_t num_train = num_pulled;
+      for (long long key = num_keys + pass * num_new_keys;
+           key < static_cast<long long>(num_keys + (pass + 1) * num_new_keys); key++) {
+        if (pulled_keys.find(key) == pulled_keys.end()) {
+          key_ptr[num_train] = key;
+          slot_id_ptr[num_train] = 0;
+          num_train++;
+        }
+      }
+      std::fill_n(buf_bag.embedding.get_ptr(), num_train * emb_vec_size, 1.f);
+      std::this_thread::sleep_for(train_time);
+      num_pulled = num_train;
+    }
+    parameter_server.push(buf_bag, num_pulled);
+    parameter_server.sync();
+
+    // The first pass cannot be prefetched.
+    const double mean_stall_ms =
+        std::accumulate(stall_ms.begin() + 1, stall_ms.end(), 0.) / (num_passes - 1);
+    std::ostringstream os;
+    for (size_t pass = 1; pass < num_passes; pass++) {
+      os << ' ' << stall_ms[pass];
+    }
+    HCTR_LOG_S(INFO, ROOT) << (ps_type == TrainPSType_t::Staged ? "Staged" : "Cached") << ", "
+                           << num_keys << " keys, prefetch=" << use_prefetch
+                           << ": stall per pass switch " << mean_stall_ms << " ms (ms:"
+                           << os.str() << ')' << std::endl;
+  }
+
+  std::filesystem::remove_all(sparse_model);
+  for (const std::string& keyset_file : keyset_files) {
+    std::filesystem::remove(keyset_file);
+  }
+}
+
+}  // namespace
+
+TEST(parameter_server_perf_test, staged_2M) {
+  parameter_server_perf_test(TrainPSType_t::Staged, 2000000, 10000, std::chrono::seconds{1});
+}
+TEST(parameter_server_perf_test, cached_2M) {
+  parameter_server_perf_test(TrainPSType_t::Cached, 2000000, 10000, std::chrono::seconds{1});
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <base/debug/async_log_sink.hpp>
+#include <base/debug/logger.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int num_evaluations = 0;
+
+int evaluate() { return ++num_evaluations; }
+
+template <typename Function>
+double ns_per_call(const size_t num_calls, const Function& function) {
+  const auto begin = Clock::now();
+  for (size_t i = 0; i < num_calls; i++) {
+    function(i);
+  }
+  return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / num_calls;
+}
+
+}  // namespace
+
+TEST(logger, disabled_level_does_not_evaluate_arguments) {
+  if (Logger::get().is_enabled(LOG_LEVEL(TRACE), true)) {
+    GTEST_SKIP() << "TRACE level is enabled.";
+  }
+  num_evaluations = 0;
+  HCTR_LOG_S(TRACE, WORLD) << "value " << evaluate() << std::endl;
+  HCTR_LOG(TRACE, WORLD, "value %d\n", evaluate());
+  HCTR_PRINT(TRACE, "value %d\n", evaluate());
+  EXPECT_EQ(num_evaluations, 0);
+
+  if (Logger::get().is_enabled(LOG_LEVEL(INFO), true)) {
+    HCTR_LOG_S(INFO, WORLD) << "value " << evaluate() << std::endl;
+    EXPECT_EQ(num_evaluations, 1);
+  }
+}
+
+TEST(logger, async_sink_keeps_order) {
+  const size_t num_threads = 4;
+  const size_t num_messages = 10000;
+
+  std::vector<std::string> written;
+  size_t num_pushed = 0;
+  {
+    AsyncLogSink sink(
+        1024, [&](int, const std::string& message) { written.emplace_back(message); }, []() {});
+
+    std::atomic<size_t> num_accepted{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < num_messages; i++) {
+          if (sink.push(LOG_INFO_LEVEL, std::to_string(t) + ' ' + std::to_string(i))) {
+            num_accepted++;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    sink.flush();
+    num_pushed = num_accepted;
+    EXPECT_EQ(written.size(), num_pushed);
+    EXPECT_EQ(num_pushed + sink.get_num_dropped(), num_threads * num_messages);
+  }
+  ASSERT_EQ(written.size(), num_pushed);
+
+  // Messages of each thread must arrive in order.
+  std::vector<long> last(num_threads, -1);
+  for (const std::string& message : written) {
+    size_t t;
+    long i;
+    ASSERT_EQ(sscanf(message.c_str(), "%zu %ld", &t, &i), 2);
+    ASSERT_LT(t, num_threads);
+    EXPECT_GT(i, last[t]);
+    last[t] = i;
+  }
+}
+
+TEST(logger, async_sink_drops_instead_of_blocking) {
+  std::atomic<bool> blocked{true};
+  size_t num_written = 0;
+  AsyncLogSink sink(
+      4,
+      [&](int, const std::string&) {
+        while (blocked) {
+          std::this_thread::yield();
+        }
+        num_written++;
+      },
+      []() {});
+
+  size_t num_pushed = 0;
+  for (size_t i = 0; i < 100; i++) {
+    num_pushed += sink.push(LOG_INFO_LEVEL, "message\n");
+  }
+  EXPECT_LT(num_pushed, 100);
+  EXPECT_EQ(num_pushed + sink.get_num_dropped(), 100);
+
+  blocked = false;
+  sink.flush();
+  EXPECT_EQ(num_written, num_pushed);
+}
+
+// Per-call cost of a filtered log statement, and of an enabled one. Enabled statements are written
+// synchronously, or by the asynchronous sink if HUGECTR_LOG_ASYNC=1 is set.
+TEST(logger, call_cost) {
+  if (!Logger::get().is_enabled(LOG_LEVEL(TRACE), true)) {
+    const double filtered_ns = ns_per_call(200000, [](const size_t i) {
+      HCTR_LOG_S(TRACE, WORLD) << "HashMap backend; batch " << i << ": " << evaluate() << " hits."
+                               << std::endl;
+    });
+    std::cout << "filtered HCTR_LOG_S: " << filtered_ns << " ns/call" << std::endl;
+  }
+  if (!Logger::get().is_enabled(LOG_LEVEL(INFO), true)) {
+    return;
+  }
+
+  // Messages go to stdout, which is redirected to /dev/null meanwhile. Fewer calls than the
+  // asynchronous sink can queue, so that no message is dropped.
+  fflush(stdout);
+  const int stdout_fd = dup(fileno(stdout));
+  ASSERT_NE(stdout_fd, -1);
+  const int null_fd = open("/dev/null", O_WRONLY);
+  ASSERT_NE(null_fd, -1);
+  dup2(null_fd, fileno(stdout));
+
+  const double enabled_ns = ns_per_call(10000, [](const size_t i) {
+    HCTR_LOG_S(INFO, WORLD) << "HashMap backend; Table t, partition 0, batch " << i
+                            << ": 1024 / 1024 hits. Time: 12345 / 1000000 ns." << std::endl;
+  });
+  Logger::get().flush();
+
+  fflush(stdout);
+  dup2(stdout_fd, fileno(stdout));
+  close(stdout_fd);
+  close(null_fd);
+
+  const char* const async_str = std::getenv("HUGECTR_LOG_ASYNC");
+  const bool async = async_str != nullptr && std::atoi(async_str) > 0;
+  std::cout << "enabled HCTR_LOG_S, " << (async ? "asynchronous" : "synchronous")
+            << " write: " << enabled_ns << " ns/call" << std::endl;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <base/debug/logger.hpp>
+#include <base/debug/tracer.hpp>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void traced_function() {
+  HCTR_TRACE_SCOPE("test", "outer");
+  {
+    HCTR_TRACE_SCOPE("test", "inner");
+    std::this_thread::sleep_for(std::chrono::microseconds{100});
+  }
+}
+
+nlohmann::json parse_trace() {
+  std::stringstream ss;
+  Tracer::get().write_chrome_trace(ss);
+  return nlohmann::json::parse(ss.str());
+}
+
+}  // namespace
+
+TEST(tracer, disabled_records_nothing) {
+  Tracer& tracer = Tracer::get();
+  tracer.set_enabled(false);
+  tracer.clear();
+  traced_function();
+  EXPECT_EQ(tracer.get_num_events(), 0);
+}
+
+#ifndef HCTR_DISABLE_TRACING
+
+TEST(tracer, chrome_trace_export) {
+  Tracer& tracer = Tracer::get();
+  tracer.clear();
+  tracer.set_enabled(true);
+
+  const size_t num_threads = 4;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([t]() {
+      hctr_set_thread_name("worker #" + std::to_string(t));
+      traced_function();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const int64_t begin = HCTR_TRACE_NOW();
+  HCTR_TRACE_RECORD("test", "interval", begin);
+  tracer.set_enabled(false);
+  EXPECT_EQ(tracer.get_num_events(), 2 * num_threads + 1);
+
+  const nlohmann::json trace = parse_trace();
+  size_t num_spans = 0;
+  size_t num_thread_names = 0;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] == "M") {
+      EXPECT_EQ(event["name"], "thread_name");
+      num_thread_names += event["args"]["name"].get<std::string>().rfind("worker #", 0) == 0;
+      continue;
+    }
+    EXPECT_EQ(event["ph"], "X");
+    EXPECT_EQ(event["cat"], "test");
+    EXPECT_GE(event["dur"].get<double>(), 0);
+    if (event["name"] == "inner") {
+      EXPECT_GE(event["dur"].get<double>(), 100);
+    }
+    num_spans++;
+  }
+  EXPECT_EQ(num_spans, 2 * num_threads + 1);
+  EXPECT_EQ(num_thread_names, num_threads);
+
+  tracer.clear();
+  EXPECT_EQ(tracer.get_num_events(), 0);
+}
+
+#else
+
+TEST(tracer, compiled_out_records_nothing) {
+  Tracer& tracer = Tracer::get();
+  tracer.clear();
+  tracer.set_enabled(true);
+  traced_function();
+  tracer.set_enabled(false);
+  EXPECT_EQ(tracer.get_num_events(), 0);
+}
+
+#endif
+
+TEST(tracer, interned_names) {
+  Tracer& tracer = Tracer::get();
+  const char* const name = tracer.intern(std::string("layer ") + "fc1");
+  EXPECT_EQ(std::string(name), "layer fc1");
+  EXPECT_EQ(tracer.intern("layer fc1"), name);
+}
+
+// Per-span cost while tracing is disabled and enabled. The bounds are loose, so that they also hold
+// for unoptimized builds.
+TEST(tracer, span_cost) {
+  Tracer& tracer = Tracer::get();
+  const size_t num_spans = 100000;
+
+  const auto measure = [&]() {
+    const auto begin = Clock::now();
+    for (size_t i = 0; i < num_spans; i++) {
+      HCTR_TRACE_SCOPE("test", "span");
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / num_spans;
+  };
+
+  tracer.set_enabled(false);
+  const double disabled_ns = measure();
+  tracer.set_enabled(true);
+  const double enabled_ns = measure();
+  tracer.set_enabled(false);
+  tracer.clear();
+
+  EXPECT_LT(disabled_ns, 100);
+  EXPECT_LT(enabled_ns, 2000);
+}
@@ -121,7 +121,7 @@ void statistics_test(const size_t batch_size, const size_t num_tables) {
   size_t num_categories = EmbeddingTableFunctors<dtype>::get_num_categories(table_sizes);
   HCTR_LOG_S(DEBUG, WORLD) << "Number of tables : " << num_tables << std::endl;
   {
-    auto log = HCTR_LOG_S(DEBUG, WORLD);
+    auto log = HCTR_LOG_ENTRY(DEBUG, WORLD);
     log << "Table sizes : ";
     for (size_t embedding = 0; embedding < table_sizes.size(); ++embedding) {
       log << '\t' << table_sizes[embedding];
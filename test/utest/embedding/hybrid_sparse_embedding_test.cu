@@ -46,7 +46,7 @@ const float lr = 0.01f;
 const DeviceMap::Layout layout = DeviceMap::LOCAL_FIRST;
 template <typename dtype>
 void print_vector(const std::vector<dtype> &vec, size_t num_elment, const std::string &vec_name) {
-  auto log = HCTR_LOG_S(INFO, WORLD);
+  auto log = HCTR_LOG_ENTRY(INFO, WORLD);
   log << "vector name: " << vec_name << ",vector size: " << vec.size() << std::endl;
   for (size_t i = 0; i < std::min(num_elment, vec.size()); ++i) {
     log << vec[i] << ",";
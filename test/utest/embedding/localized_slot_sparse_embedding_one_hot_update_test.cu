@@ -184,7 +184,7 @@ void update_test(const std::vector<size_t>& value_index, size_t max_vocabulary_s
   if (!all_el_equal) {
     HCTR_LOG_S(DEBUG, WORLD) << "average diff : " << diff_ave << std::endl;
     {
-      auto log = HCTR_LOG_S(DEBUG, WORLD);
+      auto log = HCTR_LOG_ENTRY(DEBUG, WORLD);
       log << "CPU : ";
       for (size_t i = 0; i < 10; ++i) {
         log << '\t' << weights_ref[128 + i];
@@ -192,7 +192,7 @@ void update_test(const std::vector<size_t>& value_index, size_t max_vocabulary_s
       log << std::endl;
     }
     {
-      auto log = HCTR_LOG_S(DEBUG, WORLD);
+      auto log = HCTR_LOG_ENTRY(DEBUG, WORLD);
       log << "GPU : ";
       for (size_t i = 0; i < 10; ++i) {
         log << '\t' << weights_test[128 + i];
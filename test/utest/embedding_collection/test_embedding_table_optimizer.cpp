@@ -222,7 +222,7 @@ void test_embedding_table_optimizer(int device_id, const char table_type[],
   };
 
   auto print = [&](const std::vector<std::tuple<int32_t, Key, std::vector<float>>>& records) {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
 
     // Divider.
     log << std::endl;
@@ -21,8 +21,10 @@
 
 #include <algorithm>
 #include <fstream>
+#include <numeric>
 #include <random>
 #include <type_traits>
+#include <unordered_set>
 
 #include "utest/embedding_training_cache/etc_test_utils.hpp"
 
@@ -290,6 +292,126 @@ void read_api_test(double table_size, size_t num_pass, size_t num_cached_pass,
   check_vector_equality(num_dump, slot_ids, tmp_slot_ids, data_vecs, tmp_data_vecs);
 }
 
+/**
+ * Draws num_pass keysets from a power-law (Zipf) distribution over the keys of the table, and reads
+ * them through the HMemCache. The cache holds the keys of the last num_cached_pass passes, plus the
+ * hot lines retained from evicted blocks. Hence, its hit rate must be at least the one of plain
+ * LRU eviction of whole passes.
+ */
+template <typename TypeKey>
+void power_law_hit_rate_test(double table_size, size_t num_pass, size_t num_cached_pass,
+                             double pass_fraction, double zipf_alpha, bool use_slot_id,
+                             Optimizer_t opt_type) {
+  std::vector<std::vector<int>> vvgpu;
+  vvgpu.push_back({0});
+  const auto resource_manager{ResourceManagerExt::create(vvgpu, 0)};
+
+  generate_embedding_table(snapshot_src_file, table_size, opt_type, emb_vec_size);
+  if (std::filesystem::exists(snapshot_dst_file)) std::filesystem::remove_all(snapshot_dst_file);
+  std::filesystem::copy(snapshot_src_file, snapshot_dst_file);
+
+  const std::string key_file{std::string(snapshot_dst_file) + "/key"};
+  const size_t num_key{std::filesystem::file_size(key_file) / sizeof(long long)};
+  const size_t pass_size{static_cast<size_t>(num_key * pass_fraction)};
+
+  // Popularity rank -> key. Hot keys are scattered over the table.
+  std::vector<TypeKey> ranked_keys(num_key);
+  std::iota(ranked_keys.begin(), ranked_keys.end(), 0);
+  std::mt19937 gen(42);
+  std::shuffle(ranked_keys.begin(), ranked_keys.end(), gen);
+  std::vector<double> cdf(num_key);
+  for (size_t i{0}; i < num_key; i++) {
+    cdf[i] = ((i > 0) ? cdf[i - 1] : 0.) + 1. / std::pow(i + 1., zipf_alpha);
+  }
+  std::uniform_real_distribution<double> uniform(0., cdf.back());
+
+  std::vector<std::vector<TypeKey>> key_vecs(num_pass);
+  for (auto& key_vec : key_vecs) {
+    std::unordered_set<TypeKey> keyset;
+    for (size_t attempt{0}; keyset.size() < pass_size && attempt < 32 * pass_size; attempt++) {
+      const size_t rank = std::upper_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin();
+      keyset.insert(ranked_keys[std::min(rank, num_key - 1)]);
+    }
+    key_vec.assign(keyset.begin(), keyset.end());
+  }
+
+  const size_t max_vocabulary_size{pass_size * 2};
+  HMemCache<TypeKey> hmem_cache(num_cached_pass, 1.0, num_pass, max_vocabulary_size,
+                                snapshot_dst_file, "./", use_slot_id, opt_type, emb_vec_size,
+                                resource_manager);
+
+  const auto data_files{get_data_file(opt_type)};
+  std::vector<size_t> slot_ids(max_vocabulary_size);
+  std::vector<std::vector<float>> data_vecs(data_files.size());
+  std::vector<float*> data_ptrs;
+  for (auto& data_vec : data_vecs) {
+    data_vec.resize(max_vocabulary_size * emb_vec_size);
+    data_ptrs.push_back(data_vec.data());
+  }
+  std::vector<std::vector<float>> ref_data_vecs(data_vecs);
+  std::vector<float*> ref_data_ptrs;
+  for (auto& data_vec : ref_data_vecs) {
+    ref_data_ptrs.push_back(data_vec.data());
+  }
+  std::vector<size_t> ref_slot_ids(max_vocabulary_size);
+  auto sparse_model_ptr{hmem_cache.get_sparse_model_file()};
+
+  double sum_hit_rate{0.};
+  double sum_lru_hit_rate{0.};
+  for (size_t pass_id{0}; pass_id < num_pass; pass_id++) {
+    std::vector<TypeKey> keys(key_vecs[pass_id]);
+    size_t len{keys.size()};
+
+    std::unordered_set<TypeKey> lru_keyset;
+    for (size_t i{pass_id - std::min(pass_id, num_cached_pass)}; i < pass_id; i++) {
+      lru_keyset.insert(key_vecs[i].begin(), key_vecs[i].end());
+    }
+    const size_t num_lru_hits = std::count_if(keys.begin(), keys.end(), [&](const TypeKey key) {
+      return lru_keyset.find(key) != lru_keyset.end();
+    });
+    const double lru_hit_rate{(len != 0) ? (1.0 * num_lru_hits / len) : 0.};
+
+    Timer timer;
+    timer.start();
+    hmem_cache.read(keys.data(), len, slot_ids.data(), data_ptrs);
+    const double elapsed{timer.elapsedSeconds()};
+    ASSERT_EQ(len, key_vecs[pass_id].size());
+
+    const double hit_rate{hmem_cache.get_hit_rate()};
+    const double num_bytes{1. * len * data_files.size() * emb_vec_size * sizeof(float)};
+    EXPECT_GE(hit_rate, lru_hit_rate);
+    if (pass_id >= num_cached_pass) {
+      sum_hit_rate += hit_rate;
+      sum_lru_hit_rate += lru_hit_rate;
+    }
+    HCTR_LOG_S(INFO, ROOT) << "Pass " << pass_id << ": " << len << " keys, hit rate "
+                           << hit_rate * 100. << " % (LRU " << lru_hit_rate * 100.
+                           << " %), bandwidth " << num_bytes / elapsed / 1e9 << " GB/s"
+                           << std::endl;
+
+    // Read-only passes. Hence, the SSD always holds the reference values.
+    std::vector<size_t> ssd_idx_vec(len);
+#pragma omp parallel for
+    for (size_t i = 0; i < len; i++) {
+      ssd_idx_vec[i] = sparse_model_ptr->find(keys[i]);
+    }
+    sparse_model_ptr->load(ssd_idx_vec, ref_slot_ids.data(), ref_data_ptrs);
+    if (use_slot_id) {
+      ASSERT_TRUE(std::equal(slot_ids.begin(), slot_ids.begin() + len, ref_slot_ids.begin()));
+    }
+    for (size_t i{0}; i < data_vecs.size(); i++) {
+      ASSERT_TRUE(std::equal(data_vecs[i].begin(), data_vecs[i].begin() + len * emb_vec_size,
+                             ref_data_vecs[i].begin()));
+    }
+  }
+  HCTR_LOG_S(INFO, ROOT) << "Average hit rate after warm-up: "
+                         << sum_hit_rate * 100. / (num_pass - num_cached_pass) << " % (LRU "
+                         << sum_lru_hit_rate * 100. / (num_pass - num_cached_pass) << " %)"
+                         << std::endl;
+  // Zipf-distributed passes share many hot keys that plain LRU evicts with their pass.
+  EXPECT_GT(sum_hit_rate, sum_lru_hit_rate);
+}
+
 TEST(hmem_cache_test, long_long_adam_4_2_80_4) {
   read_api_test<long long>(0.8, 4, 2, 0.8, 4, true, Optimizer_t::Adam);
 }
@@ -298,4 +420,8 @@ TEST(hmem_cache_test, unsigned_sgd_8_8_80_4) {
   read_api_test<unsigned>(0.8, 8, 8, 0.8, 4, false, Optimizer_t::SGD);
 }
 
+TEST(hmem_cache_test, long_long_adam_power_law_16_2) {
+  power_law_hit_rate_test<long long>(0.8, 16, 2, 0.1, 1.1, true, Optimizer_t::Adam);
+}
+
 }  // namespace
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <embedding_training_cache/key_index_map.hpp>
+#include <embedding_training_cache/sparse_model_file.hpp>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename TypeKey>
+std::vector<TypeKey> generate_unique_keys(const size_t num_keys) {
+  std::vector<TypeKey> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::mt19937 gen(42);
+  // Spread the keys so that they do not form a single dense range.
+  for (auto& key : keys) {
+    key = key * 64 + static_cast<TypeKey>(gen() % 64);
+  }
+  std::shuffle(keys.begin(), keys.end(), gen);
+  return keys;
+}
+
+template <typename TypeKey>
+void key_index_map_test(const size_t num_keys) {
+  const std::vector<TypeKey> keys = generate_unique_keys<TypeKey>(num_keys);
+  std::vector<SlotIndex> values(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    values[i] = {i % 26, i};
+  }
+
+  KeyIndexMap<TypeKey, SlotIndex> seq_map, par_map;
+  for (size_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(seq_map.insert({keys[i], values[i]}).second);
+  }
+  ASSERT_EQ(par_map.bulk_insert(num_keys, keys.data(), values.data()), num_keys);
+  ASSERT_EQ(seq_map.size(), num_keys);
+  ASSERT_EQ(par_map.size(), num_keys);
+
+  // Duplicates must not be inserted again.
+  ASSERT_FALSE(seq_map.insert({keys[0], values[1]}).second);
+  ASSERT_EQ(par_map.bulk_insert(num_keys / 2, keys.data(), values.data()), size_t{0});
+
+  for (size_t i = 0; i < num_keys; i++) {
+    for (const auto* map : {&seq_map, &par_map}) {
+      const auto it = map->find(keys[i]);
+      ASSERT_TRUE(it != map->end());
+      ASSERT_EQ(it->second.first, values[i].first);
+      ASSERT_EQ(it->second.second, values[i].second);
+    }
+  }
+  ASSERT_TRUE(seq_map.find(KeyIndexMap<TypeKey, SlotIndex>::empty_key) == seq_map.end());
+  ASSERT_THROW(seq_map.at(static_cast<TypeKey>(-2)), std::out_of_range);
+
+  // The sentinel key must be storable like any other key.
+  const TypeKey empty_key = KeyIndexMap<TypeKey, SlotIndex>::empty_key;
+  ASSERT_TRUE(seq_map.emplace(empty_key, SlotIndex{1, 2}).second);
+  ASSERT_EQ(seq_map.at(empty_key).second, size_t{2});
+  ASSERT_EQ(seq_map.size(), num_keys + 1);
+
+  // Iteration must visit every entry exactly once.
+  std::vector<size_t> visited(num_keys, 0);
+  size_t num_visited = 0;
+  for (const auto& pair : seq_map) {
+    if (pair.first != empty_key) {
+      visited[pair.second.second]++;
+    }
+    num_visited++;
+  }
+  ASSERT_EQ(num_visited, seq_map.size());
+  ASSERT_TRUE(std::all_of(visited.begin(), visited.end(), [](size_t n) { return n == 1; }));
+
+  seq_map.clear();
+  ASSERT_EQ(seq_map.size(), size_t{0});
+  ASSERT_TRUE(seq_map.begin() == seq_map.end());
+  ASSERT_TRUE(seq_map.find(keys[0]) == seq_map.end());
+}
+
+template <typename TypeKey>
+void key_index_map_duplicates_test(const size_t num_keys, const size_t num_threads) {
+  // Every key occurs 4 times at random positions. Some keys are present before the insert.
+  const std::vector<TypeKey> unique_keys = generate_unique_keys<TypeKey>(num_keys);
+  std::vector<TypeKey> keys;
+  for (size_t r = 0; r < 4; r++) {
+    keys.insert(keys.end(), unique_keys.begin(), unique_keys.end());
+  }
+  keys.push_back(KeyIndexMap<TypeKey, size_t>::empty_key);
+  keys.push_back(KeyIndexMap<TypeKey, size_t>::empty_key);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1337));
+  std::vector<size_t> values(keys.size());
+  std::iota(values.begin(), values.end(), 0);
+
+  KeyIndexMap<TypeKey, size_t> seq_map, par_map;
+  for (size_t i = 0; i < num_keys / 8; i++) {
+    seq_map.emplace(unique_keys[i], keys.size() + i);
+    par_map.emplace(unique_keys[i], keys.size() + i);
+  }
+  size_t num_inserted = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    num_inserted += seq_map.emplace(keys[i], values[i]).second;
+  }
+  ASSERT_EQ(par_map.bulk_insert(keys.size(), keys.data(), values.data(), num_threads),
+            num_inserted);
+  ASSERT_EQ(par_map.size(), seq_map.size());
+  for (const auto& pair : seq_map) {
+    ASSERT_EQ(par_map.at(pair.first), pair.second);
+  }
+}
+
+}  // namespace
+
+TEST(key_index_map_test, long_long_100k) { key_index_map_test<long long>(100000); }
+TEST(key_index_map_test, unsigned_100k) { key_index_map_test<unsigned>(100000); }
+
+TEST(key_index_map_test, duplicates_1_thread) {
+  key_index_map_duplicates_test<long long>(100000, 1);
+}
+TEST(key_index_map_test, duplicates_8_threads) {
+  key_index_map_duplicates_test<long long>(100000, 8);
+}
@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 
 #include <HugeCTR/include/optimizer.hpp>
+#include <map>
+#include <unordered_set>
 
 #include "embedding_training_cache/hmem_cache/hmem_cache.hpp"
 #include "embedding_training_cache/parameter_server.hpp"
@@ -170,6 +172,149 @@ void do_upload_and_download_snapshot(int batch_num_train, TrainPSType_t ps_type,
   ASSERT_TRUE(check_vector_equality(snapshot_src_file, "./", "emb_vector"));
 }
 
+template <typename TypeKey>
+BufferBag create_host_buffer_bag(size_t capacity, Optimizer_t opt_type) {
+  BufferBag buf_bag;
+  auto blobs_buff{GeneralBuffer2<CudaHostAllocator>::create()};
+  buf_bag.opt_states.resize(OptParams::num_parameters_per_weight(opt_type));
+
+  Tensor2<TypeKey> tensor_keys;
+  Tensor2<size_t> tensor_slot_id;
+  blobs_buff->reserve({capacity}, &tensor_keys);
+  blobs_buff->reserve({capacity}, &tensor_slot_id);
+  blobs_buff->reserve({capacity, emb_vec_size}, &(buf_bag.embedding));
+  for (auto& opt_state : buf_bag.opt_states) {
+    blobs_buff->reserve({capacity, emb_vec_size}, &opt_state);
+  }
+  blobs_buff->allocate();
+
+  buf_bag.keys = tensor_keys.shrink();
+  buf_bag.slot_id = tensor_slot_id.shrink();
+  return buf_bag;
+}
+
+/**
+ * Emulates the ETC training loop: Push the previous pass, load the next pass, and "train" by
+ * incrementing all values. Keys that were not found in the PS are created, like the embedding
+ * would do. Returns the time spent in waiting for the PS.
+ */
+template <typename TypeKey>
+double run_passes(ParameterServer<TypeKey>& parameter_server, BufferBag& buf_bag,
+                  const std::vector<std::vector<TypeKey>>& keysets,
+                  const std::vector<std::string>& keyset_files, bool use_prefetch) {
+  TypeKey* key_ptr{Tensor2<TypeKey>::stretch_from(buf_bag.keys).get_ptr()};
+  size_t* slot_id_ptr{Tensor2<size_t>::stretch_from(buf_bag.slot_id).get_ptr()};
+
+  double stall_time = 0;
+  size_t num_keys = 0;
+  for (size_t pass = 0; pass < keyset_files.size(); pass++) {
+    Timer timer;
+    timer.start();
+    if (pass > 0) {
+      parameter_server.push(buf_bag, num_keys);
+    }
+    parameter_server.load_keyset_from_file(keyset_files[pass]);
+    parameter_server.pull(buf_bag, num_keys);
+    stall_time += timer.elapsedSeconds();
+
+    if (use_prefetch && pass + 1 < keyset_files.size()) {
+      parameter_server.prefetch(keyset_files[pass + 1]);
+    }
+
+    std::unordered_set<TypeKey> hit_keys(key_ptr, key_ptr + num_keys);
+    for (const TypeKey key : keysets[pass]) {
+      if (hit_keys.find(key) != hit_keys.end()) continue;
+      key_ptr[num_keys] = key;
+      slot_id_ptr[num_keys] = 0;
+      std::fill_n(buf_bag.embedding.get_ptr() + num_keys * emb_vec_size, emb_vec_size, 0.f);
+      for (auto& opt_state : buf_bag.opt_states) {
+        std::fill_n(opt_state.get_ptr() + num_keys * emb_vec_size, emb_vec_size, 0.f);
+      }
+      num_keys++;
+    }
+    std::for_each_n(buf_bag.embedding.get_ptr(), num_keys * emb_vec_size, [](float& x) { x++; });
+    for (auto& opt_state : buf_bag.opt_states) {
+      std::for_each_n(opt_state.get_ptr(), num_keys * emb_vec_size, [](float& x) { x++; });
+    }
+  }
+  parameter_server.push(buf_bag, num_keys);
+  parameter_server.flush_emb_tbl_to_ssd();
+  return stall_time;
+}
+
+template <typename TypeKey>
+void do_prefetch_passes(TrainPSType_t ps_type, bool is_distributed,
+                        Optimizer_t opt_type = Optimizer_t::Adam,
+                        HMemCacheConfig hc_config = HMemCacheConfig()) {
+  Embedding_t embedding_type = is_distributed ? Embedding_t::DistributedSlotSparseEmbeddingHash
+                                              : Embedding_t::LocalizedSlotSparseEmbeddingHash;
+  std::vector<std::vector<int>> vvgpu;
+  vvgpu.push_back({0});
+  const auto resource_manager{ResourceManagerExt::create(vvgpu, 0)};
+
+  generate_sparse_model<TypeKey, check>(
+      snapshot_src_file, snapshot_dst_file, snapshot_bkp_file_unsigned, snapshot_bkp_file_longlong,
+      file_list_name_train, file_list_name_eval, prefix, num_files, label_dim, dense_dim, slot_num,
+      max_nnz_per_slot, max_feature_num, vocabulary_size, emb_vec_size, combiner, scaler,
+      num_workers, batchsize, 20, batch_num_eval, update_type, resource_manager);
+  generate_opt_state(snapshot_src_file, opt_type);
+
+  // Overlapping keysets. Every other pass introduces keys that are not in the model yet.
+  std::vector<long long> keys_in_file;
+  {
+    const std::string key_file(std::string(snapshot_src_file) + "/key");
+    std::ifstream key_ifs(key_file, std::ifstream::binary);
+    keys_in_file.resize(std::filesystem::file_size(key_file) / sizeof(long long));
+    key_ifs.read(reinterpret_cast<char*>(keys_in_file.data()),
+                 keys_in_file.size() * sizeof(long long));
+  }
+  const size_t num_passes = 6;
+  const size_t pass_stride = keys_in_file.size() / num_passes;
+  const size_t num_new_keys = 1000;
+  std::vector<std::vector<TypeKey>> keysets(num_passes);
+  std::vector<std::string> keyset_files(num_passes);
+  std::vector<long long> all_keys(keys_in_file);
+  for (size_t pass = 0; pass < num_passes; pass++) {
+    const size_t begin = pass * pass_stride;
+    const size_t end = std::min(begin + 2 * pass_stride, keys_in_file.size());
+    auto& keyset = keysets[pass];
+    keyset.assign(keys_in_file.begin() + begin, keys_in_file.begin() + end);
+    for (size_t i = 0; i < num_new_keys; i++) {
+      const long long key = vocabulary_size + (pass / 2) * num_new_keys + i;
+      keyset.push_back(static_cast<TypeKey>(key));
+      if (pass % 2 == 0) all_keys.push_back(key);
+    }
+    keyset_files[pass] = "prefetch_keyset_" + std::to_string(pass) + ".bin";
+    std::ofstream key_ofs(keyset_files[pass], std::ofstream::binary | std::ofstream::trunc);
+    key_ofs.write(reinterpret_cast<const char*>(keyset.data()), keyset.size() * sizeof(TypeKey));
+  }
+
+  BufferBag buf_bag{create_host_buffer_bag<TypeKey>(vocabulary_size, opt_type)};
+  hc_config.block_capacity = vocabulary_size;
+
+  // Run the same passes with and without prefetching. The resulting models must be identical.
+  std::vector<std::map<long long, std::vector<float>>> models(2);
+  for (const bool use_prefetch : {false, true}) {
+    copy_sparse_model(snapshot_src_file, snapshot_dst_file);
+    ParameterServer<TypeKey> parameter_server(ps_type, snapshot_dst_file, embedding_type, opt_type,
+                                              emb_vec_size, resource_manager, "./", hc_config);
+    const double stall_time{
+        run_passes(parameter_server, buf_bag, keysets, keyset_files, use_prefetch)};
+    HCTR_LOG_S(INFO, ROOT) << "prefetch=" << use_prefetch << ", " << num_passes
+                           << " passes, time waiting for the PS=" << stall_time << "s"
+                           << std::endl;
+
+    const auto key_vec_pair{parameter_server.pull(all_keys)};
+    ASSERT_EQ(key_vec_pair.first.size(), all_keys.size());
+    auto& model = models[use_prefetch];
+    for (size_t i = 0; i < key_vec_pair.first.size(); i++) {
+      const auto vec_begin{key_vec_pair.second.begin() + i * emb_vec_size};
+      model.emplace(key_vec_pair.first[i], std::vector<float>(vec_begin, vec_begin + emb_vec_size));
+    }
+  }
+  ASSERT_TRUE(models[0] == models[1]);
+}
+
 TEST(parameter_server_test, unsigned_host_distributed) {
   do_upload_and_download_snapshot<unsigned>(20, TrainPSType_t::Staged, true);
 }
@@ -188,4 +333,15 @@ TEST(parameter_server_test, unsigned_cache_localized_SGD) {
                                             "./", hc_config);
 }
 
+TEST(parameter_server_test, unsigned_host_localized_prefetch) {
+  do_prefetch_passes<unsigned>(TrainPSType_t::Staged, false);
+}
+TEST(parameter_server_test, long_long_host_distributed_prefetch) {
+  do_prefetch_passes<long long>(TrainPSType_t::Staged, true);
+}
+TEST(parameter_server_test, long_long_cache_localized_Adam_prefetch) {
+  HMemCacheConfig hc_config(1, 0.5, 0);
+  do_prefetch_passes<long long>(TrainPSType_t::Cached, false, Optimizer_t::Adam, hc_config);
+}
+
 }  // namespace
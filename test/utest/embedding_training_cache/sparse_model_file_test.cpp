@@ -78,7 +78,7 @@ void sparse_model_file_test(int batch_num_train, bool is_distributed) {
     HugeCTR::SparseModelFile<TypeKey> sparse_model_file(snapshot_dst_file, embedding_type,
                                                         emb_vec_size, resource_manager);
 
-    std::unordered_map<TypeKey, std::pair<size_t, size_t>> mem_key_index_map;
+    typename HugeCTR::SparseModelFile<TypeKey>::HashTableType mem_key_index_map;
     std::vector<float> mem_emb_table;
     sparse_model_file.load_emb_tbl_to_mem(mem_key_index_map, mem_emb_table);
 
@@ -279,6 +279,73 @@ void sparse_model_file_test(int batch_num_train, bool is_distributed) {
                                                    load_slots.size() * sizeof(size_t), 0));
     }
   }
+
+  // test delta log and compact
+  {
+    HCTR_LOG(INFO, ROOT, "[TEST] sparse_model_file::compact\n");
+    const size_t key_file_size_in_byte =
+        std::filesystem::file_size(get_ext_file(snapshot_dst_file, "key"));
+    const size_t num_keys = key_file_size_in_byte / sizeof(long long);
+    std::vector<TypeKey> all_keys(num_keys);
+    {
+      std::ifstream key_ifs(get_ext_file(snapshot_dst_file, "key"));
+      load_key_to_vec(all_keys, key_ifs, num_keys, key_file_size_in_byte);
+    }
+    const TypeKey max_key = *std::max_element(all_keys.begin(), all_keys.end());
+
+    const size_t num_new_keys = 256;
+    std::vector<TypeKey> new_keys(num_new_keys);
+    iota(new_keys.begin(), new_keys.end(), max_key + 1);
+    std::vector<size_t> new_slots(num_new_keys);
+    for (size_t i = 0; i < num_new_keys; i++) new_slots[i] = i % slot_num;
+    std::vector<float> new_vecs(num_new_keys * emb_vec_size);
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> real_distribution(0.0f, 1.0f);
+    for_each(new_vecs.begin(), new_vecs.end(),
+             [&generator, &real_distribution](float &elem) { elem = real_distribution(generator); });
+    std::vector<size_t> vec_indices(num_new_keys);
+    iota(vec_indices.begin(), vec_indices.end(), 0);
+
+    {
+      HugeCTR::SparseModelFile<TypeKey> sparse_model_file(snapshot_dst_file, embedding_type,
+                                                          emb_vec_size, resource_manager);
+      sparse_model_file.append_new_vec_and_key(new_keys, new_slots.data(), vec_indices,
+                                               new_vecs.data());
+      // the new keys are kept in the delta log, the base files are untouched
+      ASSERT_EQ(sparse_model_file.get_num_delta_rows(), num_new_keys);
+      ASSERT_EQ(std::filesystem::file_size(get_ext_file(snapshot_dst_file, "key")),
+                key_file_size_in_byte);
+
+      // update the appended vectors in place
+      for_each(new_vecs.begin(), new_vecs.end(), [](float &elem) { elem += 1.0f; });
+      sparse_model_file.dump_exist_vec_by_key(new_keys, vec_indices, new_vecs.data());
+    }
+
+    HugeCTR::SparseModelFile<TypeKey> sparse_model_file(snapshot_dst_file, embedding_type,
+                                                        emb_vec_size, resource_manager);
+    ASSERT_EQ(sparse_model_file.get_num_delta_rows(), num_new_keys);
+    auto check_new_keys = [&]() {
+      std::vector<size_t> load_slots;
+      std::vector<float> load_vecs;
+      sparse_model_file.load_exist_vec_by_key(new_keys, load_slots, load_vecs);
+      ASSERT_TRUE(test::compare_array_approx<char>(reinterpret_cast<char *>(load_vecs.data()),
+                                                   reinterpret_cast<char *>(new_vecs.data()),
+                                                   new_vecs.size() * sizeof(float), 0));
+      if (!is_distributed) {
+        ASSERT_TRUE(test::compare_array_approx<size_t>(load_slots.data(), new_slots.data(),
+                                                       num_new_keys, 0));
+      }
+    };
+    check_new_keys();
+
+    sparse_model_file.compact();
+    ASSERT_EQ(sparse_model_file.get_num_delta_rows(), size_t{0});
+    ASSERT_EQ(std::filesystem::file_size(get_ext_file(snapshot_dst_file, "key")),
+              (num_keys + num_new_keys) * sizeof(long long));
+    ASSERT_EQ(std::filesystem::file_size(get_ext_file(snapshot_dst_file, "emb_vector")),
+              (num_keys + num_new_keys) * emb_vec_size * sizeof(float));
+    check_new_keys();
+  }
 }
 
 TEST(sparse_model_file_test, long_long_distributed) { sparse_model_file_test<long long>(30, true); }
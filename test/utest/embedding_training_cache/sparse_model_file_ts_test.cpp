@@ -257,7 +257,7 @@ void load_api_test(int batch_num_train, bool use_slot_id, Optimizer_t opt_type,
   compare_with_ssd(data_files, keys, use_slot_id, slot_ids, data_vecs);
 
   ////////////////////////////// dump_update
-  std::unordered_map<TypeKey, size_t> key_idx_map;
+  typename SparseModelFileTS<TypeKey>::HashTableType key_idx_map;
   key_idx_map.reserve(keys.size());
   size_t count(0);
   for (auto key : keys) {
@@ -17,17 +17,31 @@
 #include <cuda_profiler_api.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <base/debug/logger.hpp>
 #include <cassert>
+#include <chrono>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <hps/database_backend.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server_base.hpp>
+#include <hps/immutable_store_backend.hpp>
+#include <hps/key_filter.hpp>
 #include <hps/mp_hash_map_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <hps/sharded_hash_map_backend.hpp>
+#include <hps/update_applier.hpp>
+#include <hps/value_codec.hpp>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 using namespace HugeCTR;
@@ -43,6 +57,9 @@ void db_backend_multi_evict_test(DatabaseType_t database_type) {
     case DatabaseType_t::MultiProcessHashMap:
       db = std::make_unique<MultiProcessHashMapBackend<Key>>(16);
       break;
+    case DatabaseType_t::ShardedHashMap:
+      db = std::make_unique<ShardedHashMapBackend<Key>>(16);
+      break;
     case DatabaseType_t::RedisCluster:
       db = std::make_unique<RedisClusterBackend<Key>>(
           "127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002");
@@ -109,6 +126,9 @@ void db_backend_multi_evict_test(DatabaseType_t database_type) {
 TEST(db_backend_multi_evict, HashMap) {
   db_backend_multi_evict_test<long long>(DatabaseType_t::ParallelHashMap);
 }
+TEST(db_backend_multi_evict, ShardedHashMap) {
+  db_backend_multi_evict_test<long long>(DatabaseType_t::ShardedHashMap);
+}
 TEST(db_backend_multi_evict, Redis) {
   db_backend_multi_evict_test<long long>(DatabaseType_t::RedisCluster);
 }
@@ -228,6 +248,25 @@ void db_backend_dump_test(DatabaseType_t database_type) {
 
 }  // namespace
 
+TEST(db_backend_insert_async, HashMap) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "async");
+  HashMapBackend<long long> db(16, 1024);
+
+  auto keys = std::make_shared<std::vector<long long>>(1000);
+  std::iota(keys->begin(), keys->end(), 0LL);
+  auto values = std::make_shared<std::vector<char>>(keys->size() * sizeof(float));
+
+  // The completion callback reports the outcome of the background insertion.
+  std::atomic<size_t> num_completed{0};
+  db.insert_async(tag, keys, values, sizeof(float), [&](const bool success) {
+    EXPECT_TRUE(success);
+    num_completed++;
+  });
+  db.synchronize();
+  EXPECT_EQ(num_completed, 1);
+  EXPECT_EQ(db.size(tag), keys->size());
+}
+
 TEST(db_backend_dump_load, HashMap) {
   db_backend_dump_test<long long>(DatabaseType_t::ParallelHashMap);
 }
@@ -235,3 +274,846 @@ TEST(db_backend_dump_load, RedisCluster) {
   db_backend_dump_test<long long>(DatabaseType_t::RedisCluster);
 }
 TEST(db_backend_dump_load, RocksDB) { db_backend_dump_test<long long>(DatabaseType_t::RocksDB); }
+
+namespace {
+
+template <typename Key>
+void db_backend_update_applier_test(const size_t max_batch_size) {
+  auto db = std::make_unique<HashMapBackend<Key>>(16);
+  const std::string tag0 = HierParameterServerBase::make_tag_name("mdl", "tbl0");
+  const std::string tag1 = HierParameterServerBase::make_tag_name("mdl", "tbl1");
+
+  const size_t num_keys = 10000;
+  const size_t num_rounds = 5;
+  {
+    UpdateApplier<Key> applier(db.get(), max_batch_size, std::chrono::milliseconds{10},
+                               max_batch_size * 4);
+
+    // Overwrite the same keys multiple times. Only the last round should survive.
+    std::vector<Key> keys(num_keys);
+    std::vector<double> values(num_keys);
+    for (size_t r = 0; r < num_rounds; r++) {
+      for (size_t i = 0; i < num_keys; i++) {
+        keys[i] = static_cast<Key>(i);
+        values[i] = static_cast<double>(r * num_keys + i);
+      }
+      for (size_t i = 0; i < num_keys; i += 100) {
+        EXPECT_TRUE(applier.post(tag0, 100, &keys[i], reinterpret_cast<const char*>(&values[i]),
+                                 sizeof(double)));
+        EXPECT_TRUE(applier.post(tag1, 100, &keys[i], reinterpret_cast<const char*>(&values[i]),
+                                 sizeof(double)));
+      }
+    }
+    applier.flush();
+
+    EXPECT_EQ(applier.num_pairs_pending(), size_t{0});
+    EXPECT_EQ(applier.num_pairs_received(), 2 * num_rounds * num_keys);
+    EXPECT_EQ(applier.num_pairs_applied() + applier.num_pairs_deduplicated(),
+              applier.num_pairs_received());
+    EXPECT_GE(applier.num_applies(), size_t{1});
+    EXPECT_GT(applier.max_lag().count(), 0);
+  }
+
+  // Check that the latest values were applied.
+  for (const std::string& tag : {tag0, tag1}) {
+    EXPECT_EQ(db->size(tag), num_keys);
+    for (Key k = 0; k < static_cast<Key>(num_keys); k++) {
+      double v = -1;
+      db->fetch(
+          tag, 1, &k,
+          [&](size_t index, const char* value, size_t value_size) {
+            v = *reinterpret_cast<const double*>(value);
+          },
+          [&](size_t index) { FAIL(); }, std::chrono::nanoseconds::max());
+      EXPECT_EQ(v, static_cast<double>((num_rounds - 1) * num_keys + k));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(db_backend_update_applier, HashMap_small_batch) {
+  db_backend_update_applier_test<long long>(1000);
+}
+TEST(db_backend_update_applier, HashMap_large_batch) {
+  db_backend_update_applier_test<long long>(256 * 1024);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_bulk_fetch_test(DatabaseType_t database_type) {
+  std::unique_ptr<DatabaseBackend<Key>> db;
+  switch (database_type) {
+    case DatabaseType_t::ParallelHashMap:
+      db = std::make_unique<HashMapBackend<Key>>(16);
+      break;
+    case DatabaseType_t::MultiProcessHashMap:
+      db = std::make_unique<MultiProcessHashMapBackend<Key>>(16);
+      break;
+    default:
+      break;
+  }
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+
+  // Insert only the even keys. Hence, every other key in the query will miss.
+  const size_t num_keys = 20000;
+  const size_t dim = 16;
+  const size_t value_size = dim * sizeof(float);
+  const size_t value_stride = value_size + 2 * sizeof(float);
+  {
+    std::vector<Key> keys;
+    std::vector<float> values;
+    for (size_t i = 0; i < num_keys; i += 2) {
+      keys.emplace_back(static_cast<Key>(i));
+      values.insert(values.end(), dim, static_cast<float>(i));
+    }
+    db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+               value_size);
+  }
+  std::vector<Key> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(i);
+  }
+
+  // Callback based fetch.
+  std::vector<float> cb_values(num_keys * dim, -1);
+  std::vector<size_t> cb_missing;
+  std::mutex cb_missing_guard;
+  size_t cb_hits = db->fetch(
+      tag, num_keys, keys.data(),
+      [&](const size_t index, const char* const value, const size_t size) {
+        memcpy(&cb_values[index * dim], value, size);
+      },
+      [&](const size_t index) {
+        std::lock_guard<std::mutex> lock(cb_missing_guard);
+        cb_missing.emplace_back(index);
+      },
+      std::chrono::nanoseconds::max());
+  std::sort(cb_missing.begin(), cb_missing.end());
+
+  // Bulk fetch into a strided buffer.
+  std::vector<char> bulk_values(num_keys * value_stride, 0);
+  std::vector<size_t> missing{42};
+  size_t bulk_hits = db->fetch(tag, num_keys, keys.data(), bulk_values.data(), value_size,
+                               value_stride, missing, std::chrono::nanoseconds::max());
+
+  EXPECT_EQ(cb_hits, num_keys / 2);
+  EXPECT_EQ(bulk_hits, cb_hits);
+  EXPECT_EQ(missing, cb_missing);
+  for (size_t i = 0; i < num_keys; i += 2) {
+    const float* const value = reinterpret_cast<const float*>(&bulk_values[i * value_stride]);
+    ASSERT_TRUE(std::equal(value, &value[dim], &cb_values[i * dim]));
+    ASSERT_EQ(value[0], static_cast<float>(i));
+  }
+
+  // Indexed bulk fetch, querying the missing keys and a few hits.
+  std::vector<size_t> indices(missing);
+  indices.insert(indices.end(), {0, 2, 4});
+  std::vector<size_t> still_missing;
+  bulk_hits = db->fetch(tag, indices.size(), indices.data(), keys.data(), bulk_values.data(),
+                        value_size, value_stride, still_missing, std::chrono::nanoseconds::max());
+  EXPECT_EQ(bulk_hits, size_t{3});
+  EXPECT_EQ(still_missing, missing);
+}
+
+}  // namespace
+
+TEST(db_backend_bulk_fetch, HashMap) {
+  db_backend_bulk_fetch_test<long long>(DatabaseType_t::ParallelHashMap);
+}
+TEST(db_backend_bulk_fetch, MultiProcessHashMap) {
+  db_backend_bulk_fetch_test<long long>(DatabaseType_t::MultiProcessHashMap);
+}
+
+namespace {
+
+template <typename Key>
+std::unique_ptr<DatabaseBackend<Key>> make_hash_map_backend(const DatabaseType_t database_type,
+                                                            const size_t num_partitions) {
+  const size_t allocation_rate = 16 * 1024 * 1024;
+  if (database_type == DatabaseType_t::MultiProcessHashMap) {
+    return std::make_unique<MultiProcessHashMapBackend<Key>>(num_partitions, allocation_rate);
+  }
+  return std::make_unique<HashMapBackend<Key>>(num_partitions, allocation_rate);
+}
+
+template <typename Key>
+void db_backend_raw_dump_test(const DatabaseType_t database_type, const size_t num_keys) {
+  const std::string tag0 = HierParameterServerBase::make_tag_name("mdl", "tbl0");
+  const std::string tag1 = HierParameterServerBase::make_tag_name("mdl", "tbl1");
+  const size_t dim = 32;
+  const size_t value_size = dim * sizeof(float);
+
+  // Populate a table.
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(i * 7 + 3);
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+  {
+    auto db = make_hash_map_backend<Key>(database_type, 16);
+    db->insert(tag0, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+               value_size);
+    db->dump(tag0, "tbl_v2.bin");
+    db->evict(tag0);
+  }
+
+  // Write the same pairs in the version 1 format (interleaved keys and values).
+  {
+    std::ofstream file{"tbl_v1.bin", std::ios::binary};
+    const char magic[] = "bin";
+    const uint32_t header[] = {1, sizeof(Key), static_cast<uint32_t>(value_size)};
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (size_t i = 0; i < num_keys; i++) {
+      file.write(reinterpret_cast<const char*>(&keys[i]), sizeof(Key));
+      file.write(reinterpret_cast<const char*>(&values[i * dim]), value_size);
+    }
+  }
+
+  // Restore with the same partitioning (per-partition path), a different one (generic path), and
+  // from the version 1 dump.
+  const std::vector<std::pair<const char*, size_t>> runs{
+      {"tbl_v2.bin", 16}, {"tbl_v2.bin", 7}, {"tbl_v1.bin", 16}};
+  for (const auto& [path, num_partitions] : runs) {
+    auto db = make_hash_map_backend<Key>(database_type, num_partitions);
+    db->load_dump(tag1, path);
+    EXPECT_EQ(db->size(tag1), num_keys);
+
+    std::vector<float> fetched(num_keys * dim);
+    std::vector<size_t> missing;
+    EXPECT_EQ(db->fetch(tag1, num_keys, keys.data(), reinterpret_cast<char*>(fetched.data()),
+                        value_size, value_size, missing, std::chrono::nanoseconds::max()),
+              num_keys);
+    EXPECT_TRUE(missing.empty());
+    EXPECT_TRUE(fetched == values);
+    db->evict(tag1);
+  }
+  std::filesystem::remove("tbl_v2.bin");
+  std::filesystem::remove("tbl_v1.bin");
+}
+
+}  // namespace
+
+TEST(db_backend_raw_dump, HashMap) {
+  db_backend_raw_dump_test<long long>(DatabaseType_t::ParallelHashMap, 20000);
+}
+TEST(db_backend_raw_dump, MultiProcessHashMap) {
+  db_backend_raw_dump_test<long long>(DatabaseType_t::MultiProcessHashMap, 20000);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_immutable_store_test(const DatabaseType_t baseline_type) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+  const std::string path = "immutable_store_test";
+  const size_t num_keys = 50000;
+  const size_t dim = 16;
+  const size_t value_size = dim * sizeof(float);
+  std::filesystem::remove_all(path);
+
+  // Half of the keys are dense, the other half is scattered across the entire key space.
+  std::mt19937_64 gen{42};
+  std::vector<Key> keys;
+  std::vector<float> values;
+  keys.reserve(num_keys);
+  values.reserve(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    const Key key = i % 2 ? static_cast<Key>(gen()) : static_cast<Key>(i / 2);
+    keys.emplace_back(key);
+    values.insert(values.end(), dim, static_cast<float>(i));
+  }
+
+  std::unique_ptr<DatabaseBackend<Key>> baseline;
+  switch (baseline_type) {
+    case DatabaseType_t::ParallelHashMap:
+      baseline = std::make_unique<HashMapBackend<Key>>(16);
+      break;
+    case DatabaseType_t::RocksDB:
+      baseline = std::make_unique<RocksDBBackend<Key>>("/hugectr/Test_Data/rockdb");
+      break;
+    default:
+      break;
+  }
+  baseline->insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                   value_size);
+
+  // Build the store by inserting into an empty table.
+  auto db = std::make_unique<ImmutableStoreBackend<Key>>(path);
+  EXPECT_TRUE(db->insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                         value_size));
+  const size_t num_unique = db->size(tag);
+  EXPECT_EQ(baseline->size(tag), num_unique);
+
+  // Further modifications are ignored.
+  EXPECT_TRUE(db->insert(tag, 1, keys.data(), reinterpret_cast<const char*>(values.data()),
+                         value_size));
+  EXPECT_EQ(db->evict(tag, 1, keys.data()), size_t{0});
+  EXPECT_EQ(db->size(tag), num_unique);
+
+  // Tables survive reopening. Query all keys in random order, interleaved with unknown keys.
+  db = std::make_unique<ImmutableStoreBackend<Key>>(path, true);
+  EXPECT_EQ(db->find_tables("mdl"), std::vector<std::string>{tag});
+  EXPECT_EQ(db->size(tag), num_unique);
+
+  std::vector<Key> query;
+  query.reserve(num_keys * 2);
+  for (size_t i = 0; i < num_keys; i++) {
+    query.emplace_back(keys[i]);
+    query.emplace_back(static_cast<Key>(num_keys + i * 3 + 1));
+  }
+  std::shuffle(query.begin(), query.end(), gen);
+
+  std::vector<std::vector<float>> fetched;
+  std::vector<std::vector<size_t>> missing;
+  const std::vector<DatabaseBackend<Key>*> backends{baseline.get(), db.get()};
+  for (DatabaseBackend<Key>* const backend : backends) {
+    fetched.emplace_back(query.size() * dim);
+    missing.emplace_back();
+    backend->fetch(tag, query.size(), query.data(), reinterpret_cast<char*>(fetched.back().data()),
+                   value_size, value_size, missing.back(), std::chrono::nanoseconds::max());
+  }
+  EXPECT_EQ(missing[1], missing[0]);
+  EXPECT_TRUE(fetched[1] == fetched[0]);
+  EXPECT_EQ(query.size() - missing[1].size(), db->contains(tag, query.size(), query.data(),
+                                                           std::chrono::nanoseconds::max()));
+
+  baseline->evict(tag);
+  db.reset();
+  std::filesystem::remove_all(path);
+}
+
+}  // namespace
+
+TEST(db_backend_immutable_store, HashMap) {
+  db_backend_immutable_store_test<long long>(DatabaseType_t::ParallelHashMap);
+}
+TEST(db_backend_immutable_store, RocksDB) {
+  db_backend_immutable_store_test<long long>(DatabaseType_t::RocksDB);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_rocksdb_fetch_test(const size_t block_cache_size, const double bloom_filter_bits,
+                                   const bool partitioned_index,
+                                   const DatabaseCompression_t compression) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "tbl");
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "hctr_rocksdb_fetch_test").string();
+  const size_t num_keys = 50000;
+  const size_t dim = 32;
+  const size_t value_size = dim * sizeof(float);
+  std::filesystem::remove_all(path);
+
+  // Populate a local on-disk database.
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(i * 3);
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+  {
+    RocksDBBackend<Key> db(path, 16, false, 64L * 1024L, 64L * 1024L, block_cache_size,
+                           bloom_filter_bits, partitioned_index, compression);
+    db.insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+              value_size);
+  }
+
+  // Reopen, and query all keys in random order, interleaved with unknown keys.
+  auto db = std::make_unique<RocksDBBackend<Key>>(path, 16, true, 64L * 1024L, 64L * 1024L,
+                                                  block_cache_size, bloom_filter_bits,
+                                                  partitioned_index, compression);
+  std::vector<Key> query;
+  query.reserve(num_keys * 2);
+  for (size_t i = 0; i < num_keys; i++) {
+    query.emplace_back(keys[i]);
+    query.emplace_back(keys[i] + 1);
+  }
+  std::shuffle(query.begin(), query.end(), std::mt19937_64{42});
+
+  // Cold cache, callback interface.
+  std::vector<float> cb_values(query.size() * dim, -1);
+  size_t cb_misses = 0;
+  const size_t cb_hits = db->fetch(
+      tag, query.size(), query.data(),
+      [&](const size_t index, const char* const value, const size_t size) {
+        memcpy(&cb_values[index * dim], value, size);
+      },
+      [&](const size_t index) { cb_misses++; }, std::chrono::nanoseconds::max());
+
+  // Warm cache, bulk interface.
+  std::vector<float> bulk_values(query.size() * dim, -1);
+  std::vector<size_t> missing;
+  const size_t bulk_hits = db->fetch(tag, query.size(), query.data(),
+                                     reinterpret_cast<char*>(bulk_values.data()), value_size,
+                                     value_size, missing, std::chrono::nanoseconds::max());
+
+  EXPECT_EQ(cb_hits, num_keys);
+  EXPECT_EQ(cb_misses, num_keys);
+  EXPECT_EQ(bulk_hits, num_keys);
+  EXPECT_EQ(missing.size(), num_keys);
+  for (const size_t index : missing) {
+    ASSERT_EQ(query[index] % 3, Key{1});
+  }
+  for (size_t i = 0; i < query.size(); i++) {
+    if (query[i] % 3 == 0) {
+      ASSERT_EQ(bulk_values[i * dim], static_cast<float>(query[i] / 3));
+      ASSERT_EQ(cb_values[i * dim], bulk_values[i * dim]);
+    }
+  }
+  db.reset();
+  std::filesystem::remove_all(path);
+}
+
+}  // namespace
+
+TEST(db_backend_rocksdb_fetch, Default) {
+  db_backend_rocksdb_fetch_test<long long>(256L * 1024L * 1024L, 10, false,
+                                           DatabaseCompression_t::Snappy);
+}
+TEST(db_backend_rocksdb_fetch, PartitionedIndex) {
+  db_backend_rocksdb_fetch_test<long long>(256L * 1024L * 1024L, 10, true,
+                                           DatabaseCompression_t::Snappy);
+}
+TEST(db_backend_rocksdb_fetch, NoCompressionNoFilter) {
+  db_backend_rocksdb_fetch_test<long long>(256L * 1024L * 1024L, 0, false,
+                                           DatabaseCompression_t::None);
+}
+TEST(db_backend_rocksdb_fetch, SmallCache) {
+  db_backend_rocksdb_fetch_test<long long>(8L * 1024L * 1024L, 10, false,
+                                           DatabaseCompression_t::LZ4);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_rocksdb_bulk_insert_test(const size_t num_keys) {
+  const std::string tag0 = HierParameterServerBase::make_tag_name("mdl", "tbl0");
+  const std::string tag1 = HierParameterServerBase::make_tag_name("mdl", "tbl1");
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "hctr_rocksdb_bulk_insert_test").string();
+  const size_t dim = 16;
+  const size_t value_size = dim * sizeof(float);
+  std::filesystem::remove_all(path);
+
+  // Random keys, including duplicates and keys whose bytewise order differs from their value.
+  std::mt19937_64 gen{42};
+  std::vector<Key> keys(num_keys);
+  std::vector<float> values(num_keys * dim);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<Key>(gen() % (num_keys * 2));
+    std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+  }
+
+  auto db = std::make_unique<RocksDBBackend<Key>>(path);
+
+  // Empty table: Bulk insertion.
+  EXPECT_TRUE(db->insert(tag0, num_keys, keys.data(),
+                         reinterpret_cast<const char*>(values.data()), value_size));
+
+  // Non-empty table: Batched insertion.
+  EXPECT_TRUE(db->insert(tag1, 1, keys.data(), reinterpret_cast<const char*>(values.data()),
+                         value_size));
+  EXPECT_TRUE(db->insert(tag1, num_keys, keys.data(),
+                         reinterpret_cast<const char*>(values.data()), value_size));
+
+  // Both tables must be identical, and the last occurrence of each key wins.
+  std::unordered_map<Key, size_t> last;
+  for (size_t i = 0; i < num_keys; i++) {
+    last[keys[i]] = i;
+  }
+  for (const std::string& tag : {tag0, tag1}) {
+    std::vector<float> fetched(num_keys * dim, -1);
+    std::vector<size_t> missing;
+    EXPECT_EQ(db->fetch(tag, num_keys, keys.data(), reinterpret_cast<char*>(fetched.data()),
+                        value_size, value_size, missing, std::chrono::nanoseconds::max()),
+              num_keys);
+    EXPECT_TRUE(missing.empty());
+    for (size_t i = 0; i < num_keys; i++) {
+      ASSERT_EQ(fetched[i * dim], static_cast<float>(last[keys[i]]));
+    }
+  }
+  EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(path) / "ingest"));
+
+  db.reset();
+  std::filesystem::remove_all(path);
+}
+
+}  // namespace
+
+TEST(db_backend_rocksdb_bulk_insert, RocksDB) {
+  db_backend_rocksdb_bulk_insert_test<long long>(100000);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_redis_async_fetch_test(const size_t num_partitions, const size_t batch_size) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "async_fetch");
+  const std::string address = "127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002";
+  const size_t num_keys = 100000;
+  const size_t num_requests = 20;
+  const size_t dim = 32;
+  const size_t value_size = dim * sizeof(float);
+
+  auto sync_db = std::make_unique<RedisClusterBackend<Key>>(address, "default", "",
+                                                            num_partitions, 5, 64L * 1024L,
+                                                            64L * 1024L, false);
+  auto async_db = std::make_unique<RedisClusterBackend<Key>>(address, "default", "",
+                                                             num_partitions, 5, 64L * 1024L,
+                                                             64L * 1024L, true);
+  sync_db->evict(tag);
+
+  // Insert even keys only. Hence, roughly every other key in a request will miss.
+  {
+    std::vector<Key> keys(num_keys);
+    std::vector<float> values(num_keys * dim);
+    for (size_t i = 0; i < num_keys; i++) {
+      keys[i] = static_cast<Key>(i * 2);
+      std::fill_n(&values[i * dim], dim, static_cast<float>(i));
+    }
+    sync_db->insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+                    value_size);
+  }
+
+  std::mt19937_64 gen{42};
+  std::vector<std::vector<Key>> requests(num_requests, std::vector<Key>(batch_size));
+  for (std::vector<Key>& request : requests) {
+    for (Key& k : request) {
+      k = static_cast<Key>(gen() % (num_keys * 2));
+    }
+  }
+
+  auto run = [&](DatabaseBackend<Key>& db, std::vector<std::vector<float>>& results) {
+    results.resize(num_requests);
+    for (size_t r = 0; r < num_requests; r++) {
+      std::vector<float>& values = results[r];
+      values.assign(batch_size * dim, -1);
+      std::vector<size_t> missing;
+      db.fetch(tag, batch_size, requests[r].data(), reinterpret_cast<char*>(values.data()),
+               value_size, value_size, missing, std::chrono::nanoseconds::max());
+    }
+  };
+
+  std::vector<std::vector<float>> sync_results;
+  run(*sync_db, sync_results);
+  std::vector<std::vector<float>> async_results;
+  run(*async_db, async_results);
+
+  for (size_t r = 0; r < num_requests; r++) {
+    for (size_t i = 0; i < batch_size; i++) {
+      const Key k = requests[r][i];
+      const float expected = (k % 2 == 0) ? static_cast<float>(k / 2) : -1.f;
+      ASSERT_EQ(sync_results[r][i * dim], expected);
+      ASSERT_EQ(async_results[r][i * dim], expected);
+    }
+  }
+
+  // Indexed callback variant.
+  std::vector<size_t> indices(batch_size / 2);
+  std::iota(indices.begin(), indices.end(), size_t{0});
+  size_t num_hits = 0;
+  std::mutex hit_guard;
+  const size_t hit_count = async_db->fetch(
+      tag, indices.size(), indices.data(), requests[0].data(),
+      [&](const size_t index, const char* const value, const size_t size) {
+        ASSERT_EQ(size, value_size);
+        ASSERT_EQ(*reinterpret_cast<const float*>(value),
+                  static_cast<float>(requests[0][index] / 2));
+        std::lock_guard<std::mutex> lock(hit_guard);
+        num_hits++;
+      },
+      [&](const size_t index) { ASSERT_EQ(requests[0][index] % 2, Key{1}); },
+      std::chrono::nanoseconds::max());
+  EXPECT_EQ(hit_count, num_hits);
+
+  sync_db->evict(tag);
+}
+
+}  // namespace
+
+TEST(db_backend_redis_async_fetch, SmallBatch) {
+  db_backend_redis_async_fetch_test<long long>(8, 1024);
+}
+TEST(db_backend_redis_async_fetch, LargeBatch) {
+  db_backend_redis_async_fetch_test<long long>(8, 32 * 1024);
+}
+TEST(db_backend_redis_async_fetch, ManyPartitions) {
+  db_backend_redis_async_fetch_test<long long>(64, 32 * 1024);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_redis_overflow_test(const DatabaseOverflowPolicy_t overflow_policy) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "overflow");
+  const size_t num_keys = 1000;
+  const size_t overflow_margin = 1500;
+  const double overflow_resolution_target = 0.8;
+
+  // Single partition, to make the outcome deterministic.
+  RedisClusterBackend<Key> db("127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002", "default", "", 1, 1,
+                              64L * 1024L, 64L * 1024L, false, 16, false, overflow_margin,
+                              overflow_policy, overflow_resolution_target);
+  db.evict(tag);
+
+  std::vector<Key> keys(num_keys * 2);
+  std::iota(keys.begin(), keys.end(), Key{0});
+  const std::vector<double> values(keys.size(), 1.0);
+
+  // Timestamps have a resolution of 1 second.
+  db.insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+            sizeof(double));
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  db.insert(tag, num_keys, &keys[num_keys], reinterpret_cast<const char*>(values.data()),
+            sizeof(double));
+
+  // Values and access times must stay consistent.
+  const size_t target = static_cast<size_t>(overflow_margin * overflow_resolution_target);
+  EXPECT_EQ(db.size(tag), target);
+  std::vector<Key> remaining = db.keys(tag);
+  EXPECT_EQ(remaining.size(), target);
+  EXPECT_EQ(db.contains(tag, remaining.size(), remaining.data(), std::chrono::nanoseconds::max()),
+            target);
+
+  // The newer keys must survive oldest-first eviction.
+  if (overflow_policy == DatabaseOverflowPolicy_t::EvictOldest) {
+    EXPECT_EQ(db.contains(tag, num_keys, &keys[num_keys], std::chrono::nanoseconds::max()),
+              num_keys);
+  }
+  db.evict(tag);
+}
+
+}  // namespace
+
+TEST(db_backend_redis_overflow, EvictOldest) {
+  db_backend_redis_overflow_test<long long>(DatabaseOverflowPolicy_t::EvictOldest);
+}
+TEST(db_backend_redis_overflow, EvictRandom) {
+  db_backend_redis_overflow_test<long long>(DatabaseOverflowPolicy_t::EvictRandom);
+}
+
+namespace {
+
+template <typename Key>
+void db_backend_redis_legacy_layout_test() {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "legacy");
+  const size_t num_keys = 1000;
+  const size_t overflow_margin = 1500;
+  const double overflow_resolution_target = 0.8;
+
+  RedisClusterBackend<Key> db("127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002", "default", "", 1, 1,
+                              64L * 1024L, 64L * 1024L, false, 16, false, overflow_margin,
+                              DatabaseOverflowPolicy_t::EvictOldest, overflow_resolution_target);
+  db.evict(tag);
+
+  std::vector<Key> keys(num_keys * 2);
+  std::iota(keys.begin(), keys.end(), Key{0});
+  const double value = 1.0;
+
+  // Write the first half with the previous layout (access times in a hash).
+  const std::string hkey_v = "hps_et{" + tag + "/p0}v";
+  const std::string hkey_l = "hps_et{" + tag + "/p0}t";
+  {
+    sw::redis::RedisCluster redis("tcp://127.0.0.1:7000");
+    const time_t then = std::time(nullptr) - 60;
+    for (size_t i = 0; i < num_keys; i++) {
+      const std::string_view k_view{reinterpret_cast<const char*>(&keys[i]), sizeof(Key)};
+      redis.hset(hkey_v, k_view, {reinterpret_cast<const char*>(&value), sizeof(double)});
+      redis.hset(hkey_l, k_view, {reinterpret_cast<const char*>(&then), sizeof(time_t)});
+    }
+  }
+
+  // Keys of partitions that were not migrated yet must be listed (used by dump_bin / dump_sst).
+  EXPECT_EQ(db.keys(tag).size(), num_keys);
+
+  // Legacy values must be accounted for, and evicted first.
+  const std::vector<double> values(num_keys, value);
+  db.insert(tag, num_keys, &keys[num_keys], reinterpret_cast<const char*>(values.data()),
+            sizeof(double));
+  const size_t target = static_cast<size_t>(overflow_margin * overflow_resolution_target);
+  EXPECT_EQ(db.size(tag), target);
+  EXPECT_EQ(db.contains(tag, num_keys, &keys[num_keys], std::chrono::nanoseconds::max()),
+            num_keys);
+
+  // The legacy access time hash must be gone.
+  db.evict(tag);
+  sw::redis::RedisCluster redis("tcp://127.0.0.1:7000");
+  EXPECT_EQ(redis.exists(hkey_l), 0);
+}
+
+}  // namespace
+
+TEST(db_backend_redis_overflow, LegacyLayout) { db_backend_redis_legacy_layout_test<long long>(); }
+
+namespace {
+
+void db_backend_value_codec_test(const DatabaseValueCodec_t codec, const double max_rel_error) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "codec");
+  const size_t num_keys = 10000;
+  const size_t dim = 128;
+  const size_t value_size = value_codec_size(codec, dim);
+
+  // Typical embeddings are small and centered around 0. Add a few outliers.
+  std::mt19937 gen(4711);
+  std::normal_distribution<float> dist(0.f, 0.05f);
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0LL);
+  std::vector<float> values(num_keys * dim);
+  std::generate(values.begin(), values.end(), [&]() { return dist(gen); });
+  for (size_t i = 0; i < num_keys; i += 97) {
+    values[i * dim + i % dim] = 4.f;
+  }
+
+  std::vector<char> encoded(num_keys * value_size);
+  encode_values(codec, num_keys, dim, values.data(), encoded.data());
+  std::vector<float> decoded(num_keys * dim);
+  decode_values(codec, num_keys, dim, encoded.data(), decoded.data());
+
+  // Error relative to the range of each embedding vector.
+  double max_rel = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    const auto [lo, hi] = std::minmax_element(&values[i * dim], &values[(i + 1) * dim]);
+    for (size_t j = i * dim; j < (i + 1) * dim; j++) {
+      const double error = std::abs(static_cast<double>(values[j]) - decoded[j]);
+      max_rel = std::max(max_rel, error / static_cast<double>(*hi - *lo));
+    }
+  }
+  EXPECT_LE(max_rel, max_rel_error);
+
+  // Round trip through a database.
+  HashMapBackend<long long> db(16);
+  db.insert(tag, num_keys, keys.data(), encoded.data(), value_size);
+  EXPECT_EQ(db.size(tag), num_keys);
+
+  std::vector<char> fetched(num_keys * value_size);
+  std::vector<size_t> missing;
+  EXPECT_EQ(db.fetch(tag, num_keys, keys.data(), fetched.data(), value_size, value_size, missing,
+                     std::chrono::nanoseconds::max()),
+            num_keys);
+  EXPECT_TRUE(missing.empty());
+
+  std::vector<float> fetched_decoded(num_keys * dim);
+  decode_values(codec, num_keys, dim, fetched.data(), fetched_decoded.data());
+  EXPECT_TRUE(fetched_decoded == decoded);
+  db.evict(tag);
+}
+
+}  // namespace
+
+TEST(db_backend_value_codec, Float32) {
+  db_backend_value_codec_test(DatabaseValueCodec_t::Float32, 0);
+}
+TEST(db_backend_value_codec, Float16) {
+  db_backend_value_codec_test(DatabaseValueCodec_t::Float16, 1.0 / 2048);
+}
+TEST(db_backend_value_codec, BFloat16) {
+  db_backend_value_codec_test(DatabaseValueCodec_t::BFloat16, 1.0 / 256);
+}
+TEST(db_backend_value_codec, Int8) {
+  db_backend_value_codec_test(DatabaseValueCodec_t::Int8, 1.0 / 510 + 1e-6);
+}
+
+namespace {
+
+void db_backend_sharded_resize_test(const size_t num_shards, const size_t new_num_shards) {
+  const std::string tag = HierParameterServerBase::make_tag_name("mdl", "sharded");
+  const size_t num_keys = 100000;
+
+  ShardedHashMapBackend<long long> db(num_shards, true, 1024 * 1024);
+  EXPECT_EQ(db.num_shards(), num_shards);
+
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0LL);
+  std::vector<double> values(num_keys);
+  std::transform(keys.begin(), keys.end(), values.begin(),
+                 [](const long long k) { return static_cast<double>(k) * 0.5; });
+  db.insert(tag, num_keys, keys.data(), reinterpret_cast<const char*>(values.data()),
+            sizeof(double));
+  EXPECT_EQ(db.size(tag), num_keys);
+
+  // Keys should be spread roughly evenly.
+  std::vector<size_t> owners(num_keys);
+  std::vector<size_t> shard_sizes(num_shards);
+  for (size_t i = 0; i < num_keys; i++) {
+    owners[i] = db.shard_of(keys[i]);
+    shard_sizes[owners[i]]++;
+  }
+  const size_t max_size = *std::max_element(shard_sizes.begin(), shard_sizes.end());
+  EXPECT_LE(max_size, 2 * num_keys / num_shards);
+
+  // Only keys that belong to new shards (or lost their shard) should move.
+  db.resize(new_num_shards);
+  EXPECT_EQ(db.num_shards(), new_num_shards);
+  EXPECT_EQ(db.size(tag), num_keys);
+
+  size_t num_moved = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    const size_t owner = db.shard_of(keys[i]);
+    EXPECT_LT(owner, new_num_shards);
+    if (owner != owners[i]) {
+      num_moved++;
+      EXPECT_TRUE(owner >= num_shards || owners[i] >= new_num_shards);
+    }
+  }
+  const double expected_moved = std::abs(static_cast<double>(new_num_shards) - num_shards) /
+                                static_cast<double>(std::max(num_shards, new_num_shards));
+  const double moved = static_cast<double>(num_moved) / num_keys;
+  EXPECT_LE(moved, expected_moved * 1.5);
+
+  // All values must still be there.
+  std::vector<double> fetched(num_keys);
+  std::vector<size_t> missing;
+  EXPECT_EQ(db.fetch(tag, num_keys, keys.data(), reinterpret_cast<char*>(fetched.data()),
+                     sizeof(double), sizeof(double), missing, std::chrono::nanoseconds::max()),
+            num_keys);
+  EXPECT_TRUE(missing.empty());
+  EXPECT_TRUE(fetched == values);
+
+  EXPECT_EQ(db.evict(tag), num_keys);
+  EXPECT_TRUE(db.find_tables("mdl").empty());
+}
+
+}  // namespace
+
+TEST(db_backend_sharded_hash_map, Grow) { db_backend_sharded_resize_test(8, 12); }
+TEST(db_backend_sharded_hash_map, Shrink) { db_backend_sharded_resize_test(16, 12); }
+
+namespace {
+
+void db_backend_key_filter_test(const double bits_per_key, const double max_false_positive_rate) {
+  const size_t num_keys = 100000;
+
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0LL);
+  KeyFilter filter(num_keys, bits_per_key);
+
+  filter.insert(keys.size(), keys.data());
+  EXPECT_EQ(filter.num_inserted(), num_keys);
+
+  // Inserted keys must always pass.
+  size_t num_false_negatives = 0;
+  for (const long long k : keys) {
+    num_false_negatives += !filter.may_contain(k);
+  }
+  EXPECT_EQ(num_false_negatives, 0);
+
+  // Keys that were never inserted (e.g., new IDs at serving time).
+  size_t num_false_positives = 0;
+  for (long long k = num_keys; k < static_cast<long long>(2 * num_keys); k++) {
+    num_false_positives += filter.may_contain(k);
+  }
+
+  const double fpr = static_cast<double>(num_false_positives) / static_cast<double>(num_keys);
+  EXPECT_LE(fpr, max_false_positive_rate);
+}
+
+}  // namespace
+
+TEST(db_backend_key_filter, Bits8) { db_backend_key_filter_test(8, 0.035); }
+TEST(db_backend_key_filter, Bits10) { db_backend_key_filter_test(10, 0.015); }
+TEST(db_backend_key_filter, Bits16) { db_backend_key_filter_test(16, 0.002); }
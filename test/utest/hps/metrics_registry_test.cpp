@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <hps/metrics_registry.hpp>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+std::string http_get(const uint16_t port, const std::string& path) {
+  const int s = ::socket(AF_INET, SOCK_STREAM, 0);
+  EXPECT_GE(s, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  EXPECT_EQ(::connect(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)), 0);
+
+  const std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  EXPECT_EQ(::send(s, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+
+  std::string response;
+  char buffer[4096];
+  for (ssize_t n; (n = ::recv(s, buffer, sizeof(buffer), 0)) > 0;) {
+    response.append(buffer, n);
+  }
+  ::close(s);
+  return response;
+}
+
+}  // namespace
+
+TEST(metrics_registry, counter_is_exact_across_threads) {
+  MetricCounter& counter =
+      MetricsRegistry::get().counter("test_counter_total", "Test counter.", {{"case", "threads"}});
+  const size_t num_threads = 8;
+  const size_t num_adds = 100000;
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&]() {
+      for (size_t i = 0; i < num_adds; i++) {
+        counter.add();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter.value(), num_threads * num_adds);
+
+  // Same name and labels yield the same metric.
+  EXPECT_EQ(&MetricsRegistry::get().counter("test_counter_total", "", {{"case", "threads"}}),
+            &counter);
+}
+
+TEST(metrics_registry, histogram_buckets) {
+  for (uint64_t value = 0; value < 100000; value++) {
+    const size_t index = MetricHistogram::bucket_index(value);
+    ASSERT_LE(MetricHistogram::bucket_lower_bound(index), value);
+    ASSERT_GT(MetricHistogram::bucket_lower_bound(index + 1), value);
+  }
+  for (size_t shift = 0; shift < 64; shift++) {
+    const uint64_t value = uint64_t{1} << shift;
+    ASSERT_LT(MetricHistogram::bucket_index(value), MetricHistogram::num_buckets);
+    ASSERT_LT(MetricHistogram::bucket_index(value | (value - 1)), MetricHistogram::num_buckets);
+    EXPECT_EQ(MetricHistogram::bucket_lower_bound(MetricHistogram::bucket_index(value)), value);
+  }
+}
+
+TEST(metrics_registry, histogram_quantiles) {
+  MetricHistogram histogram;
+  EXPECT_EQ(histogram.quantile(0.5), 0);
+
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<uint64_t> dist(1000, 1000000);
+  std::vector<uint64_t> values(100000);
+  for (uint64_t& value : values) {
+    value = dist(gen);
+    histogram.record(value);
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(histogram.count(), values.size());
+
+  for (const double q : {0.5, 0.9, 0.99, 0.999}) {
+    const double expected = static_cast<double>(values[static_cast<size_t>(q * values.size())]);
+    const double actual = static_cast<double>(histogram.quantile(q));
+    EXPECT_LE(std::abs(actual - expected) / expected, 1. / MetricHistogram::num_sub_buckets);
+  }
+}
+
+TEST(metrics_registry, prometheus_text) {
+  MetricsRegistry& registry = MetricsRegistry::get();
+  registry.counter("test_export_total", "Exported counter.", {{"table", "t\"1"}}).add(3);
+  registry.gauge("test_export_gauge", "Exported gauge.").set(0.25);
+  MetricHistogram& histogram =
+      registry.histogram("test_export_duration_seconds", "Exported histogram.");
+  histogram.record(std::chrono::microseconds{500});
+  histogram.record(std::chrono::milliseconds{20});
+
+  const std::string text = registry.to_prometheus();
+  std::cout << text;
+  EXPECT_NE(text.find("# TYPE test_export_total counter\n"), std::string::npos);
+  EXPECT_NE(text.find("test_export_total{table=\"t\\\"1\"} 3\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_export_gauge gauge\n"), std::string::npos);
+  EXPECT_NE(text.find("test_export_gauge 0.25\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_export_duration_seconds histogram\n"), std::string::npos);
+  EXPECT_NE(text.find("test_export_duration_seconds_bucket{le=\"0.001048576\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_export_duration_seconds_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+  EXPECT_NE(text.find("test_export_duration_seconds_sum 0.0205\n"), std::string::npos);
+  EXPECT_NE(text.find("test_export_duration_seconds_count 2\n"), std::string::npos);
+
+  // Reusing a name with a different type is an error.
+  EXPECT_THROW(registry.gauge("test_export_total", ""), std::exception);
+}
+
+TEST(metrics_registry, http_server) {
+  MetricsRegistry::get().counter("test_http_total", "Scraped counter.").add(7);
+
+  MetricsHttpServer server(0);
+  ASSERT_NE(server.port(), 0);
+
+  const std::string response = http_get(server.port(), "/metrics");
+  EXPECT_EQ(response.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+  EXPECT_NE(response.find("\r\n\r\n# HELP "), std::string::npos);
+  EXPECT_NE(response.find("test_http_total 7\n"), std::string::npos);
+
+  EXPECT_EQ(http_get(server.port(), "/other").compare(0, 12, "HTTP/1.1 404"), 0);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cpu/embedding_feature_combiner_cpu.hpp>
+#include <general_buffer2.hpp>
+#include <hps/hash_map_backend.hpp>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+// Checks the fused embedding bag and the separate lookup + combine against a scalar reference.
+// Embedding vectors are either fetched from a HashMap database (like the parameter server of the
+// CPU inference session does), or copied from a dense table. With `max_hotness = 0`, all slots of
+// every other sample are empty.
+void cpu_embedding_bag_test(const int batch_size, const int slot_num, const int max_hotness,
+                            const int embedding_vec_size,
+                            const EmbeddingFeatureCombiner_t combiner_type,
+                            const bool use_hash_map) {
+  const std::string tag = "hps_et.mdl.bag";
+  const size_t num_table_keys = 64 * 1024;
+
+  // Embedding table.
+  std::mt19937_64 gen(4711);
+  std::normal_distribution<float> value_dist(0.f, 1.f);
+  std::vector<float> table(num_table_keys * embedding_vec_size);
+  std::generate(table.begin(), table.end(), [&]() { return value_dist(gen); });
+  HashMapBackend<long long> db(16, 64 * 1024 * 1024);
+  if (use_hash_map) {
+    std::vector<long long> keys(num_table_keys);
+    std::iota(keys.begin(), keys.end(), 0LL);
+    db.insert(tag, num_table_keys, keys.data(), reinterpret_cast<const char*>(table.data()),
+              embedding_vec_size * sizeof(float));
+  }
+
+  // Queries with variable hotness (1..max_hotness features per slot).
+  const int hotness = std::max(max_hotness, 1);
+  std::uniform_int_distribution<int> nnz_dist(1, hotness);
+  std::uniform_int_distribution<long long> key_dist(0, num_table_keys - 1);
+  std::vector<int> h_row_ptrs(batch_size * slot_num + 1);
+  h_row_ptrs[0] = 0;
+  for (size_t i = 1; i < h_row_ptrs.size(); i++) {
+    const bool empty = max_hotness == 0 && ((i - 1) / slot_num) % 2 == 1;
+    h_row_ptrs[i] = h_row_ptrs[i - 1] + (empty ? 0 : nnz_dist(gen));
+  }
+  const size_t num_keys = h_row_ptrs.back();
+  std::vector<long long> h_keys(num_keys);
+  std::generate(h_keys.begin(), h_keys.end(), [&]() { return key_dist(gen); });
+
+  // Reference.
+  std::vector<float> expected(static_cast<size_t>(batch_size) * slot_num * embedding_vec_size);
+  for (int i = 0; i < batch_size * slot_num; i++) {
+    const int feature_num = h_row_ptrs[i + 1] - h_row_ptrs[i];
+    for (int k = 0; k < embedding_vec_size; k++) {
+      double sum = 0;
+      for (int l = h_row_ptrs[i]; l < h_row_ptrs[i + 1]; l++) {
+        sum += table[h_keys[l] * embedding_vec_size + k];
+      }
+      if (combiner_type == EmbeddingFeatureCombiner_t::Mean && feature_num > 0) {
+        sum /= feature_num;
+      }
+      expected[static_cast<size_t>(i) * embedding_vec_size + k] = static_cast<float>(sum);
+    }
+  }
+  auto check = [&](const float* const out, const size_t num_valid) {
+    for (size_t i = 0; i < num_valid; i++) {
+      ASSERT_NEAR(out[i], expected[i], 1e-4f * (1.f + std::abs(expected[i])));
+    }
+  };
+
+  // Combiner.
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  auto row_ptrs_tensor = std::make_shared<Tensor2<int>>();
+  buff->reserve({h_row_ptrs.size()}, row_ptrs_tensor.get());
+  auto in_tensor = std::make_shared<Tensor2<float>>();
+  buff->reserve({static_cast<size_t>(batch_size * slot_num * hotness),
+                 static_cast<size_t>(embedding_vec_size)},
+                in_tensor.get());
+  Tensor2<float> out_tensor;
+  EmbeddingFeatureCombinerCPU<float> combiner(in_tensor, row_ptrs_tensor, out_tensor, batch_size,
+                                              slot_num, combiner_type, buff);
+  buff->allocate();
+  std::copy(h_row_ptrs.begin(), h_row_ptrs.end(), row_ptrs_tensor->get_ptr());
+  const size_t out_size = out_tensor.get_num_elements();
+
+  std::vector<size_t> missing;
+  size_t next_key = 0;
+  size_t num_lookups = 0;
+  auto lookup = [&](const size_t count, float* const vectors) {
+    ASSERT_LE(next_key + count, num_keys);
+    num_lookups++;
+    if (use_hash_map) {
+      db.fetch(tag, count, &h_keys[next_key], reinterpret_cast<char*>(vectors),
+               embedding_vec_size * sizeof(float), embedding_vec_size * sizeof(float), missing,
+               std::chrono::nanoseconds::max());
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        std::copy_n(&table[h_keys[next_key + i] * embedding_vec_size], embedding_vec_size,
+                    &vectors[i * embedding_vec_size]);
+      }
+    }
+    next_key += count;
+  };
+
+  // Separate: Materialize all vectors, then combine.
+  lookup(num_keys, in_tensor->get_ptr());
+  combiner.fprop(false);
+  check(out_tensor.get_ptr(), out_size);
+
+  // Fused: Chunks cover all keys once, in order.
+  std::fill_n(out_tensor.get_ptr(), out_size, -1.f);
+  next_key = 0;
+  num_lookups = 0;
+  combiner.fprop_fused(lookup, batch_size);
+  EXPECT_EQ(next_key, num_keys);
+  EXPECT_LE(num_lookups, num_keys);
+  check(out_tensor.get_ptr(), out_size);
+
+  // Padding samples are zeroed.
+  if (batch_size > 1) {
+    next_key = 0;
+    combiner.fprop_fused(lookup, batch_size / 2);
+    const float* const out = out_tensor.get_ptr();
+    const size_t num_valid = static_cast<size_t>(batch_size / 2) * slot_num * embedding_vec_size;
+    check(out, num_valid);
+    EXPECT_TRUE(std::all_of(out + num_valid, out + out_size, [](float x) { return x == 0.f; }));
+  }
+}
+
+}  // namespace
+
+TEST(cpu_embedding_bag, 1hot_Sum) {
+  cpu_embedding_bag_test(256, 26, 1, 128, EmbeddingFeatureCombiner_t::Sum, false);
+}
+TEST(cpu_embedding_bag, 100hot_Sum) {
+  cpu_embedding_bag_test(256, 4, 100, 128, EmbeddingFeatureCombiner_t::Sum, false);
+}
+TEST(cpu_embedding_bag, 100hot_Mean) {
+  cpu_embedding_bag_test(256, 4, 100, 16, EmbeddingFeatureCombiner_t::Mean, false);
+}
+TEST(cpu_embedding_bag, EmptySlots_Sum) {
+  cpu_embedding_bag_test(256, 4, 0, 16, EmbeddingFeatureCombiner_t::Sum, false);
+}
+TEST(cpu_embedding_bag, EmptySlots_Mean) {
+  cpu_embedding_bag_test(256, 4, 0, 16, EmbeddingFeatureCombiner_t::Mean, false);
+}
+TEST(cpu_embedding_bag, 1hot_Sum_HashMap) {
+  cpu_embedding_bag_test(256, 26, 1, 128, EmbeddingFeatureCombiner_t::Sum, true);
+}
+TEST(cpu_embedding_bag, 100hot_Mean_HashMap) {
+  cpu_embedding_bag_test(256, 4, 100, 128, EmbeddingFeatureCombiner_t::Mean, true);
+}
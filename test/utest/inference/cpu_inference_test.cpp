@@ -18,13 +18,19 @@
 #include <gtest/gtest.h>
 #include <utest/test_utils.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cpu/batching_inference_session_cpu.hpp>
 #include <cpu/embedding_feature_combiner_cpu.hpp>
 #include <cpu/inference_session_cpu.hpp>
 #include <data_generator.hpp>
 #include <fstream>
+#include <future>
 #include <general_buffer2.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/inference_utils.hpp>
+#include <numeric>
+#include <random>
 #include <utils.hpp>
 #include <vector>
 
@@ -233,7 +239,7 @@ void session_inference_criteo_test(const std::string& config_file, const std::st
   timer_inference.stop();
 
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "==========================labels===================" << std::endl;
     for (int i = 0; i < num_samples; i++) {
       log << labels[i] << " ";
@@ -241,7 +247,7 @@ void session_inference_criteo_test(const std::string& config_file, const std::st
     log << std::endl;
   }
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "==========================prediction result===================" << std::endl;
     for (int i = 0; i < num_samples; i++) {
       log << h_out[i] << " ";
@@ -321,7 +327,7 @@ void session_inference_generated_test(const std::string& config_file, const std:
   timer_inference.stop();
 
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "==========================prediction result===================" << std::endl;
     for (int i = 0; i < num_samples; i++) {
       log << h_out[i] << " ";
@@ -333,6 +339,130 @@ void session_inference_generated_test(const std::string& config_file, const std:
   host_allocator.deallocate(h_embeddingcolumns);
 }
 
+// One request of a simulated client (one key per slot). Buffers are sized for \p capacity
+// samples, because InferenceSessionCPU always reads full batches.
+template <typename TypeHashKey>
+struct GeneratedRequest {
+  int num_samples;
+  std::vector<float> dense;
+  std::vector<TypeHashKey> keys;
+  std::vector<int> row_ptrs;
+  std::vector<float> output;
+};
+
+template <typename TypeHashKey>
+GeneratedRequest<TypeHashKey> generate_request(const InferenceInfo& inference_info,
+                                               const int num_samples, const int capacity,
+                                               std::mt19937& gen) {
+  const int dense_dim = inference_info.dense_dim;
+  const int slot_num = inference_info.slot_num[0];
+  GeneratedRequest<TypeHashKey> request;
+  request.num_samples = num_samples;
+
+  std::uniform_real_distribution<float> dense_dist(0, 1);
+  request.dense.resize(capacity * dense_dim);
+  std::generate_n(request.dense.begin(), num_samples * dense_dim,
+                  [&]() { return dense_dist(gen); });
+
+  request.keys.resize(capacity * inference_info.max_feature_num_per_sample[0]);
+  for (int i = 0; i < num_samples; i++) {
+    for (int j = 0; j < slot_num; j++) {
+      std::uniform_int_distribution<long long> key_dist(RANGE[j], RANGE[j + 1] - 1);
+      request.keys[i * slot_num + j] = static_cast<TypeHashKey>(key_dist(gen));
+    }
+  }
+
+  request.row_ptrs.resize(capacity * slot_num + 1);
+  std::iota(request.row_ptrs.begin(), request.row_ptrs.begin() + num_samples * slot_num + 1, 0);
+
+  request.output.resize(capacity);
+  return request;
+}
+
+std::shared_ptr<HierParameterServerBase> create_parameter_server(
+    const std::string& config_file, const InferenceParams& infer_param) {
+  std::vector<InferenceParams> inference_params{infer_param};
+  std::vector<std::string> model_config_path{config_file};
+  parameter_server_config ps_config{model_config_path, inference_params};
+  return HierParameterServerBase::create(ps_config, inference_params);
+}
+
+// Merged batches must produce the same predictions as running each request on its own.
+template <typename TypeHashKey>
+void session_batching_test(const std::string& config_file, const std::string& model,
+                           int num_requests, int max_request_size, int batchsize) {
+  InferenceInfo inference_info(read_json_file(config_file));
+  std::string dense_model{"/hugectr/test/utest/_dense_10000.model"};
+  std::vector<std::string> sparse_models{"/hugectr/test/utest/0_sparse_10000.model"};
+  InferenceParams infer_param(model, batchsize, 0.5, dense_model, sparse_models, 0, true, 0.8,
+                              false);
+  infer_param.i64_input_key = std::is_same<TypeHashKey, long long>::value;
+  auto parameter_server = create_parameter_server(config_file, infer_param);
+
+  // Requests are merged in order, and a batch is only dispatched early if the next request does
+  // not fit. The last request fills up the last batch, so that no batch waits for the deadline.
+  std::mt19937 gen(4711);
+  std::uniform_int_distribution<int> size_dist(1, max_request_size);
+  std::vector<int> request_sizes;
+  size_t expected_num_batches = 0;
+  int batch_fill = batchsize;
+  for (int i = 0; i < num_requests; i++) {
+    request_sizes.emplace_back(size_dist(gen));
+    if (batch_fill + request_sizes.back() > batchsize) {
+      expected_num_batches++;
+      batch_fill = 0;
+    }
+    batch_fill += request_sizes.back();
+  }
+  if (batch_fill < batchsize) {
+    request_sizes.emplace_back(batchsize - batch_fill);
+  }
+  std::vector<GeneratedRequest<TypeHashKey>> requests;
+  for (const int num_samples : request_sizes) {
+    requests.emplace_back(generate_request<TypeHashKey>(inference_info, num_samples, batchsize,
+                                                        gen));
+  }
+
+  // Reference: One request at a time.
+  std::vector<std::vector<float>> expected;
+  {
+    InferenceSessionCPU<TypeHashKey> sess(config_file, infer_param, parameter_server);
+    for (auto& request : requests) {
+      sess.predict(request.dense.data(), request.keys.data(), request.row_ptrs.data(),
+                   request.output.data(), request.num_samples);
+      expected.emplace_back(request.output.begin(),
+                            request.output.begin() + request.num_samples);
+      std::fill(request.output.begin(), request.output.end(), -1.f);
+    }
+  }
+
+  // Concurrent requests, merged by the batching session.
+  BatchingInferenceSessionCPU<TypeHashKey> sess(config_file, infer_param, parameter_server, 2,
+                                                std::chrono::hours(1));
+  std::vector<std::future<void>> done;
+  for (auto& request : requests) {
+    done.emplace_back(sess.predict_async(request.dense.data(), request.keys.data(),
+                                         request.row_ptrs.data(), request.output.data(),
+                                         request.num_samples));
+  }
+  for (auto& d : done) {
+    d.get();
+  }
+  for (size_t i = 0; i < requests.size(); i++) {
+    for (int j = 0; j < requests[i].num_samples; j++) {
+      ASSERT_NEAR(requests[i].output[j], expected[i][j], 1e-5);
+    }
+  }
+  EXPECT_EQ(sess.num_requests(), requests.size());
+  EXPECT_EQ(sess.num_batches(), expected_num_batches);
+
+  // Oversized requests are rejected.
+  EXPECT_THROW(sess.predict(requests[0].dense.data(), requests[0].keys.data(),
+                            requests[0].row_ptrs.data(), requests[0].output.data(),
+                            batchsize + 1),
+               std::exception);
+}
+
 }  // namespace
 
 TEST(session_inference_cpu, criteo_dcn) {
@@ -342,4 +472,8 @@ TEST(session_inference_cpu, criteo_dcn) {
 TEST(session_inference_cpu, generated_dcn_32) {
   session_inference_generated_test<unsigned int>("/workdir/test/utest/simple_inference_config.json",
                                                  "DCN", 32, 32);
-}
\ No newline at end of file
+}
+TEST(session_inference_cpu, batching_dcn) {
+  session_batching_test<unsigned int>("/workdir/test/utest/simple_inference_config.json", "DCN",
+                                      64, 16, 256);
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cpu/layers/fully_connected_layer_cpu.hpp>
+#include <cpu/layers/fused_fully_connected_layer_cpu.hpp>
+#include <cpu/layers/multi_cross_layer_cpu.hpp>
+#include <cpu/quantization_cpu.hpp>
+#include <general_buffer2.hpp>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+// Compares INT8 layers with their floating point version (relative L2 error). Timings are in
+// test/cpu_inference_perf_test.
+
+template <typename T>
+double relative_error(const T* actual, const std::vector<float>& expected) {
+  double num = 0, den = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    const double d = static_cast<double>(actual[i]) - static_cast<double>(expected[i]);
+    num += d * d;
+    den += static_cast<double>(expected[i]) * static_cast<double>(expected[i]);
+  }
+  return std::sqrt(num / den);
+}
+
+// Activations are post-ReLU (non-negative), weights are centered.
+template <typename T>
+void fill_inputs(T* in, const size_t in_size, float* weights, const size_t weights_size,
+                 std::mt19937& gen, const float weight_scale) {
+  std::normal_distribution<float> dist(0.f, 1.f);
+  for (size_t i = 0; i < in_size; i++) {
+    in[i] = std::max(dist(gen), 0.f);
+  }
+  for (size_t i = 0; i < weights_size; i++) {
+    weights[i] = dist(gen) * weight_scale;
+  }
+}
+
+void fully_connected_int8_test(const size_t m, const size_t k, const size_t n) {
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  std::shared_ptr<BufferBlock2<float>> weight_buff = buff->create_block<float>();
+  std::shared_ptr<BufferBlock2<float>> wgrad_buff = buff->create_block<float>();
+  Tensor2<float> in_tensor, out_tensor;
+  buff->reserve({m, k}, &in_tensor);
+  buff->reserve({m, n}, &out_tensor);
+  FullyConnectedLayerCPU<float> layer(weight_buff, wgrad_buff, in_tensor, out_tensor, false);
+  buff->allocate();
+  layer.initialize();
+
+  std::mt19937 gen(4711);
+  Tensor2<float> weights = weight_buff->as_tensor();
+  fill_inputs(in_tensor.get_ptr(), m * k, weights.get_ptr(), weights.get_num_elements(), gen,
+              1.f / std::sqrt(static_cast<float>(k)));
+
+  layer.fprop(false);
+  const std::vector<float> expected(out_tensor.get_ptr(), out_tensor.get_ptr() + m * n);
+
+  layer.quantize();
+  layer.fprop(false);
+  EXPECT_LT(relative_error(out_tensor.get_ptr(), expected), 0.02);
+}
+
+void fused_fully_connected_int8_test(const size_t m, const size_t k, const size_t n) {
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  std::shared_ptr<BufferBlock2<float>> master_weight_buff = buff->create_block<float>();
+  std::shared_ptr<BufferBlock2<__half>> weight_buff = buff->create_block<__half>();
+  std::shared_ptr<BufferBlock2<__half>> wgrad_buff = buff->create_block<__half>();
+  Tensor2<__half> bottom_tensor, top_tensor;
+  buff->reserve({m, k}, &bottom_tensor);
+  buff->reserve({m, n}, &top_tensor);
+  FusedFullyConnectedLayerCPU layer(master_weight_buff, weight_buff, wgrad_buff, buff,
+                                    bottom_tensor, top_tensor);
+  buff->allocate();
+  layer.initialize();
+
+  std::mt19937 gen(4711);
+  Tensor2<float> master_weights = master_weight_buff->as_tensor();
+  std::vector<float> h_bottom(m * k);
+  fill_inputs(h_bottom.data(), m * k, master_weights.get_ptr(),
+              master_weights.get_num_elements(), gen, 1.f / std::sqrt(static_cast<float>(k)));
+  std::transform(h_bottom.begin(), h_bottom.end(), bottom_tensor.get_ptr(),
+                 [](const float x) { return __float2half(x); });
+  Tensor2<__half> weights = weight_buff->as_tensor();
+  std::transform(master_weights.get_ptr(),
+                 master_weights.get_ptr() + master_weights.get_num_elements(), weights.get_ptr(),
+                 [](const float x) { return __float2half(x); });
+
+  layer.fprop(false);
+  std::vector<float> expected(m * n);
+  std::transform(top_tensor.get_ptr(), top_tensor.get_ptr() + m * n, expected.begin(),
+                 [](const __half x) { return __half2float(x); });
+
+  layer.quantize();
+  layer.fprop(false);
+  std::vector<float> actual(m * n);
+  std::transform(top_tensor.get_ptr(), top_tensor.get_ptr() + m * n, actual.begin(),
+                 [](const __half x) { return __half2float(x); });
+  EXPECT_LT(relative_error(actual.data(), expected), 0.02);
+}
+
+void multi_cross_int8_test(const size_t batchsize, const size_t w, const int num_layers,
+                           const size_t projection_dim = 0) {
+  std::shared_ptr<GeneralBuffer2<HostAllocator>> buff = GeneralBuffer2<HostAllocator>::create();
+  std::shared_ptr<BufferBlock2<float>> weight_buff = buff->create_block<float>();
+  std::shared_ptr<BufferBlock2<float>> wgrad_buff = buff->create_block<float>();
+  Tensor2<float> in_tensor, out_tensor;
+  buff->reserve({batchsize, w}, &in_tensor);
+  buff->reserve({batchsize, w}, &out_tensor);
+  MultiCrossLayerCPU layer(weight_buff, wgrad_buff, buff, in_tensor, out_tensor, num_layers,
+                           projection_dim);
+  buff->allocate();
+  layer.initialize();
+
+  std::mt19937 gen(4711);
+  Tensor2<float> weights = weight_buff->as_tensor();
+  fill_inputs(in_tensor.get_ptr(), batchsize * w, weights.get_ptr(), weights.get_num_elements(),
+              gen, 1.f / static_cast<float>(w));
+
+  layer.fprop(false);
+  const std::vector<float> expected(out_tensor.get_ptr(), out_tensor.get_ptr() + batchsize * w);
+
+  layer.quantize();
+  layer.fprop(false);
+  EXPECT_LT(relative_error(out_tensor.get_ptr(), expected), 0.02);
+}
+
+void gemm_kernels_test(const size_t m, const size_t k, const size_t n) {
+  std::mt19937 gen(4711);
+  std::normal_distribution<float> dist(0.f, 1.f);
+  std::vector<float> in(m * k), weights(k * n);
+  std::generate(in.begin(), in.end(), [&]() { return dist(gen); });
+  std::generate(weights.begin(), weights.end(), [&]() { return dist(gen); });
+
+  Int8WeightsCPU w;
+  w.quantize(weights.data(), k, n);
+  Int8ActivationsCPU a;
+  a.quantize(in.data(), m, k);
+
+  // All kernels accumulate in INT32. Hence, the result must match a plain integer dot product.
+  std::vector<float> expected(m * n);
+  for (size_t i = 0; i < m; i++) {
+    for (size_t j = 0; j < n; j++) {
+      int32_t dot = 0;
+      for (size_t kk = 0; kk < k; kk++) {
+        dot += a.values[i * a.k_padded + kk] * w.values[j * w.k_padded + kk];
+      }
+      expected[i * n + j] = static_cast<float>(dot) * a.scales[i] * w.scales[j];
+    }
+  }
+
+  const std::vector<Int8GemmKernel_t> kernels = int8_gemm_cpu_kernels();
+  ASSERT_EQ(kernels.back(), Int8GemmKernel_t::Generic);
+  for (const Int8GemmKernel_t kernel : kernels) {
+    std::vector<float> out(m * n, -1.f);
+    int8_gemm_cpu(a, w, out.data(), kernel);
+    EXPECT_TRUE(out == expected) << "kernel " << static_cast<int>(kernel);
+  }
+
+  // The default kernel is the fastest one.
+  std::vector<float> out(m * n, -1.f);
+  int8_gemm_cpu(a, w, out.data());
+  EXPECT_TRUE(out == expected);
+}
+
+}  // namespace
+
+// Odd sizes exercise the partial tiles and the padding of the kernels.
+TEST(cpu_int8, gemm_kernels_5x131x7) { gemm_kernels_test(5, 131, 7); }
+TEST(cpu_int8, gemm_kernels_64x429x256) { gemm_kernels_test(64, 429, 256); }
+TEST(cpu_int8, fully_connected_256x429x1024) { fully_connected_int8_test(256, 429, 1024); }
+TEST(cpu_int8, fully_connected_256x1024x512) { fully_connected_int8_test(256, 1024, 512); }
+TEST(cpu_int8, fully_connected_7x13x5) { fully_connected_int8_test(7, 13, 5); }
+TEST(cpu_int8, fused_fully_connected_256x512x256) {
+  fused_fully_connected_int8_test(256, 512, 256);
+}
+TEST(cpu_int8, multi_cross_256x429x6) { multi_cross_int8_test(256, 429, 6); }
+TEST(cpu_int8, multi_cross_dcnv2_256x429x3x64) { multi_cross_int8_test(256, 429, 3, 64); }
@@ -18,6 +18,7 @@
 #include <math.h>
 #include <utest/test_utils.h>
 
+#include <algorithm>
 #include <cpu/layers/multi_cross_layer_cpu.hpp>
 #include <layer.hpp>
 #include <memory>
@@ -31,6 +32,7 @@ class MultiCrossLayerCPUTest {
   const size_t batchsize_;
   const size_t w_;
   const int layers_;
+  const size_t projection_dim_;
   std::shared_ptr<GeneralBuffer2<HostAllocator>> blob_buf_;
   std::shared_ptr<BufferBlock2<float>> weight_buf_;
   std::shared_ptr<BufferBlock2<float>> wgrad_buf_;
@@ -44,7 +46,8 @@ class MultiCrossLayerCPUTest {
   std::vector<float> h_input_;
   std::vector<float> h_input_grad_;
   std::vector<float> h_output_grad_;
-  std::vector<std::vector<float>> h_kernels_;
+  std::vector<std::vector<float>> h_kernels_;    // DCNv1 kernels, or U of DCNv2
+  std::vector<std::vector<float>> h_v_kernels_;  // V of DCNv2
   std::vector<std::vector<float>> h_biases_;
 
   std::vector<std::vector<float>> h_outputs_;
@@ -59,7 +62,10 @@ class MultiCrossLayerCPUTest {
   void reset_forward_() {
     data_sim_.fill(h_input_.data(), batchsize_ * w_);
     for (auto& a : h_kernels_) {
-      data_sim_.fill(a.data(), w_);
+      data_sim_.fill(a.data(), a.size());
+    }
+    for (auto& a : h_v_kernels_) {
+      data_sim_.fill(a.data(), a.size());
     }
     for (auto& a : h_biases_) {
       data_sim_.fill(a.data(), w_);
@@ -68,14 +74,40 @@ class MultiCrossLayerCPUTest {
 
     float* p = weight_.get_ptr();
     for (int i = 0; i < layers_; i++) {
-      memcpy(p, h_kernels_[i].data(), w_ * sizeof(float));
-      p += w_;
+      memcpy(p, h_kernels_[i].data(), h_kernels_[i].size() * sizeof(float));
+      p += h_kernels_[i].size();
+      if (projection_dim_) {
+        memcpy(p, h_v_kernels_[i].data(), h_v_kernels_[i].size() * sizeof(float));
+        p += h_v_kernels_[i].size();
+      }
       memcpy(p, h_biases_[i].data(), w_ * sizeof(float));
       p += w_;
     }
     return;
   }
 
+  void matrix_matrix_mul(float* out, const float* in_m_1, const float* in_m_2, size_t h, size_t k,
+                         size_t w) {
+    for (size_t j = 0; j < h; j++) {
+      for (size_t i = 0; i < w; i++) {
+        out[j * w + i] = 0.0f;
+        for (size_t l = 0; l < k; l++) {
+          out[j * w + i] += in_m_1[j * k + l] * in_m_2[l * w + i];
+        }
+      }
+    }
+  }
+
+  void matrix_elementwise_mul(float* out, const float* in_m_1, const float* in_m_2, size_t h,
+                              size_t w) {
+    for (size_t j = 0; j < h; j++) {
+      for (size_t i = 0; i < w; i++) {
+        size_t k = j * w + i;
+        out[k] = in_m_1[k] * in_m_2[k];
+      }
+    }
+  }
+
   void matrix_vec_mul(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
     for (size_t j = 0; j < h; j++) {
       out[j] = 0.0f;
@@ -114,6 +146,10 @@ class MultiCrossLayerCPUTest {
   }
 
   void cpu_fprop_() {
+    if (projection_dim_) {
+      cpu_fprop_v2_();
+      return;
+    }
     for (int i = 0; i < layers_; i++) {
       matrix_vec_mul(h_hiddens_[i].data(), i == 0 ? h_input_.data() : h_outputs_[i - 1].data(),
                      h_kernels_[i].data(), batchsize_, w_);
@@ -125,6 +161,21 @@ class MultiCrossLayerCPUTest {
     }
   }
 
+  void cpu_fprop_v2_() {
+    std::vector<float> xu(batchsize_ * projection_dim_);
+    for (int i = 0; i < layers_; i++) {
+      const float* in = i == 0 ? h_input_.data() : h_outputs_[i - 1].data();
+      matrix_matrix_mul(xu.data(), in, h_kernels_[i].data(), batchsize_, w_, projection_dim_);
+      matrix_matrix_mul(h_hiddens_[i].data(), xu.data(), h_v_kernels_[i].data(), batchsize_,
+                        projection_dim_, w_);
+      matrix_vec_add(h_hiddens_[i].data(), h_hiddens_[i].data(), h_biases_[i].data(), batchsize_,
+                     w_);
+      matrix_elementwise_mul(h_outputs_[i].data(), h_input_.data(), h_hiddens_[i].data(),
+                             batchsize_, w_);
+      matrix_add(h_outputs_[i].data(), h_outputs_[i].data(), in, batchsize_, w_);
+    }
+  }
+
   void layer_fprop_() {
     layer_->fprop(false);
     return;
@@ -136,19 +187,26 @@ class MultiCrossLayerCPUTest {
 
     memcpy(d2h_output.data(), output_.get_ptr(), output_.get_size_in_bytes());
 
-    // todo compare
+    // The layer sums in a different order than the reference. Hence, the tolerance grows with the
+    // magnitude of the outputs, which compounds over the cross layers.
+    float max_output = 0.0f;
+    for (float output : h_outputs_.back()) {
+      max_output = std::max(max_output, fabsf(output));
+    }
+    const float tolerance = 0.05f + 1e-5f * max_output;
     for (size_t i = 0; i < h_outputs_.back().size(); i++) {
-      if (abs(d2h_output[i] - h_outputs_.back()[i]) > 0.05f) {
+      if (abs(d2h_output[i] - h_outputs_.back()[i]) > tolerance) {
         HCTR_OWN_THROW(Error_t::WrongInput, "cpu multicross layer wrong result");
       }
     }
   }
 
  public:
-  MultiCrossLayerCPUTest(size_t batchsize, size_t w, int layers)
+  MultiCrossLayerCPUTest(size_t batchsize, size_t w, int layers, size_t projection_dim = 0)
       : batchsize_(batchsize),
         w_(w),
         layers_(layers),
+        projection_dim_(projection_dim),
         blob_buf_(GeneralBuffer2<HostAllocator>::create()),
         data_sim_(0.0f, 1.0f) {
     weight_buf_ = blob_buf_->create_block<float>();
@@ -162,17 +220,23 @@ class MultiCrossLayerCPUTest {
     h_input_grad_.resize(batchsize * w);
 
     for (int i = 0; i < layers_; i++) {
-      h_kernels_.push_back(std::vector<float>(1 * w));
+      if (projection_dim) {
+        h_kernels_.push_back(std::vector<float>(w * projection_dim));
+        h_v_kernels_.push_back(std::vector<float>(projection_dim * w));
+        h_hiddens_.push_back(std::vector<float>(batchsize * w));
+      } else {
+        h_kernels_.push_back(std::vector<float>(1 * w));
+        h_hiddens_.push_back(std::vector<float>(batchsize * 1));
+      }
       h_biases_.push_back(std::vector<float>(1 * w));
       h_outputs_.push_back(std::vector<float>(batchsize * w));
-      h_hiddens_.push_back(std::vector<float>(batchsize * 1));
       h_kernel_grads_.push_back(std::vector<float>(1 * w));
       h_bias_grads_.push_back(std::vector<float>(1 * w));
     }
 
     // layer
-    layer_.reset(
-        new MultiCrossLayerCPU(weight_buf_, wgrad_buf_, blob_buf_, input_, output_, layers));
+    layer_.reset(new MultiCrossLayerCPU(weight_buf_, wgrad_buf_, blob_buf_, input_, output_, layers,
+                                        projection_dim));
 
     blob_buf_->allocate();
     layer_->initialize();
@@ -211,6 +275,21 @@ TEST(multi_cross_layer_cpu, fp32_32x1024x3) {
   test.test();
 }
 
+TEST(multi_cross_layer_cpu, fp32_dcnv2_1x4x1x2) {
+  MultiCrossLayerCPUTest test(1, 4, 1, 2);
+  test.test();
+}
+
+TEST(multi_cross_layer_cpu, fp32_dcnv2_13x128x2x16) {
+  MultiCrossLayerCPUTest test(13, 128, 2, 16);
+  test.test();
+}
+
+TEST(multi_cross_layer_cpu, fp32_dcnv2_32x512x3x64) {
+  MultiCrossLayerCPUTest test(32, 512, 3, 64);
+  test.test();
+}
+
 // TEST(multi_cross_layer_cpu, fp32_4096x1024x2) {
 //   MultiCrossLayerCPUTest test(4096, 1024, 2);
 //   test.test();
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cpu/network_cpu.hpp>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+// Compares networks created with and without graph optimization: Predictions and memory. Timings
+// are in test/cpu_inference_perf_test. Also checks how mc_param configures the MultiCross layer.
+
+const size_t batchsize = 64;
+
+struct Input {
+  std::string name;
+  std::vector<size_t> dims;
+};
+
+std::vector<TensorEntry> create_inputs(const std::vector<Input>& inputs,
+                                       const std::shared_ptr<GeneralBuffer2<HostAllocator>>& buff) {
+  std::vector<TensorEntry> tensor_entries;
+  std::vector<Tensor2<float>> tensors;
+  for (const Input& input : inputs) {
+    Tensor2<float> tensor;
+    buff->reserve(input.dims, &tensor);
+    tensors.push_back(tensor);
+    tensor_entries.push_back({input.name, tensor.shrink()});
+  }
+  buff->allocate();
+
+  std::mt19937 gen(4711);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (Tensor2<float>& tensor : tensors) {
+    for (size_t i = 0; i < tensor.get_num_elements(); i++) {
+      tensor.get_ptr()[i] = dist(gen);
+    }
+  }
+  return tensor_entries;
+}
+
+void network_optimization_test(const std::string& layers,
+                               const std::vector<Input>& inputs) {
+  const nlohmann::json j_layers = nlohmann::json::parse(layers);
+  const auto cpu_resource = std::make_shared<CPUResource>(0, std::vector<unsigned long long>{});
+
+  const auto input_buff = GeneralBuffer2<HostAllocator>::create();
+  const std::vector<TensorEntry> input_entries = create_inputs(inputs, input_buff);
+
+  std::vector<TensorEntry> tensor_entries = input_entries;
+  std::unique_ptr<NetworkCPU> reference(
+      NetworkCPU::create_network(j_layers, tensor_entries, cpu_resource, false, false, false));
+  tensor_entries = input_entries;
+  std::unique_ptr<NetworkCPU> optimized(
+      NetworkCPU::create_network(j_layers, tensor_entries, cpu_resource, false, false, true));
+  ASSERT_EQ(reference->get_params_num(), optimized->get_params_num());
+
+  // Both networks must use the same weights.
+  const std::string model_file =
+      (std::filesystem::temp_directory_path() / "cpu_network_optimization_test.model").string();
+  {
+    std::mt19937 gen(4712);
+    std::normal_distribution<float> dist(0.f, 0.1f);
+    std::vector<float> weights(reference->get_params_num());
+    for (float& w : weights) {
+      w = dist(gen);
+    }
+    std::ofstream model_stream(model_file, std::ofstream::binary);
+    model_stream.write(reinterpret_cast<const char*>(weights.data()),
+                       weights.size() * sizeof(float));
+  }
+  for (NetworkCPU* network : {reference.get(), optimized.get()}) {
+    network->initialize();
+    network->load_params_from_model(model_file);
+  }
+  std::filesystem::remove(model_file);
+
+  reference->predict();
+  optimized->predict();
+
+  const Tensor2<float> expected = reference->get_pred_tensor();
+  const Tensor2<float> actual = optimized->get_pred_tensor();
+  ASSERT_EQ(expected.get_num_elements(), actual.get_num_elements());
+  for (size_t i = 0; i < expected.get_num_elements(); i++) {
+    ASSERT_NEAR(expected.get_ptr()[i], actual.get_ptr()[i], 1e-5f) << "at " << i;
+  }
+
+  EXPECT_LT(optimized->get_buffer_size_in_bytes(), reference->get_buffer_size_in_bytes());
+}
+
+// Reshape -> Concat -> Slice (copies) -> MultiCross | MLP -> Concat -> InnerProduct
+const char* const dcn_layers = R"([
+  {"name": "data", "type": "Data"},
+  {"name": "reshape1", "type": "Reshape", "bottom": "sparse_embedding1", "top": "reshape1",
+   "leading_dim": 416},
+  {"name": "concat1", "type": "Concat", "bottom": ["reshape1", "dense"], "top": "concat1"},
+  {"name": "slice1", "type": "Slice", "bottom": "concat1", "top": ["slice11", "slice12"],
+   "ranges": [[0, 429], [0, 429]]},
+  {"name": "multicross1", "type": "MultiCross", "bottom": "slice11", "top": "multicross1",
+   "mc_param": {"num_layers": 6}},
+  {"name": "fc1", "type": "InnerProduct", "bottom": "slice12", "top": "fc1",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+  {"name": "dropout1", "type": "Dropout", "bottom": "relu1", "top": "dropout1", "rate": 0.5},
+  {"name": "fc2", "type": "InnerProduct", "bottom": "dropout1", "top": "fc2",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu2", "type": "ReLU", "bottom": "fc2", "top": "relu2"},
+  {"name": "dropout2", "type": "Dropout", "bottom": "relu2", "top": "dropout2", "rate": 0.5},
+  {"name": "concat2", "type": "Concat", "bottom": ["dropout2", "multicross1"], "top": "concat2"},
+  {"name": "fc3", "type": "InnerProduct", "bottom": "concat2", "top": "fc3",
+   "fc_param": {"num_output": 1}},
+  {"name": "sigmoid", "type": "Sigmoid", "bottom": "fc3", "top": "sigmoid"}
+])";
+
+// Bottom MLP -> Interaction -> Top MLP
+// DCN with the low-rank DCNv2 cross layer.
+std::string dcnv2_layers() {
+  nlohmann::json j_layers = nlohmann::json::parse(dcn_layers);
+  for (nlohmann::json& j : j_layers) {
+    if (j["type"] == "MultiCross") {
+      j["mc_param"]["projection_dim"] = 64;
+    }
+  }
+  return j_layers.dump();
+}
+
+const char* const dlrm_layers = R"([
+  {"name": "data", "type": "Data"},
+  {"name": "fc1", "type": "InnerProduct", "bottom": "dense", "top": "fc1",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+  {"name": "fc2", "type": "InnerProduct", "bottom": "relu1", "top": "fc2",
+   "fc_param": {"num_output": 128}},
+  {"name": "relu2", "type": "ReLU", "bottom": "fc2", "top": "relu2"},
+  {"name": "fc3", "type": "InnerProduct", "bottom": "relu2", "top": "fc3",
+   "fc_param": {"num_output": 64}},
+  {"name": "relu3", "type": "ReLU", "bottom": "fc3", "top": "relu3"},
+  {"name": "interaction1", "type": "Interaction", "bottom": ["relu3", "sparse_embedding1"],
+   "top": "interaction1"},
+  {"name": "fc4", "type": "InnerProduct", "bottom": "interaction1", "top": "fc4",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu4", "type": "ReLU", "bottom": "fc4", "top": "relu4"},
+  {"name": "fc5", "type": "InnerProduct", "bottom": "relu4", "top": "fc5",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu5", "type": "ReLU", "bottom": "fc5", "top": "relu5"},
+  {"name": "fc6", "type": "InnerProduct", "bottom": "relu5", "top": "fc6",
+   "fc_param": {"num_output": 128}},
+  {"name": "relu6", "type": "ReLU", "bottom": "fc6", "top": "relu6"},
+  {"name": "fc7", "type": "InnerProduct", "bottom": "relu6", "top": "fc7",
+   "fc_param": {"num_output": 1}},
+  {"name": "sigmoid", "type": "Sigmoid", "bottom": "fc7", "top": "sigmoid"}
+])";
+
+// Deep (Reshape -> Concat -> MLP) + wide (Reshape) -> Add
+const char* const wdl_layers = R"([
+  {"name": "data", "type": "Data"},
+  {"name": "reshape1", "type": "Reshape", "bottom": "sparse_embedding1", "top": "reshape1",
+   "leading_dim": 416},
+  {"name": "reshape2", "type": "Reshape", "bottom": "sparse_embedding2", "top": "reshape2",
+   "leading_dim": 1},
+  {"name": "concat1", "type": "Concat", "bottom": ["reshape1", "dense"], "top": "concat1"},
+  {"name": "fc1", "type": "InnerProduct", "bottom": "concat1", "top": "fc1",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+  {"name": "dropout1", "type": "Dropout", "bottom": "relu1", "top": "dropout1", "rate": 0.5},
+  {"name": "fc2", "type": "InnerProduct", "bottom": "dropout1", "top": "fc2",
+   "fc_param": {"num_output": 256}},
+  {"name": "relu2", "type": "ReLU", "bottom": "fc2", "top": "relu2"},
+  {"name": "dropout2", "type": "Dropout", "bottom": "relu2", "top": "dropout2", "rate": 0.5},
+  {"name": "fc3", "type": "InnerProduct", "bottom": "dropout2", "top": "fc3",
+   "fc_param": {"num_output": 1}},
+  {"name": "add1", "type": "Add", "bottom": ["fc3", "reshape2"], "top": "add1"},
+  {"name": "sigmoid", "type": "Sigmoid", "bottom": "add1", "top": "sigmoid"}
+])";
+
+}  // namespace
+
+TEST(cpu_network_optimization, dcn) {
+  network_optimization_test(
+      dcn_layers, {{"dense", {batchsize, 13}}, {"sparse_embedding1", {batchsize, 26, 16}}});
+}
+TEST(cpu_network_optimization, dcnv2) {
+  network_optimization_test(
+      dcnv2_layers(), {{"dense", {batchsize, 13}}, {"sparse_embedding1", {batchsize, 26, 16}}});
+}
+TEST(cpu_network_optimization, dlrm) {
+  network_optimization_test(
+      dlrm_layers, {{"dense", {batchsize, 13}}, {"sparse_embedding1", {batchsize, 26, 64}}});
+}
+TEST(cpu_network_optimization, wdl) {
+  network_optimization_test(wdl_layers,
+                            {{"dense", {batchsize, 13}},
+                             {"sparse_embedding1", {batchsize, 26, 16}},
+                             {"sparse_embedding2", {batchsize, 1, 1}}});
+}
+
+// Without projection_dim, each cross layer has a kernel [1,w] and a bias [1,w]. With it, U [w,p],
+// V [p,w] and a bias [1,w].
+TEST(cpu_network, multi_cross_projection_dim) {
+  const size_t w = 429;
+  const int num_layers = 3;
+  const auto cpu_resource = std::make_shared<CPUResource>(0, std::vector<unsigned long long>{});
+  const auto input_buff = GeneralBuffer2<HostAllocator>::create();
+  const std::vector<TensorEntry> input_entries =
+      create_inputs({{"dense", {batchsize, w}}}, input_buff);
+
+  const auto create_network = [&](const nlohmann::json& j_mc_param) {
+    const nlohmann::json j_layers = nlohmann::json::array({
+        {{"name", "data"}, {"type", "Data"}},
+        {{"name", "multicross1"},
+         {"type", "MultiCross"},
+         {"bottom", "dense"},
+         {"top", "multicross1"},
+         {"mc_param", j_mc_param}}});
+    std::vector<TensorEntry> tensor_entries = input_entries;
+    return std::unique_ptr<NetworkCPU>(
+        NetworkCPU::create_network(j_layers, tensor_entries, cpu_resource, false, false, false));
+  };
+
+  EXPECT_EQ(create_network({{"num_layers", num_layers}})->get_params_num(), num_layers * 2 * w);
+  const size_t p = 64;
+  EXPECT_EQ(create_network({{"num_layers", num_layers}, {"projection_dim", p}})->get_params_num(),
+            num_layers * (2 * w * p + w));
+  EXPECT_THROW(create_network({{"num_layers", num_layers}, {"projection_dim", -1}}),
+               internal_runtime_error);
+}
@@ -240,7 +240,7 @@ void session_inference_criteo_test(const std::string& config_file, const std::st
   HCTR_LIB_THROW(cudaDeviceSynchronize());
 
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "==========================labels===================" << std::endl;
     for (int i = 0; i < num_samples; i++) {
       log << labels[i] << " ";
@@ -248,7 +248,7 @@ void session_inference_criteo_test(const std::string& config_file, const std::st
     log << std::endl;
   }
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "==========================prediction result===================" << std::endl;
     for (int i = 0; i < num_samples; i++) {
       log << h_out[i] << " ";
@@ -355,7 +355,7 @@ void session_inference_generated_test(const std::string& config_file, const std:
   HCTR_LIB_THROW(cudaDeviceSynchronize());
 
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     log << "==========================prediction result===================" << std::endl;
     for (int i = 0; i < num_samples; i++) {
       log << h_out[i] << " ";
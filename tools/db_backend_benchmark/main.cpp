@@ -0,0 +1,640 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/debug/logger.hpp"
+#include "hps/database_backend.hpp"
+#include "hps/hash_map_backend.hpp"
+#include "hps/hier_parameter_server_base.hpp"
+#include "hps/inference_utils.hpp"
+#include "hps/metrics_registry.hpp"
+#include "hps/mp_hash_map_backend.hpp"
+#include "hps/redis_backend.hpp"
+#include "hps/rocksdb_backend.hpp"
+#include "hps/sharded_hash_map_backend.hpp"
+
+using namespace HugeCTR;
+
+using Key = long long;
+using Clock = std::chrono::steady_clock;
+
+// Named workloads, so that backend changes can be compared on the same footing. The key
+// distribution and read ratio of a profile can be overridden individually.
+struct WorkloadProfile {
+  const char* name;
+  const char* distribution;
+  double read_ratio;
+  const char* description;
+};
+
+const WorkloadProfile workload_profiles[] = {
+    {"read_only", "uniform", 1.0, "Uniform lookups, no updates."},
+    {"read_mostly", "zipf", 0.95, "Skewed lookups with 5% updates (online inference)."},
+    {"update_heavy", "zipf", 0.5, "Skewed lookups and updates in equal parts (online training)."},
+    {"hot_set", "hot_set", 0.95, "Lookups concentrate on a slowly drifting subset of keys."},
+    {"ingest", "uniform", 0.0, "Updates only (model refresh)."},
+};
+
+enum class KeyDistribution_t { Uniform, Zipf, HotSet };
+
+struct BenchmarkConfig {
+  DatabaseType_t backend;
+  std::string profile;
+  KeyDistribution_t distribution;
+  std::string distribution_name;
+  double zipf_theta;
+  double hot_set_fraction;
+  double hot_set_probability;
+  double hot_set_speed;
+  double read_ratio;
+  size_t num_tables;
+  size_t num_keys;
+  size_t key_space;
+  size_t value_size;
+  size_t batch_size;
+  size_t num_threads;
+  double duration;
+  size_t seed;
+  VolatileDatabaseParams volatile_db;
+  PersistentDatabaseParams persistent_db;
+};
+
+/**
+ * Zipf distributed ranks in [0, n) (rank 0 is the most popular), using rejection-inversion
+ * sampling (W. Hormann, G. Derflinger, "Rejection-inversion to generate variates from monotone
+ * discrete distributions"). Takes constant memory and time, and supports any exponent > 0.
+ */
+class ZipfDistribution {
+ public:
+  ZipfDistribution(const size_t n, const double theta)
+      : n_{static_cast<double>(n)},
+        theta_{theta},
+        h_integral_x1_{h_integral_(1.5) - 1},
+        h_integral_n_{h_integral_(n_ + 0.5)},
+        s_{2 - h_integral_inverse_(h_integral_(2.5) - h_(2))} {}
+
+  template <typename Generator>
+  size_t operator()(Generator& gen) const {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    while (true) {
+      const double u = h_integral_n_ + uniform(gen) * (h_integral_x1_ - h_integral_n_);
+      const double x = h_integral_inverse_(u);
+      const double k = std::clamp(std::floor(x + 0.5), 1., n_);
+      if (k - x <= s_ || u >= h_integral_(k + 0.5) - h_(k)) {
+        return static_cast<size_t>(k) - 1;
+      }
+    }
+  }
+
+ private:
+  double h_(const double x) const { return std::exp(-theta_ * std::log(x)); }
+
+  double h_integral_(const double x) const {
+    const double log_x = std::log(x);
+    return helper2_((1 - theta_) * log_x) * log_x;
+  }
+
+  double h_integral_inverse_(const double x) const {
+    const double t = std::max(x * (1 - theta_), -1.);
+    return std::exp(helper1_(t) * x);
+  }
+
+  // log(1 + x) / x
+  static double helper1_(const double x) {
+    return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1. / 3 - 0.25 * x));
+  }
+
+  // (exp(x) - 1) / x
+  static double helper2_(const double x) {
+    return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+  }
+
+  const double n_;
+  const double theta_;
+  const double h_integral_x1_;
+  const double h_integral_n_;
+  const double s_;
+};
+
+/**
+ * Draws keys from [0, key_space) according to the configured distribution. Keys are scrambled, so
+ * that popular keys are spread over partitions and are not adjacent in sorted stores.
+ */
+class KeyGenerator {
+ public:
+  explicit KeyGenerator(const BenchmarkConfig& config)
+      : config_{config},
+        zipf_{config.key_space, config.zipf_theta},
+        hot_set_size_{std::max<size_t>(
+            static_cast<size_t>(config.hot_set_fraction * static_cast<double>(config.key_space)),
+            1)} {}
+
+  static Key key_of(const size_t index) {
+    return static_cast<Key>((index * 0x9E3779B97F4A7C15ULL) & 0x7FFFFFFFFFFFFFFFULL);
+  }
+
+  /**
+   * @param elapsed Seconds since the start of the benchmark (moves the hot set).
+   */
+  template <typename Generator>
+  Key operator()(Generator& gen, const double elapsed) const {
+    switch (config_.distribution) {
+      case KeyDistribution_t::Uniform:
+        return key_of(uniform_(gen, config_.key_space));
+      case KeyDistribution_t::Zipf:
+        return key_of(zipf_(gen));
+      case KeyDistribution_t::HotSet: {
+        if (std::uniform_real_distribution<double>(0, 1)(gen) >= config_.hot_set_probability) {
+          return key_of(uniform_(gen, config_.key_space));
+        }
+        const size_t offset = static_cast<size_t>(elapsed * config_.hot_set_speed *
+                                                  static_cast<double>(hot_set_size_));
+        return key_of((offset + uniform_(gen, hot_set_size_)) % config_.key_space);
+      }
+    }
+    return 0;
+  }
+
+ private:
+  template <typename Generator>
+  static size_t uniform_(Generator& gen, const size_t n) {
+    return std::uniform_int_distribution<size_t>(0, n - 1)(gen);
+  }
+
+  const BenchmarkConfig& config_;
+  const ZipfDistribution zipf_;
+  const size_t hot_set_size_;
+};
+
+// Constructs the backend like the hierarchical parameter server does.
+std::unique_ptr<DatabaseBackend<Key>> create_backend(const BenchmarkConfig& config) {
+  const VolatileDatabaseParams& v = config.volatile_db;
+  const PersistentDatabaseParams& p = config.persistent_db;
+  switch (config.backend) {
+    case DatabaseType_t::HashMap:
+    case DatabaseType_t::ParallelHashMap:
+      return std::make_unique<HashMapBackend<Key>>(
+          v.num_partitions, v.allocation_rate, v.max_get_batch_size, v.max_set_batch_size,
+          v.overflow_margin, v.overflow_policy, v.overflow_resolution_target);
+    case DatabaseType_t::MultiProcessHashMap:
+      return std::make_unique<MultiProcessHashMapBackend<Key>>(
+          v.num_partitions, v.allocation_rate, v.shared_memory_size, v.shared_memory_name,
+          std::chrono::milliseconds{100}, true, v.max_get_batch_size, v.max_set_batch_size,
+          v.overflow_margin, v.overflow_policy, v.overflow_resolution_target);
+    case DatabaseType_t::ShardedHashMap:
+      return std::make_unique<ShardedHashMapBackend<Key>>(
+          v.num_partitions, v.numa_aware, v.allocation_rate, v.max_get_batch_size,
+          v.max_set_batch_size, v.overflow_margin, v.overflow_policy,
+          v.overflow_resolution_target);
+    case DatabaseType_t::RedisCluster:
+      return std::make_unique<RedisClusterBackend<Key>>(
+          v.address, v.user_name, v.password, v.num_partitions, v.num_node_connections,
+          v.max_get_batch_size, v.max_set_batch_size, v.async_fetch, v.max_pipeline_depth,
+          v.refresh_time_after_fetch, v.overflow_margin, v.overflow_policy,
+          v.overflow_resolution_target);
+    case DatabaseType_t::RocksDB:
+      return std::make_unique<RocksDBBackend<Key>>(
+          p.path, p.num_threads, false, p.max_get_batch_size, p.max_set_batch_size,
+          p.block_cache_size, p.bloom_filter_bits, p.partitioned_index, p.compression);
+    default:
+      HCTR_DIE("Backend '%s' is not supported by this benchmark!",
+               hctr_enum_to_c_str(config.backend));
+  }
+  return nullptr;
+}
+
+struct OperationStats {
+  MetricHistogram latency;  // ns per batch
+  std::atomic<uint64_t> num_keys{0};
+  std::atomic<uint64_t> num_hits{0};
+
+  nlohmann::json to_json(const double elapsed, const bool with_hits) const {
+    const uint64_t num_ops = latency.count();
+    nlohmann::json j = {
+        {"ops", num_ops},
+        {"keys", num_keys.load()},
+        {"ops_per_second", static_cast<double>(num_ops) / elapsed},
+        {"keys_per_second", static_cast<double>(num_keys) / elapsed},
+        {"latency_us",
+         {{"mean", num_ops ? static_cast<double>(latency.sum()) * 1e-3 / num_ops : 0.},
+          {"p50", latency.quantile(0.5) * 1e-3},
+          {"p90", latency.quantile(0.9) * 1e-3},
+          {"p99", latency.quantile(0.99) * 1e-3},
+          {"p999", latency.quantile(0.999) * 1e-3},
+          {"max", latency.quantile(1) * 1e-3}}}};
+    if (with_hits) {
+      j["hit_rate"] = num_keys ? static_cast<double>(num_hits) / num_keys : 0.;
+    }
+
+    // Non-empty power-of-two buckets: [le_us / 2, le_us).
+    nlohmann::json histogram = nlohmann::json::array();
+    std::vector<uint64_t> bounds;
+    for (uint64_t bound = 1024; bound && bounds.size() < 40; bound <<= 1) {
+      bounds.emplace_back(bound);
+    }
+    const std::vector<uint64_t> counts = latency.cumulative_counts(bounds);
+    uint64_t prev_count = 0;
+    for (size_t i = 0; i < bounds.size() && prev_count < num_ops; i++) {
+      if (counts[i] > prev_count) {
+        histogram.push_back({{"le_us", bounds[i] / 1024}, {"count", counts[i] - prev_count}});
+      }
+      prev_count = counts[i];
+    }
+    if (prev_count < num_ops) {
+      histogram.push_back({{"le_us", "+Inf"}, {"count", num_ops - prev_count}});
+    }
+    j["histogram"] = histogram;
+    return j;
+  }
+};
+
+void print_stats(const std::string& name, const nlohmann::json& stats) {
+  auto log = HCTR_LOG_ENTRY(INFO, WORLD);
+  const nlohmann::json& latency = stats["latency_us"];
+  log << std::fixed << std::setprecision(1) << name << ": " << stats["ops_per_second"].get<double>()
+      << " ops/s, " << stats["keys_per_second"].get<double>() << " keys/s";
+  if (stats.contains("hit_rate")) {
+    log << ", hit rate " << stats["hit_rate"].get<double>() * 100 << '%';
+  }
+  log << std::endl
+      << "  latency [us]: mean " << latency["mean"].get<double>() << ", p50 "
+      << latency["p50"].get<double>() << ", p90 " << latency["p90"].get<double>() << ", p99 "
+      << latency["p99"].get<double>() << ", p999 " << latency["p999"].get<double>() << ", max "
+      << latency["max"].get<double>() << std::endl;
+
+  const uint64_t num_ops = stats["ops"].get<uint64_t>();
+  for (const auto& bucket : stats["histogram"]) {
+    const uint64_t count = bucket["count"].get<uint64_t>();
+    const std::string le = bucket["le_us"].is_string()
+                               ? bucket["le_us"].get<std::string>()
+                               : std::to_string(bucket["le_us"].get<uint64_t>());
+    log << "  < " << std::setw(8) << le << " us " << std::setw(12) << count << ' '
+        << std::string(num_ops ? count * 50 / num_ops : 0, '#') << std::endl;
+  }
+}
+
+nlohmann::json run_benchmark(const BenchmarkConfig& config) {
+  std::unique_ptr<DatabaseBackend<Key>> db = create_backend(config);
+  std::vector<std::string> table_names;
+  for (size_t t = 0; t < config.num_tables; t++) {
+    table_names.emplace_back(HierParameterServerBase::make_tag_name(
+        "db_backend_benchmark", "table" + std::to_string(t)));
+  }
+
+  // Preload tables with keys [0, num_keys).
+  OperationStats preload;
+  const auto preload_begin = Clock::now();
+  {
+    const size_t batch_size = config.backend == DatabaseType_t::RocksDB
+                                  ? config.persistent_db.max_set_batch_size
+                                  : config.volatile_db.max_set_batch_size;
+    std::vector<Key> keys(batch_size);
+    std::vector<char> values(batch_size * config.value_size);
+    std::mt19937_64 gen(config.seed);
+    std::generate(values.begin(), values.end(), [&]() { return static_cast<char>(gen()); });
+    for (const std::string& table_name : table_names) {
+      for (size_t first = 0; first < config.num_keys; first += batch_size) {
+        const size_t n = std::min(batch_size, config.num_keys - first);
+        for (size_t i = 0; i < n; i++) {
+          keys[i] = KeyGenerator::key_of(first + i);
+        }
+        const MetricTimer timer(preload.latency);
+        HCTR_CHECK(db->insert(table_name, n, keys.data(), values.data(), config.value_size));
+        preload.num_keys += n;
+      }
+    }
+  }
+  const double preload_elapsed = std::chrono::duration<double>(Clock::now() - preload_begin).count();
+
+  // Closed-loop clients. Each operation reads or writes a batch of keys in a random table.
+  const KeyGenerator key_generator(config);
+  OperationStats reads;
+  OperationStats writes;
+  std::atomic<bool> running{true};
+  const auto begin = Clock::now();
+  std::vector<std::thread> clients;
+  for (size_t t = 0; t < config.num_threads; t++) {
+    clients.emplace_back([&, t]() {
+      hctr_set_thread_name("client #" + std::to_string(t));
+      std::mt19937_64 gen(config.seed + t + 1);
+      std::uniform_real_distribution<double> op_dist(0, 1);
+      std::uniform_int_distribution<size_t> table_dist(0, config.num_tables - 1);
+      std::vector<Key> keys(config.batch_size);
+      std::vector<char> values(config.batch_size * config.value_size);
+      std::generate(values.begin(), values.end(), [&]() { return static_cast<char>(gen()); });
+      std::vector<size_t> missing;
+
+      while (running.load(std::memory_order_relaxed)) {
+        const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+        std::generate(keys.begin(), keys.end(), [&]() { return key_generator(gen, elapsed); });
+        const std::string& table_name = table_names[table_dist(gen)];
+
+        if (op_dist(gen) < config.read_ratio) {
+          const auto op_begin = Clock::now();
+          const size_t num_hits =
+              db->fetch(table_name, keys.size(), keys.data(), values.data(), config.value_size,
+                        config.value_size, missing, std::chrono::nanoseconds::max());
+          reads.latency.record(Clock::now() - op_begin);
+          reads.num_keys.fetch_add(keys.size(), std::memory_order_relaxed);
+          reads.num_hits.fetch_add(num_hits, std::memory_order_relaxed);
+        } else {
+          const auto op_begin = Clock::now();
+          HCTR_CHECK(
+              db->insert(table_name, keys.size(), keys.data(), values.data(), config.value_size));
+          writes.latency.record(Clock::now() - op_begin);
+          writes.num_keys.fetch_add(keys.size(), std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::duration<double>(config.duration));
+  running = false;
+  for (auto& client : clients) {
+    client.join();
+  }
+  const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+  nlohmann::json results;
+  results["preload"] = preload.to_json(preload_elapsed, false);
+  results["read"] = reads.to_json(elapsed, true);
+  results["write"] = writes.to_json(elapsed, false);
+  results["size"] = nlohmann::json::object();
+  for (const std::string& table_name : table_names) {
+    results["size"][table_name] = db->size(table_name);
+    db->evict(table_name);
+  }
+  return results;
+}
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args("db_backend_benchmark");
+
+  std::string profile_help = "Workload profile:";
+  for (const WorkloadProfile& profile : workload_profiles) {
+    profile_help += std::string("\n  ") + profile.name + ": " + profile.description;
+  }
+
+  args.add_argument("--backend")
+      .default_value(std::string("hash_map"))
+      .help(
+          "Database backend (hash_map, sharded_hash_map, multi_process_hash_map, redis_cluster or "
+          "rocks_db)");
+
+  args.add_argument("--profile").default_value(std::string("read_mostly")).help(profile_help);
+
+  args.add_argument("--distribution")
+      .default_value(std::string(""))
+      .help("Key distribution (uniform, zipf or hot_set); overrides the profile");
+
+  args.add_argument("--read_ratio")
+      .default_value(std::string(""))
+      .help("Fraction of operations that are lookups; overrides the profile");
+
+  args.add_argument("--zipf_theta").default_value(0.99).action([](const std::string& value) {
+    return std::stod(value);
+  });
+
+  args.add_argument("--hot_set_fraction")
+      .default_value(0.01)
+      .action([](const std::string& value) { return std::stod(value); })
+      .help("Size of the hot set, relative to the key space");
+
+  args.add_argument("--hot_set_probability")
+      .default_value(0.9)
+      .action([](const std::string& value) { return std::stod(value); })
+      .help("Probability that a key is drawn from the hot set");
+
+  args.add_argument("--hot_set_speed")
+      .default_value(0.1)
+      .action([](const std::string& value) { return std::stod(value); })
+      .help("Hot set widths that the hot set moves per second");
+
+  args.add_argument("--num_tables").default_value(1).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--num_keys")
+      .default_value(1000000)
+      .action([](const std::string& value) { return std::stoi(value); })
+      .help("Keys inserted into each table before the measurement");
+
+  args.add_argument("--key_space")
+      .default_value(0)
+      .action([](const std::string& value) { return std::stoi(value); })
+      .help("Range of queried keys (0 = num_keys). Keys beyond num_keys are misses");
+
+  args.add_argument("--value_size")
+      .default_value(64)
+      .action([](const std::string& value) { return std::stoi(value); })
+      .help("Value size in bytes");
+
+  args.add_argument("--batch_size")
+      .default_value(1024)
+      .action([](const std::string& value) { return std::stoi(value); })
+      .help("Keys per operation");
+
+  args.add_argument("--num_threads").default_value(8).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--duration")
+      .default_value(10.0)
+      .action([](const std::string& value) { return std::stod(value); })
+      .help("Seconds to measure");
+
+  args.add_argument("--num_partitions").default_value(16).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--overflow_margin")
+      .default_value(0)
+      .action([](const std::string& value) { return std::stoi(value); })
+      .help("Maximum number of keys per partition (0 = unlimited)");
+
+  args.add_argument("--overflow_policy")
+      .default_value(std::string("evict_oldest"))
+      .help("evict_oldest or evict_random");
+
+  args.add_argument("--overflow_resolution_target")
+      .default_value(0.8)
+      .action([](const std::string& value) { return std::stod(value); });
+
+  args.add_argument("--path")
+      .default_value(std::string(""))
+      .help("RocksDB directory (default: temporary directory that is removed afterwards)");
+
+  args.add_argument("--address")
+      .default_value(std::string("127.0.0.1:7000"))
+      .help("Redis cluster address");
+
+  args.add_argument("--seed").default_value(0).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--output").default_value(std::string("")).help("Write results as JSON");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cout << err.what() << std::endl;
+    std::cout << args;
+    exit(1);
+  }
+
+  BenchmarkConfig config;
+  config.backend = get_hps_database_type({{"type", args.get<std::string>("--backend")}}, "type");
+
+  config.profile = args.get<std::string>("--profile");
+  const WorkloadProfile* const profile = std::find_if(
+      std::begin(workload_profiles), std::end(workload_profiles),
+      [&](const WorkloadProfile& p) { return config.profile == p.name; });
+  if (profile == std::end(workload_profiles)) {
+    std::cout << "Unknown workload profile: " << config.profile << std::endl;
+    exit(1);
+  }
+  config.distribution_name = args.get<std::string>("--distribution");
+  if (config.distribution_name.empty()) {
+    config.distribution_name = profile->distribution;
+  }
+  if (config.distribution_name == "uniform") {
+    config.distribution = KeyDistribution_t::Uniform;
+  } else if (config.distribution_name == "zipf") {
+    config.distribution = KeyDistribution_t::Zipf;
+  } else if (config.distribution_name == "hot_set") {
+    config.distribution = KeyDistribution_t::HotSet;
+  } else {
+    std::cout << "Unknown key distribution: " << config.distribution_name << std::endl;
+    exit(1);
+  }
+  const std::string read_ratio = args.get<std::string>("--read_ratio");
+  config.read_ratio = read_ratio.empty() ? profile->read_ratio : std::stod(read_ratio);
+
+  config.zipf_theta = args.get<double>("--zipf_theta");
+  config.hot_set_fraction = args.get<double>("--hot_set_fraction");
+  config.hot_set_probability = args.get<double>("--hot_set_probability");
+  config.hot_set_speed = args.get<double>("--hot_set_speed");
+  config.num_tables = static_cast<size_t>(std::max(args.get<int>("--num_tables"), 1));
+  config.num_keys = static_cast<size_t>(args.get<int>("--num_keys"));
+  config.key_space = static_cast<size_t>(args.get<int>("--key_space"));
+  if (config.key_space == 0) {
+    config.key_space = config.num_keys;
+  }
+  config.value_size = static_cast<size_t>(args.get<int>("--value_size"));
+  config.batch_size = static_cast<size_t>(args.get<int>("--batch_size"));
+  config.num_threads = static_cast<size_t>(std::max(args.get<int>("--num_threads"), 1));
+  config.duration = args.get<double>("--duration");
+  config.seed = static_cast<size_t>(args.get<int>("--seed"));
+  HCTR_CHECK_HINT(config.key_space > 0 && config.value_size > 0 && config.batch_size > 0,
+                  "key_space, value_size and batch_size must be positive!");
+
+  VolatileDatabaseParams& v = config.volatile_db;
+  v.type = config.backend;
+  v.address = args.get<std::string>("--address");
+  v.num_partitions = static_cast<size_t>(args.get<int>("--num_partitions"));
+  const size_t overflow_margin = static_cast<size_t>(args.get<int>("--overflow_margin"));
+  v.overflow_margin = overflow_margin ? overflow_margin : std::numeric_limits<size_t>::max();
+  v.overflow_policy =
+      get_hps_overflow_policy({{"policy", args.get<std::string>("--overflow_policy")}}, "policy");
+  v.overflow_resolution_target = args.get<double>("--overflow_resolution_target");
+  v.shared_memory_name = "hctr_db_backend_benchmark_" + std::to_string(getpid());
+  // Pairs plus bookkeeping, with plenty of headroom for updates.
+  v.shared_memory_size = 4 * config.num_tables * std::max(config.num_keys, config.key_space) *
+                             (config.value_size + 64) +
+                         256L * 1024L * 1024L;
+
+  PersistentDatabaseParams& p = config.persistent_db;
+  p.type = config.backend;
+  p.path = args.get<std::string>("--path");
+  const bool remove_path = p.path.empty();
+  if (remove_path) {
+    p.path = std::filesystem::temp_directory_path() /
+             ("hctr_db_backend_benchmark_" + std::to_string(getpid()));
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Backend: " << config.backend << ", profile: " << config.profile
+                          << ", distribution: " << config.distribution_name
+                          << ", read ratio: " << config.read_ratio << ", tables: "
+                          << config.num_tables << " x " << config.num_keys
+                          << " keys, key space: " << config.key_space
+                          << ", value size: " << config.value_size
+                          << " bytes, batch size: " << config.batch_size
+                          << ", threads: " << config.num_threads << std::endl;
+
+  nlohmann::json results;
+  try {
+    results = run_benchmark(config);
+  } catch (...) {
+    if (remove_path) {
+      std::filesystem::remove_all(p.path);
+    }
+    throw;
+  }
+  if (remove_path) {
+    std::filesystem::remove_all(p.path);
+  }
+
+  print_stats("preload", results["preload"]);
+  for (const char* op : {"read", "write"}) {
+    if (results[op]["ops"].get<uint64_t>() > 0) {
+      print_stats(op, results[op]);
+    }
+  }
+
+  const std::string output = args.get<std::string>("--output");
+  if (!output.empty()) {
+    results["config"] = {{"backend", hctr_enum_to_c_str(config.backend)},
+                         {"profile", config.profile},
+                         {"distribution", config.distribution_name},
+                         {"zipf_theta", config.zipf_theta},
+                         {"hot_set_fraction", config.hot_set_fraction},
+                         {"hot_set_probability", config.hot_set_probability},
+                         {"hot_set_speed", config.hot_set_speed},
+                         {"read_ratio", config.read_ratio},
+                         {"num_tables", config.num_tables},
+                         {"num_keys", config.num_keys},
+                         {"key_space", config.key_space},
+                         {"value_size", config.value_size},
+                         {"batch_size", config.batch_size},
+                         {"num_threads", config.num_threads},
+                         {"duration", config.duration},
+                         {"num_partitions", v.num_partitions},
+                         {"overflow_margin", overflow_margin},
+                         {"overflow_policy", hctr_enum_to_c_str(v.overflow_policy)},
+                         {"overflow_resolution_target", v.overflow_resolution_target},
+                         {"seed", config.seed}};
+    std::ofstream(output) << results.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Wrote results to '" << output << "'." << std::endl;
+  }
+  return 0;
+}
@@ -551,7 +551,7 @@ void process_terabyte_dataset(const std::string &input_dir_path, const std::stri
                             num_categoricals * sizeof(uint32_t), cudaMemcpyDeviceToHost));
   HCTR_LOG(INFO, ROOT, "Slot size array, missing value mapped to unused key: \n");
   {
-    auto log = HCTR_LOG_S(INFO, WORLD);
+    auto log = HCTR_LOG_ENTRY(INFO, WORLD);
     for (auto c : host_sz_per_fea) {
       log << (c) << ", ";
     }
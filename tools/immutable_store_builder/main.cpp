@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+#include "base/debug/logger.hpp"
+#include "hps/hier_parameter_server_base.hpp"
+#include "hps/immutable_store_backend.hpp"
+#include "hps/modelloader.hpp"
+#include "io/filesystem.hpp"
+
+using namespace HugeCTR;
+
+// Converts a sparse model folder (key + emb_vector files) into an immutable store table.
+template <typename Key>
+void build_table(const std::string& sparse_model, const std::string& table_name,
+                 const std::string& path, const size_t max_error, const size_t embedding_vecsize) {
+  const auto start = std::chrono::high_resolution_clock::now();
+
+  std::unique_ptr<IModelLoader> reader(
+      ModelLoader<Key, float>::CreateLoader(DBTableDumpFormat_t::Raw));
+  reader->load(table_name, sparse_model);
+
+  // Derive embedding vector size from the size of the vector file, unless given explicitly. An
+  // empty table gives no hint, so the size must be given.
+  const size_t num_keys = reader->getkeycount();
+  const size_t vec_file_size =
+      FileSystemBuilder::build_unique_by_path(sparse_model)->get_file_size(sparse_model +
+                                                                           "/emb_vector");
+  size_t value_size = embedding_vecsize * sizeof(float);
+  if (num_keys == 0) {
+    HCTR_CHECK_HINT(vec_file_size == 0, "Embedding vector file of an empty table is not empty!");
+    HCTR_CHECK_HINT(value_size > 0, "Table is empty. Specify --embedding_vecsize to build it.");
+  } else {
+    HCTR_CHECK_HINT(vec_file_size % (num_keys * sizeof(float)) == 0,
+                    "Size of embedding vector file does not match the number of keys (%zu)!",
+                    num_keys);
+    HCTR_CHECK_HINT(value_size == 0 || value_size == vec_file_size / num_keys,
+                    "Embedding vector file does not match --embedding_vecsize!");
+    value_size = vec_file_size / num_keys;
+  }
+
+  ImmutableStoreBackend<Key>::build(path, num_keys, static_cast<const Key*>(reader->getkeys()),
+                                    static_cast<const char*>(reader->getvectors()), value_size,
+                                    max_error);
+
+  const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+  HCTR_LOG_S(INFO, WORLD) << "Built '" << path << "' from " << num_keys << " embeddings ("
+                          << value_size / sizeof(float) << " floats each) in " << elapsed.count()
+                          << " s." << std::endl;
+}
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args("immutable_store_builder");
+
+  args.add_argument("--model").required().help("Name of the model");
+
+  args.add_argument("--table").required().help("Name of the embedding table within the model");
+
+  args.add_argument("--output").required().help(
+      "Directory of the immutable store (= persistent_db.path)");
+
+  args.add_argument("--key_type")
+      .default_value(std::string("I64"))
+      .help("Key type of the model (I64 or I32)");
+
+  args.add_argument("--max_error").default_value(32).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--embedding_vecsize")
+      .default_value(0)
+      .action([](const std::string& value) { return std::stoi(value); })
+      .help("Embedding vector size (default: derived from the size of emb_vector)");
+
+  args.add_argument("sparse_model").help("Sparse model folder that contains key and emb_vector");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cout << err.what() << std::endl;
+    std::cout << args;
+    exit(1);
+  }
+
+  // Tables are named like in the parameter server.
+  const std::string tag_name = HierParameterServerBase::make_tag_name(
+      args.get<std::string>("--model"), args.get<std::string>("--table"));
+  const std::filesystem::path output = args.get<std::string>("--output");
+  std::filesystem::create_directories(output);
+  const std::string path = (output / tag_name).string() + immutable_store_extension;
+
+  const std::string sparse_model = args.get<std::string>("sparse_model");
+  const size_t max_error = static_cast<size_t>(args.get<int>("--max_error"));
+  const size_t embedding_vecsize = static_cast<size_t>(args.get<int>("--embedding_vecsize"));
+  const std::string key_type = args.get<std::string>("--key_type");
+  if (key_type == "I64") {
+    build_table<long long>(sparse_model, tag_name, path, max_error, embedding_vecsize);
+  } else if (key_type == "I32") {
+    build_table<unsigned int>(sparse_model, tag_name, path, max_error, embedding_vecsize);
+  } else {
+    std::cout << "Unsupported key type: " << key_type << std::endl;
+    exit(1);
+  }
+  return 0;
+}